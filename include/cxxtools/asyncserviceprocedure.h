@@ -0,0 +1,255 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_ASYNCSERVICEPROCEDURE_H
+#define CXXTOOLS_ASYNCSERVICEPROCEDURE_H
+
+#include <cxxtools/serviceprocedure.h>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <tuple>
+
+namespace cxxtools
+{
+
+/**
+ Handle to deliver the result of an asynchronous service procedure.
+
+ An asynchronous procedure gets an AsyncResult as its first argument. It
+ returns immediately and passes the result later, possibly from another
+ thread, using set or setError. The handle may be copied; only the first
+ result or error is used.
+
+ Example:
+
+ \code
+    void fetch(cxxtools::AsyncResult<std::string> result, const std::string& key)
+    {
+        backend.asyncGet(key, [result](const std::string& value) mutable {
+            result.set(value);
+        });
+    }
+
+    server.registerAsyncFunction("fetch", fetch);
+ \endcode
+ */
+template <typename R>
+class AsyncResult
+{
+    public:
+        //! @cond internal
+        struct State
+        {
+            std::mutex mutex;
+            std::condition_variable ready;
+            std::function<void()> finished;
+            bool done;
+            R value;
+            std::exception_ptr error;
+
+            State()
+                : done(false)
+            { }
+        };
+
+        explicit AsyncResult(const std::shared_ptr<State>& state)
+            : _state(state)
+        { }
+        //! @endcond internal
+
+        /// Delivers the return value of the procedure.
+        void set(const R& value)
+        {
+            std::lock_guard<std::mutex> lock(_state->mutex);
+            if (_state->done)
+                return;
+            _state->value = value;
+            finish();
+        }
+
+        /// Reports an exception to the client. A RemoteException passes its
+        /// return code to the client.
+        void setError(std::exception_ptr error)
+        {
+            std::lock_guard<std::mutex> lock(_state->mutex);
+            if (_state->done)
+                return;
+            _state->error = error;
+            finish();
+        }
+
+        template <typename E>
+        void setError(const E& e)
+        { setError(std::make_exception_ptr(e)); }
+
+        /// Returns true, when a result or an error is already set.
+        bool done() const
+        {
+            std::lock_guard<std::mutex> lock(_state->mutex);
+            return _state->done;
+        }
+
+    private:
+        // The callback runs with the state locked, so that the procedure
+        // can't be destroyed while the server is notified.
+        void finish()
+        {
+            _state->done = true;
+            _state->ready.notify_all();
+            if (_state->finished)
+                _state->finished();
+        }
+
+        std::shared_ptr<State> _state;
+};
+
+//! @cond internal
+
+template <std::size_t... I>
+struct AsyncIndexSequence
+{ };
+
+template <std::size_t N, std::size_t... I>
+struct MakeAsyncIndexSequence : MakeAsyncIndexSequence<N - 1, N - 1, I...>
+{ };
+
+template <std::size_t... I>
+struct MakeAsyncIndexSequence<0, I...>
+{
+    typedef AsyncIndexSequence<I...> type;
+};
+
+template <typename R, typename... A>
+class AsyncServiceProcedure : public ServiceProcedure
+{
+        typedef typename AsyncResult<R>::State State;
+        typedef typename TypeTraits<R>::Value RV;
+        typedef typename MakeAsyncIndexSequence<sizeof...(A)>::type Indices;
+
+    public:
+        typedef std::function<void (AsyncResult<R>, A...)> Function;
+
+        explicit AsyncServiceProcedure(const Function& fn)
+            : _fn(fn)
+        { }
+
+        ~AsyncServiceProcedure()
+        {
+            if (_state)
+            {
+                std::lock_guard<std::mutex> lock(_state->mutex);
+                _state->finished = std::function<void()>();
+            }
+        }
+
+        ServiceProcedure* clone() const
+        {
+            return new AsyncServiceProcedure(_fn);
+        }
+
+        IComposer** beginCall()
+        {
+            beginArgs(Indices());
+            _args[sizeof...(A)] = 0;
+            return _args;
+        }
+
+        bool isAsync() const
+        { return true; }
+
+        void startCall(const std::function<void()>& finished)
+        {
+            std::shared_ptr<State> state = std::make_shared<State>();
+            state->finished = finished;
+            _state = state;
+
+            // When the procedure finishes immediately, the server may already
+            // destroy this object, so only the local state is used after the call.
+            try
+            {
+                call(AsyncResult<R>(state), Indices());
+            }
+            catch (...)
+            {
+                AsyncResult<R>(state).setError(std::current_exception());
+            }
+        }
+
+        // Servers without support for asynchronous procedures just call
+        // endCall; then we wait here for the result.
+        IDecomposer* endCall()
+        {
+            if (!_state)
+                startCall(std::function<void()>());
+
+            std::unique_lock<std::mutex> lock(_state->mutex);
+            while (!_state->done)
+                _state->ready.wait(lock);
+
+            if (_state->error)
+                std::rethrow_exception(_state->error);
+
+            _rv = _state->value;
+            _r.begin(_rv);
+            return &_r;
+        }
+
+    private:
+        template <std::size_t... I>
+        void beginArgs(AsyncIndexSequence<I...>)
+        {
+            int dummy[] = { 0, (std::get<I>(_a).begin(std::get<I>(_v)), _args[I] = &std::get<I>(_a), 0)... };
+            (void)dummy;
+        }
+
+        template <std::size_t... I>
+        void call(AsyncResult<R> result, AsyncIndexSequence<I...>)
+        {
+            _fn(result, std::get<I>(_v)...);
+        }
+
+        Function _fn;
+        std::shared_ptr<State> _state;
+
+        std::tuple<typename TypeTraits<A>::Value...> _v;
+        std::tuple<Composer<typename TypeTraits<A>::Value>...> _a;
+        IComposer* _args[sizeof...(A) + 1];
+
+        RV _rv;
+        Decomposer<RV> _r;
+};
+
+//! @endcond internal
+
+}
+
+#endif // CXXTOOLS_ASYNCSERVICEPROCEDURE_H
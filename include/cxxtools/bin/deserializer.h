@@ -71,6 +71,11 @@ namespace bin
             bool advance(std::streambuf& in)
             { return _parser.advance(in); }
 
+            /// Clears the dictionary kept with begin(false) and limits it to
+            /// maxSize names.
+            void resetDictionary(unsigned maxSize = 0x10000)
+            { _parser.resetDictionary(maxSize); }
+
             /// Rest of input is parsed but do not process any data.
             void skip()
             { _parser.skip(); }
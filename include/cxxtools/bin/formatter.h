@@ -31,7 +31,8 @@
 
 #include <cxxtools/formatter.h>
 #include <iosfwd>
-#include <vector>
+#include <string>
+#include <unordered_map>
 
 namespace cxxtools
 {
@@ -96,6 +97,27 @@ public:
 
     void finishObject();
 
+    /// Keeps the dictionary of member and type names between messages.
+    ///
+    /// By default the dictionary is cleared in begin and finish, so that each
+    /// message is self contained. With a session dictionary names are sent
+    /// once and referenced by index in all following messages. The dictionary
+    /// stops growing, when it holds maxSize names. Passing 0 returns to the
+    /// default. The receiver must use a session dictionary of the same size.
+    void sessionDictionary(unsigned maxSize);
+
+    /// Returns the size of the session dictionary or 0 if none is used.
+    unsigned sessionDictionary() const
+        { return _session ? _maxDictionarySize : 0; }
+
+    /// Clears the dictionary.
+    void resetDictionary()
+        { _dictionary.clear(); }
+
+    /// Returns true, if no more names are added to the dictionary.
+    bool dictionaryFull() const
+        { return _dictionary.size() >= _maxDictionarySize; }
+
     // function returns string as it is stored in binary data stream
     static std::string rawString(const std::string& value);
 
@@ -106,7 +128,9 @@ private:
     void outputString(const std::string& value);
 
     std::streambuf* _out = nullptr;
-    std::vector<std::string> _dictionary;
+    std::unordered_map<std::string, unsigned> _dictionary;
+    unsigned _maxDictionarySize = 0x10000;
+    bool _session = false;
 };
 
 }
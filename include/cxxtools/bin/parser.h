@@ -87,17 +87,19 @@ class Parser
         Parser(const Parser&) = delete;
         Parser& operator= (const Parser&) = delete;
 
-        explicit Parser(std::vector<std::string>* dictionary)
+        Parser(std::vector<std::string>* dictionary, unsigned maxDictionarySize)
             : _deserializer(0),
               _next(0),
-              _dictionary(dictionary)
+              _dictionary(dictionary),
+              _maxDictionarySize(maxDictionarySize)
         { }
 
     public:
         Parser()
             : _deserializer(0),
               _next(0),
-              _dictionary(&_mydictionary)
+              _dictionary(&_mydictionary),
+              _maxDictionarySize(0x10000)
         { }
 
         ~Parser() 
@@ -113,6 +115,12 @@ class Parser
 
         bool advance(std::streambuf& in, bool atLeastOne = false); // returns true, if value is complete
 
+        /// Clears the dictionary and limits it to maxSize names.
+        ///
+        /// Together with begin(handler, false) this parses messages written
+        /// by a formatter with a session dictionary of the same size.
+        void resetDictionary(unsigned maxSize = 0x10000);
+
     private:
 
         bool processFloatBase(char ch, unsigned shift, unsigned expOffset);
@@ -172,6 +180,7 @@ class Parser
         Parser* _next;
         std::vector<std::string> _mydictionary;
         std::vector<std::string>* _dictionary;
+        unsigned _maxDictionarySize;
 };
 }
 }
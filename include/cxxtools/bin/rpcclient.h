@@ -145,6 +145,12 @@ class RpcClient : public RemoteClient
 
         void setSelector(SelectorBase& selector)  { setSelector(&selector); }
 
+        /// Starts a asynchronous call.
+        ///
+        /// Calls may be started while others are still running. They are
+        /// sent on the same connection tagged with a request id, so that the
+        /// replies can be received in any order. This needs a server, which
+        /// understands request ids. A single call is sent untagged.
         void beginCall(IComposer& r, IRemoteProcedure& method, IDecomposer** argv, unsigned argc);
 
         void endCall();
@@ -157,16 +163,35 @@ class RpcClient : public RemoteClient
         Milliseconds connectTimeout() const;
         void connectTimeout(Milliseconds t);
 
+        /// Returns one of the procedures, which are currently running or
+        /// 0 if no procedure is active.
         const IRemoteProcedure* activeProcedure() const;
 
+        /// Cancels all running procedures and closes the connection.
         void cancel();
 
+        /// Cancels just the given procedure. Other procedures running on the
+        /// connection are not affected. The reply is ignored when it arrives.
+        void cancelCall(IRemoteProcedure& method);
+
+        /// Waits until all running procedures are finished.
         void wait(Milliseconds msecs = WaitInfinite);
 
         const std::string& domain() const;
 
         void domain(const std::string& p);
 
+        /// Returns the requested size of the connection level dictionary.
+        unsigned dictionarySize() const;
+
+        /// Requests a connection level dictionary with at most n names.
+        ///
+        /// Member and type names are then sent once per connection and
+        /// referenced by index in all later messages. The server may choose
+        /// a smaller size or decline. It must understand the request, so the
+        /// default is 0, which disables the dictionary. The maximum is 65535.
+        void dictionarySize(unsigned n);
+
         Delegate<bool, const SslCertificate&>& acceptSslCertificate();
 };
 
@@ -102,6 +102,24 @@ class RpcServer : public ServiceRegistry
         unsigned maxThreads() const;
         void maxThreads(unsigned m);
 
+        /** Sets the number of event loop threads watching idle connections.
+         *
+         *  Idle connections are distributed round robin over the loops.
+         *  With 0 (the default) the event loop passed to the constructor
+         *  is used. Must be set before the server is started.
+         */
+        unsigned eventLoops() const;
+        void eventLoops(unsigned n);
+
+        /** Sets the maximum size of connection level dictionaries.
+         *
+         *  Clients may ask to send member and type names just once per
+         *  connection. The server keeps up to n names per connection and
+         *  direction then. The default is 1024; 0 declines these requests.
+         */
+        unsigned dictionarySize() const;
+        void dictionarySize(unsigned n);
+
         enum Runmode {
           Stopped,
           Starting,
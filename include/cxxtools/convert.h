@@ -42,6 +42,7 @@
 #include <iterator>
 #include <cctype>
 #include <cmath>
+#include <stdint.h>
 
 #include <cxxtools/config.h>
 
@@ -291,6 +292,8 @@ template <typename OutIterT, typename T, typename FormatT>
 OutIterT putFloat(OutIterT it, T d, const FormatT& fmt, int precision);
 
 /** @brief Formats a floating point value in default format.
+
+    The shortest representation, which reads back to the same value, is used.
  */
 template <typename OutIterT, typename T>
 OutIterT putFloat(OutIterT it, T d);
@@ -647,6 +650,30 @@ inline OutIterT putInt(OutIterT it, T i)
 }
 
 
+//! @internal @brief Calculates the shortest decimal digits, which read back to \a v.
+//!
+//! The value is written as ascii digits to \a digits (at least 32 bytes)
+//! without leading or trailing zeros. The number of digits is returned and
+//! \a exp10 receives the decimal exponent of the last digit. \a v must be
+//! finite and positive.
+unsigned shortestDigits(float v, char* digits, int& exp10);
+unsigned shortestDigits(double v, char* digits, int& exp10);
+unsigned shortestDigits(long double v, char* digits, int& exp10);
+
+//! @internal @brief Converts mantissa * 10^exp10 to a floating point value.
+//!
+//! Returns false, when the result can't be calculated exactly without
+//! looking at all digits. \a inexact tells, that more non zero digits
+//! followed after the digits in the mantissa.
+bool decimalToFloat(uint64_t mantissa, int exp10, bool inexact, float& n);
+bool decimalToFloat(uint64_t mantissa, int exp10, bool inexact, double& n);
+bool decimalToFloat(uint64_t mantissa, int exp10, bool inexact, long double& n);
+
+//! @internal @brief Converts the decimal digits \a digits * 10^exp10 with correct rounding.
+void decimalToFloat(const std::string& digits, int exp10, float& n);
+void decimalToFloat(const std::string& digits, int exp10, double& n);
+void decimalToFloat(const std::string& digits, int exp10, long double& n);
+
 template <typename OutIterT, typename T, typename FormatT>
 inline OutIterT putFloat(OutIterT it, T value, const FormatT& fmt, int precision)
 {
@@ -685,68 +712,99 @@ inline OutIterT putFloat(OutIterT it, T value, const FormatT& fmt, int precision
         return it;
     }
 
-    const int bufsize = std::numeric_limits<T>::digits10 + 1;
+    if (num == 0)
+    {
+        *it = fmt.toChar(0); ++it;
+        return it;
+    }
 
-    if (precision > bufsize)
-        precision = bufsize;
+    // 4. get shortest digits, which read back to the same value
+    char digits[32];
+    int exp10;
+    int len = static_cast<int>(shortestDigits(num, digits, exp10));
 
-    CharT fract[bufsize + 1];
-    fract[precision] = CharT('\0');
+    // 5. round to requested precision
+    if (precision < 1)
+        precision = 1;
 
-    int exp = static_cast<int>(std::floor(std::log10(num))) + 1;
+    if (len > precision)
+    {
+        bool up = digits[precision] >= '5';
+        exp10 += len - precision;
+        len = precision;
+        if (up)
+        {
+            int d = len - 1;
+            while (d >= 0 && digits[d] == '9')
+                --d;
 
-    num *= std::pow(T(10.0), precision - exp);
-    num += .5;
+            if (d < 0)
+            {
+                digits[0] = '1';
+                exp10 += len;
+                len = 1;
+            }
+            else
+            {
+                ++digits[d];
+                exp10 += len - d - 1;
+                len = d + 1;
+            }
+        }
 
-    bool notZero = false;
-    for (unsigned short dd = precision; dd > 0; --dd)
-    {
-        T n = num / T(10.0);
-        T fl = std::floor(n) * T(10.0);
-        unsigned char v = static_cast<unsigned char>(num - fl);
-        notZero |= (v != 0 && v < 10);
-        fract[dd - 1] = notZero ? fmt.toChar(v) : CharT('\0');
-        num = n;
+        while (len > 1 && digits[len - 1] == '0')
+        {
+            --len;
+            ++exp10;
+        }
     }
 
-    if (fract[0] == CharT('\0'))
+    // 6. output; the decimal point is after digit number pointPos
+    int pointPos = len + exp10;
+    if (pointPos > 0 && pointPos <= 21)
     {
-        *it = '0'; ++it;
-        return it;
-    }
+        for (int d = 0; d < len; ++d)
+        {
+            if (d == pointPos)
+            {
+                *it = fmt.point(); ++it;
+            }
+            *it = fmt.toChar(digits[d] - '0'); ++it;
+        }
 
-    if (exp <= 0)
+        for (int d = len; d < pointPos; ++d)
+        {
+            *it = fmt.toChar(0); ++it;
+        }
+    }
+    else if (pointPos <= 0 && pointPos > -6)
     {
-        *it = '0'; ++it;
-        *it = '.'; ++it;
-
-        while (exp < 0)
+        *it = fmt.toChar(0); ++it;
+        *it = fmt.point(); ++it;
+        for ( ; pointPos < 0; ++pointPos)
         {
-            *it = '0'; ++it;
-            ++exp;
+            *it = fmt.toChar(0); ++it;
         }
 
-        for (int dd = 0; fract[dd]; ++dd)
+        for (int d = 0; d < len; ++d)
         {
-            *it = fract[dd]; ++it;
+            *it = fmt.toChar(digits[d] - '0'); ++it;
         }
     }
     else
     {
-        for (int dd = 0; fract[dd]; ++dd)
+        *it = fmt.toChar(digits[0] - '0'); ++it;
+        if (len > 1)
         {
-            if (exp-- == 0)
+            *it = fmt.point(); ++it;
+            for (int d = 1; d < len; ++d)
             {
-                *it = '.';
-                ++it;
+                *it = fmt.toChar(digits[d] - '0'); ++it;
             }
-            *it = fract[dd]; ++it;
         }
 
-        while (exp-- > 0)
-        {
-            *it = '0'; ++it;
-        }
+        *it = fmt.e(); ++it;
+        it = putInt(it, pointPos - 1, fmt);
     }
 
     return it;
@@ -756,9 +814,8 @@ inline OutIterT putFloat(OutIterT it, T value, const FormatT& fmt, int precision
 template <typename OutIterT, typename T>
 inline OutIterT putFloat(OutIterT it, T value)
 {
-    const int precision = std::numeric_limits<T>::digits10 - 1;
     FloatFormat<char> fmt;
-    return putFloat(it, value, fmt, precision);
+    return putFloat(it, value, fmt, std::numeric_limits<int>::max());
 }
 
 
@@ -859,7 +916,6 @@ template <typename InIterT, typename T, typename FormatT>
 InIterT getFloat(InIterT it, InIterT end, bool& ok, T& n, const FormatT& fmt)
 {
     typedef typename FormatT::CharT CharT;
-    CharT zero = fmt.toChar(0);
     n = 0.0;
     ok = false;
 
@@ -978,95 +1034,110 @@ InIterT getFloat(InIterT it, InIterT end, bool& ok, T& n, const FormatT& fmt)
         ++it;
     }
 
+    // The first 19 significant digits are collected in a 64 bit integer.
+    // More digits are only kept for the rare case, where they are needed
+    // for correct rounding.
+    uint64_t mantissa = 0;
+    unsigned mantissaDigits = 0;
+    int exp10 = 0;
+    bool digitsFound = false;
+    std::string moreDigits;
+
     // integral part
-    bool withFractional = false;
-    for( ; it != end; ++it)
+    for ( ; it != end; ++it)
     {
-        if( *it == fmt.point() || *it == fmt.e() || *it == fmt.E() )
+        unsigned digit = fmt.toDigit(*it);
+        if (digit >= 10)
+            break;
+
+        digitsFound = true;
+        if (mantissaDigits < 19)
         {
-            if( *it == fmt.point())
+            if (mantissa != 0 || digit != 0)
             {
-                withFractional = true;
-                ++it;
+                mantissa = mantissa * 10 + digit;
+                ++mantissaDigits;
             }
-            break;
         }
-        
-        unsigned digit = fmt.toDigit(*it); 
-        if(digit >= fmt.base)
-            return it;
-        
-        ok = true;
-        n *= 10;
-        n += digit; 
+        else
+        {
+            moreDigits += static_cast<char>('0' + digit);
+            ++exp10;
+        }
     }
-    
-    // it is ok, if fraction is missing
-    if(it == end)
+
+    // fractional part
+    if (it != end && *it == fmt.point())
     {
-        if( ! pos )
-            n *= -1;
+        for (++it; it != end; ++it)
+        {
+            unsigned digit = fmt.toDigit(*it);
+            if (digit >= 10)
+                break;
 
-        ok = true;
-        return it;
+            digitsFound = true;
+            if (mantissaDigits < 19)
+            {
+                if (mantissa != 0 || digit != 0)
+                {
+                    mantissa = mantissa * 10 + digit;
+                    ++mantissaDigits;
+                }
+                --exp10;
+            }
+            else
+            {
+                moreDigits += static_cast<char>('0' + digit);
+            }
+        }
     }
 
-    T base = 10.0;
-    if( withFractional)
+    if (!digitsFound)
+        return it;
+
+    // exponent [e|E][+|-][0-9]*; an 'e' at the end of the input is ignored
+    if (it != end && (*it == fmt.e() || *it == fmt.E()) && ++it != end)
     {
-        // fractional part, ignore 0 digits after dot
-        unsigned short fractDigits = 0;
-        size_t maxDigits = std::numeric_limits<unsigned short>::max() - std::numeric_limits<T>::digits10;
-        while(it != end && *it == zero)
+        bool expPos = true;
+        if (*it == fmt.minus())
+        {
+            expPos = false;
+            ++it;
+        }
+        else if (*it == fmt.plus())
         {
-            if( fractDigits > maxDigits )
-                return it;
-            
-            ++fractDigits;
             ++it;
         }
- 
-        // fractional part, parse like integer, skip insignificant digits
-        unsigned short significants = 0;
-        T fraction = 0.0;
-        for( ; it != end; ++it)
+
+        int exp = 0;
+        bool expDigits = false;
+        for ( ; it != end; ++it)
         {
-            unsigned digit = fmt.toDigit(*it); 
-            if(digit >= fmt.base)
+            unsigned digit = fmt.toDigit(*it);
+            if (digit >= 10)
                 break;
-            
-            if( significants <= std::numeric_limits<T>::digits10 )
-            {
-                fraction *= 10;
-                fraction += digit;
-                
-                ++fractDigits;
-                ++significants;
-            }
+
+            expDigits = true;
+            if (exp < 100000)
+                exp = exp * 10 + digit;
         }
-    
 
-        // fractional part, scale down
-        fraction /= std::pow(base, T(fractDigits));
-        n += fraction;
+        if (!expDigits)
+            return it;
+
+        exp10 += expPos ? exp : -exp;
     }
 
-    // exponent [e|E][+|-][0-9]*
-    if(it != end && (*it == fmt.e() || *it == fmt.E()) )
+    if (!decimalToFloat(mantissa, exp10, !moreDigits.empty(), n))
     {
-        if(++it == end)
-            return it;
-
-        long exp = 0;
-        it = getInt(it, end, ok, exp, fmt);
-        if( ! ok )
-            return it;
-            
-        n *= std::pow(base, T(exp));
+        std::string digits;
+        putInt(std::back_inserter(digits), mantissa);
+        digits += moreDigits;
+        decimalToFloat(digits, exp10 - static_cast<int>(moreDigits.size()), n);
     }
 
     if( ! pos )
-        n *= -1;
+        n = -n;
 
     ok = true;
     return it;
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_DATETIMEFORMAT_H
+#define CXXTOOLS_DATETIMEFORMAT_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+namespace cxxtools
+{
+
+class DateTime;
+
+/** @brief Format string for DateTime values, which is interpreted just once
+    @ingroup DateTime
+
+    DateTime::toString and the parsing constructor of DateTime interpret the
+    format string on each call. A DateTimeFormat translates it once into a
+    list of fields, which are then applied to any number of values. The
+    format codes are the same as in DateTime::toString for output and in
+    DateTime(const std::string&, const std::string&) for parsing.
+
+    Formatting into a buffer does not allocate memory:
+
+    @code
+      static const cxxtools::DateTimeFormat fmt("%Y-%m-%d %H:%M:%S");
+      char buffer[32];
+      std::size_t n = fmt.format(dt, buffer, sizeof(buffer));
+    @endcode
+ */
+class DateTimeFormat
+{
+    public:
+        DateTimeFormat()
+        { }
+
+        explicit DateTimeFormat(const std::string& pattern);
+
+        /// Returns the format string.
+        const std::string& pattern() const
+        { return _pattern; }
+
+        /** @brief Formats dt into a buffer.
+
+            At most size characters are written and no terminating zero is
+            added. Returns the length of the complete output, which is larger
+            than size, when the buffer is too small.
+         */
+        std::size_t format(const DateTime& dt, char* buffer, std::size_t size) const;
+
+        /// Appends the formatted dt to str.
+        void format(const DateTime& dt, std::string& str) const;
+
+        /// Returns the formatted dt.
+        std::string toString(const DateTime& dt) const;
+
+        /** @brief Parses a DateTime from str.
+
+            Throws InvalidDate, when str does not match the format.
+         */
+        DateTime parse(const std::string& str) const;
+
+        /// Parses a DateTime from str and returns false, if str does not match the format.
+        bool parse(const std::string& str, DateTime& dt) const;
+
+    private:
+        struct Field
+        {
+            unsigned char code;
+            unsigned offset;  // literal text in _literals
+            unsigned length;
+
+            Field(unsigned char code_, unsigned offset_ = 0, unsigned length_ = 0)
+                : code(code_),
+                  offset(offset_),
+                  length(length_)
+                { }
+        };
+
+        void compileOutput();
+        void compileInput();
+        void addLiteral(std::vector<Field>& fields, const char* s, unsigned length);
+
+        // returns the position in str, where parsing failed
+        std::string::size_type doParse(const std::string& str, DateTime& dt) const;
+
+        std::string _pattern;
+        std::string _literals;
+        std::vector<Field> _output;
+        std::vector<Field> _input;
+};
+
+}
+
+#endif // CXXTOOLS_DATETIMEFORMAT_H
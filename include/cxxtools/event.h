@@ -30,6 +30,8 @@
 #define cxxtools_EVENT_H
 
 #include <typeinfo>
+#include <cstddef>
+#include <new>
 
 namespace cxxtools
 {
@@ -40,6 +42,10 @@ namespace cxxtools
         and typeInfo() methods. The first is used to deep copy event objects
         for example in an EventLoop and the latter one is used to dispatch
         events by type.
+
+        Event queues may copy small events into preallocated storage using
+        cloneTo() instead. A copy created by cloneTo() is released by calling
+        its destructor only.
      */
     class Event
     {
@@ -53,6 +59,15 @@ namespace cxxtools
 
             virtual void destroy() = 0;
 
+            /** \brief Copies the event into the passed buffer.
+
+                Returns the copy or 0 when the event does not fit into the
+                buffer. The buffer is aligned for any fundamental type. The
+                default implementation returns 0.
+             */
+            virtual Event* cloneTo(void* /*buffer*/, std::size_t /*size*/) const
+            { return 0; }
+
             virtual const std::type_info& typeInfo() const = 0;
     };
 
@@ -82,6 +97,13 @@ namespace cxxtools
             {
                 delete this;
             }
+
+            virtual Event* cloneTo(void* buffer, std::size_t size) const
+            {
+                if (sizeof(T) > size || alignof(T) > alignof(std::max_align_t))
+                    return 0;
+                return new (buffer) T(*static_cast<const T*>(this));
+            }
     };
 
 } // namespace cxxtools
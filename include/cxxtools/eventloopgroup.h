@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_EVENTLOOPGROUP_H
+#define CXXTOOLS_EVENTLOOPGROUP_H
+
+#include <cxxtools/eventloop.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace cxxtools
+{
+
+/** @brief A set of event loops, each running in its own thread.
+
+    The group is used to distribute selectables over multiple threads, so
+    that waiting for activity scales with the number of cores.
+
+    Signals of the loops must be connected between resize and start, since
+    they can't be changed safely while the loops are running.
+
+    @code
+    cxxtools::EventLoopGroup group(4);
+    for (unsigned n = 0; n < group.size(); ++n)
+        group.loop(n).event.subscribe(cxxtools::slot(onEvent));
+    group.start();
+    ...
+    group.next().commitEvent(MyEvent());
+    ...
+    group.stop();
+    @endcode
+ */
+class EventLoopGroup
+{
+        EventLoopGroup(const EventLoopGroup&) = delete;
+        EventLoopGroup& operator=(const EventLoopGroup&) = delete;
+
+    public:
+        /// Creates a group with the specified number of event loops.
+        explicit EventLoopGroup(unsigned size = 0);
+
+        /// Stops the loops and destroys them.
+        ~EventLoopGroup();
+
+        /// Sets the number of event loops. The group must not be running.
+        void resize(unsigned size);
+
+        /// Starts a thread for each event loop.
+        void start();
+
+        /// Exits the event loops and waits for the threads to finish.
+        void stop();
+
+        bool running() const
+        { return !_threads.empty(); }
+
+        unsigned size() const
+        { return _loops.size(); }
+
+        EventLoop& loop(unsigned n)
+        { return *_loops[n]; }
+
+        /// Returns the index of the next loop in round robin order. This is thread safe.
+        unsigned nextIndex()
+        { return _next++ % _loops.size(); }
+
+        /// Returns the next loop in round robin order. This is thread safe.
+        EventLoop& next()
+        { return *_loops[nextIndex()]; }
+
+    private:
+        std::vector<EventLoop*> _loops;
+        std::vector<std::thread> _threads;
+        std::atomic<unsigned> _next;
+};
+
+}
+
+#endif // CXXTOOLS_EVENTLOOPGROUP_H
@@ -0,0 +1,374 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_HASHCACHE_H
+#define CXXTOOLS_HASHCACHE_H
+
+#include <unordered_map>
+#include <functional>
+#include <utility>
+
+namespace cxxtools
+{
+  /**
+     Implements a cache with a hash table.
+
+     It has the same interface and caching algorithm as cxxtools::Cache but
+     all operations take constant time. The elements are kept in a hash
+     table and linked in two lists, the winners, which were found at least
+     once, and the loosers. Both lists are ordered by last access, so that
+     the oldest element is found without searching.
+
+     Like in cxxtools::Cache new elements are put into the list of loosers
+     when the cache is full and elements, which are found, move to the top
+     of the winners. The oldest winner is then moved to the loosers. When a
+     new element is put into a full cache, the oldest looser is dropped.
+     This way elements, which are just used once, do not push out
+     frequently used elements.
+
+     The key type needs a hash function and a equal operator instead of a
+     less than operator.
+
+     The cache is not thread safe. See cxxtools::ShardedCache for a cache,
+     which can be used from multiple threads.
+   */
+  template <typename Key, typename Value, typename Hash = std::hash<Key>, typename Equal = std::equal_to<Key> >
+  class HashCache
+  {
+      struct Data
+      {
+        Value value;
+        const Key* key;
+        Data* newer;
+        Data* older;
+        bool winner;
+
+        explicit Data(const Value& value_)
+          : value(value_),
+            key(0),
+            newer(0),
+            older(0),
+            winner(false)
+            { }
+      };
+
+      typedef std::unordered_map<Key, Data, Hash, Equal> DataType;
+
+      struct List
+      {
+        Data* newest;
+        Data* oldest;
+        typename DataType::size_type size;
+
+        List()
+          : newest(0),
+            oldest(0),
+            size(0)
+            { }
+
+        void unlink(Data* d)
+        {
+          if (d->newer)
+            d->newer->older = d->older;
+          else
+            newest = d->older;
+
+          if (d->older)
+            d->older->newer = d->newer;
+          else
+            oldest = d->newer;
+
+          --size;
+        }
+
+        void pushNewest(Data* d)
+        {
+          d->newer = 0;
+          d->older = newest;
+          if (newest)
+            newest->newer = d;
+          else
+            oldest = d;
+          newest = d;
+          ++size;
+        }
+
+        void pushOldest(Data* d)
+        {
+          d->older = 0;
+          d->newer = oldest;
+          if (oldest)
+            oldest->older = d;
+          else
+            newest = d;
+          oldest = d;
+          ++size;
+        }
+      };
+
+      DataType data;
+      List winnerList;
+      List looserList;
+
+      typename DataType::size_type maxElements;
+      unsigned hits;
+      unsigned misses;
+
+      List& _list(Data* d)
+      {
+        return d->winner ? winnerList : looserList;
+      }
+
+      // drop one element; a cache with a maximum size of 0 may be empty here
+      void _dropLooser()
+      {
+        Data* d = looserList.oldest ? looserList.oldest : winnerList.oldest;
+        if (d == 0)
+          return;
+
+        _list(d).unlink(d);
+        data.erase(data.find(*d->key));
+      }
+
+      void _makeLooser()
+      {
+        // move the oldest winner to the top of the loosers
+        Data* d = winnerList.oldest;
+        if (d)
+        {
+          winnerList.unlink(d);
+          d->winner = false;
+          looserList.pushNewest(d);
+        }
+      }
+
+      void _makeWinner()
+      {
+        // move the newest looser to the winners
+        Data* d = looserList.newest;
+        if (d)
+        {
+          looserList.unlink(d);
+          d->winner = true;
+          winnerList.pushOldest(d);
+        }
+      }
+
+      // moves a found element to the top of the winners; the oldest winner
+      // is just moved to the loosers, when there are too many winners
+      void _hit(Data* d)
+      {
+        _list(d).unlink(d);
+        winnerList.pushNewest(d);
+        if (!d->winner)
+        {
+          d->winner = true;
+          if (winnerList.size > maxElements / 2)
+            _makeLooser();
+        }
+      }
+
+      Data* _insert(const Key& key, const Value& value, bool winner)
+      {
+        typename DataType::iterator it = data.insert(typename DataType::value_type(key, Data(value))).first;
+        Data* d = &it->second;
+        d->key = &it->first;
+        d->winner = winner;
+        _list(d).pushNewest(d);
+        return d;
+      }
+
+    public:
+      typedef typename DataType::size_type size_type;
+      typedef Key key_type;
+      typedef Value value_type;
+
+      explicit HashCache(size_type maxElements_)
+        : maxElements(maxElements_ + (maxElements_ & 1)),
+          hits(0),
+          misses(0)
+        { }
+
+      HashCache(const HashCache&) = delete;
+      HashCache& operator=(const HashCache&) = delete;
+
+      /// returns the number of elements currently in the cache
+      size_type size() const        { return data.size(); }
+
+      /// returns the maximum number of elements in the cache
+      size_type getMaxElements() const      { return maxElements; }
+
+      void setMaxElements(size_type maxElements_)
+      {
+        maxElements_ += (maxElements_ & 1);
+
+        if (maxElements_ > maxElements)
+        {
+          while (winnerList.size < maxElements_ / 2 && looserList.size > 0)
+            _makeWinner();
+        }
+        else
+        {
+          while (size() > maxElements_)
+            _dropLooser();
+
+          while (winnerList.size > maxElements_ / 2)
+            _makeLooser();
+        }
+
+        maxElements = maxElements_;
+      }
+
+      /// removes a element from the cache and returns true, if found
+      bool erase(const Key& key)
+      {
+        typename DataType::iterator it = data.find(key);
+        if (it == data.end())
+          return false;
+
+        Data* d = &it->second;
+        _list(d).unlink(d);
+        if (d->winner)
+          _makeWinner();
+
+        data.erase(it);
+        return true;
+      }
+
+      /// clears the cache.
+      void clear(bool stats = false)
+      {
+        data.clear();
+        winnerList = List();
+        looserList = List();
+        if (stats)
+          hits = misses = 0;
+      }
+
+      /// puts a new element in the cache. If the element is already found in
+      /// the cache, it is considered a cache hit and pushed to the top of the
+      /// list.
+      Value& put(const Key& key, const Value& value)
+      {
+        typename DataType::iterator it = data.find(key);
+        if (it == data.end())
+        {
+          if (data.size() < maxElements)
+            return _insert(key, value, data.size() < maxElements / 2)->value;
+
+          // element not found
+          _dropLooser();
+          return _insert(key, value, false)->value;
+        }
+
+        // element found
+        Data* d = &it->second;
+        _hit(d);
+        d->value = value;
+        return d->value;
+      }
+
+      /// puts a new element on the top of the cache. If the element is already
+      /// found in the cache, it is considered a cache hit and pushed to the
+      /// top of the list. This method actually overrides the need, that a element
+      /// needs a hit to get to the top of the cache.
+      void put_top(const Key& key, const Value& value)
+      {
+        typename DataType::iterator it = data.find(key);
+        if (it != data.end())
+        {
+          // element found
+          _hit(&it->second);
+        }
+        else if (data.size() < maxElements)
+        {
+          if (data.size() >= maxElements / 2)
+            _makeLooser();
+
+          _insert(key, value, true);
+        }
+        else
+        {
+          // element not found
+          _dropLooser();
+          _makeLooser();
+          _insert(key, value, true);
+        }
+      }
+
+      Value* getptr(const Key& key)
+      {
+        typename DataType::iterator it = data.find(key);
+        if (it == data.end())
+        {
+          ++misses;
+          return 0;
+        }
+
+        _hit(&it->second);
+
+        ++hits;
+        return &it->second.value;
+      }
+
+      /// returns a pair of values - a flag, if the value was found and the
+      /// value if found or the passed default otherwise. If the value is
+      /// found it is a cache hit and pushed to the top of the list.
+      std::pair<bool, Value> getx(const Key& key, Value def = Value())
+      {
+        Value* v = getptr(key);
+        return v ? std::pair<bool, Value>(true, *v)
+                 : std::pair<bool, Value>(false, def);
+      }
+
+      /// returns the value to a key or the passed default value if not found.
+      /// If the value is found it is a cache hit and pushed to the top of the
+      /// list.
+      Value get(const Key& key, Value def = Value())
+      {
+        return getx(key, def).second;
+      }
+
+      /// returns the number of hits.
+      unsigned getHits() const    { return hits; }
+      /// returns the number of misses.
+      unsigned getMisses() const  { return misses; }
+      /// returns the cache hit ratio between 0 and 1.
+      double hitRatio() const     { return hits+misses > 0 ? static_cast<double>(hits)/static_cast<double>(hits+misses) : 0; }
+      /// returns the ratio, between held elements and maximum elements.
+      double fillfactor() const   { return static_cast<double>(data.size()) / static_cast<double>(maxElements); }
+
+      unsigned winners() const    { return winnerList.size; }
+
+      unsigned loosers() const    { return looserList.size; }
+
+  };
+
+}
+
+#endif // CXXTOOLS_HASHCACHE_H
@@ -0,0 +1,241 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_HASHLRUCACHE_H
+#define CXXTOOLS_HASHLRUCACHE_H
+
+#include <unordered_map>
+#include <functional>
+#include <utility>
+
+namespace cxxtools
+{
+  /**
+     Implements a lru cache with a hash table.
+
+     It has the same interface as cxxtools::LruCache but all operations take
+     constant time. The elements are kept in a hash table and linked in a
+     list ordered by last access, so that the least recently used element is
+     found without searching.
+
+     The key type needs a hash function and a equal operator instead of a
+     less than operator.
+
+     The cache is not thread safe. See cxxtools::ShardedCache for a cache,
+     which can be used from multiple threads.
+   */
+  template <typename Key, typename Value, typename Hash = std::hash<Key>, typename Equal = std::equal_to<Key> >
+  class HashLruCache
+  {
+      struct Data
+      {
+        Value value;
+        const Key* key;
+        Data* newer;
+        Data* older;
+
+        explicit Data(const Value& value_)
+          : value(value_),
+            key(0),
+            newer(0),
+            older(0)
+            { }
+      };
+
+      typedef std::unordered_map<Key, Data, Hash, Equal> DataType;
+      DataType data;
+
+      Data* newest;
+      Data* oldest;
+
+      typename DataType::size_type maxElements;
+      unsigned hits;
+      unsigned misses;
+
+      void _unlink(Data* d)
+      {
+        if (d->newer)
+          d->newer->older = d->older;
+        else
+          newest = d->older;
+
+        if (d->older)
+          d->older->newer = d->newer;
+        else
+          oldest = d->newer;
+      }
+
+      void _pushNewest(Data* d)
+      {
+        d->newer = 0;
+        d->older = newest;
+        if (newest)
+          newest->newer = d;
+        else
+          oldest = d;
+        newest = d;
+      }
+
+      void _touch(Data* d)
+      {
+        if (d != newest)
+        {
+          _unlink(d);
+          _pushNewest(d);
+        }
+      }
+
+      void _dropOldest()
+      {
+        Data* d = oldest;
+        _unlink(d);
+        data.erase(data.find(*d->key));
+      }
+
+    public:
+      typedef typename DataType::size_type size_type;
+      typedef Key key_type;
+      typedef Value value_type;
+
+      explicit HashLruCache(size_type maxElements_)
+        : newest(0),
+          oldest(0),
+          maxElements(maxElements_),
+          hits(0),
+          misses(0)
+        { }
+
+      HashLruCache(const HashLruCache&) = delete;
+      HashLruCache& operator=(const HashLruCache&) = delete;
+
+      /// returns the number of elements currently in the cache
+      size_type size() const        { return data.size(); }
+
+      /// returns the maximum number of elements in the cache
+      size_type getMaxElements() const      { return maxElements; }
+
+      void setMaxElements(size_type maxElements_)
+      {
+        maxElements = maxElements_;
+        while (data.size() > maxElements)
+          _dropOldest();
+      }
+
+      /// removes a element from the cache and returns true, if found
+      bool erase(const Key& key)
+      {
+        typename DataType::iterator it = data.find(key);
+        if (it == data.end())
+          return false;
+
+        _unlink(&it->second);
+        data.erase(it);
+        return true;
+      }
+
+      /// clears the cache.
+      void clear(bool stats = false)
+      {
+        data.clear();
+        newest = oldest = 0;
+        if (stats)
+          hits = misses = 0;
+      }
+
+      /// puts a new element in the cache. If the element is already found in
+      /// the cache, it is considered a cache hit, the value is replaced and
+      /// it is pushed to the top of the list.
+      Value& put(const Key& key, const Value& value)
+      {
+        typename DataType::iterator it = data.find(key);
+        if (it == data.end())
+        {
+          if (data.size() >= maxElements && oldest)
+            _dropOldest();
+
+          it = data.insert(typename DataType::value_type(key, Data(value))).first;
+          it->second.key = &it->first;
+          _pushNewest(&it->second);
+        }
+        else
+        {
+          // element found
+          it->second.value = value;
+          _touch(&it->second);
+        }
+
+        return it->second.value;
+      }
+
+      Value* getptr(const Key& key)
+      {
+        typename DataType::iterator it = data.find(key);
+        if (it == data.end())
+        {
+          ++misses;
+          return 0;
+        }
+
+        _touch(&it->second);
+
+        ++hits;
+        return &it->second.value;
+      }
+
+      /// returns a pair of values - a flag, if the value was found and the
+      /// value if found or the passed default otherwise. If the value is
+      /// found it is a cache hit and pushed to the top of the list.
+      std::pair<bool, Value> getx(const Key& key, Value def = Value())
+      {
+        Value* v = getptr(key);
+        return v ? std::pair<bool, Value>(true, *v)
+                 : std::pair<bool, Value>(false, def);
+      }
+
+      /// returns the value to a key or the passed default value if not found.
+      /// If the value is found it is a cache hit and pushed to the top of the
+      /// list.
+      Value get(const Key& key, Value def = Value())
+      {
+        return getx(key, def).second;
+      }
+
+      /// returns the number of hits.
+      unsigned getHits() const    { return hits; }
+      /// returns the number of misses.
+      unsigned getMisses() const  { return misses; }
+      /// returns the cache hit ratio between 0 and 1.
+      double hitRatio() const     { return hits+misses > 0 ? static_cast<double>(hits)/static_cast<double>(hits+misses) : 0; }
+      /// returns the ratio, between held elements and maximum elements.
+      double fillfactor() const   { return static_cast<double>(data.size()) / static_cast<double>(maxElements); }
+
+  };
+
+}
+
+#endif // CXXTOOLS_HASHLRUCACHE_H
@@ -182,6 +182,9 @@ class Client
          */
         void close();
 
+        /// Returns true, when the network connection is established.
+        bool isConnected() const;
+
         ///@{ `connect` Sets the network parameters and connects the socket.
         void connect(const net::AddrInfo& addrinfo)
             { prepareConnect(addrinfo); connect(); }
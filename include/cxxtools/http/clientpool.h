@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef cxxtools_Http_ClientPool_h
+#define cxxtools_Http_ClientPool_h
+
+#include <cxxtools/http/client.h>
+#include <cxxtools/timespan.h>
+#include <string>
+#include <utility>
+
+namespace cxxtools
+{
+
+class SslCtx;
+
+namespace net
+{
+class Uri;
+}
+
+namespace http
+{
+
+class ClientPoolImpl;
+
+/**
+ Thread safe pool of keep-alive http connections.
+
+ Connections are kept per scheme, host and port. A connection is leased
+ for a request and returned to the pool afterwards, so that the next
+ request to the same server reuses it without a new tcp connect and ssl
+ handshake. The number of connections to one server is limited; when all
+ are leased, lease waits until one is returned.
+
+ Example:
+
+ \code
+   cxxtools::http::ClientPool pool;
+
+   // in any thread:
+   cxxtools::http::ClientPool::Lease client = pool.lease("http://backend:8000/");
+   std::string body = client->get("/status").body();
+   // the connection returns to the pool when the lease goes out of scope
+ \endcode
+
+ The clients of the pool are used syncronously. A lease must be released
+ before the pool is destroyed.
+ */
+class ClientPool
+{
+        ClientPoolImpl* _impl;
+
+        ClientPool(const ClientPool&) = delete;
+        ClientPool& operator=(const ClientPool&) = delete;
+
+    public:
+        /// A connection leased from the pool.
+        class Lease
+        {
+                friend class ClientPool;
+
+                ClientPoolImpl* _pool;
+                Client* _client;
+                std::string _key;
+
+                Lease(ClientPoolImpl* pool, Client* client, const std::string& key)
+                    : _pool(pool),
+                      _client(client),
+                      _key(key)
+                    { }
+
+                Lease(const Lease&) = delete;
+                Lease& operator=(const Lease&) = delete;
+
+            public:
+                Lease()
+                    : _pool(0),
+                      _client(0)
+                    { }
+
+                Lease(Lease&& other)
+                    : _pool(other._pool),
+                      _client(other._client),
+                      _key(std::move(other._key))
+                    { other._client = 0; }
+
+                Lease& operator=(Lease&& other);
+
+                ~Lease()
+                    { release(); }
+
+                Client& client()            { return *_client; }
+                Client& operator*()         { return *_client; }
+                Client* operator->()        { return _client; }
+
+                explicit operator bool() const
+                    { return _client != 0; }
+
+                /// Returns the connection to the pool. Closed connections are dropped.
+                void release();
+
+                /// Closes the connection and frees its slot, e.g. after an error
+                /// left the connection in an unknown state.
+                void discard();
+        };
+
+        /// Creates a pool. Https connections use a default ssl context.
+        ClientPool();
+
+        /// Creates a pool, which uses the ssl context for https connections.
+        explicit ClientPool(const SslCtx& sslCtx);
+
+        ~ClientPool();
+
+        /**
+         Leases a connection to the server of the uri.
+
+         The protocol must be http or https; the url part is ignored. User and
+         password of the uri are used for basic authorization. When the
+         maximum number of connections to the server are leased, the method
+         waits at most timeout milliseconds for a returned connection and
+         throws IOTimeout otherwise.
+         */
+        Lease lease(const net::Uri& uri, Milliseconds timeout = Selectable::WaitInfinite);
+
+        /// Leases a plain http connection to host and port.
+        Lease lease(const std::string& host, unsigned short port, Milliseconds timeout = Selectable::WaitInfinite);
+
+        /// Sets the maximum number of connections (leased and idle) per server; default 8.
+        void maxPerHost(unsigned n);
+        unsigned maxPerHost() const;
+
+        /// Sets the time, after which idle connections are closed; default 60 seconds.
+        void maxIdleTime(Milliseconds t);
+        Milliseconds maxIdleTime() const;
+
+        /// Closes connections, which are idle longer than maxIdleTime and
+        /// returns the number of closed connections. This is done
+        /// automatically when connections are leased or returned.
+        unsigned evictIdle();
+
+        /// Closes all idle connections.
+        void clear();
+
+        /// Returns the number of leases served by a pooled connection.
+        unsigned long hits() const;
+
+        /// Returns the number of leases, which needed a new connection.
+        unsigned long misses() const;
+
+        /// Returns the number of idle connections in the pool.
+        unsigned idle() const;
+
+        /// Returns the number of leased connections.
+        unsigned leased() const;
+};
+
+} // namespace http
+
+} // namespace cxxtools
+
+#endif
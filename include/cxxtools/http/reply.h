@@ -32,6 +32,8 @@
 #include <cxxtools/http/replyheader.h>
 #include <string>
 #include <sstream>
+#include <memory>
+#include <sys/types.h>
 
 namespace cxxtools {
 
@@ -39,10 +41,73 @@ namespace http {
 
 class Request;
 
+/**
+ Source of a reply body, which is streamed to the client after the header.
+
+ The server fetches the data in small pieces when the client is ready to
+ receive it, so that the body does not need to be held in memory.
+ */
+class BodySource
+{
+    public:
+        virtual ~BodySource() { }
+
+        /// Returns the size of the body or -1 when it is not known in advance.
+        /// A body of unknown size is sent with chunked transfer encoding.
+        virtual long long size() const
+            { return -1; }
+
+        /// Reads at most n bytes into buffer. Returns 0 at the end of the body.
+        virtual std::size_t read(char* buffer, std::size_t n) = 0;
+
+        /**
+         Transfers at most n bytes directly to the socket descriptor fd.
+
+         Returns the number of bytes transferred, 0 at the end of the body or
+         -1 with errno set. EAGAIN signals, that the socket is not ready. The
+         default implementation fails with ENOSYS, so that the data is
+         copied using read.
+         */
+        virtual ssize_t sendTo(int fd, std::size_t n);
+};
+
+/**
+ Streams a range of a file as reply body.
+
+ On plain tcp connections the data is transferred with sendfile without
+ copying it through user space.
+ */
+class FileBodySource : public BodySource
+{
+        int _fd;
+        off_t _offset;
+        std::size_t _size;
+        std::size_t _remaining;
+        bool _closeFd;
+
+    public:
+        /// Streams the whole file.
+        explicit FileBodySource(const std::string& path);
+
+        /// Streams count bytes from offset of the open file descriptor fd.
+        /// The descriptor is closed in the destructor when closeFd is set.
+        FileBodySource(int fd, off_t offset, std::size_t count, bool closeFd = false);
+
+        ~FileBodySource();
+
+        long long size() const
+            { return _size; }
+
+        std::size_t read(char* buffer, std::size_t n);
+
+        ssize_t sendTo(int fd, std::size_t n);
+};
+
 class Reply
 {
         ReplyHeader _header;
         std::stringstream _body;
+        std::unique_ptr<BodySource> _bodySource;
 
     public:
         Reply()
@@ -84,6 +149,7 @@ class Reply
             _header.clear();
             _body.clear();
             _body.str(std::string());
+            _bodySource.reset();
         }
 
         unsigned httpReturnCode() const
@@ -107,6 +173,22 @@ class Reply
         void sendBody(std::ostream& out) const
         { out << _body.str(); }
 
+        /// Streams the body from source instead of the body stream.
+        /// The reply takes ownership of the source.
+        void bodySource(BodySource* source)
+        { _bodySource.reset(source); }
+
+        BodySource* bodySource() const
+        { return _bodySource.get(); }
+
+        /// Streams the file as body.
+        void bodyFile(const std::string& path)
+        { bodySource(new FileBodySource(path)); }
+
+        /// Streams count bytes from offset of the file descriptor fd as body.
+        void bodyFile(int fd, off_t offset, std::size_t count, bool closeFd = false)
+        { bodySource(new FileBodySource(fd, offset, count, closeFd)); }
+
         operator std::string() const
         { return _body.str(); }
 
@@ -32,6 +32,7 @@
 #include <cxxtools/http/service.h>
 #include <iosfwd>
 #include <exception>
+#include <functional>
 
 namespace cxxtools
 {
@@ -58,6 +59,16 @@ class Responder
 
         virtual void beginRequest(net::TcpSocket& socket, std::istream& in, Request& request);
         virtual std::size_t readBody(std::istream&);
+
+        /**
+         Called after the request body is read.
+
+         A responder, which produces the reply asynchronously, starts its work
+         here and returns true. The server then releases the worker thread
+         and calls reply, when ready is called, possibly from another thread.
+         The default returns false, so that reply is called immediately.
+         */
+        virtual bool prepareReply(Request& request, const std::function<void()>& ready);
         virtual void reply(std::ostream&, Request& request, Reply& reply) = 0;
         virtual void replyError(std::ostream&, Request& request, Reply& reply, const std::exception& ex);
 
@@ -108,6 +108,38 @@ class Server
         unsigned maxThreads() const;
         void maxThreads(unsigned m);
 
+        /** Sets the number of event loop threads watching idle connections.
+         *
+         *  Keep alive connections are distributed round robin over the
+         *  loops. With 0 (the default) the event loop passed to the
+         *  constructor is used. Must be set before the server is started.
+         */
+        unsigned eventLoops() const;
+        void eventLoops(unsigned n);
+
+        /** Processes connections completely in the event loops.
+         *
+         *  By default a worker thread reads the request and writes the reply
+         *  and passes the connection to an event loop only, when it gets
+         *  idle. In event driven mode the event loops parse the requests and
+         *  send the replies and the worker threads just run the responders,
+         *  so that slow clients do not occupy threads. Must be set before
+         *  the server is started.
+         */
+        bool eventDriven() const;
+        void eventDriven(bool sw);
+
+        /** Sets the number of pipelined requests processed ahead.
+         *
+         *  When a client sends requests without waiting for the replies,
+         *  the requests already received are processed, before the replies
+         *  are sent, so that they are sent with one write. This limits the
+         *  number of replies held back on one connection. With 0 or 1 each
+         *  reply is sent before the next request is read. The default is 16.
+         */
+        unsigned pipelineDepth() const;
+        void pipelineDepth(unsigned n);
+
         enum Runmode {
           Stopped,
           Starting,
@@ -35,6 +35,7 @@
 #include <cxxtools/selectable.h>
 #include <limits>
 #include <ios>
+#include <sys/uio.h>
 
 namespace cxxtools {
 
@@ -148,6 +149,22 @@ class IODevice : public Selectable
          */
         size_t write(const char* buffer, size_t n);
 
+        /** @brief Starts writing a list of buffers
+
+            Like beginWrite, but the data is taken from count buffers in
+            the order given. The buffers and the iovec array must be kept
+            until endWrite is called. Devices, which support it, send the
+            buffers with a single system call.
+         */
+        size_t beginWrite(const struct iovec* vec, size_t count);
+
+        //! @brief Writes a list of buffers to the I/O device
+        /**
+            Like write, but the data is taken from count buffers in the
+            order given. Returns the number of bytes written in total.
+         */
+        size_t write(const struct iovec* vec, size_t count);
+
         /** @brief Cancels asynchronous reading and writing
         */
         void cancel();
@@ -259,6 +276,13 @@ class IODevice : public Selectable
         size_t wavail() const
         { return _wavail; }
 
+        //! @brief Returns the buffers of a pending write started with a list of buffers
+        const struct iovec* wvec() const
+        { return _wvec; }
+
+        size_t wveccount() const
+        { return _wveccount; }
+
     protected:
         //! @brief Default Constructor
         IODevice();
@@ -277,6 +301,11 @@ class IODevice : public Selectable
         //! @brief Write bytes to device
         virtual size_t onWrite(const char* buffer, size_t count);
 
+        virtual size_t onBeginWritev(const struct iovec* vec, size_t count);
+
+        //! @brief Write a list of buffers to device
+        virtual size_t onWritev(const struct iovec* vec, size_t count);
+
         virtual void onClose();
 
         virtual void onCancel();
@@ -321,6 +350,8 @@ class IODevice : public Selectable
         const char* _wbuf;
         size_t _wbuflen;
         size_t _wavail;
+        const struct iovec* _wvec;
+        size_t _wveccount;
 };
 
 } // namespace cxxtools
@@ -264,6 +264,14 @@ class OStream : public BasicOStream<char>, public Connectable
         std::streamsize out_avail()
         { return buffer().out_avail(); }
 
+        //! @brief Appends a block of data to the output without copying it (see StreamBuffer::putSlice).
+        void putSlice(std::string&& data)
+        { buffer().putSlice(std::move(data)); }
+
+        //! @brief Appends a block of data, which must stay valid until it is written.
+        void putSlice(const char* data, size_t n)
+        { buffer().putSlice(data, n); }
+
         IODevice* attachDevice(IODevice& device);
 
         IODevice* detachDevice();
@@ -315,6 +323,14 @@ class IOStream : public BasicIOStream<char>, public Connectable
         std::streamsize out_avail()
         { return buffer().out_avail(); }
 
+        //! @brief Appends a block of data to the output without copying it (see StreamBuffer::putSlice).
+        void putSlice(std::string&& data)
+        { buffer().putSlice(std::move(data)); }
+
+        //! @brief Appends a block of data, which must stay valid until it is written.
+        void putSlice(const char* data, size_t n)
+        { buffer().putSlice(data, n); }
+
         IODevice* attachDevice(IODevice& device);
 
         IODevice* detachDevice();
@@ -98,6 +98,15 @@ class RpcServer : public ServiceRegistry
         unsigned maxThreads() const;
         void maxThreads(unsigned m);
 
+        /** Sets the number of event loop threads watching idle connections.
+         *
+         *  Idle connections are distributed round robin over the loops.
+         *  With 0 (the default) the event loop passed to the constructor
+         *  is used. Must be set before the server is started.
+         */
+        unsigned eventLoops() const;
+        void eventLoops(unsigned n);
+
         enum Runmode {
           Stopped,
           Starting,
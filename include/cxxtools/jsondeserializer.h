@@ -115,6 +115,9 @@ namespace cxxtools
             int advance(Char ch) // 1: end character detected; -1: end but char not consumed; 0: no end
             { return _parser.advance(ch); }
 
+            int advance(char ch) // utf-8 encoded input
+            { return _parser.advance(ch); }
+
             void finish()
             { return _parser.finish(); }
 
@@ -68,6 +68,9 @@ namespace cxxtools
             {
                     JsonParser* _jsonParser;
                     String _str;
+                    std::string _str8;  // utf-8 encoded string in byte mode
+                    bool _utf8;
+                    bool _ascii;
                     unsigned _count;
                     unsigned short _value;
                     unsigned short _surrogateValue;
@@ -88,13 +91,36 @@ namespace cxxtools
                 public:
                     explicit JsonStringParser(JsonParser* jsonParser)
                         : _jsonParser(jsonParser),
+                          _utf8(false),
+                          _ascii(true),
                           _state(state_0)
                         { }
 
                     bool advance(Char ch);
 
+                    // Processes one byte of a utf-8 encoded string. Plain
+                    // characters are appended without decoding.
+                    bool advance(char ch)
+                    {
+                        if (_state == state_0 && ch != '\\' && ch != '"')
+                        {
+                            if (static_cast<unsigned char>(ch) >= 0x80)
+                                _ascii = false;
+                            _str8 += ch;
+                            return false;
+                        }
+
+                        return advance(Char(static_cast<unsigned char>(ch)));
+                    }
+
                     void clear()
-                    { _state = state_0; _str.clear(); }
+                    { _state = state_0; _str.clear(); _str8.clear(); _ascii = true; }
+
+                    void utf8(bool sw)
+                    { _utf8 = sw; }
+
+                    bool ascii() const
+                    { return _ascii; }
 
                     const String& str() const
                     { return _str; }
@@ -104,6 +130,12 @@ namespace cxxtools
 
                     void str(String&& s)
                     { _str = std::move(s); }
+
+                    std::string& str8()
+                    { return _str8; }
+
+                private:
+                    void put(Char ch);
             };
 
             JsonParser(const JsonParser&) = delete;
@@ -120,7 +152,23 @@ namespace cxxtools
                 _deserializer = &handler;
             }
 
-            int advance(Char ch); // 1: end character detected; -1: end but char not consumed; 0: no end
+            int advance(Char ch) // 1: end character detected; -1: end but char not consumed; 0: no end
+            {
+                _utf8 = false;
+                _stringParser.utf8(false);
+                return doAdvance(ch);
+            }
+
+            // Processes one byte of utf-8 encoded json. Strings are collected
+            // as utf-8 and stored as std::string when they are pure ascii, so
+            // no per character decoding is needed.
+            int advance(char ch)
+            {
+                _utf8 = true;
+                _stringParser.utf8(true);
+                return doAdvance(Char(static_cast<unsigned char>(ch)));
+            }
+
             void finish();
 
         private:
@@ -151,13 +199,23 @@ namespace cxxtools
                 state_end
             } _state, _nextState;
 
-            String _token;
+            std::string _token;
+            bool _utf8;
 
             JsonDeserializer* _deserializer;
             JsonStringParser _stringParser;
             JsonParser* _next;
             unsigned _lineNo;
 
+            int doAdvance(Char ch);
+            int advanceNext(Char ch)
+            { return _utf8 ? _next->advance(static_cast<char>(ch.value())) : _next->advance(ch); }
+            bool advanceString(Char ch)
+            { return _utf8 ? _stringParser.advance(static_cast<char>(ch.value())) : _stringParser.advance(ch); }
+            void setPlainName();
+            void beginMember();
+            void setStringValue();
+
             void doThrow(const std::string& msg);
             void throwInvalidCharacter(Char ch);
     };
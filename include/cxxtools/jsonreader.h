@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_JSONREADER_H
+#define CXXTOOLS_JSONREADER_H
+
+#include <cxxtools/deserializer.h>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace cxxtools
+{
+    /**
+     * Pull parser for json.
+     *
+     * Unlike JsonDeserializer the reader does not build a SerializationInfo
+     * for the whole document. The application fetches one token after
+     * another and decides, whether to read a value, deserialize a complete
+     * subtree into a object or skip it. Only the subtree passed to get() is
+     * kept in memory, so large arrays of records can be processed with
+     * constant memory.
+     *
+     * The input is expected to be UTF-8 encoded. After the end of a
+     * document the reader continues with the next one, so streams of
+     * concatenated json documents (e.g. one per line) can be read.
+     *
+     * @code
+     *   cxxtools::JsonReader reader(std::cin);
+     *
+     *   if (reader.next() != cxxtools::JsonReader::BeginArray)
+     *     throw std::runtime_error("array expected");
+     *
+     *   while (reader.next() != cxxtools::JsonReader::EndArray)
+     *   {
+     *     Record record;
+     *     reader.get(record);  // deserializes one array element
+     *     process(record);
+     *   }
+     * @endcode
+     *
+     * Members of objects are visited in the same way. The member name of
+     * the current value is returned by name():
+     *
+     * @code
+     *   while (reader.next() != cxxtools::JsonReader::EndObject)
+     *   {
+     *     if (reader.name() == "id")
+     *       reader.get(id);
+     *     else
+     *       reader.skip();
+     *   }
+     * @endcode
+     */
+    class JsonReader
+    {
+            JsonReader(const JsonReader&) = delete;
+            JsonReader& operator=(const JsonReader&) = delete;
+
+        public:
+            enum Token
+            {
+                None,
+                BeginObject,
+                EndObject,
+                BeginArray,
+                EndArray,
+                StringValue,
+                NumberValue,
+                BoolValue,
+                NullValue,
+                EndOfInput
+            };
+
+            explicit JsonReader(std::istream& in);
+
+            /// Reads the next token and returns it.
+            Token next();
+
+            /// Returns the current token.
+            Token token() const
+            { return _token; }
+
+            /// Returns the member name of the current value, when it is
+            /// a member of a object and a empty string otherwise.
+            const std::string& name() const
+            { return _name; }
+
+            /// Returns the value of the current scalar token as UTF-8.
+            /// Strings are unescaped, numbers returned as written and
+            /// booleans as "true" or "false".
+            const std::string& value() const
+            { return _value; }
+
+            /// Returns true, if the current number has a fraction or exponent.
+            bool isFloat() const
+            { return _float; }
+
+            /// Returns the nesting level of the current token.
+            unsigned depth() const
+            { return _stack.size(); }
+
+            /// Skips the current value. When the current token is BeginObject
+            /// or BeginArray, all tokens up to the matching end are read
+            /// without storing any values.
+            void skip();
+
+            /// Deserializes the current value and its subtree into `value`.
+            /// After that the current token is the last token of the value.
+            template <typename T>
+            void get(T& value)
+            {
+                read();
+                _deserializer.deserialize(value);
+            }
+
+            /// Reads the current value and its subtree into a
+            /// SerializationInfo. The returned object is reused by the next
+            /// call.
+            const SerializationInfo& read();
+
+            unsigned lineNo() const
+            { return _lineNo; }
+
+        private:
+            struct Level
+            {
+                bool object;
+                bool first;
+            };
+
+            std::streambuf* _sb;
+            std::vector<Level> _stack;
+            Token _token;
+            std::string _name;
+            std::string _value;
+            bool _float;
+            bool _ascii;
+            bool _skipping;
+            unsigned _lineNo;
+            Deserializer _deserializer;
+
+            int getc();
+            int peekc();
+            int skipWs();
+            Token readValue();
+            void readString(std::string& str);
+            void readPlainName();
+            void readNumber();
+            void readWord();
+            void appendUtf8(std::string& str, unsigned long code);
+            unsigned readHex4();
+            void fill();
+
+            void doThrow(const std::string& msg);
+            void throwInvalidCharacter(int ch);
+    };
+}
+
+#endif // CXXTOOLS_JSONREADER_H
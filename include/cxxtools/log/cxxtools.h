@@ -271,6 +271,14 @@ namespace cxxtools
 
       typedef Logger::log_level_type log_level_type;
 
+      /// What happens in asynchronous mode when the buffer of a thread is full.
+      enum OverflowPolicy
+      {
+        OverflowBlock,  ///< the logging thread waits for the writer
+        OverflowDrop,   ///< the message is dropped
+        OverflowCount   ///< the message is dropped and the number of dropped messages is logged
+      };
+
       LogConfiguration();
       LogConfiguration(const LogConfiguration&);
       LogConfiguration& operator=(const LogConfiguration&);
@@ -283,6 +291,10 @@ namespace cxxtools
       int rootFlags() const;
       int logFlags(const std::string& category) const;
 
+      bool async() const;
+      unsigned asyncBufferSize() const;
+      OverflowPolicy asyncOverflow() const;
+
       // setter
       void setRootFlags(int flags);
       void setRootLevel(log_level_type level)
@@ -306,6 +318,13 @@ namespace cxxtools
       void setStdout();
       void setStderr();
       void setLogFormat(const LogFormat& logFormat);
+
+      /// Enables asynchronous logging.
+      /// Each thread puts its messages into a buffer of bufferSize entries,
+      /// which is written by a background thread. Fatal messages are written
+      /// before the log statement returns.
+      void setAsync(unsigned bufferSize = 1024, OverflowPolicy overflow = OverflowBlock);
+      void setSync();
   };
 
   void operator>>= (const SerializationInfo& si, LogConfiguration& logConfiguration);
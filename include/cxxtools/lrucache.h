@@ -87,6 +87,7 @@ namespace cxxtools
 
     public:
       typedef typename DataType::size_type size_type;
+      typedef Key key_type;
       typedef Value value_type;
 
       explicit LruCache(size_type maxElements_)
@@ -0,0 +1,400 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_MPMCQUEUE_H
+#define CXXTOOLS_MPMCQUEUE_H
+
+#include <cxxtools/timespan.h>
+#include <cxxtools/scopedincrement.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace cxxtools
+{
+    /** @brief A thread safe multi producer multi consumer queue.
+
+        The queue has the same interface as cxxtools::Queue but does not
+        take a lock when putting or fetching elements as long as there are
+        elements available and there is space left. The elements are kept
+        in a ring buffer of fixed capacity, which is rounded up to the next
+        power of two.
+
+        Threads, which have to wait because the queue is empty or full are
+        parked on a condition variable. The mutex is only touched by threads,
+        which have to wait and by threads, which have to wake up a waiting
+        thread.
+
+        When the ring buffer is full, put blocks until space is available
+        unless force is set or the queue was constructed with overflow
+        enabled. In that case the element is appended to a mutex protected
+        overflow list, which is drained after the ring buffer is empty.
+     */
+    template <typename T>
+    class MpmcQueue
+    {
+        public:
+            typedef T value_type;
+            typedef std::size_t size_type;
+            typedef const T& const_reference;
+
+        private:
+            struct Cell
+            {
+                std::atomic<size_type> sequence;
+                value_type value;
+            };
+
+            // keep producer and consumer positions on separate cache lines
+            char _pad0[64];
+            std::atomic<size_type> _head;
+            char _pad1[64 - sizeof(std::atomic<size_type>)];
+            std::atomic<size_type> _tail;
+            char _pad2[64 - sizeof(std::atomic<size_type>)];
+
+            std::unique_ptr<Cell[]> _cells;
+            size_type _mask;
+            bool _overflow;
+
+            std::atomic<size_type> _numWaiting;
+            std::atomic<size_type> _numFullWaiting;
+            std::atomic<size_type> _overflowSize;
+
+            mutable std::mutex _mutex;
+            std::condition_variable _notEmpty;
+            std::condition_variable _notFull;
+            std::deque<value_type> _overflowQueue;
+
+            MpmcQueue(const MpmcQueue&) = delete;
+            MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+            bool tryPush(const_reference element);
+            bool tryPop(value_type& element);
+            bool tryGetLocked(value_type& element);
+
+            void wakeConsumer();
+            void wakeProducer();
+
+        public:
+            /** @brief Creates a queue.
+
+                The ring buffer holds at least capacity elements. When
+                overflow is set, put never blocks.
+             */
+            explicit MpmcQueue(size_type capacity = 1024, bool overflow = false);
+
+            /** @brief Returns the next element.
+
+                If the queue is empty, the thread is parked until a element
+                is available.
+             */
+            value_type get();
+
+            /** @brief Returns the next element if the queue is not empty.
+
+                If the queue is empty, the thread will wait up to timeout
+                milliseconds until a element is available. If the queue was
+                empty after the timeout, a pair of a default constructed
+                value_type and the value false are returned.
+             */
+            std::pair<value_type, bool> get(const Milliseconds& timeout);
+
+            /** @brief Returns the next element if the queue is not empty.
+
+                If the queue is empty, a default constructed value_type is returned.
+                The returned flag is set to false, if the queue was empty.
+             */
+            std::pair<value_type, bool> tryGet();
+
+            /** @brief Adds a element to the queue.
+
+                If the ring buffer is full, the method blocks until there is
+                space available unless force is set or overflow is enabled.
+             */
+            void put(const_reference element, bool force = false);
+
+            /// @brief Returns true, if the queue is empty.
+            bool empty() const
+            { return size() == 0; }
+
+            /// @brief Returns the number of elements currently in queue.
+            size_type size() const
+            {
+                size_type tail = _tail.load(std::memory_order_acquire);
+                size_type head = _head.load(std::memory_order_acquire);
+                return (head > tail ? head - tail : 0) + _overflowSize.load(std::memory_order_acquire);
+            }
+
+            /// @brief Returns the capacity of the ring buffer.
+            size_type capacity() const
+            { return _mask + 1; }
+
+            /// @brief returns the number of threads blocked in the get method.
+            size_type numWaiting() const
+            { return _numWaiting.load(std::memory_order_relaxed); }
+    };
+
+    template <typename T>
+    MpmcQueue<T>::MpmcQueue(size_type capacity, bool overflow)
+        : _head(0),
+          _tail(0),
+          _mask(0),
+          _overflow(overflow),
+          _numWaiting(0),
+          _numFullWaiting(0),
+          _overflowSize(0)
+    {
+        size_type size = 2;
+        while (size < capacity)
+            size <<= 1;
+
+        _cells.reset(new Cell[size]);
+        _mask = size - 1;
+
+        for (size_type n = 0; n < size; ++n)
+            _cells[n].sequence.store(n, std::memory_order_relaxed);
+    }
+
+    template <typename T>
+    bool MpmcQueue<T>::tryPush(const_reference element)
+    {
+        size_type pos = _head.load(std::memory_order_relaxed);
+        Cell* cell;
+
+        while (true)
+        {
+            cell = &_cells[pos & _mask];
+            size_type seq = cell->sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0)
+            {
+                if (_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+                return false;
+            else
+                pos = _head.load(std::memory_order_relaxed);
+        }
+
+        cell->value = element;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    template <typename T>
+    bool MpmcQueue<T>::tryPop(value_type& element)
+    {
+        size_type pos = _tail.load(std::memory_order_relaxed);
+        Cell* cell;
+
+        while (true)
+        {
+            cell = &_cells[pos & _mask];
+            size_type seq = cell->sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0)
+            {
+                if (_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+                return false;
+            else
+                pos = _tail.load(std::memory_order_relaxed);
+        }
+
+        element = std::move(cell->value);
+        cell->sequence.store(pos + _mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Fetches a element from the ring buffer or the overflow list.
+    // The mutex must be locked.
+    template <typename T>
+    bool MpmcQueue<T>::tryGetLocked(value_type& element)
+    {
+        if (tryPop(element))
+            return true;
+
+        if (!_overflowQueue.empty())
+        {
+            element = _overflowQueue.front();
+            _overflowQueue.pop_front();
+            _overflowSize.fetch_sub(1, std::memory_order_release);
+            return true;
+        }
+
+        return false;
+    }
+
+    template <typename T>
+    void MpmcQueue<T>::wakeConsumer()
+    {
+        // pairs with the fence in get: either the consumer sees the new
+        // element or we see the consumer waiting
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_numWaiting.load(std::memory_order_relaxed) > 0)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _notEmpty.notify_one();
+        }
+    }
+
+    template <typename T>
+    void MpmcQueue<T>::wakeProducer()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_numFullWaiting.load(std::memory_order_relaxed) > 0)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _notFull.notify_one();
+        }
+    }
+
+    template <typename T>
+    typename MpmcQueue<T>::value_type MpmcQueue<T>::get()
+    {
+        value_type element;
+
+        if (_overflowSize.load(std::memory_order_acquire) == 0 && tryPop(element))
+        {
+            wakeProducer();
+            return element;
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            ScopedIncrement<std::atomic<size_type> > inc(_numWaiting);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            while (!tryGetLocked(element))
+                _notEmpty.wait(lock);
+        }
+
+        wakeProducer();
+        return element;
+    }
+
+    template <typename T>
+    std::pair<typename MpmcQueue<T>::value_type, bool> MpmcQueue<T>::get(const Milliseconds& timeout)
+    {
+        typedef std::pair<value_type, bool> return_type;
+
+        value_type element;
+
+        if (_overflowSize.load(std::memory_order_acquire) == 0 && tryPop(element))
+        {
+            wakeProducer();
+            return return_type(element, true);
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            ScopedIncrement<std::atomic<size_type> > inc(_numWaiting);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+            while (!tryGetLocked(element))
+            {
+                if (_notEmpty.wait_until(lock, until) == std::cv_status::timeout
+                    && !tryGetLocked(element))
+                    return return_type(value_type(), false);
+            }
+        }
+
+        wakeProducer();
+        return return_type(element, true);
+    }
+
+    template <typename T>
+    std::pair<typename MpmcQueue<T>::value_type, bool> MpmcQueue<T>::tryGet()
+    {
+        typedef std::pair<value_type, bool> return_type;
+
+        value_type element;
+
+        if (_overflowSize.load(std::memory_order_acquire) == 0)
+        {
+            if (!tryPop(element))
+                return return_type(value_type(), false);
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (!tryGetLocked(element))
+                return return_type(value_type(), false);
+        }
+
+        wakeProducer();
+        return return_type(element, true);
+    }
+
+    template <typename T>
+    void MpmcQueue<T>::put(const_reference element, bool force)
+    {
+        // elements go to the overflow list as long as it is not empty,
+        // so that they are fetched in order
+        if (_overflowSize.load(std::memory_order_acquire) == 0 && tryPush(element))
+        {
+            wakeConsumer();
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(_mutex);
+
+        if (_overflow || force)
+        {
+            if (_overflowQueue.empty() && tryPush(element))
+            {
+                _notEmpty.notify_one();
+                return;
+            }
+
+            _overflowQueue.push_back(element);
+            _overflowSize.fetch_add(1, std::memory_order_release);
+            _notEmpty.notify_one();
+            return;
+        }
+
+        ScopedIncrement<std::atomic<size_type> > inc(_numFullWaiting);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        while (!tryPush(element))
+            _notFull.wait(lock);
+
+        _notEmpty.notify_one();
+    }
+}
+
+#endif // CXXTOOLS_MPMCQUEUE_H
@@ -31,6 +31,7 @@
 
 #include <string>
 #include <cxxtools/systemerror.h>
+#include <cxxtools/timespan.h>
 
 namespace cxxtools
 {
@@ -40,6 +41,23 @@ namespace net
 
 class AddrInfoImpl;
 
+/**
+   Address informations of a host and port.
+
+   The name is resolved lazily when the addresses are needed for the first
+   time. A non blocking connect of a net::TcpSocket, which is attached to a
+   selector, resolves the name asynchronously, so that the event loop is not
+   blocked.
+
+   Since the constructor does not resolve the name, an unknown host does not
+   throw there. The AddrInfoError is thrown by resolve(), by iterating the
+   addresses or by a blocking connect. A non blocking connect reports the
+   failure as an IOError from TcpSocket::endConnect.
+
+   Results are kept in a process wide cache. Successful lookups are cached
+   for cacheTtl() and failed lookups for negativeCacheTtl(). Setting the ttl
+   to 0 disables caching.
+ */
 class AddrInfo
 {
 public:
@@ -59,6 +77,20 @@ public:
     const std::string& host() const;
     unsigned short port() const;
 
+    /// Returns true when the addresses are available without a lookup.
+    bool resolved() const;
+
+    /// Resolves the name if not yet done. Throws AddrInfoError on failure.
+    void resolve();
+
+    static void cacheTtl(Milliseconds ttl);
+    static Milliseconds cacheTtl();
+
+    static void negativeCacheTtl(Milliseconds ttl);
+    static Milliseconds negativeCacheTtl();
+
+    static void clearCache();
+
     AddrInfoImpl* impl()               { return _impl; }
     const AddrInfoImpl* impl() const   { return _impl; }
 
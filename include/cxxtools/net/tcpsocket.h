@@ -150,6 +150,9 @@ class TcpSocket : public IODevice
         // inherit doc
         virtual size_t onBeginWrite(const char* buffer, size_t n);
 
+        // inherit doc
+        virtual size_t onBeginWritev(const struct iovec* vec, size_t count);
+
     public:
         // inherit doc
         virtual SelectableImpl& simpl();
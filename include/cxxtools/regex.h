@@ -43,18 +43,23 @@ namespace cxxtools
   class Regex
   {
       std::unique_ptr<regex_t, decltype(&regfree)> expr;
+      std::string _pattern;
+      int _cflags;
 
       void checkerr(int ret) const;
 
     public:
       /// create a uninitialized regex object.
       Regex()
-        : expr(0, ::regfree)
+        : expr(0, ::regfree),
+          _cflags(0)
       { }
 
       /// create a regex object with a const char*.
       explicit Regex(const char* ex, int cflags = REG_EXTENDED)
-        : expr(0, ::regfree)
+        : expr(0, ::regfree),
+          _pattern(ex ? ex : ""),
+          _cflags(cflags)
       {
         if (ex && ex[0])
         {
@@ -65,7 +70,9 @@ namespace cxxtools
 
       /// create a regex object with std::string.
       explicit Regex(const std::string& ex, int cflags = REG_EXTENDED)
-        : expr(0, ::regfree)
+        : expr(0, ::regfree),
+          _pattern(ex),
+          _cflags(cflags)
       {
         if (!ex.empty())
         {
@@ -93,10 +100,16 @@ namespace cxxtools
       std::string subst(const std::string& str, const std::string& expr, bool all = true);
 
       /// Destroys the regular expression. This is normally done by the destructor.
-      void free()  { expr = 0; }
+      void free()  { expr = 0; _pattern.clear(); }
 
       /// Returns true, if the object does not have a valid regular expression.
       bool empty() const    { return !expr; }
+
+      /// Returns the source of the regular expression.
+      const std::string& pattern() const  { return _pattern; }
+
+      /// Returns the flags passed to regcomp.
+      int cflags() const    { return _cflags; }
   };
 
   /// collects matches in a regex
@@ -58,6 +58,15 @@ namespace cxxtools
 
             virtual void cancel() = 0;
 
+            /// Cancels the given procedure if it is active.
+            /// Clients, which run more than one procedure at a time, override
+            /// this to keep the other procedures running.
+            virtual void cancelCall(IRemoteProcedure& method)
+            {
+                if (activeProcedure() == &method)
+                    cancel();
+            }
+
             virtual void wait(Milliseconds msecs = WaitInfinite) = 0;
 
             virtual Milliseconds timeout() const = 0;
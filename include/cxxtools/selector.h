@@ -32,7 +32,6 @@
 
 #include <cxxtools/timespan.h>
 #include <cxxtools/connectable.h>
-#include <map>
 
 namespace cxxtools {
 
@@ -40,6 +39,7 @@ namespace cxxtools {
     class Selectable;
     class Application;
     class SelectorImpl;
+    class TimerWheel;
 
     /** @brief Reports activity on a set of devices.
 
@@ -168,6 +168,21 @@ namespace cxxtools {
              */
             Timespan waitTimer();
 
+            /** @brief Sets the resolution of the timers
+
+                A timer fires at the first multiple of the resolution at or
+                after its due time. Timers due within the same interval are
+                coalesced and fire together on a single wakeup, so a coarser
+                resolution reduces wakeups when many timers are used, e.g.
+                for connection timeouts. Timers never fire early.
+
+                The default resolution is 1 millisecond.
+             */
+            void timerResolution(Milliseconds r);
+
+            /// Returns the resolution of the timers.
+            Milliseconds timerResolution() const;
+
         protected:
             //! @brief Default constructor
             SelectorBase();
@@ -214,10 +229,7 @@ namespace cxxtools {
             bool updateTimer(Timespan& timeout);
 
             //! @internal
-            typedef std::multimap<Timespan, Timer*> TimerMap;
-
-            //! @internal
-            TimerMap _timers;
+            TimerWheel* _timerWheel;
     };
 
     class Selector : public SelectorBase
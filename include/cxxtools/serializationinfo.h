@@ -41,6 +41,9 @@
 #include <unordered_map>
 #include <tuple>
 #include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
 #include <type_traits>
 #include <iosfwd>
 
@@ -138,6 +141,36 @@ class SerializationInfo
         typedef unsigned long unsigned_type;
 #endif
 
+        /** @brief A member name with precomputed hash value.
+
+            Objects with many members are searched using a hash index. A key
+            can be created once, e.g. as a static variable in a
+            deserialization operator, so that the hash of the name is not
+            calculated on each lookup.
+
+            @code
+                void operator>>= (const cxxtools::SerializationInfo& si, Config& config)
+                {
+                    static const cxxtools::SerializationInfo::Key port("port");
+                    si.getMember(port) >>= config.port;
+                }
+            @endcode
+         */
+        class Key
+        {
+                std::string _name;
+                std::size_t _hash;
+
+            public:
+                explicit Key(const std::string& name)
+                    : _name(name),
+                      _hash(std::hash<std::string>()(name))
+                    { }
+
+                const std::string& name() const   { return _name; }
+                std::size_t hash() const          { return _hash; }
+        };
+
     public:
         SerializationInfo();
 
@@ -163,7 +196,7 @@ class SerializationInfo
 
         const std::string& typeName() const
         {
-            return _type;
+            return _type.str();
         }
 
         void setTypeName(const std::string& type)
@@ -182,16 +215,18 @@ class SerializationInfo
 
         const std::string& name() const
         {
-            return _name;
+            return _name.str();
         }
 
         void setName(const std::string& name)
         {
+            _unindex();
             _name = name;
         }
 
         void setName(std::string&& name)
         {
+            _unindex();
             _name = std::move(name);
         }
 
@@ -292,6 +327,7 @@ class SerializationInfo
         */
         const SerializationInfo& getMember(const std::string& name) const;
         SerializationInfo& getMember(const std::string& name);
+        const SerializationInfo& getMember(const Key& key) const;
 
         SerializationInfo& getNthMember(const std::string& name, int unsigned);
         const SerializationInfo& getNthMember(const std::string& name, int unsigned) const;
@@ -318,13 +354,31 @@ class SerializationInfo
             return true;
         }
 
+        template <typename T>
+        bool getMember(const Key& key, T& value) const
+        {
+            const SerializationInfo* si = findMember(key);
+            if (si == 0)
+                return false;
+            *si >>= value;
+            return true;
+        }
+
         /** @brief Find member data by name
 
             This method returns the data for an object with the name \a name.
             or null if it is not present.
+
+            Objects with many members build a hash index over the member
+            names on the first lookup, so that deserializing wide objects
+            does not take quadratic time. The index is dropped when members
+            are added or the object is reset and rebuilt when a member is
+            renamed.
         */
         const SerializationInfo* findMember(const std::string& name) const;
 
+        const SerializationInfo* findMember(const Key& key) const;
+
         /** @brief Find member data by name
 
             This method returns the data for an object with the name \a name.
@@ -332,35 +386,30 @@ class SerializationInfo
         */
         SerializationInfo* findMember(const std::string& name);
 
-        size_t memberCount() const
-        {
-            return nodes().size();
-        }
+        size_t memberCount() const;
 
         size_t memberCount(const std::string& name) const;
 
-        Iterator begin()
-        {
-            return nodes().begin();
-        }
+        Iterator begin();
 
-        Iterator end()
-        {
-            return nodes().end();
-        }
+        Iterator end();
 
-        ConstIterator begin() const
-        {
-            return nodes().begin();
-        }
+        ConstIterator begin() const;
 
-        ConstIterator end() const
-        {
-            return nodes().end();
-        }
+        ConstIterator end() const;
 
         void clear();
 
+        /** @brief Clears the content but keeps the member nodes for reuse.
+
+            Unlike clear() the member nodes and their buffers are not released
+            but reused by subsequent calls to addMember. Filling the object
+            again with data of a similar shape does not need to allocate new
+            nodes. Deserializers use it, so that decoding messages with a
+            reused deserializer reaches a steady state without allocations.
+         */
+        void reset();
+
         void swap(SerializationInfo& si);
 
         bool isNull() const       { return _t == t_none && (_category == Void || _category == Value); }
@@ -407,9 +456,62 @@ class SerializationInfo
         void dump(std::ostream& out, const std::string& prefix = std::string()) const;
 
     private:
+        // Member or type name. Short names are interned, so that nodes with
+        // equal names share one string. Other names are owned by the node.
+        class Name
+        {
+                // the lowest bit marks a owned string; 0 is the empty name
+                std::uintptr_t _p;
+
+                const std::string* ptr() const
+                { return reinterpret_cast<const std::string*>(_p & ~std::uintptr_t(1)); }
+
+                bool owned() const
+                { return (_p & 1) != 0; }
+
+                static const std::string& emptyName();
+
+            public:
+                Name()
+                    : _p(0)
+                { }
+
+                Name(const Name& name);
+
+                Name(Name&& name) noexcept
+                    : _p(name._p)
+                { name._p = 0; }
+
+                ~Name()
+                { clear(); }
+
+                Name& operator=(const Name& name);
+                Name& operator=(Name&& name) noexcept;
+                Name& operator=(const std::string& name);
+                Name& operator=(std::string&& name);
+
+                const std::string& str() const
+                { return _p ? *ptr() : emptyName(); }
+
+                bool empty() const
+                { return _p == 0; }
+
+                void clear()
+                {
+                    if (owned())
+                        delete ptr();
+                    _p = 0;
+                }
+
+                void swap(Name& name)
+                { std::swap(_p, name._p); }
+        };
+
         Category _category;
-        std::string _name;
-        std::string _type;
+        // set when the node is found through the member index of its parent
+        mutable std::atomic<bool> _indexed;
+        Name _name;
+        Name _type;
 
         void _releaseValue();
         void _setString(String&& value);
@@ -473,17 +575,89 @@ class SerializationInfo
           t_ldouble
         } _t;
 
-        Nodes* _nodes;             // objects/arrays
+        class MemberIndex;
+        class NodePool;
+
+        // member nodes of objects and arrays; the nodes after the first
+        // `used` nodes are kept by reset() for reuse in addMember
+        struct NodeList
+        {
+            Nodes nodes;
+            Nodes::size_type used;
+            // built on demand by const lookups; may be set concurrently
+            std::atomic<MemberIndex*> index;
+
+            NodeList()
+                : used(0),
+                  index(0)
+            { }
+
+            ~NodeList();
+
+            void dropIndex();
+            // removes all nodes for reuse of the list
+            void clear();
+        };
+
+        NodeList* _nodes;
+
+        // the name of a indexed member changes
+        void _unindex()
+        {
+            if (_indexed.load(std::memory_order_relaxed))
+                _renamed();
+        }
+
+        void _renamed();
+
+        const MemberIndex* memberIndex() const;
+        const SerializationInfo* findMember(const std::string& name, std::size_t hash) const;
+
+        static NodeList* copyNodes(const NodeList& nodeList);
+        // member lists are taken from and released to a pool of the thread
+        static NodeList* newNodes();
+        static void releaseNodes(NodeList* nodeList);
 };
 
 
 inline SerializationInfo::SerializationInfo()
 : _category(Void),
+  _indexed(false),
   _t(t_none),
   _nodes(0)
 { }
 
 
+inline size_t SerializationInfo::memberCount() const
+{
+    return _nodes ? _nodes->used : 0;
+}
+
+
+inline SerializationInfo::Iterator SerializationInfo::begin()
+{
+    return nodes().begin();
+}
+
+
+inline SerializationInfo::Iterator SerializationInfo::end()
+{
+    return nodes().begin() + _nodes->used;
+}
+
+
+inline SerializationInfo::ConstIterator SerializationInfo::begin() const
+{
+    return nodes().begin();
+}
+
+
+inline SerializationInfo::ConstIterator SerializationInfo::end() const
+{
+    return nodes().begin() + memberCount();
+}
+
+
 inline void operator >>=(const SerializationInfo& si, SerializationInfo& ssi)
 {
     ssi = si;
@@ -34,6 +34,7 @@
 #include <cxxtools/void.h>
 #include <cxxtools/typetraits.h>
 #include <cxxtools/callable.h>
+#include <functional>
 
 namespace cxxtools
 {
@@ -52,6 +53,23 @@ class ServiceProcedure
         virtual IComposer** beginCall() = 0;
 
         virtual IDecomposer* endCall() = 0;
+
+        /// Returns true, when the procedure delivers its result asynchronously.
+        /// Servers then call startCall and release the worker thread until
+        /// the result is available.
+        virtual bool isAsync() const
+        { return false; }
+
+        /**
+         Starts the procedure after the arguments are composed.
+
+         The function finished is called, possibly from another thread, when
+         the result is available. endCall then returns the result without
+         blocking. The procedure may be destroyed before it has finished; the
+         callback is not called then.
+         */
+        virtual void startCall(const std::function<void()>& finished)
+        { finished(); }
 };
 
 //! @cond internal
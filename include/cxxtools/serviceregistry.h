@@ -30,6 +30,7 @@
 #define CXXTOOLS_SERVICEREGISTRY_H
 
 #include <cxxtools/serviceprocedure.h>
+#include <cxxtools/asyncserviceprocedure.h>
 #include <cxxtools/callable.h>
 #include <cxxtools/function.h>
 #include <cxxtools/method.h>
@@ -281,6 +282,37 @@ namespace cxxtools
                 this->registerProcedure(name, proc);
             }
 
+            /**
+             Registers an asynchronous procedure.
+
+             The function gets an AsyncResult<R> handle as first argument and
+             returns immediately. The server does not block a worker thread
+             while the procedure runs; the reply is sent, when the result is
+             passed to the handle.
+             */
+            template <typename R, typename... A>
+            void registerAsync(const std::string& name, const std::function<void (AsyncResult<R>, A...)>& fn)
+            {
+                ServiceProcedure* proc = new AsyncServiceProcedure<R, A...>(fn);
+                this->registerProcedure(name, proc);
+            }
+
+            template <typename R, typename... A>
+            void registerAsyncFunction(const std::string& name, void (*fn)(AsyncResult<R>, A...))
+            {
+                ServiceProcedure* proc = new AsyncServiceProcedure<R, A...>(fn);
+                this->registerProcedure(name, proc);
+            }
+
+            template <typename R, class C, typename... A>
+            void registerAsyncMethod(const std::string& name, C& obj, void (C::*method)(AsyncResult<R>, A...))
+            {
+                C* o = &obj;
+                ServiceProcedure* proc = new AsyncServiceProcedure<R, A...>(
+                    [o, method](AsyncResult<R> result, A... args) { (o->*method)(result, args...); });
+                this->registerProcedure(name, proc);
+            }
+
             ServiceProcedure* getProcedure(const std::string& name) const;
 
             void releaseProcedure(ServiceProcedure* proc) const;
@@ -0,0 +1,213 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_SHARDEDCACHE_H
+#define CXXTOOLS_SHARDEDCACHE_H
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <functional>
+#include <utility>
+
+namespace cxxtools
+{
+  /**
+     Thread safe cache, which splits the elements into independent shards.
+
+     Each shard is a cache of type CacheType (typically cxxtools::HashCache or
+     cxxtools::HashLruCache) guarded by its own mutex. The shard of a key is
+     selected by its hash, so that threads accessing different keys rarely
+     wait for each other.
+
+     The maximum number of elements is divided between the shards and the
+     caching algorithm is applied per shard. Hits and misses are counted per
+     shard and can be requested in total or per shard.
+
+     Since the elements are owned by the shards, values are always returned
+     as copies.
+
+     Example:
+     \code
+       cxxtools::ShardedCache<cxxtools::HashLruCache<std::string, int> > cache(1000);
+       cache.put("foo", 42);
+       std::pair<bool, int> r = cache.getx("foo");
+     \endcode
+   */
+  template <typename CacheType, typename Hash = std::hash<typename CacheType::key_type> >
+  class ShardedCache
+  {
+    public:
+      typedef typename CacheType::size_type size_type;
+      typedef typename CacheType::key_type key_type;
+      typedef typename CacheType::value_type value_type;
+
+    private:
+      struct Shard
+      {
+        mutable std::mutex mutex;
+        CacheType cache;
+
+        explicit Shard(size_type maxElements)
+          : cache(maxElements)
+          { }
+      };
+
+      std::vector<std::unique_ptr<Shard> > _shards;
+      Hash _hash;
+
+      Shard& _shard(const key_type& key) const
+      {
+        // The hash of integers is often the identity, so the bits are mixed
+        // to prevent keys with a common stride from ending in a single shard.
+        size_t h = _hash(key);
+        h ^= h >> 16;
+        h *= 0x45d9f3b;
+        h ^= h >> 16;
+        return *_shards[h % _shards.size()];
+      }
+
+    public:
+      /// Creates a cache with a total of maxElements elements in the given
+      /// number of shards. The number of shards is at least 1.
+      explicit ShardedCache(size_type maxElements, unsigned shards = 16)
+      {
+        if (shards == 0)
+          shards = 1;
+
+        size_type perShard = (maxElements + shards - 1) / shards;
+        _shards.reserve(shards);
+        for (unsigned n = 0; n < shards; ++n)
+          _shards.push_back(std::unique_ptr<Shard>(new Shard(perShard)));
+      }
+
+      /// returns the number of shards
+      unsigned shards() const   { return _shards.size(); }
+
+      /// returns the number of elements currently in the cache
+      size_type size() const
+      {
+        size_type s = 0;
+        for (unsigned n = 0; n < _shards.size(); ++n)
+          s += size(n);
+        return s;
+      }
+
+      /// returns the number of elements currently in the given shard
+      size_type size(unsigned shard) const
+      {
+        std::lock_guard<std::mutex> lock(_shards[shard]->mutex);
+        return _shards[shard]->cache.size();
+      }
+
+      /// removes a element from the cache and returns true, if found
+      bool erase(const key_type& key)
+      {
+        Shard& s = _shard(key);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        return s.cache.erase(key);
+      }
+
+      /// clears all shards.
+      void clear(bool stats = false)
+      {
+        for (unsigned n = 0; n < _shards.size(); ++n)
+        {
+          std::lock_guard<std::mutex> lock(_shards[n]->mutex);
+          _shards[n]->cache.clear(stats);
+        }
+      }
+
+      /// puts a new element in the cache.
+      void put(const key_type& key, const value_type& value)
+      {
+        Shard& s = _shard(key);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.cache.put(key, value);
+      }
+
+      /// returns a pair of values - a flag, if the value was found and a copy
+      /// of the value if found or the passed default otherwise.
+      std::pair<bool, value_type> getx(const key_type& key, value_type def = value_type())
+      {
+        Shard& s = _shard(key);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        return s.cache.getx(key, def);
+      }
+
+      /// returns a copy of the value to a key or the passed default value if
+      /// not found.
+      value_type get(const key_type& key, value_type def = value_type())
+      {
+        return getx(key, def).second;
+      }
+
+      /// returns the number of hits of all shards.
+      unsigned getHits() const
+      {
+        unsigned h = 0;
+        for (unsigned n = 0; n < _shards.size(); ++n)
+          h += getHits(n);
+        return h;
+      }
+
+      /// returns the number of misses of all shards.
+      unsigned getMisses() const
+      {
+        unsigned m = 0;
+        for (unsigned n = 0; n < _shards.size(); ++n)
+          m += getMisses(n);
+        return m;
+      }
+
+      /// returns the number of hits of the given shard.
+      unsigned getHits(unsigned shard) const
+      {
+        std::lock_guard<std::mutex> lock(_shards[shard]->mutex);
+        return _shards[shard]->cache.getHits();
+      }
+
+      /// returns the number of misses of the given shard.
+      unsigned getMisses(unsigned shard) const
+      {
+        std::lock_guard<std::mutex> lock(_shards[shard]->mutex);
+        return _shards[shard]->cache.getMisses();
+      }
+
+      /// returns the cache hit ratio between 0 and 1.
+      double hitRatio() const
+      {
+        unsigned hits = getHits();
+        unsigned misses = getMisses();
+        return hits+misses > 0 ? static_cast<double>(hits)/static_cast<double>(hits+misses) : 0;
+      }
+  };
+
+}
+
+#endif // CXXTOOLS_SHARDEDCACHE_H
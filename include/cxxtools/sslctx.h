@@ -29,6 +29,7 @@
 #ifndef CXXTOOLS_SSLCTX_H
 #define CXXTOOLS_SSLCTX_H
 
+#include <cxxtools/timespan.h>
 #include <string>
 
 namespace cxxtools
@@ -131,6 +132,31 @@ public:
 
     SslCtx& setCipherServerPreference(bool sw = true);
 
+    /** Sets the number of client sessions kept for resumption.
+
+        Client connections remember the ssl session per host and port and
+        try to resume it on reconnect, which saves the full handshake. The
+        default is 100. Setting it to 0 disables session resumption in
+        clients.
+     */
+    SslCtx& setSessionCacheSize(unsigned n);
+
+    /** Sets the interval, after which a new session ticket key is created in servers.
+
+        Session tickets encrypted with the previous key are still accepted
+        and renewed. The default is one hour. 0 disables rotation.
+     */
+    SslCtx& setTicketKeyRotation(Milliseconds interval);
+
+    /** Creates a new session ticket key immediately. */
+    SslCtx& rotateTicketKey();
+
+    /** Returns the number of handshakes, which did not resume a session. */
+    unsigned long fullHandshakes() const;
+
+    /** Returns the number of handshakes, which resumed a session. */
+    unsigned long resumedHandshakes() const;
+
     /** return standard ctx with low security */
     static SslCtx standard() { return SslCtx().enable(); }
 
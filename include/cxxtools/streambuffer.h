@@ -30,6 +30,9 @@
 
 #include <ios>
 #include <streambuf>
+#include <deque>
+#include <string>
+#include <vector>
 #include <cxxtools/iodevice.h>
 
 namespace cxxtools
@@ -120,6 +123,32 @@ class StreamBuffer : public BasicStreamBuffer<char>,
          */
         size_t endWrite();
 
+        /** Appends a block of data to the output without copying it to the buffer.
+         *
+         *  The string is moved into the stream buffer and is sent after the
+         *  data already buffered. Buffered data and blocks are passed to the
+         *  device in a single write, so that e.g. a header and a large body
+         *  are sent with one system call. Small blocks and blocks appended
+         *  while a write is pending are copied to the buffer.
+         */
+        void putSlice(std::string&& data);
+
+        /** Appends a block of data to the output without copying it to the buffer.
+         *
+         *  Unlike the string variant the stream buffer just keeps a pointer
+         *  to the data, which must stay valid until it is written, i.e.
+         *  until out_avail returns 0.
+         */
+        void putSlice(const char* data, size_t n);
+
+        /** Returns the number of bytes to be written.
+         *
+         *  This includes the buffered data and the blocks appended with
+         *  putSlice.
+         */
+        std::streamsize out_avail()
+            { return BasicStreamBuffer<char>::out_avail() + _slicesSize; }
+
         /** Returns true if the underlying device is in reading mode.
          *
          *  The device is in reading mode, when beginRead has been called.
@@ -143,6 +172,14 @@ class StreamBuffer : public BasicStreamBuffer<char>,
          */
         void discard();
 
+        /** Empties the output buffer except the first keep bytes.
+         *
+         *  Unlike discard, data in the input buffer is kept. The data, which
+         *  is currently written to the device, must be kept. A exception of
+         *  type cxxtools::IOPending will be thrown otherwise.
+         */
+        void discardOutput(std::streamsize keep = 0);
+
         /** Signals, that the underlying I/O device has data to read.
          */
         Signal<StreamBuffer&> inputReady;
@@ -175,6 +212,21 @@ class StreamBuffer : public BasicStreamBuffer<char>,
 
         void onWrite(IODevice& dev);
 
+        struct Slice
+        {
+            std::string data;
+            const char* ptr;
+            size_t size;
+        };
+
+        Slice& appendSlice();
+
+        void initWvec();
+
+        void consumeOutput(size_t n);
+
+        void writeOutput();
+
     private:
         IODevice* _ioDevice;
         size_t _ibufferSize;
@@ -183,6 +235,9 @@ class StreamBuffer : public BasicStreamBuffer<char>,
         char* _obuffer;
         const size_t _pbmax;
         bool _oextend;
+        std::deque<Slice> _slices;
+        size_t _slicesSize;
+        std::vector<struct iovec> _wvec;
 };
 
 } // namespace cxxtools
@@ -70,6 +70,7 @@ namespace cxxtools {
     class Timer
     {
         class Sentry;
+        friend class TimerWheel;
 
         public:
             /** @brief Default constructor
@@ -198,6 +199,13 @@ namespace cxxtools {
             Timespan      _interval;
             Timespan      _finished;
             bool          _once;
+
+            // links of the timer wheel of the selector
+            Timer*        _wheelNext;
+            Timer*        _wheelPrev;
+            uint64_t      _wheelTick;
+            uint64_t      _wheelSeq;
+            unsigned      _wheelSlot;
     };
 
 }
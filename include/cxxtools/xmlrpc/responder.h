@@ -74,6 +74,8 @@ class XmlRpcResponder : public http::Responder
 
         std::size_t readBody(std::istream& is);
 
+        bool prepareReply(http::Request& request, const std::function<void()>& ready);
+
         void replyError(std::ostream& os, http::Request& request,
                         http::Reply& reply, const std::exception& ex);
 
@@ -30,6 +30,7 @@
 #include <cxxtools/log.h>
 #include <string.h>
 #include "addrinfoimpl.h"
+#include "resolver.h"
 
 log_define("cxxtools.net.addrinfo")
 
@@ -101,6 +102,41 @@ unsigned short AddrInfo::port() const
   return _impl->port();
 }
 
+bool AddrInfo::resolved() const
+{
+  return _impl && _impl->resolved();
+}
+
+void AddrInfo::resolve()
+{
+  _impl->resolve();
+}
+
+void AddrInfo::cacheTtl(Milliseconds ttl)
+{
+  Resolver::cacheTtl(ttl);
+}
+
+Milliseconds AddrInfo::cacheTtl()
+{
+  return Resolver::cacheTtl();
+}
+
+void AddrInfo::negativeCacheTtl(Milliseconds ttl)
+{
+  Resolver::negativeCacheTtl(ttl);
+}
+
+Milliseconds AddrInfo::negativeCacheTtl()
+{
+  return Resolver::negativeCacheTtl();
+}
+
+void AddrInfo::clearCache()
+{
+  Resolver::clearCache();
+}
+
 
 }
 
@@ -27,6 +27,7 @@
  */
 
 #include "addrinfoimpl.h"
+#include "resolver.h"
 #include "error.h"
 
 #include <cxxtools/net/addrinfo.h>
@@ -82,14 +83,14 @@ namespace net
   {
     log_debug("init(\"" << host << "\", " << port << ')');
 
-    if (_ai && _ai != &_unix)
-    {
-      freeaddrinfo(_ai);
-      _ai = 0;
-    }
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    _list.reset();
+    _ai = 0;
 
     _host = host;
     _port = port;
+    _hints = hints;
 
     if (_port == 0)
     {
@@ -110,29 +111,48 @@ namespace net
       return;
     }
 
-    std::ostringstream p;
-    p << port;
-
-    while (true)
+    // The lookup itself is deferred until the addresses are needed, so that
+    // it can be done asynchronously. Take the result from the cache if
+    // available; cached failures are reported on first access.
+    try
     {
-      int ret = ::getaddrinfo(host.empty() ? 0 : host.c_str(), p.str().c_str(), &hints, &_ai);
-      if (ret == 0)
-        break;
+      if (Resolver::lookupCached(_host, _port, _hints, _list))
+        _ai = _list.get();
+    }
+    catch (const AddrInfoError&)
+    {
+    }
+  }
 
-      if (ret == EAI_AGAIN)
-        continue;
+  bool AddrInfoImpl::resolved() const
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _ai != 0;
+  }
 
-      throw AddrInfoError(ret, host, port);
+  void AddrInfoImpl::resolve() const
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_ai == 0)
+    {
+      _list = Resolver::lookup(_host, _port, _hints);
+      _ai = _list.get();
     }
+  }
 
-    if (_ai == 0)
-      throw SystemError("getaddrinfo");
+  bool AddrInfoImpl::resolveCached() const
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_ai == 0 && Resolver::lookupCached(_host, _port, _hints, _list))
+      _ai = _list.get();
+    return _ai != 0;
   }
 
-  AddrInfoImpl::~AddrInfoImpl()
+  void AddrInfoImpl::setResolved(const std::shared_ptr<struct addrinfo>& list)
   {
-    if (_ai && _ai != &_unix)
-      freeaddrinfo(_ai);
+    std::lock_guard<std::mutex> lock(_mutex);
+    _list = list;
+    _ai = _list.get();
   }
 
   const std::string& AddrInfoImpl::host() const
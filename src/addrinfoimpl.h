@@ -32,6 +32,8 @@
 #include <cxxtools/refcounted.h>
 #include <string>
 #include <iterator>
+#include <memory>
+#include <mutex>
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/un.h>
@@ -43,11 +45,17 @@ namespace cxxtools
 namespace net
 {
 
+/// The address informations are resolved lazily on first access or
+/// asynchronously using the Resolver. The result list is shared with the
+/// process wide address cache.
 class AddrInfoImpl : public cxxtools::RefCounted
 {
     std::string _host;
     unsigned short _port;
-    struct addrinfo* _ai;
+    struct addrinfo _hints;
+    mutable std::mutex _mutex;
+    mutable std::shared_ptr<struct addrinfo> _list;
+    mutable struct addrinfo* _ai;
     struct addrinfo _unix;
     struct sockaddr_un _unix_sockaddr;
 
@@ -66,7 +74,24 @@ public:
              const addrinfo& hints)
       : _ai(0)
       { init(host, port, hints); }
-    ~AddrInfoImpl();
+
+    /// Returns true when the address informations are available without
+    /// blocking.
+    bool resolved() const;
+
+    /// Resolves the address informations using the address cache and
+    /// getaddrinfo(3) if not yet done.
+    void resolve() const;
+
+    /// Takes the address informations from the address cache if found there.
+    /// Returns true when the address informations are available. A cached
+    /// failure is thrown as AddrInfoError.
+    bool resolveCached() const;
+
+    /// Sets the result of a asynchronous resolve.
+    void setResolved(const std::shared_ptr<struct addrinfo>& list);
+
+    const struct addrinfo& hints() const  { return _hints; }
 
     class const_iterator
     {
@@ -102,7 +127,7 @@ public:
     const std::string& host() const;
     unsigned short port() const;
 
-    const_iterator begin() const  { return const_iterator(_ai); }
+    const_iterator begin() const  { resolve(); return const_iterator(_ai); }
     const_iterator end() const    { return const_iterator(); }
 };
 
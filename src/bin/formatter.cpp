@@ -96,15 +96,24 @@ void Formatter::format(const SerializationInfo& si)
 void Formatter::begin(std::streambuf& out)
 {
     _out = &out;
-    _dictionary.clear();
+    if (!_session)
+        _dictionary.clear();
 }
 
 void Formatter::finish()
 {
-    _dictionary.clear();
+    if (!_session)
+        _dictionary.clear();
     _out = 0;
 }
 
+void Formatter::sessionDictionary(unsigned maxSize)
+{
+    _session = maxSize > 0;
+    _maxDictionarySize = _session ? maxSize : 0x10000;
+    _dictionary.clear();
+}
+
 void Formatter::addValueString(const std::string& name, const std::string& type,
                       String&& value)
 {
@@ -876,23 +885,22 @@ void Formatter::outputString(const std::string& value)
         return;
     }
 
-    unsigned idx;
-    for (idx = 0; idx < _dictionary.size(); ++idx)
+    auto it = _dictionary.find(value);
+    if (it != _dictionary.end())
     {
-        if (_dictionary[idx] == value)
-        {
-            log_debug("use dictionary value \"" << value << "\" idx=" << idx);
-            _out->sputc('\1');
-            _out->sputc(static_cast<char>(idx >> 8));
-            _out->sputc(static_cast<char>(idx));
-            return;
-        }
+        unsigned idx = it->second;
+        log_debug("use dictionary value \"" << value << "\" idx=" << idx);
+        _out->sputc('\1');
+        _out->sputc(static_cast<char>(idx >> 8));
+        _out->sputc(static_cast<char>(idx));
+        return;
     }
 
-    if (_dictionary.size() <= 0xffff)
+    if (_dictionary.size() < _maxDictionarySize)
     {
-        log_debug("add dictionary value \"" << value << "\" idx=" << _dictionary.size());
-        _dictionary.push_back(value);
+        unsigned idx = _dictionary.size();
+        log_debug("add dictionary value \"" << value << "\" idx=" << idx);
+        _dictionary.emplace(value, idx);
     }
 
     _out->sputn(value.data(), value.size());
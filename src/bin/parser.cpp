@@ -131,6 +131,12 @@ void Parser::begin(Deserializer& handler, bool resetDictionary)
         _mydictionary.clear();
 }
 
+void Parser::resetDictionary(unsigned maxSize)
+{
+    _dictionary->clear();
+    _maxDictionarySize = maxSize;
+}
+
 void Parser::finish()
 {
     _deserializer = 0;
@@ -847,7 +853,7 @@ bool Parser::advance(std::streambuf& in, bool atLeastOne)
                 }
 
                 if (_next == 0)
-                    _next = new Parser(_dictionary);
+                    _next = new Parser(_dictionary, _maxDictionarySize);
 
                 if (_deserializer)
                 {
@@ -940,7 +946,7 @@ bool Parser::advance(std::streambuf& in, bool atLeastOne)
                 }
 
                 if (_next == 0)
-                    _next = new Parser(_dictionary);
+                    _next = new Parser(_dictionary, _maxDictionarySize);
 
                 if (_deserializer)
                 {
@@ -1049,7 +1055,7 @@ bool Parser::processFloatBase(char ch, unsigned shift, unsigned expOffset)
 
 void Parser::dict(const std::string& value)
 {
-    if (value.empty())
+    if (value.empty() || _dictionary->size() >= _maxDictionarySize)
         return;
 
     for (unsigned idx = 0; idx < _dictionary->size(); ++idx)
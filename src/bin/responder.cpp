@@ -32,6 +32,8 @@
 #include <cxxtools/serviceprocedure.h>
 #include <cxxtools/remoteexception.h>
 #include <cxxtools/log.h>
+#include <algorithm>
+#include <stdexcept>
 
 log_define("cxxtools.bin.responder")
 
@@ -45,21 +47,25 @@ Responder::~Responder()
         _serviceRegistry.releaseProcedure(_proc);
 }
 
-void Responder::reply(IOStream& out)
+void Responder::reply(IOStream& out, IDecomposer* result, bool tagged, uint32_t requestId)
 {
     log_info("send reply");
 
+    replyTag(out, tagged, requestId);
+    replyDictionary(out);
     out << '\xc1';
     _formatter.begin(out.buffer());
-    _result->format(_formatter);
+    result->format(_formatter);
     _formatter.finish();
     out << '\xff';
 }
 
-void Responder::replyError(IOStream& out, const char* msg, int rc)
+void Responder::replyError(IOStream& out, const char* msg, int rc, bool tagged, uint32_t requestId)
 {
     log_info("send error \"" << msg << '"');
 
+    replyTag(out, tagged, requestId);
+    replyDictionary(out);
     out << '\xc2'
         << static_cast<char>(static_cast<uint32_t>(rc) >> 24)
         << static_cast<char>(static_cast<uint32_t>(rc) >> 16)
@@ -69,44 +75,76 @@ void Responder::replyError(IOStream& out, const char* msg, int rc)
         << '\0' << '\xff';
 }
 
+void Responder::replyTag(IOStream& out, bool tagged, uint32_t requestId)
+{
+    if (tagged)
+        out << '\xc4'
+            << static_cast<char>(requestId >> 24)
+            << static_cast<char>(requestId >> 16)
+            << static_cast<char>(requestId >> 8)
+            << static_cast<char>(requestId);
+}
+
+// The dictionary of the replies is started with the reply to the request,
+// which asked for it, and restarted when it is full.
+void Responder::replyDictionary(IOStream& out)
+{
+    if (!_restartDictionary
+        && (_formatter.sessionDictionary() == 0 || !_formatter.dictionaryFull()))
+        return;
+
+    log_debug("start dictionary with size " << _dictionarySize);
+    _formatter.sessionDictionary(_dictionarySize);
+    _restartDictionary = false;
+
+    out << '\xc5'
+        << static_cast<char>(_dictionarySize >> 8)
+        << static_cast<char>(_dictionarySize);
+}
+
+void Responder::requestDictionary(unsigned size)
+{
+    if (_dictionarySize == 0)
+    {
+        // the client asks for a dictionary
+        if (_maxDictionarySize == 0 || size == 0)
+        {
+            log_debug("dictionary declined");
+            return;
+        }
+
+        _dictionarySize = std::min(size, _maxDictionarySize);
+        _restartDictionary = true;
+    }
+    else
+    {
+        // the client starts or restarts its dictionary
+        if (size > _dictionarySize)
+            throw std::runtime_error("dictionary size exceeds negotiated size");
+
+        if (size > 0)
+            _deserializer.resetDictionary(size);
+        else
+            _deserializer.resetDictionary();
+
+        _requestDictionary = size > 0;
+    }
+}
+
 bool Responder::onInput(IOStream& ios)
 {
     while (ios.buffer().in_avail() > 0)
     {
         if (advance(ios.buffer()))
         {
-            if (_failed)
+            if (!_failed && _proc->isAsync())
             {
-                replyError(ios, _errorMessage.c_str(), 0);
-            }
-            else
-            {
-                try
-                {
-                    _result = _proc->endCall();
-                    reply(ios);
-                }
-                catch (const RemoteException& e)
-                {
-                    ios.buffer().discard();
-                    replyError(ios, e.what(), e.rc());
-                }
-                catch (const std::exception& e)
-                {
-                    ios.buffer().discard();
-                    replyError(ios, e.what(), 0);
-                }
+                log_debug("asynchronous procedure called");
+                _asyncPending = true;
+                return false;
             }
 
-            _serviceRegistry.releaseProcedure(_proc);
-            _proc = 0;
-            _args = 0;
-            _result = 0;
-            _state = state_0;
-            _failed = false;
-            _errorMessage.clear();
-            _deserializer.begin();
-
+            finishCall(ios);
             return true;
         }
     }
@@ -114,6 +152,77 @@ bool Responder::onInput(IOStream& ios)
     return false;
 }
 
+void Responder::finishCall(IOStream& ios)
+{
+    if (_failed)
+        replyError(ios, _errorMessage.c_str(), 0, _tagged, _requestId);
+    else
+        sendResult(ios, _proc, _tagged, _requestId);
+
+    _serviceRegistry.releaseProcedure(_proc);
+    nextRequest();
+}
+
+std::shared_ptr<AsyncCall> Responder::detachCall(Socket* socket)
+{
+    log_debug("detach asynchronous call " << _requestId);
+
+    std::shared_ptr<AsyncCall> call = std::make_shared<AsyncCall>();
+    call->proc = _proc;
+    call->tagged = _tagged;
+    call->requestId = _requestId;
+    call->socket = socket;
+    call->finished = false;
+
+    nextRequest();
+
+    return call;
+}
+
+void Responder::finishCall(IOStream& ios, AsyncCall& call)
+{
+    sendResult(ios, call.proc, call.tagged, call.requestId);
+    _serviceRegistry.releaseProcedure(call.proc);
+    call.proc = 0;
+}
+
+void Responder::sendResult(IOStream& ios, ServiceProcedure* proc, bool tagged, uint32_t requestId)
+{
+    // replies of previous requests may still be in the output buffer
+    std::streamsize keep = ios.buffer().out_avail();
+
+    try
+    {
+        IDecomposer* result = proc->endCall();
+        reply(ios, result, tagged, requestId);
+    }
+    catch (const RemoteException& e)
+    {
+        ios.buffer().discardOutput(keep);
+        _restartDictionary = _dictionarySize > 0;
+        replyError(ios, e.what(), e.rc(), tagged, requestId);
+    }
+    catch (const std::exception& e)
+    {
+        ios.buffer().discardOutput(keep);
+        _restartDictionary = _dictionarySize > 0;
+        replyError(ios, e.what(), 0, tagged, requestId);
+    }
+}
+
+void Responder::nextRequest()
+{
+    _proc = 0;
+    _args = 0;
+    _state = state_0;
+    _failed = false;
+    _errorMessage.clear();
+    _asyncPending = false;
+    _tagged = false;
+    _requestId = 0;
+    _deserializer.begin(!_requestDictionary);
+}
+
 bool Responder::advance(std::streambuf& in)
 {
     std::streambuf::int_type chi;
@@ -125,15 +234,54 @@ bool Responder::advance(std::streambuf& in)
             case state_0:
                 log_debug("new rpc request");
 
+                if (ch == '\xc4')
+                {
+                    _tagged = true;
+                    _requestId = 0;
+                    _idCount = 4;
+                    _state = state_id;
+                    in.sbumpc();
+                    break;
+                }
+
+                // fall through
+
+            case state_request:
                 if (ch == '\xc0')
                     _state = state_method;
                 else if (ch == '\xc3')
                     _state = state_domain;
+                else if (ch == '\xc5')
+                    _state = state_dictionary0;
                 else
                     throw std::runtime_error("domain or method name expected");
                 in.sbumpc();
                 break;
 
+            case state_dictionary0:
+                _dictionaryValue = static_cast<unsigned char>(ch) << 8;
+                _state = state_dictionary1;
+                in.sbumpc();
+                break;
+
+            case state_dictionary1:
+                _dictionaryValue |= static_cast<unsigned char>(ch);
+                log_debug("dictionary size " << _dictionaryValue);
+                requestDictionary(_dictionaryValue);
+                _state = state_request;
+                in.sbumpc();
+                break;
+
+            case state_id:
+                _requestId = (_requestId << 8) | static_cast<unsigned char>(ch);
+                if (--_idCount == 0)
+                {
+                    log_debug("request id " << _requestId);
+                    _state = state_request;
+                }
+                in.sbumpc();
+                break;
+
             case state_domain:
                 if (ch == '\0')
                 {
@@ -35,6 +35,8 @@
 #include <cxxtools/serviceregistry.h>
 
 #include <iosfwd>
+#include <memory>
+#include <stdint.h>
 
 namespace cxxtools
 {
@@ -48,6 +50,19 @@ namespace bin
 class RpcServerImpl;
 class Socket;
 
+// A request for an asynchronous procedure. It runs while the connection
+// reads further requests and the reply is sent, when it has finished.
+// socket and finished are guarded by the mutex of the asynchronous calls
+// in the server.
+struct AsyncCall
+{
+    ServiceProcedure* proc;
+    bool tagged;
+    uint32_t requestId;
+    Socket* socket;     // 0, when the connection is closed
+    bool finished;
+};
+
 class Responder
 {
         friend class Socket;
@@ -55,6 +70,10 @@ class Responder
         enum State
         {
             state_0,
+            state_id,
+            state_request,
+            state_dictionary0,
+            state_dictionary1,
             state_domain,
             state_method,
             state_params,
@@ -64,22 +83,42 @@ class Responder
         };
 
     public:
-        explicit Responder(ServiceRegistry& serviceRegistry)
+        Responder(ServiceRegistry& serviceRegistry, unsigned maxDictionarySize)
             : _serviceRegistry(serviceRegistry),
               _state(state_0),
               _proc(0),
               _args(0),
-              _result(0),
-              _failed(false)
+              _failed(false),
+              _asyncPending(false),
+              _tagged(false),
+              _requestId(0),
+              _idCount(0),
+              _maxDictionarySize(maxDictionarySize),
+              _dictionarySize(0),
+              _dictionaryValue(0),
+              _requestDictionary(false),
+              _restartDictionary(false)
         { }
 
         ~Responder();
 
         // returns true, if request is ready and reply is put to the socket
         bool onInput(IOStream& ios);
+
+        // true, when a request for an asynchronous procedure is read; it is
+        // detached with detachCall and the reply is sent with finishCall
+        // after the procedure finished
+        bool asyncPending() const
+        { return _asyncPending; }
+
+        void finishCall(IOStream& ios);
+
+        std::shared_ptr<AsyncCall> detachCall(Socket* socket);
+        void finishCall(IOStream& ios, AsyncCall& call);
+
         bool advance(std::streambuf& in);
-        void reply(IOStream& out);
-        void replyError(IOStream& out, const char* msg, int rc);
+        void reply(IOStream& out, IDecomposer* result, bool tagged, uint32_t requestId);
+        void replyError(IOStream& out, const char* msg, int rc, bool tagged, uint32_t requestId);
 
     private:
         ServiceRegistry& _serviceRegistry;
@@ -90,11 +129,30 @@ class Responder
 
         ServiceProcedure* _proc;
         IComposer** _args;
-        IDecomposer* _result;
         Formatter _formatter;
 
         bool _failed;
         std::string _errorMessage;
+        bool _asyncPending;
+
+        // request id of multiplexed requests, which is sent back in the reply
+        bool _tagged;
+        uint32_t _requestId;
+        unsigned _idCount;
+
+        // connection level dictionary; the size is 0 until the client asks
+        // for a dictionary and the server accepts
+        unsigned _maxDictionarySize;
+        unsigned _dictionarySize;
+        unsigned _dictionaryValue;
+        bool _requestDictionary;
+        bool _restartDictionary;  // the next reply starts a new dictionary
+
+        void replyTag(IOStream& out, bool tagged, uint32_t requestId);
+        void replyDictionary(IOStream& out);
+        void requestDictionary(unsigned size);
+        void sendResult(IOStream& ios, ServiceProcedure* proc, bool tagged, uint32_t requestId);
+        void nextRequest();
 };
 }
 }
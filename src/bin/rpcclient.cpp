@@ -174,6 +174,12 @@ void RpcClient::cancel()
         _impl->cancel();
 }
 
+void RpcClient::cancelCall(IRemoteProcedure& method)
+{
+    if (_impl)
+        _impl->cancelCall(method);
+}
+
 void RpcClient::wait(Milliseconds msecs)
 {
     _impl->wait(msecs);
@@ -189,6 +195,16 @@ void RpcClient::domain(const std::string& p)
     getImpl()->domain(p);
 }
 
+unsigned RpcClient::dictionarySize() const
+{
+    return getImpl()->dictionarySize();
+}
+
+void RpcClient::dictionarySize(unsigned n)
+{
+    getImpl()->dictionarySize(n);
+}
+
 Delegate<bool, const SslCertificate&>& RpcClient::acceptSslCertificate()
 {
     return getImpl()->socket().acceptSslCertificate;
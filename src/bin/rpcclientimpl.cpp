@@ -33,6 +33,7 @@
 #include <cxxtools/selector.h>
 #include <cxxtools/clock.h>
 #include <cxxtools/resetter.h>
+#include <cxxtools/remoteexception.h>
 #include <stdexcept>
 
 log_define("cxxtools.bin.rpcclient.impl")
@@ -42,10 +43,28 @@ namespace cxxtools
 namespace bin
 {
 
+namespace
+{
+    // receives replies of cancelled calls
+    class IgnoreComposer : public IComposer
+    {
+        public:
+            void fixup(const SerializationInfo&)  { }
+    };
+
+    IgnoreComposer ignoreComposer;
+}
+
 RpcClientImpl::RpcClientImpl()
     : _stream(_socket, 8192, true),
       _exceptionPending(false),
-      _proc(0),
+      _nextId(0),
+      _replyState(reply_0),
+      _replyId(0),
+      _replyIdCount(0),
+      _connecting(false),
+      _dictionarySize(0),
+      _dictionaryState(dictionary_none),
       _timeout(Selectable::WaitInfinite),
       _connectTimeoutSet(false),
       _connectTimeout(Selectable::WaitInfinite)
@@ -60,6 +79,7 @@ void RpcClientImpl::connect()
 {
     _socket.setTimeout(_connectTimeout);
     _socket.close();
+    resetDictionary();
     _socket.connect(_addrInfo);
     if (_sslCtx.enabled())
         _socket.sslConnect(_sslCtx);
@@ -68,6 +88,7 @@ void RpcClientImpl::connect()
 void RpcClientImpl::close()
 {
     _socket.close();
+    resetDictionary();
 }
 
 void RpcClientImpl::beginCall(IComposer& r, IRemoteProcedure& method, IDecomposer** argv, unsigned argc)
@@ -75,16 +96,29 @@ void RpcClientImpl::beginCall(IComposer& r, IRemoteProcedure& method, IDecompose
     if (_socket.selector() == 0)
         throw std::logic_error("cannot run async rpc request without a selector");
 
-    if (_proc)
-        throw std::logic_error("asyncronous request already running");
+    // The procedure may be started again e.g. after a timeout. The reply to
+    // the previous call is ignored then.
+    if (findCall(method) != _calls.end())
+        cancelCall(method);
 
-    _proc = &method;
+    uint32_t id = nextRequestId();
+    log_debug("begin call " << id);
 
-    prepareRequest(method.name(), argv, argc);
+    _calls.insert(Calls::value_type(id, Call(&method, &r)));
 
     try
     {
-        if (_socket.isConnected())
+        // a new connection starts without dictionary
+        if (!_connecting && !_socket.isConnected())
+            resetDictionary();
+
+        prepareRequest(method.name(), argv, argc, id);
+
+        if (_connecting)
+        {
+            log_debug("request is sent when connected");
+        }
+        else if (_socket.isConnected())
         {
             try
             {
@@ -92,38 +126,39 @@ void RpcClientImpl::beginCall(IComposer& r, IRemoteProcedure& method, IDecompose
             }
             catch (const IOError&)
             {
+                // other running calls will not get their replies any more
+                if (_calls.size() > 1)
+                    throw;
+
                 log_debug("write failed, connection is not active any more");
+
+                // the request may refer to the dictionary of the old connection
+                if (_dictionarySize > 0)
+                {
+                    _stream.buffer().discardOutput();
+                    resetDictionary();
+                    prepareRequest(method.name(), argv, argc, id);
+                }
+
+                _connecting = true;
                 _socket.beginConnect(_addrInfo);
             }
         }
         else
         {
             log_debug("not yet connected - do it now");
+            _connecting = true;
             _socket.beginConnect(_addrInfo);
         }
     }
     catch (const std::exception& )
     {
-        IRemoteProcedure* proc = _proc;
-        cancel();
-
-        _exceptionPending = true;
-        Resetter<bool> exceptionPending(_exceptionPending, false);
-
-        proc->onFinished();
-
-        if (_exceptionPending)
-            throw;
+        failCalls();
     }
-
-    _scanner.begin(_deserializer, r);
 }
 
 void RpcClientImpl::endCall()
 {
-    _proc = 0;
-    _formatter.finish();
-
     if (_exceptionPending)
     {
         _exceptionPending = false;
@@ -133,9 +168,12 @@ void RpcClientImpl::endCall()
 
 void RpcClientImpl::call(IComposer& r, IRemoteProcedure& method, IDecomposer** argv, unsigned argc)
 {
+    if (!_calls.empty())
+        throw std::logic_error("asyncronous request already running");
+
     try
     {
-        _proc = &method;
+        _calls.insert(Calls::value_type(0, Call(&method, &r)));
         StreamBuffer& sb = _stream.buffer();
 
         if (_socket.isConnected())
@@ -144,7 +182,7 @@ void RpcClientImpl::call(IComposer& r, IRemoteProcedure& method, IDecomposer** a
 
             try
             {
-                prepareRequest(_proc->name(), argv, argc);
+                prepareRequest(method.name(), argv, argc);
                 _socket.setTimeout(timeout());
                 sb.pubsync();
 
@@ -173,7 +211,8 @@ void RpcClientImpl::call(IComposer& r, IRemoteProcedure& method, IDecomposer** a
             if (_sslCtx.enabled())
                 _socket.sslConnect(_sslCtx);
 
-            prepareRequest(_proc->name(), argv, argc);
+            resetDictionary();
+            prepareRequest(method.name(), argv, argc);
             _socket.setTimeout(timeout());
             sb.pubsync();
         }
@@ -190,7 +229,7 @@ void RpcClientImpl::call(IComposer& r, IRemoteProcedure& method, IDecomposer** a
 
             if (_scanner.advance(sb))
             {
-                _proc = 0;
+                _calls.clear();
                 _scanner.finish();
                 break;
             }
@@ -198,7 +237,7 @@ void RpcClientImpl::call(IComposer& r, IRemoteProcedure& method, IDecomposer** a
     }
     catch (const RemoteException&)
     {
-        _proc = 0;
+        _calls.clear();
         throw;
     }
     catch (const std::exception& e)
@@ -213,8 +252,26 @@ void RpcClientImpl::cancel()
     _socket.close();
     _stream.clear();
     _stream.buffer().discard();
-    _proc = 0;
+    _calls.clear();
+    _replyState = reply_0;
+    _connecting = false;
     _exceptionPending = false;
+    resetDictionary();
+}
+
+void RpcClientImpl::cancelCall(IRemoteProcedure& method)
+{
+    Calls::iterator it = findCall(method);
+    if (it == _calls.end())
+        return;
+
+    log_debug("cancel call " << it->first);
+
+    // the reply may be just received
+    if (_replyState == reply_body && _replyId == it->first)
+        _scanner.composer(ignoreComposer);
+
+    _calls.erase(it);
 }
 
 void RpcClientImpl::wait(Timespan timeout)
@@ -242,9 +299,44 @@ void RpcClientImpl::wait(Timespan timeout)
     }
 }
 
-void RpcClientImpl::prepareRequest(const String& name, IDecomposer** argv, unsigned argc)
+RpcClientImpl::Calls::iterator RpcClientImpl::findCall(const IRemoteProcedure& method)
+{
+    Calls::iterator it;
+    for (it = _calls.begin(); it != _calls.end(); ++it)
+        if (it->second.proc == &method)
+            break;
+    return it;
+}
+
+uint32_t RpcClientImpl::nextRequestId()
+{
+    // Id 0 is sent without tag, so that a single call can be processed by
+    // servers, which do not know request ids.
+    if (_calls.find(0) == _calls.end())
+        return 0;
+
+    do
+    {
+        ++_nextId;
+    } while (_nextId == 0 || _calls.find(_nextId) != _calls.end());
+
+    return _nextId;
+}
+
+void RpcClientImpl::prepareRequest(const String& name, IDecomposer** argv, unsigned argc, uint32_t id)
 {
     _formatter.begin(_stream.buffer());
+
+    if (id != 0)
+        _stream << '\xc4'
+                << static_cast<char>(id >> 24)
+                << static_cast<char>(id >> 16)
+                << static_cast<char>(id >> 8)
+                << static_cast<char>(id);
+
+    if (_dictionarySize > 0)
+        prepareDictionary();
+
     if (_domain.empty())
         _stream << '\xc0' << name << '\0';
     else
@@ -256,6 +348,179 @@ void RpcClientImpl::prepareRequest(const String& name, IDecomposer** argv, unsig
     }
 
     _stream << '\xff';
+
+    _formatter.finish();
+}
+
+// The client asks for a dictionary with the marker '\xc5' and the maximum size
+// in the first request of a connection. The server accepts with a marker and
+// the negotiated size in a reply and uses its dictionary from there on. The
+// next request repeats the marker, when the client starts using its own. Each
+// side repeats the marker to restart its dictionary, when it is full.
+void RpcClientImpl::prepareDictionary()
+{
+    unsigned size = 0;
+
+    switch (_dictionaryState)
+    {
+        case dictionary_none:
+            size = _dictionarySize;
+            _dictionaryState = dictionary_requested;
+            break;
+
+        case dictionary_requested:
+            size = _scanner.dictionarySize();
+            if (size == 0)
+                return;
+
+            log_debug("server accepted dictionary size " << size);
+            _formatter.sessionDictionary(size);
+            _dictionaryState = dictionary_active;
+            break;
+
+        case dictionary_active:
+            if (!_formatter.dictionaryFull())
+                return;
+
+            log_debug("restart full dictionary");
+            size = _formatter.sessionDictionary();
+            _formatter.resetDictionary();
+            break;
+    }
+
+    _stream << '\xc5'
+            << static_cast<char>(size >> 8)
+            << static_cast<char>(size);
+}
+
+void RpcClientImpl::resetDictionary()
+{
+    _dictionaryState = dictionary_none;
+    _formatter.sessionDictionary(0);
+    _scanner.resetDictionary();
+}
+
+bool RpcClientImpl::advanceReply(std::streambuf& in)
+{
+    while (in.in_avail() > 0)
+    {
+        switch (_replyState)
+        {
+            case reply_0:
+                if (in.sgetc() == std::streambuf::traits_type::to_int_type('\xc4'))
+                {
+                    in.sbumpc();
+                    _replyId = 0;
+                    _replyIdCount = 4;
+                    _replyState = reply_id;
+                }
+                else
+                    beginReply(0);
+                break;
+
+            case reply_id:
+                _replyId = (_replyId << 8) | static_cast<unsigned char>(in.sbumpc());
+                if (--_replyIdCount == 0)
+                    beginReply(_replyId);
+                break;
+
+            case reply_body:
+                if (_scanner.advance(in))
+                {
+                    _replyState = reply_0;
+                    return true;
+                }
+                break;
+        }
+    }
+
+    return false;
+}
+
+void RpcClientImpl::beginReply(uint32_t id)
+{
+    log_debug("reply to call " << id);
+
+    _replyId = id;
+    _replyState = reply_body;
+
+    Calls::iterator it = _calls.find(id);
+    _scanner.begin(_deserializer, it == _calls.end() ? ignoreComposer : *it->second.composer);
+}
+
+void RpcClientImpl::finishReply()
+{
+    Calls::iterator it = _calls.find(_replyId);
+    if (it == _calls.end())
+    {
+        log_debug("ignore reply to cancelled call " << _replyId);
+        try
+        {
+            _scanner.finish();
+        }
+        catch (const RemoteException&)
+        {
+        }
+
+        return;
+    }
+
+    IRemoteProcedure* proc = it->second.proc;
+    _calls.erase(it);
+
+    // A fault reported by the server finishes just this call. The connection
+    // stays usable for the other calls.
+    try
+    {
+        _scanner.finish();
+    }
+    catch (const RemoteException& e)
+    {
+        proc->setFault(e.rc(), e.text());
+    }
+
+    proc->onFinished();
+}
+
+// Passes the exception, which is currently handled, to all running calls.
+// It is rethrown when no callback fetched the result.
+void RpcClientImpl::failCalls()
+{
+    Calls calls;
+    calls.swap(_calls);
+    cancel();
+
+    if (calls.empty())
+        throw;
+
+    // Calls, which are not notified since a callback throws, report a fault.
+    std::string msg;
+    try
+    {
+        throw;
+    }
+    catch (const std::exception& e)
+    {
+        msg = e.what();
+    }
+
+    for (Calls::iterator it = calls.begin(); it != calls.end(); ++it)
+        it->second.proc->setFault(0, msg);
+
+    bool unhandled = false;
+    for (Calls::iterator it = calls.begin(); it != calls.end(); ++it)
+    {
+        _exceptionPending = true;
+        Resetter<bool> exceptionPending(_exceptionPending, false);
+
+        it->second.proc->onFinished();
+
+        if (_exceptionPending)
+            unhandled = true;
+    }
+
+    if (unhandled)
+        throw;
 }
 
 void RpcClientImpl::onConnect(net::TcpSocket& socket)
@@ -273,23 +538,12 @@ void RpcClientImpl::onConnect(net::TcpSocket& socket)
             return;
         }
 
+        _connecting = false;
         _stream.buffer().beginWrite();
     }
     catch (const std::exception& )
     {
-        IRemoteProcedure* proc = _proc;
-        cancel();
-
-        if (!proc)
-            throw;
-
-        _exceptionPending = true;
-        Resetter<bool> exceptionPending(_exceptionPending, false);
-
-        proc->onFinished();
-
-        if (_exceptionPending)
-            throw;
+        failCalls();
     }
 }
 
@@ -302,23 +556,12 @@ void RpcClientImpl::onSslConnect(net::TcpSocket& socket)
         _exceptionPending = false;
         socket.endSslConnect();
 
+        _connecting = false;
         _stream.buffer().beginWrite();
     }
     catch (const std::exception& )
     {
-        IRemoteProcedure* proc = _proc;
-        cancel();
-
-        if (!proc)
-            throw;
-
-        _exceptionPending = true;
-        Resetter<bool> exceptionPending(_exceptionPending, false);
-
-        proc->onFinished();
-
-        if (_exceptionPending)
-            throw;
+        failCalls();
     }
 }
 
@@ -330,24 +573,15 @@ void RpcClientImpl::onOutput(StreamBuffer& sb)
         sb.endWrite();
         if (sb.out_avail() > 0)
             sb.beginWrite();
-        else
+
+        // Replies are read while further requests are sent, so that the
+        // server does not block on a full connection.
+        if (!_calls.empty())
             sb.beginRead();
     }
     catch (const std::exception&)
     {
-        IRemoteProcedure* proc = _proc;
-        cancel();
-
-        if (!proc)
-            throw;
-
-        _exceptionPending = true;
-        Resetter<bool> exceptionPending(_exceptionPending, false);
-
-        proc->onFinished();
-
-        if (_exceptionPending)
-            throw;
+        failCalls();
     }
 }
 
@@ -361,13 +595,13 @@ void RpcClientImpl::onInput(StreamBuffer& sb)
         if (sb.device()->eof())
             throw IOError("end of input");
 
-        if (_scanner.advance(sb))
+        while (advanceReply(sb))
         {
-            _scanner.finish();
-            IRemoteProcedure* proc = _proc;
-            _proc = 0;
-            proc->onFinished();
-            return;
+            finishReply();
+
+            // the callback may have cancelled the connection
+            if (!_socket.isConnected())
+                return;
         }
 
         if (!_stream)
@@ -376,23 +610,12 @@ void RpcClientImpl::onInput(StreamBuffer& sb)
             throw std::runtime_error("reading result failed");
         }
 
-        sb.beginRead();
+        if (!_calls.empty() || _replyState != reply_0)
+            sb.beginRead();
     }
     catch (const std::exception&)
     {
-        IRemoteProcedure* proc = _proc;
-        cancel();
-
-        if (!proc)
-            throw;
-
-        _exceptionPending = true;
-        Resetter<bool> exceptionPending(_exceptionPending, false);
-
-        proc->onFinished();
-
-        if (_exceptionPending)
-            throw;
+        failCalls();
     }
 }
 
@@ -40,6 +40,8 @@
 #include <cxxtools/timespan.h>
 #include <cxxtools/sslctx.h>
 #include <string>
+#include <map>
+#include <stdint.h>
 #include "scanner.h"
 
 namespace cxxtools
@@ -69,6 +71,7 @@ class RpcClientImpl : public RefCounted, public Connectable
         {
             _addrInfo = addrinfo;
             _socket.close();
+            resetDictionary();
             _sslCtx = sslCtx;
         }
 
@@ -89,10 +92,12 @@ class RpcClientImpl : public RefCounted, public Connectable
         void connectTimeout(Timespan t)  { _connectTimeout = t; _connectTimeoutSet = true; }
 
         const IRemoteProcedure* activeProcedure() const
-        { return _proc; }
+        { return _calls.empty() ? 0 : _calls.begin()->second.proc; }
 
         void cancel();
 
+        void cancelCall(IRemoteProcedure& method);
+
         void wait(Timespan msecs);
 
         const std::string& domain() const
@@ -101,8 +106,37 @@ class RpcClientImpl : public RefCounted, public Connectable
         void domain(const std::string& p)
         { _domain = p; }
 
+        unsigned dictionarySize() const
+        { return _dictionarySize; }
+
+        void dictionarySize(unsigned n)
+        { _dictionarySize = n < 0xffff ? n : 0xffff; }
+
     private:
-        void prepareRequest(const String& name, IDecomposer** argv, unsigned argc);
+        struct Call
+        {
+            IRemoteProcedure* proc;
+            IComposer* composer;
+
+            Call(IRemoteProcedure* proc_, IComposer* composer_)
+                : proc(proc_),
+                  composer(composer_)
+                { }
+        };
+
+        // running calls by request id; id 0 is sent without a tag
+        typedef std::map<uint32_t, Call> Calls;
+
+        Calls::iterator findCall(const IRemoteProcedure& method);
+        uint32_t nextRequestId();
+        bool advanceReply(std::streambuf& in);
+        void beginReply(uint32_t id);
+        void finishReply();
+        void failCalls();
+
+        void prepareRequest(const String& name, IDecomposer** argv, unsigned argc, uint32_t id = 0);
+        void prepareDictionary();
+        void resetDictionary();
         void onConnect(net::TcpSocket& socket);
         void onSslConnect(net::TcpSocket& socket);
         void onOutput(StreamBuffer& sb);
@@ -122,7 +156,27 @@ class RpcClientImpl : public RefCounted, public Connectable
         Formatter _formatter;
 
         bool _exceptionPending;
-        IRemoteProcedure* _proc;
+        Calls _calls;
+        uint32_t _nextId;
+
+        enum
+        {
+            reply_0,
+            reply_id,
+            reply_body
+        } _replyState;
+        uint32_t _replyId;
+        unsigned _replyIdCount;
+        bool _connecting;
+
+        // connection level dictionary
+        unsigned _dictionarySize;
+        enum
+        {
+            dictionary_none,
+            dictionary_requested,
+            dictionary_active
+        } _dictionaryState;
 
         Timespan _timeout;
         bool _connectTimeoutSet;  // indicates if connectTimeout is explicitely set
@@ -109,6 +109,26 @@ void RpcServer::maxThreads(unsigned m)
     _impl->maxThreads(m);
 }
 
+unsigned RpcServer::eventLoops() const
+{
+    return _impl->eventLoops();
+}
+
+void RpcServer::eventLoops(unsigned n)
+{
+    _impl->eventLoops(n);
+}
+
+unsigned RpcServer::dictionarySize() const
+{
+    return _impl->dictionarySize();
+}
+
+void RpcServer::dictionarySize(unsigned n)
+{
+    _impl->dictionarySize(n);
+}
+
 Delegate<bool, const SslCertificate&>& RpcServer::acceptSslCertificate()
 {
     return _impl->acceptSslCertificate;
@@ -46,13 +46,34 @@ namespace bin
 class IdleSocketEvent : public BasicEvent<IdleSocketEvent>
 {
         Socket* _socket;
+        unsigned _loop;
 
     public:
-        explicit IdleSocketEvent(Socket* socket)
-            : _socket(socket)
+        IdleSocketEvent(Socket* socket, unsigned loop)
+            : _socket(socket),
+              _loop(loop)
             { }
 
         Socket* socket() const   { return _socket; }
+        unsigned loop() const    { return _loop; }
+
+};
+
+// Sent, when an asynchronous procedure of a socket in the event loop has
+// finished. The server takes that socket to a worker, which sends the reply.
+class ActiveSocketEvent : public BasicEvent<ActiveSocketEvent>
+{
+        Socket* _socket;
+        unsigned _loop;
+
+    public:
+        ActiveSocketEvent(Socket* socket, unsigned loop)
+            : _socket(socket),
+              _loop(loop)
+            { }
+
+        Socket* socket() const   { return _socket; }
+        unsigned loop() const    { return _loop; }
 
 };
 
@@ -99,9 +120,14 @@ RpcServerImpl::RpcServerImpl(EventLoopBase& eventLoop, Signal<RpcServer::Runmode
       inputSlot(slot(*this, &RpcServerImpl::onInput)),
       _serviceRegistry(serviceRegistry),
       _minThreads(5),
-      _maxThreads(200)
+      _maxThreads(200),
+      _eventLoops(0),
+      _dictionarySize(1024),
+      _queue(1024, true),
+      _idleSocket(1)
 {
     _eventLoop.event.subscribe(slot(*this, &RpcServerImpl::onIdleSocket));
+    _eventLoop.event.subscribe(slot(*this, &RpcServerImpl::onActiveSocket));
     _eventLoop.event.subscribe(slot(*this, &RpcServerImpl::onNoWaitingThreads));
     _eventLoop.event.subscribe(slot(*this, &RpcServerImpl::onThreadTerminated));
     _eventLoop.event.subscribe(slot(*this, &RpcServerImpl::onServerStart));
@@ -135,6 +161,24 @@ void RpcServerImpl::start()
     log_trace("start server");
     runmode(RpcServer::Starting);
 
+    if (eventLoops() > 0)
+    {
+        log_debug("start " << eventLoops() << " event loops");
+
+        // loops kept from a previous start are already subscribed
+        unsigned subscribed = _loopGroup.size();
+        _loopGroup.resize(eventLoops());
+        _idleSocket.resize(eventLoops());
+
+        for (unsigned n = subscribed; n < _loopGroup.size(); ++n)
+        {
+            _loopGroup.loop(n).event.subscribe(slot(*this, &RpcServerImpl::onIdleSocket));
+            _loopGroup.loop(n).event.subscribe(slot(*this, &RpcServerImpl::onActiveSocket));
+        }
+
+        _loopGroup.start();
+    }
+
     std::lock_guard<std::mutex> lock(_threadMutex);
     while (_threads.size() < minThreads())
     {
@@ -189,6 +233,16 @@ void RpcServerImpl::terminate()
             delete th;
         }
 
+        if (_loopGroup.running())
+        {
+            log_debug("stop " << _loopGroup.size() << " event loops");
+            _loopGroup.stop();
+
+            // pending idle sockets are moved to the idle socket sets
+            for (unsigned n = 0; n < _loopGroup.size(); ++n)
+                _loopGroup.loop(n).processEvents();
+        }
+
         for (unsigned n = 0; n < _listener.size(); ++n)
             delete _listener[n];
         _listener.clear();
@@ -196,10 +250,13 @@ void RpcServerImpl::terminate()
         while (!_queue.empty())
             delete _queue.get();
 
-        for (IdleSocket::iterator it = _idleSocket.begin(); it != _idleSocket.end(); ++it)
-            delete *it;
+        for (unsigned n = 0; n < _idleSocket.size(); ++n)
+        {
+            for (IdleSocket::iterator it = _idleSocket[n].begin(); it != _idleSocket[n].end(); ++it)
+                delete *it;
 
-        _idleSocket.clear();
+            _idleSocket[n].clear();
+        }
 
         runmode(RpcServer::Stopped);
     }
@@ -238,7 +295,18 @@ void RpcServerImpl::addIdleSocket(Socket* socket)
 
     if (runmode() == RpcServer::Running)
     {
-        _eventLoop.commitEvent(IdleSocketEvent(socket));
+        std::lock_guard<std::mutex> lock(_asyncMutex);
+
+        if (socket->asyncReplies())
+        {
+            log_debug("asynchronous procedure of socket " << static_cast<void*>(socket) << " finished");
+            _queue.put(socket);
+            return;
+        }
+
+        unsigned n = _loopGroup.size() > 0 ? _loopGroup.nextIndex() : 0;
+        socket->idleLoop(n);
+        idleLoop(n).commitEvent(IdleSocketEvent(socket, n));
     }
     else
     {
@@ -247,17 +315,57 @@ void RpcServerImpl::addIdleSocket(Socket* socket)
     }
 }
 
+void RpcServerImpl::onAsyncCallFinished(const std::shared_ptr<AsyncCall>& call)
+{
+    // called from the thread, which passes the result to the procedure
+    std::lock_guard<std::mutex> lock(_asyncMutex);
+
+    Socket* socket = call->socket;
+    if (socket == 0)
+    {
+        log_debug("asynchronous procedure of closed connection finished");
+        return;
+    }
+
+    call->finished = true;
+    socket->asyncReplies(true);
+
+    // a socket, which has a worker, sends the reply there
+    if (socket->idleLoop() >= 0)
+    {
+        unsigned n = socket->idleLoop();
+        log_debug("asynchronous procedure of idle socket " << static_cast<void*>(socket) << " finished");
+        socket->idleLoop(-1);
+        idleLoop(n).commitEvent(ActiveSocketEvent(socket, n));
+    }
+}
+
 void RpcServerImpl::onIdleSocket(const IdleSocketEvent& event)
 {
     Socket* socket = event.socket();
 
-    log_debug("add idle socket " << static_cast<void*>(socket) << " to selector");
+    log_debug("add idle socket " << static_cast<void*>(socket) << " to selector " << event.loop());
 
-    _idleSocket.insert(socket);
-    socket->setSelector(&_eventLoop);
+    _idleSocket[event.loop()].insert(socket);
+    socket->setSelector(&idleLoop(event.loop()));
     socket->inputConnection = socket->inputReady.connect(inputSlot);
 }
 
+void RpcServerImpl::onActiveSocket(const ActiveSocketEvent& event)
+{
+    Socket* socket = event.socket();
+
+    // the socket may be taken from the loop by input already
+    if (_idleSocket[event.loop()].erase(socket) == 0)
+        return;
+
+    log_debug("take socket " << static_cast<void*>(socket) << " from selector " << event.loop());
+
+    socket->removeSelector();
+    socket->inputConnection.close();
+    _queue.put(socket);
+}
+
 void RpcServerImpl::onNoWaitingThreads(const NoWaitingThreadsEvent& /*event*/)
 {
     std::lock_guard<std::mutex> lock(_threadMutex);
@@ -307,6 +415,14 @@ void RpcServerImpl::onThreadTerminated(const ThreadTerminatedEvent& event)
     delete event.worker();
 }
 
+unsigned RpcServerImpl::idleLoopIndex(const SelectorBase* selector)
+{
+    for (unsigned n = 0; n < _loopGroup.size(); ++n)
+        if (&_loopGroup.loop(n) == selector)
+            return n;
+    return 0;
+}
+
 void RpcServerImpl::onServerStart(const ServerStartEvent& event)
 {
     if (event.server() == this)
@@ -317,9 +433,15 @@ void RpcServerImpl::onServerStart(const ServerStartEvent& event)
 
 void RpcServerImpl::onInput(Socket& socket)
 {
+    unsigned n = idleLoopIndex(socket.selector());
     socket.removeSelector();
     log_debug("search socket " << static_cast<void*>(&socket) << " in idle socket");
-    _idleSocket.erase(&socket);
+    _idleSocket[n].erase(&socket);
+
+    {
+        std::lock_guard<std::mutex> lock(_asyncMutex);
+        socket.idleLoop(-1);
+    }
 
     if (socket.isConnected())
     {
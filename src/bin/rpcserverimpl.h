@@ -31,13 +31,15 @@
 
 #include <cxxtools/bin/rpcserver.h>
 #include <cxxtools/event.h>
-#include <cxxtools/queue.h>
+#include <cxxtools/mpmcqueue.h>
 #include <cxxtools/signal.h>
 #include <cxxtools/delegate.h>
 #include <cxxtools/connectable.h>
+#include <cxxtools/eventloopgroup.h>
 
 #include <mutex>
 #include <condition_variable>
+#include <memory>
 #include <set>
 #include <vector>
 
@@ -45,6 +47,7 @@ namespace cxxtools
 {
 
 class EventLoopBase;
+class SelectorBase;
 class ServiceProcedure;
 class SslCtx;
 
@@ -63,6 +66,7 @@ namespace bin
     class NoWaitingThreadsEvent;
     class ThreadTerminatedEvent;
     class ActiveSocketEvent;
+    struct AsyncCall;
 
     class RpcServerImpl : public Connectable
     {
@@ -86,6 +90,18 @@ namespace bin
             void maxThreads(unsigned m)
             { _maxThreads = m; }
 
+            unsigned eventLoops() const
+            { return _eventLoops; }
+
+            void eventLoops(unsigned n)
+            { _eventLoops = n; }
+
+            unsigned dictionarySize() const
+            { return _dictionarySize; }
+
+            void dictionarySize(unsigned n)
+            { _dictionarySize = n < 0xffff ? n : 0xffff; }
+
             void terminate();
 
             RpcServer::Runmode runmode() const
@@ -104,11 +120,18 @@ namespace bin
             Signal<RpcServer::Runmode>& _runmodeChanged;
 
             EventLoopBase& _eventLoop;
+            EventLoopGroup _loopGroup;
+
+            EventLoopBase& idleLoop(unsigned n)
+            { return _loopGroup.size() == 0 ? _eventLoop : _loopGroup.loop(n); }
+
+            unsigned idleLoopIndex(const SelectorBase* selector);
 
             void noWaitingThreads();
             void onInput(Socket& _socket);
 
             void addIdleSocket(Socket* socket);
+            void onAsyncCallFinished(const std::shared_ptr<AsyncCall>& call);
             void onIdleSocket(const IdleSocketEvent& event);
             void onActiveSocket(const ActiveSocketEvent& event);
             void onNoWaitingThreads(const NoWaitingThreadsEvent& event);
@@ -126,12 +149,20 @@ namespace bin
             ServiceRegistry& _serviceRegistry;
             unsigned _minThreads;
             unsigned _maxThreads;
+            unsigned _eventLoops;
+            unsigned _dictionarySize;
 
             std::vector<net::TcpServer*> _listener;
-            Queue<Socket*> _queue;
+            // sockets ready for the workers; overflow enabled so that the
+            // event loop never blocks when putting sockets
+            MpmcQueue<Socket*> _queue;
 
             typedef std::set<Socket*> IdleSocket;
-            IdleSocket _idleSocket;
+            std::vector<IdleSocket> _idleSocket;
+
+            // guards the asynchronous calls of the sockets; sockets in the
+            // event loops are put to the queue, when a call finishes
+            std::mutex _asyncMutex;
 
             std::mutex _threadMutex;
             std::condition_variable _threadTerminated;
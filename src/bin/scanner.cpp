@@ -42,7 +42,7 @@ namespace bin
 
 void Scanner::begin(Deserializer& handler, IComposer& composer)
 {
-    _vp.begin(handler);
+    _vp.begin(handler, _dictionarySize == 0);
     _deserializer = &handler;
     _composer = &composer;
     _deserializer->begin();
@@ -72,12 +72,32 @@ bool Scanner::advance(std::streambuf& in)
                     _state = state_errorcode;
                     _count = 4;
                 }
+                else if (ch == '\xc5')
+                    _state = state_dictionary0;
                 else
                     throw std::runtime_error("response expected");
 
                 in.sbumpc();
                 break;
 
+            case state_dictionary0:
+                _count = static_cast<unsigned char>(ch) << 8;
+                _state = state_dictionary1;
+                in.sbumpc();
+                break;
+
+            case state_dictionary1:
+                // the server starts a new session dictionary with this reply
+                _dictionarySize = _count | static_cast<unsigned char>(ch);
+                log_debug("session dictionary size " << _dictionarySize);
+                if (_dictionarySize > 0)
+                    _vp.resetDictionary(_dictionarySize);
+                else
+                    _vp.resetDictionary();
+                _state = state_0;
+                in.sbumpc();
+                break;
+
             case state_value:
                 if (_vp.advance(in))
                 {
@@ -119,6 +139,12 @@ bool Scanner::advance(std::streambuf& in)
     return false;
 }
 
+void Scanner::resetDictionary()
+{
+    _dictionarySize = 0;
+    _vp.resetDictionary();
+}
+
 void Scanner::finish()
 {
     _vp.finish();
@@ -50,7 +50,8 @@ namespace cxxtools
                       _composer(0),
                       _count(0),
                       _failed(false),
-                      _errorCode(0)
+                      _errorCode(0),
+                      _dictionarySize(0)
                 { }
 
                 void begin(Deserializer& handler, IComposer& composer);
@@ -59,10 +60,24 @@ namespace cxxtools
 
                 void finish();
 
+                // replaces the composer, which receives the result
+                void composer(IComposer& composer)
+                { _composer = &composer; }
+
+                // returns the size of the session dictionary announced by the
+                // server or 0 if the replies are self contained
+                unsigned dictionarySize() const
+                { return _dictionarySize; }
+
+                // forgets the session dictionary e.g. after a reconnect
+                void resetDictionary();
+
             private:
                 enum
                 {
                     state_0,
+                    state_dictionary0,
+                    state_dictionary1,
                     state_value,
                     state_errorcode,
                     state_errormessage,
@@ -78,6 +93,7 @@ namespace cxxtools
                 bool _failed;
                 int _errorCode;
                 std::string _errorMessage;
+                unsigned _dictionarySize;
         };
     }
 }
@@ -29,6 +29,7 @@
 #include "socket.h"
 #include "rpcserverimpl.h"
 #include <cxxtools/log.h>
+#include <functional>
 
 log_define("cxxtools.bin.socket")
 
@@ -42,8 +43,10 @@ Socket::Socket(RpcServerImpl& rpcServerImpl, net::TcpServer& tcpServer, const Ss
       _rpcServerImpl(rpcServerImpl),
       _tcpServer(tcpServer),
       _sslCtx(sslCtx),
-      _responder(rpcServerImpl._serviceRegistry),
-      _accepted(false)
+      _responder(rpcServerImpl._serviceRegistry, rpcServerImpl.dictionarySize()),
+      _accepted(false),
+      _asyncReplies(false),
+      _idleLoop(-1)
 {
     _stream.attachDevice(*this);
     cxxtools::connect(IODevice::inputReady, *this, &Socket::onIODeviceInput);
@@ -58,8 +61,10 @@ Socket::Socket(Socket& socket)
       _rpcServerImpl(socket._rpcServerImpl),
       _tcpServer(socket._tcpServer),
       _sslCtx(socket._sslCtx),
-      _responder(_rpcServerImpl._serviceRegistry),
-      _accepted(false)
+      _responder(_rpcServerImpl._serviceRegistry, _rpcServerImpl.dictionarySize()),
+      _accepted(false),
+      _asyncReplies(false),
+      _idleLoop(-1)
 {
     _stream.attachDevice(*this);
     cxxtools::connect(IODevice::inputReady, *this, &Socket::onIODeviceInput);
@@ -67,6 +72,24 @@ Socket::Socket(Socket& socket)
     cxxtools::connect(acceptSslCertificate, *this, &Socket::onAcceptSslCertificate);
 }
 
+Socket::~Socket()
+{
+    // Calls, which finish later, must not access the socket any more. The
+    // procedures are released without the lock, since they may wait for the
+    // finish callback, which takes it.
+    std::vector<std::shared_ptr<AsyncCall> > calls;
+
+    {
+        std::lock_guard<std::mutex> lock(_rpcServerImpl._asyncMutex);
+        for (unsigned n = 0; n < _asyncCalls.size(); ++n)
+            _asyncCalls[n]->socket = 0;
+        calls.swap(_asyncCalls);
+    }
+
+    for (unsigned n = 0; n < calls.size(); ++n)
+        _rpcServerImpl._serviceRegistry.releaseProcedure(calls[n]->proc);
+}
+
 void Socket::accept()
 {
     log_debug("accept");
@@ -122,15 +145,85 @@ void Socket::onInput(StreamBuffer& sb)
         return;
     }
 
-    if (_responder.onInput(_stream))
+    processInput();
+}
+
+// All requests in the input buffer are processed at once. The replies are
+// collected in the output buffer, which is sent while reading goes on, so
+// that pipelined requests do not wait until the previous replies are sent.
+void Socket::processInput()
+{
+    StreamBuffer& sb = _stream.buffer();
+
+    bool reply = false;
+    while (true)
+    {
+        if (_responder.onInput(_stream))
+            reply = true;
+        else if (_responder.asyncPending())
+            startAsyncCall();
+        else
+            break;
+    }
+
+    if (reply)
     {
         sb.beginWrite();
-        onOutput(sb);
+        if (!onOutput(sb))
+            return;
+    }
+
+    sb.beginRead();
+
+    // procedures may finish immediately
+    sendAsyncReplies();
+}
+
+void Socket::startAsyncCall()
+{
+    std::shared_ptr<AsyncCall> call = _responder.detachCall(this);
+
+    {
+        std::lock_guard<std::mutex> lock(_rpcServerImpl._asyncMutex);
+        _asyncCalls.push_back(call);
     }
-    else
+
+    call->proc->startCall(std::bind(&RpcServerImpl::onAsyncCallFinished, &_rpcServerImpl, call));
+}
+
+bool Socket::sendAsyncReplies()
+{
+    std::vector<std::shared_ptr<AsyncCall> > finished;
+
     {
-        sb.beginRead();
+        std::lock_guard<std::mutex> lock(_rpcServerImpl._asyncMutex);
+        if (!_asyncReplies)
+            return false;
+
+        std::vector<std::shared_ptr<AsyncCall> >::iterator it = _asyncCalls.begin();
+        while (it != _asyncCalls.end())
+        {
+            if ((*it)->finished)
+            {
+                finished.push_back(*it);
+                it = _asyncCalls.erase(it);
+            }
+            else
+                ++it;
+        }
+
+        _asyncReplies = false;
     }
+
+    log_debug("send " << finished.size() << " replies of asynchronous procedures");
+
+    for (unsigned n = 0; n < finished.size(); ++n)
+        _responder.finishCall(_stream, *finished[n]);
+
+    buffer().beginWrite();
+    onOutput(buffer());
+
+    return true;
 }
 
 bool Socket::onOutput(StreamBuffer& sb)
@@ -144,16 +237,7 @@ bool Socket::onOutput(StreamBuffer& sb)
         sb.endWrite();
 
         if ( sb.out_avail() )
-        {
             sb.beginWrite();
-        }
-        else
-        {
-            if (sb.in_avail())
-                onInput(sb);
-            else
-                sb.beginRead();
-        }
     }
     catch (const std::exception& e)
     {
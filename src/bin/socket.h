@@ -36,6 +36,8 @@
 #include <cxxtools/method.h>
 #include <cxxtools/sslctx.h>
 #include "responder.h"
+#include <memory>
+#include <vector>
 
 namespace cxxtools
 {
@@ -48,6 +50,7 @@ class Socket : public net::TcpSocket, public Connectable
     public:
         Socket(RpcServerImpl& rpcServerImpl, net::TcpServer& tcpServer, const SslCtx& sslCtx);
         explicit Socket(Socket& socket);
+        ~Socket();
 
         void accept();
         void postAccept();
@@ -61,6 +64,19 @@ class Socket : public net::TcpSocket, public Connectable
         bool onOutput(StreamBuffer& sb);
         bool onAcceptSslCertificate(const SslCertificate& cert);
 
+        // Asynchronous procedures run, while further requests are read. When
+        // one of them has finished, the socket is taken from the idle loop
+        // and the worker sends the reply. Both are guarded by the mutex of
+        // the asynchronous calls in the server; the idle loop is -1, while a
+        // worker has the socket.
+        bool asyncReplies() const      { return _asyncReplies; }
+        void asyncReplies(bool r)      { _asyncReplies = r; }
+        int idleLoop() const           { return _idleLoop; }
+        void idleLoop(int n)           { _idleLoop = n; }
+
+        // returns false, when no asynchronous call has finished
+        bool sendAsyncReplies();
+
         Signal<Socket&> inputReady;
 
         StreamBuffer& buffer()         { return _stream.buffer(); }
@@ -81,6 +97,13 @@ class Socket : public net::TcpSocket, public Connectable
         int _sslVerifyLevel;
         std::string _sslCa;
         bool _accepted;
+
+        std::vector<std::shared_ptr<AsyncCall> > _asyncCalls;
+        bool _asyncReplies;
+        int _idleLoop;
+
+        void processInput();
+        void startAsyncCall();
 };
 
 }
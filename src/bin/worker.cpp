@@ -102,8 +102,13 @@ void Worker::run()
             }
             else if (socket->isConnected())
             {
-                log_debug("process available input from " << socket->getPeerAddr());
-                socket->onInput(socket->buffer());
+                // a socket taken from the idle loop for the replies of
+                // asynchronous procedures still waits for input
+                if (!socket->sendAsyncReplies())
+                {
+                    log_debug("process available input from " << socket->getPeerAddr());
+                    socket->onInput(socket->buffer());
+                }
             }
             else
             {
@@ -117,7 +122,7 @@ void Worker::run()
                 socket->inputSlot);
 
             while (socket->wait(10) && socket->isConnected())
-                ;
+                socket->sendAsyncReplies();
 
             if (socket->isConnected())
             {
@@ -31,6 +31,9 @@
 #include <limits>
 #include <cctype>
 #include <iterator>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 
 namespace cxxtools
 {
@@ -765,4 +768,542 @@ void convert(long double& n, const char* str)
 }
 
 
+//
+// Shortest float formatting and fast float parsing
+//
+
+namespace
+{
+    // Floating point number with a 64 bit significand: f * 2^e.
+    struct DiyFp
+    {
+        uint64_t f;
+        int e;
+
+        DiyFp(uint64_t f_, int e_)
+            : f(f_), e(e_)
+            { }
+    };
+
+    inline DiyFp operator- (DiyFp a, DiyFp b)
+    {
+        return DiyFp(a.f - b.f, a.e);
+    }
+
+    // multiplies and rounds the upper 64 bits of the 128 bit result
+    inline DiyFp operator* (DiyFp a, DiyFp b)
+    {
+        const uint64_t m32 = 0xffffffffu;
+
+        uint64_t a1 = a.f >> 32;
+        uint64_t a0 = a.f & m32;
+        uint64_t b1 = b.f >> 32;
+        uint64_t b0 = b.f & m32;
+
+        uint64_t p11 = a1 * b1;
+        uint64_t p10 = a1 * b0;
+        uint64_t p01 = a0 * b1;
+        uint64_t p00 = a0 * b0;
+
+        uint64_t tmp = (p00 >> 32) + (p10 & m32) + (p01 & m32) + (uint64_t(1) << 31);
+
+        return DiyFp(p11 + (p10 >> 32) + (p01 >> 32) + (tmp >> 32), a.e + b.e + 64);
+    }
+
+    inline DiyFp normalize(DiyFp x)
+    {
+        while ((x.f >> 56) == 0)
+        {
+            x.f <<= 8;
+            x.e -= 8;
+        }
+
+        while ((x.f >> 63) == 0)
+        {
+            x.f <<= 1;
+            --x.e;
+        }
+
+        return x;
+    }
+
+    // normalized approximations of 10^k = f * 2^e for k = -300, -292, ... 324
+    struct CachedPower
+    {
+        uint64_t f;
+        int e;
+        int k;
+    };
+
+    const CachedPower cachedPowers[] = {
+        { 0xab70fe17c79ac6caull, -1060, -300 },
+        { 0xff77b1fcbebcdc4full, -1034, -292 },
+        { 0xbe5691ef416bd60cull, -1007, -284 },
+        { 0x8dd01fad907ffc3cull,  -980, -276 },
+        { 0xd3515c2831559a83ull,  -954, -268 },
+        { 0x9d71ac8fada6c9b5ull,  -927, -260 },
+        { 0xea9c227723ee8bcbull,  -901, -252 },
+        { 0xaecc49914078536dull,  -874, -244 },
+        { 0x823c12795db6ce57ull,  -847, -236 },
+        { 0xc21094364dfb5637ull,  -821, -228 },
+        { 0x9096ea6f3848984full,  -794, -220 },
+        { 0xd77485cb25823ac7ull,  -768, -212 },
+        { 0xa086cfcd97bf97f4ull,  -741, -204 },
+        { 0xef340a98172aace5ull,  -715, -196 },
+        { 0xb23867fb2a35b28eull,  -688, -188 },
+        { 0x84c8d4dfd2c63f3bull,  -661, -180 },
+        { 0xc5dd44271ad3cdbaull,  -635, -172 },
+        { 0x936b9fcebb25c996ull,  -608, -164 },
+        { 0xdbac6c247d62a584ull,  -582, -156 },
+        { 0xa3ab66580d5fdaf6ull,  -555, -148 },
+        { 0xf3e2f893dec3f126ull,  -529, -140 },
+        { 0xb5b5ada8aaff80b8ull,  -502, -132 },
+        { 0x87625f056c7c4a8bull,  -475, -124 },
+        { 0xc9bcff6034c13053ull,  -449, -116 },
+        { 0x964e858c91ba2655ull,  -422, -108 },
+        { 0xdff9772470297ebdull,  -396, -100 },
+        { 0xa6dfbd9fb8e5b88full,  -369,  -92 },
+        { 0xf8a95fcf88747d94ull,  -343,  -84 },
+        { 0xb94470938fa89bcfull,  -316,  -76 },
+        { 0x8a08f0f8bf0f156bull,  -289,  -68 },
+        { 0xcdb02555653131b6ull,  -263,  -60 },
+        { 0x993fe2c6d07b7facull,  -236,  -52 },
+        { 0xe45c10c42a2b3b06ull,  -210,  -44 },
+        { 0xaa242499697392d3ull,  -183,  -36 },
+        { 0xfd87b5f28300ca0eull,  -157,  -28 },
+        { 0xbce5086492111aebull,  -130,  -20 },
+        { 0x8cbccc096f5088ccull,  -103,  -12 },
+        { 0xd1b71758e219652cull,   -77,   -4 },
+        { 0x9c40000000000000ull,   -50,    4 },
+        { 0xe8d4a51000000000ull,   -24,   12 },
+        { 0xad78ebc5ac620000ull,     3,   20 },
+        { 0x813f3978f8940984ull,    30,   28 },
+        { 0xc097ce7bc90715b3ull,    56,   36 },
+        { 0x8f7e32ce7bea5c70ull,    83,   44 },
+        { 0xd5d238a4abe98068ull,   109,   52 },
+        { 0x9f4f2726179a2245ull,   136,   60 },
+        { 0xed63a231d4c4fb27ull,   162,   68 },
+        { 0xb0de65388cc8ada8ull,   189,   76 },
+        { 0x83c7088e1aab65dbull,   216,   84 },
+        { 0xc45d1df942711d9aull,   242,   92 },
+        { 0x924d692ca61be758ull,   269,  100 },
+        { 0xda01ee641a708deaull,   295,  108 },
+        { 0xa26da3999aef774aull,   322,  116 },
+        { 0xf209787bb47d6b85ull,   348,  124 },
+        { 0xb454e4a179dd1877ull,   375,  132 },
+        { 0x865b86925b9bc5c2ull,   402,  140 },
+        { 0xc83553c5c8965d3dull,   428,  148 },
+        { 0x952ab45cfa97a0b3ull,   455,  156 },
+        { 0xde469fbd99a05fe3ull,   481,  164 },
+        { 0xa59bc234db398c25ull,   508,  172 },
+        { 0xf6c69a72a3989f5cull,   534,  180 },
+        { 0xb7dcbf5354e9beceull,   561,  188 },
+        { 0x88fcf317f22241e2ull,   588,  196 },
+        { 0xcc20ce9bd35c78a5ull,   614,  204 },
+        { 0x98165af37b2153dfull,   641,  212 },
+        { 0xe2a0b5dc971f303aull,   667,  220 },
+        { 0xa8d9d1535ce3b396ull,   694,  228 },
+        { 0xfb9b7cd9a4a7443cull,   720,  236 },
+        { 0xbb764c4ca7a44410ull,   747,  244 },
+        { 0x8bab8eefb6409c1aull,   774,  252 },
+        { 0xd01fef10a657842cull,   800,  260 },
+        { 0x9b10a4e5e9913129ull,   827,  268 },
+        { 0xe7109bfba19c0c9dull,   853,  276 },
+        { 0xac2820d9623bf429ull,   880,  284 },
+        { 0x80444b5e7aa7cf85ull,   907,  292 },
+        { 0xbf21e44003acdd2dull,   933,  300 },
+        { 0x8e679c2f5e44ff8full,   960,  308 },
+        { 0xd433179d9c8cb841ull,   986,  316 },
+        { 0x9e19db92b4e31ba9ull,  1013,  324 },
+    };
+
+    const int cachedPowersMinDecExp = -300;
+    const int cachedPowersDecStep = 8;
+
+    // Returns a cached power c with -60 <= e + c.e + 64 <= -32.
+    const CachedPower& cachedPowerForBinaryExponent(int e)
+    {
+        // k = ceil((alpha - e - 1) * log10(2)) with alpha = -60
+        const int f = -60 - e - 1;
+        const int k = (f * 78913) / (1 << 18) + (f > 0);
+        const int index = (-cachedPowersMinDecExp + k + (cachedPowersDecStep - 1)) / cachedPowersDecStep;
+        return cachedPowers[index];
+    }
+
+    // Moves the last digit towards w as long as it stays within the unsafe
+    // interval. Returns false, when the imprecision of the cached power
+    // does not allow to decide, whether the digits are the shortest and
+    // closest ones.
+    bool grisuRoundWeed(char* buffer, unsigned len, uint64_t distTooHighW,
+                        uint64_t unsafeInterval, uint64_t rest, uint64_t tenK, uint64_t unit)
+    {
+        uint64_t smallDist = distTooHighW - unit;
+        uint64_t bigDist = distTooHighW + unit;
+
+        while (rest < smallDist
+            && unsafeInterval - rest >= tenK
+            && (rest + tenK < smallDist || smallDist - rest >= rest + tenK - smallDist))
+        {
+            --buffer[len - 1];
+            rest += tenK;
+        }
+
+        if (rest < bigDist
+            && unsafeInterval - rest >= tenK
+            && (rest + tenK < bigDist || bigDist - rest > rest + tenK - bigDist))
+            return false;
+
+        return 2 * unit <= rest && rest <= unsafeInterval - 4 * unit;
+    }
+
+    unsigned countDecimalDigits(uint32_t n, uint32_t& pow10)
+    {
+        static const uint32_t powers[] = {
+            1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+        };
+
+        unsigned d = 10;
+        while (d > 1 && n < powers[d - 1])
+            --d;
+        pow10 = powers[d - 1];
+        return d;
+    }
+
+    // Generates the shortest digits of a value within [mMinus, mPlus]. The
+    // boundaries are off by up to one unit, so the digits are generated
+    // for the widened interval and checked by grisuRoundWeed.
+    bool grisuDigitGen(char* buffer, unsigned& len, int& exp10, DiyFp mMinus, DiyFp w, DiyFp mPlus)
+    {
+        uint64_t unit = 1;
+        DiyFp tooLow(mMinus.f - unit, mMinus.e);
+        DiyFp tooHigh(mPlus.f + unit, mPlus.e);
+        uint64_t unsafeInterval = (tooHigh - tooLow).f;
+        uint64_t distTooHighW = (tooHigh - w).f;
+
+        const DiyFp one(uint64_t(1) << -w.e, w.e);
+
+        uint32_t p1 = static_cast<uint32_t>(tooHigh.f >> -one.e);
+        uint64_t p2 = tooHigh.f & (one.f - 1);
+
+        uint32_t pow10;
+        unsigned n = countDecimalDigits(p1, pow10);
+        len = 0;
+
+        while (n > 0)
+        {
+            uint32_t d = p1 / pow10;
+            p1 %= pow10;
+            buffer[len++] = static_cast<char>('0' + d);
+            --n;
+
+            uint64_t rest = (uint64_t(p1) << -one.e) + p2;
+            if (rest < unsafeInterval)
+            {
+                exp10 += n;
+                return grisuRoundWeed(buffer, len, distTooHighW, unsafeInterval,
+                    rest, uint64_t(pow10) << -one.e, unit);
+            }
+
+            pow10 /= 10;
+        }
+
+        int m = 0;
+        for (;;)
+        {
+            p2 *= 10;
+            unit *= 10;
+            unsafeInterval *= 10;
+            uint64_t d = p2 >> -one.e;
+            p2 &= one.f - 1;
+            buffer[len++] = static_cast<char>('0' + d);
+            ++m;
+
+            if (p2 < unsafeInterval)
+            {
+                exp10 -= m;
+                return grisuRoundWeed(buffer, len, distTooHighW * unit, unsafeInterval,
+                    p2, one.f, unit);
+            }
+        }
+    }
+
+    // Grisu3: shortest digits of f * 2^e, which are within the rounding
+    // boundaries. lowerCloser is set, when the significand is a power of 2
+    // and the next smaller value is nearer. Returns false for the about
+    // 0.5% of values, where the result is not known to be the shortest.
+    bool grisu3(uint64_t f, int e, bool lowerCloser, char* buffer, unsigned& len, int& exp10)
+    {
+        DiyFp w = normalize(DiyFp(f, e));
+        DiyFp mPlus = normalize(DiyFp(2 * f + 1, e - 1));
+        DiyFp mMinus = lowerCloser ? DiyFp(4 * f - 1, e - 2) : DiyFp(2 * f - 1, e - 1);
+        mMinus.f <<= mMinus.e - mPlus.e;
+        mMinus.e = mPlus.e;
+
+        const CachedPower& c = cachedPowerForBinaryExponent(mPlus.e);
+        DiyFp cp(c.f, c.e);
+
+        exp10 = -c.k;
+        return grisuDigitGen(buffer, len, exp10, mMinus * cp, w * cp, mPlus * cp);
+    }
+
+    int printExp(char* s, std::size_t size, int precision, double v)
+    {
+        return snprintf(s, size, "%.*e", precision, v);
+    }
+
+    int printExp(char* s, std::size_t size, int precision, long double v)
+    {
+        return snprintf(s, size, "%.*Le", precision, v);
+    }
+
+    // Increases the precision starting at `precision` until the printed
+    // value reads back. Decimals with up to digits10 digits survive the
+    // round trip, so starting there still finds the shortest digits.
+    template <typename T>
+    unsigned printedDigits(T v, int precision, char* digits, int& exp10,
+                           T (*read)(const char*, char**))
+    {
+        char s[64];
+        for ( ; ; ++precision)
+        {
+            printExp(s, sizeof(s), precision - 1, v);
+            if (precision >= std::numeric_limits<T>::max_digits10
+                    || read(s, 0) == v)
+                break;
+        }
+
+        unsigned len = 0;
+        const char* p;
+        for (p = s; *p && *p != 'e'; ++p)
+            if (*p >= '0' && *p <= '9')
+                digits[len++] = *p;
+
+        exp10 = std::atoi(p + 1) - static_cast<int>(len) + 1;
+
+        while (len > 1 && digits[len - 1] == '0')
+        {
+            --len;
+            ++exp10;
+        }
+
+        return len;
+    }
+
+    // exactly representable powers of 10 for the conversion of short decimals
+    const double exactPowersOfTen[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    // normalized 10^1 ... 10^7
+    const DiyFp adjustPowersOfTen[] = {
+        DiyFp(0xa000000000000000ull, -60),
+        DiyFp(0xc800000000000000ull, -57),
+        DiyFp(0xfa00000000000000ull, -54),
+        DiyFp(0x9c40000000000000ull, -50),
+        DiyFp(0xc350000000000000ull, -47),
+        DiyFp(0xf424000000000000ull, -44),
+        DiyFp(0x9896800000000000ull, -40)
+    };
+
+    template <typename T>
+    T exactPowerOfTen(int n)
+    {
+        T p = 1;
+        while (n-- > 0)
+            p *= 10;
+        return p;
+    }
+
+    template <typename T>
+    bool exactDecimalToFloat(uint64_t mantissa, int exp10, bool inexact, T& n, int maxExp10)
+    {
+        const int digits = std::numeric_limits<T>::digits;
+        if (inexact
+            || (digits < 64 && (mantissa >> (digits & 63)) != 0)
+            || exp10 > maxExp10 || exp10 < -maxExp10)
+            return false;
+
+        if (exp10 >= 0)
+            n = static_cast<T>(mantissa) * exactPowerOfTen<T>(exp10);
+        else
+            n = static_cast<T>(mantissa) / exactPowerOfTen<T>(-exp10);
+
+        return true;
+    }
+
+    template <typename T>
+    void stringToFloat(const std::string& digits, int exp10, T& n, T (*fn)(const char*, char**))
+    {
+        // no decimal point, so the locale does not matter
+        std::string s = digits;
+        s += 'e';
+        putInt(std::back_inserter(s), exp10);
+        n = fn(s.c_str(), 0);
+    }
+}
+
+unsigned shortestDigits(float v, char* digits, int& exp10)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+
+    uint64_t f = bits & ((uint32_t(1) << 23) - 1);
+    int e = static_cast<int>(bits >> 23) & 0xff;
+
+    unsigned len;
+    bool ok = e == 0 ? grisu3(f, -149, false, digits, len, exp10)
+                     : grisu3(f | (uint32_t(1) << 23), e - 150, f == 0 && e > 1, digits, len, exp10);
+
+    return ok ? len : printedDigits(v, std::numeric_limits<float>::digits10, digits, exp10, strtof);
+}
+
+unsigned shortestDigits(double v, char* digits, int& exp10)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+
+    uint64_t f = bits & ((uint64_t(1) << 52) - 1);
+    int e = static_cast<int>(bits >> 52) & 0x7ff;
+
+    unsigned len;
+    bool ok = e == 0 ? grisu3(f, -1074, false, digits, len, exp10)
+                     : grisu3(f | (uint64_t(1) << 52), e - 1075, f == 0 && e > 1, digits, len, exp10);
+
+    return ok ? len : printedDigits(v, std::numeric_limits<double>::digits10, digits, exp10, strtod);
+}
+
+unsigned shortestDigits(long double v, char* digits, int& exp10)
+{
+    // There is no portable binary layout of long double, so we increase
+    // the precision until the printed value reads back.
+    return printedDigits(v, std::numeric_limits<long double>::digits10, digits, exp10, strtold);
+}
+
+bool decimalToFloat(uint64_t mantissa, int exp10, bool inexact, float& n)
+{
+    if (mantissa == 0)
+    {
+        n = 0;
+        return true;
+    }
+
+    return exactDecimalToFloat(mantissa, exp10, inexact, n, 10);
+}
+
+bool decimalToFloat(uint64_t mantissa, int exp10, bool inexact, double& n)
+{
+    if (mantissa == 0)
+    {
+        n = 0;
+        return true;
+    }
+
+    // fast path: both the mantissa and the power of 10 are exact doubles
+    if (!inexact && (mantissa >> 53) == 0)
+    {
+        if (exp10 >= 0 && exp10 <= 22)
+        {
+            n = static_cast<double>(mantissa) * exactPowersOfTen[exp10];
+            return true;
+        }
+
+        if (exp10 < 0 && exp10 >= -22)
+        {
+            n = static_cast<double>(mantissa) / exactPowersOfTen[-exp10];
+            return true;
+        }
+    }
+
+    if (exp10 < cachedPowersMinDecExp || exp10 > 300)
+        return false;
+
+    // Multiply with a cached power of 10 and track the error in 1/8 ulp.
+    // When the result is too close to the half way point between two
+    // doubles, we give up and let the caller do an exact conversion.
+    const uint64_t denominator = 8;
+    uint64_t error = inexact ? denominator : 0;
+
+    DiyFp input = normalize(DiyFp(mantissa, 0));
+    error <<= -input.e;
+
+    const CachedPower& c = cachedPowers[(exp10 - cachedPowersMinDecExp) / cachedPowersDecStep];
+    int adjust = exp10 - c.k;
+    if (adjust > 0)
+    {
+        static const uint64_t maxExact[] = {
+            0, 1844674407370955161ull, 184467440737095516ull, 18446744073709551ull,
+            1844674407370955ull, 184467440737095ull, 18446744073709ull, 1844674407370ull
+        };
+
+        input = input * adjustPowersOfTen[adjust - 1];
+        if (mantissa > maxExact[adjust])
+            error += denominator / 2;
+    }
+
+    input = input * DiyFp(c.f, c.e);
+    error += denominator / 2 + (error == 0 ? 0 : 1) + denominator / 2;
+
+    int oldE = input.e;
+    input = normalize(input);
+    error <<= oldE - input.e;
+
+    // the result must be a normal double
+    if (input.e + 63 < -1022 || input.e + 63 > 1023)
+        return false;
+
+    const int extraBits = 64 - 53;
+    uint64_t precision = (input.f & ((uint64_t(1) << extraBits) - 1)) * denominator;
+    uint64_t halfway = (uint64_t(1) << (extraBits - 1)) * denominator;
+    if (precision + error > halfway && precision < halfway + error)
+        return false;
+
+    uint64_t f = input.f >> extraBits;
+    int e = input.e + extraBits;
+    if (precision >= halfway + error)
+    {
+        ++f;
+        if ((f >> 53) != 0)
+        {
+            f >>= 1;
+            ++e;
+        }
+    }
+
+    int biased = e + 1075;
+    if (biased >= 0x7ff)
+        return false;
+
+    uint64_t bits = (uint64_t(biased) << 52) | (f & ((uint64_t(1) << 52) - 1));
+    std::memcpy(&n, &bits, sizeof(n));
+    return true;
+}
+
+bool decimalToFloat(uint64_t mantissa, int exp10, bool inexact, long double& n)
+{
+    if (mantissa == 0)
+    {
+        n = 0;
+        return true;
+    }
+
+    return exactDecimalToFloat(mantissa, exp10, inexact, n,
+        std::numeric_limits<long double>::digits >= 64 ? 27 : 22);
+}
+
+void decimalToFloat(const std::string& digits, int exp10, float& n)
+{
+    stringToFloat(digits, exp10, n, strtof);
+}
+
+void decimalToFloat(const std::string& digits, int exp10, double& n)
+{
+    stringToFloat(digits, exp10, n, strtod);
+}
+
+void decimalToFloat(const std::string& digits, int exp10, long double& n)
+{
+    stringToFloat(digits, exp10, n, strtold);
+}
+
 }
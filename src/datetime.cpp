@@ -28,183 +28,39 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
 #include "cxxtools/datetime.h"
+#include "cxxtools/datetimeformat.h"
 #include "cxxtools/clock.h"
 #include "cxxtools/serializationinfo.h"
-#include "dateutils.h"
-#include <stdexcept>
-#include <cctype>
 
 namespace cxxtools
 {
 
-static void throwInvalidDate(const std::string& str, std::string::const_iterator p, const std::string& fmt)
+namespace
 {
-    throw InvalidDate("string <" + std::string(str.begin(), p) + "(*)" + std::string(p, str.end()) + "> does not match datetime format <" + fmt + '>');
-}
-
-DateTime::DateTime(const std::string& str, const std::string& fmt)
-{
-  unsigned year = 0;
-  unsigned month = 1;
-  unsigned day = 1;
-  unsigned hours = 0;
-  unsigned minutes = 0;
-  unsigned seconds = 0;
-  unsigned useconds = 0;
-  bool am = true;
-
-  enum {
-    state_0,
-    state_fmt,
-    state_two
-  } state = state_0;
-
-  std::string::const_iterator dit = str.begin();
-  try
-  {
-    std::string::const_iterator it;
-    for (it = fmt.begin(); it != fmt.end(); ++it)
+    const DateTimeFormat& isoFormat()
     {
-      char ch = *it;
-      switch (state)
-      {
-        case state_0:
-          if (ch == '%')
-            state = state_fmt;
-          else
-          {
-            if (ch == '*')
-              skipNonDigit(dit, str.end());
-            else if (ch == '#')
-              skipWord(dit, str.end());
-            else if (dit == str.end() || (*dit != ch && ch != '?'))
-              throwInvalidDate(str, dit, fmt);
-            else
-              ++dit;
-          }
-          break;
-
-        case state_fmt:
-          state = state_0;
-          switch (ch)
-          {
-            case 'Y':
-              year = getInt(dit, str.end(), 4);
-              break;
-
-            case 'y':
-              year = getInt(dit, str.end(), 2);
-              year += (year < 50 ? 2000 : 1900);
-              break;
-
-            case 'm':
-              month = getUnsigned(dit, str.end(), 2);
-              break;
-
-            case 'O':
-              month = getMonthFromName(dit, str.end());
-              break;
-
-            case 'd':
-              day = getUnsigned(dit, str.end(), 2);
-              break;
-
-            case 'H':
-            case 'I':
-              hours = getUnsigned(dit, str.end(), 2);
-              break;
-
-            case 'M':
-              minutes = getUnsigned(dit, str.end(), 2);
-              break;
-
-            case 'S':
-              seconds = getUnsigned(dit, str.end(), 2);
-              break;
-
-            case 'j':
-              if (dit != str.end() && *dit == '.')
-                ++dit;
-              useconds = getMicroseconds(dit, str.end(), 6);
-              break;
-
-            case 'J':
-            case 'U':
-              if (dit != str.end() && *dit == '.')
-              {
-                ++dit;
-                useconds = getMicroseconds(dit, str.end(), 6);
-              }
-              break;
-
-            case 'K':
-              if (dit != str.end() && *dit == '.')
-              {
-                ++dit;
-                useconds = getMicroseconds(dit, str.end(), 3);
-              }
-              break;
-
-            case 'k':
-              useconds = getMicroseconds(dit, str.end(), 3);
-              break;
-
-            case 'u':
-              useconds = getMicroseconds(dit, str.end(), 6);
-              break;
-
-            case 'p':
-              if (dit == str.end()
-                || dit + 1 == str.end()
-                || ((*dit != 'A'
-                  && *dit != 'a'
-                  && *dit != 'P'
-                  && *dit != 'p')
-                || (*(dit + 1) != 'M'
-                  &&  *(dit + 1) != 'm')))
-              {
-                throwInvalidDate(str, dit, fmt);
-              }
-
-              am = (*dit == 'A' || *dit == 'a');
-              dit += 2;
-              break;
-
-            case '2':
-              state = state_two;
-              break;
+        static const DateTimeFormat format("%Y-%m-%d %H:%M:%S%j");
+        return format;
+    }
 
-            default:
-              throw InvalidDate("invalid datetime format <" + fmt + '>');
-          }
+    // The same format is typically used again and again, so the last one is
+    // kept per thread.
+    const DateTimeFormat& cachedFormat(const std::string& fmt)
+    {
+        if (fmt == isoFormat().pattern())
+            return isoFormat();
 
-          break;
+        static thread_local DateTimeFormat format;
+        if (format.pattern() != fmt)
+            format = DateTimeFormat(fmt);
 
-        case state_two:
-          state = state_0;
-          switch (ch)
-          {
-            case 'm': month = getUnsignedF(dit, str.end(), 2); break;
-            case 'd': day = getUnsignedF(dit, str.end(), 2); break;
-            case 'H':
-            case 'I': hours = getUnsignedF(dit, str.end(), 2); break;
-            case 'M': minutes = getUnsignedF(dit, str.end(), 2); break;
-            case 'S': seconds = getUnsignedF(dit, str.end(), 2); break;
-            default:
-              throw InvalidDate("invalid datetime format <" + fmt + '>');
-          }
-      }
+        return format;
     }
+}
 
-    if (it != fmt.end() || dit != str.end())
-      throwInvalidDate(str, dit, fmt);
-
-    set(year, month, day, am ? hours : hours + 12, minutes, seconds, 0, useconds);
-  }
-  catch (const std::invalid_argument&)
-  {
-    throwInvalidDate(str, dit, fmt);
-  }
+DateTime::DateTime(const std::string& str, const std::string& fmt)
+{
+    *this = cachedFormat(fmt).parse(str);
 }
 
 UtcDateTime DateTime::fromMSecsSinceEpoch(cxxtools::Milliseconds sinceEpoch)
@@ -231,123 +87,7 @@ Milliseconds DateTime::msecsSinceEpoch() const
 
 std::string DateTime::toString(const std::string& fmt) const
 {
-  int year;
-  unsigned month, day, hours, minutes, seconds, mseconds, useconds;
-
-  get(year, month, day, hours, minutes, seconds, mseconds, useconds);
-
-  std::string str;
-
-  enum {
-    state_0,
-    state_fmt,
-    state_one
-  } state = state_0;
-
-  for (std::string::const_iterator it = fmt.begin(); it != fmt.end(); ++it)
-  {
-    switch (state)
-    {
-      case state_0:
-        if (*it == '%')
-          state = state_fmt;
-        else
-          str += *it;
-        break;
-
-      case state_fmt:
-        if (*it != '%')
-          state = state_0;
-
-        switch (*it)
-        {
-          case 'Y': appendDn(str, 4, year); break;
-          case 'y': appendDn(str, 2, year % 100); break;
-          case 'm': appendDn(str, 2, month); break;
-          case 'O': str += monthnames[month-1]; break;
-          case 'd': appendDn(str, 2, day); break;
-          case 'w': appendDn(str, 1, dayOfWeek()); break;
-          case 'W': { int dow = dayOfWeek(); appendDn(str, 1, dow == 0 ? 7 : dow); } break;
-          case 'N': str += weekdaynames[dayOfWeek()]; break;
-          case 'H': appendDn(str, 2, hours); break;
-          case 'I': appendDn(str, 2, hours % 12); break;
-          case 'M': appendDn(str, 2, minutes); break;
-          case 'S': appendDn(str, 2, seconds); break;
-          case 'j': if (useconds != 0)
-                    {
-                      str += '.';
-                      str += (useconds / 100000 + '0');
-                      useconds %= 100000;
-                      for (unsigned e = 10000; e > 0 && useconds > 0; e /= 10)
-                      {
-                        str += (useconds / e + '0');
-                        useconds %= e;
-                      }
-                    }
-                    break;
-
-          case 'J': str += '.';
-                    str += (useconds / 100000 + '0');
-                    useconds %= 100000;
-                    for (unsigned e = 10000; e > 0 && useconds > 0; e /= 10)
-                    {
-                      str += (useconds / e + '0');
-                      useconds %= e;
-                    }
-                    break;
-
-          case 'k': appendDn(str, 3, mseconds);
-                    break;
-
-          case 'K': str += '.';
-                    appendDn(str, 3, mseconds);
-                    break;
-
-          case 'u': appendDn(str, 6, useconds);
-                    break;
-
-          case 'U': str += '.';
-                    appendDn(str, 6, useconds);
-                    break;
-
-          case 'p': str += (hours < 12 ? "am" : "pm"); break;
-          case 'P': str += (hours < 12 ? "AM" : "PM"); break;
-
-          case '1': state = state_one; break;
-
-          default:
-            str += '%';
-            str += *it;
-        }
-
-        break;
-
-      case state_one:
-        state = state_0;
-        switch (*it)
-        {
-          case 'd': appendDn(str, day < 10 ? 1 : 2, day); break;
-          case 'm': appendDn(str, month < 10 ? 1 : 2, month); break;
-          case 'H': appendDn(str, hours < 10 ? 1 : 2, hours); break;
-          case 'I': appendDn(str, hours%12 < 10 ? 1 : 2, hours%12); break;
-          case 'M': appendDn(str, minutes < 10 ? 1 : 2, minutes); break;
-          case 'S': appendDn(str, seconds < 10 ? 1 : 2, seconds); break;
-
-          default:  str += "%1";
-                    str += *it;
-                    if (*it == '%')
-                      state = state_fmt;
-                    break;
-        }
-
-        break;
-    }
-  }
-
-  if (state == state_fmt)
-    str += '%';
-
-  return str;
+    return cachedFormat(fmt).toString(*this);
 }
 
 
@@ -434,13 +174,13 @@ void operator >>=(const SerializationInfo& si, DateTime& datetime)
     {
         std::string s;
         si.getValue(s);
-        datetime = DateTime(s);
+        datetime = isoFormat().parse(s);
     }
 }
 
 void operator <<=(SerializationInfo& si, const DateTime& dt)
 {
-    si.setValue(dt.toString());
+    si.setValue(isoFormat().toString(dt));
     si.setTypeName("DateTime");
 }
 
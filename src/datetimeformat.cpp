@@ -0,0 +1,558 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/datetimeformat.h"
+#include "cxxtools/datetime.h"
+#include "dateutils.h"
+#include <stdexcept>
+
+namespace cxxtools
+{
+
+namespace
+{
+    enum Code
+    {
+        code_literal,
+
+        code_year4,         // %Y
+        code_year2,         // %y
+        code_month,         // %m
+        code_monthname,     // %O
+        code_day,           // %d
+        code_hour,          // %H
+        code_hour12,        // %I
+        code_minute,        // %M
+        code_second,        // %S
+        code_fraction,      // %j
+        code_dotfraction,   // %J
+        code_msec,          // %k
+        code_dotmsec,       // %K
+        code_usec,          // %u
+        code_dotusec,       // %U
+        code_ampm,          // %p
+
+        // output only
+        code_AMPM,          // %P
+        code_weekday,       // %w
+        code_weekday7,      // %W
+        code_dayname,       // %N
+        code_month1,        // %1m
+        code_day1,          // %1d
+        code_hour1,         // %1H
+        code_hour12_1,      // %1I
+        code_minute1,       // %1M
+        code_second1,       // %1S
+
+        // input only
+        code_anychar,       // ?
+        code_skipnondigit,  // *
+        code_skipword,      // #
+        code_month2,        // %2m
+        code_day2,          // %2d
+        code_hour2,         // %2H, %2I
+        code_minute2,       // %2M
+        code_second2,       // %2S
+        code_invalid
+    };
+
+    // writes at most size characters but counts all
+    class Writer
+    {
+            char* _buffer;
+            std::size_t _size;
+            std::size_t _pos;
+
+        public:
+            Writer(char* buffer, std::size_t size)
+                : _buffer(buffer),
+                  _size(size),
+                  _pos(0)
+                { }
+
+            std::size_t pos() const
+            { return _pos; }
+
+            void put(char ch)
+            {
+                if (_pos < _size)
+                    _buffer[_pos] = ch;
+                ++_pos;
+            }
+
+            void put(const char* s, std::size_t n)
+            {
+                while (n-- > 0)
+                    put(*s++);
+            }
+
+            void put(const char* s)
+            {
+                while (*s)
+                    put(*s++);
+            }
+
+            // n digits with leading zeros like appendDn
+            void putDn(unsigned short n, unsigned v)
+            {
+                char digits[10];
+                for (unsigned short i = n; i > 0; --i)
+                {
+                    digits[i - 1] = static_cast<char>('0' + v % 10);
+                    v /= 10;
+                }
+                put(digits, n);
+            }
+
+            void putDn(unsigned short n, int v)
+            {
+                if (v < 0)
+                {
+                    put('-');
+                    putDn(n, static_cast<unsigned>(-v));
+                }
+                else
+                    putDn(n, static_cast<unsigned>(v));
+            }
+
+            // fractional seconds without trailing zeros
+            void putFraction(unsigned useconds)
+            {
+                put(static_cast<char>(useconds / 100000 + '0'));
+                useconds %= 100000;
+                for (unsigned e = 10000; e > 0 && useconds > 0; e /= 10)
+                {
+                    put(static_cast<char>(useconds / e + '0'));
+                    useconds %= e;
+                }
+            }
+    };
+}
+
+DateTimeFormat::DateTimeFormat(const std::string& pattern)
+    : _pattern(pattern)
+{
+    compileOutput();
+    compileInput();
+}
+
+void DateTimeFormat::addLiteral(std::vector<Field>& fields, const char* s, unsigned length)
+{
+    if (!fields.empty()
+      && fields.back().code == code_literal
+      && fields.back().offset + fields.back().length == _literals.size())
+    {
+        fields.back().length += length;
+    }
+    else
+    {
+        fields.push_back(Field(code_literal, _literals.size(), length));
+    }
+
+    _literals.append(s, length);
+}
+
+// The rules follow DateTime::toString: unknown codes are copied to the output.
+void DateTimeFormat::compileOutput()
+{
+    enum {
+      state_0,
+      state_fmt,
+      state_one
+    } state = state_0;
+
+    for (std::string::const_iterator it = _pattern.begin(); it != _pattern.end(); ++it)
+    {
+        char ch = *it;
+        switch (state)
+        {
+            case state_0:
+                if (ch == '%')
+                    state = state_fmt;
+                else
+                    addLiteral(_output, &ch, 1);
+                break;
+
+            case state_fmt:
+                if (ch != '%')
+                    state = state_0;
+
+                switch (ch)
+                {
+                    case 'Y': _output.push_back(Field(code_year4)); break;
+                    case 'y': _output.push_back(Field(code_year2)); break;
+                    case 'm': _output.push_back(Field(code_month)); break;
+                    case 'O': _output.push_back(Field(code_monthname)); break;
+                    case 'd': _output.push_back(Field(code_day)); break;
+                    case 'w': _output.push_back(Field(code_weekday)); break;
+                    case 'W': _output.push_back(Field(code_weekday7)); break;
+                    case 'N': _output.push_back(Field(code_dayname)); break;
+                    case 'H': _output.push_back(Field(code_hour)); break;
+                    case 'I': _output.push_back(Field(code_hour12)); break;
+                    case 'M': _output.push_back(Field(code_minute)); break;
+                    case 'S': _output.push_back(Field(code_second)); break;
+                    case 'j': _output.push_back(Field(code_fraction)); break;
+                    case 'J': _output.push_back(Field(code_dotfraction)); break;
+                    case 'k': _output.push_back(Field(code_msec)); break;
+                    case 'K': _output.push_back(Field(code_dotmsec)); break;
+                    case 'u': _output.push_back(Field(code_usec)); break;
+                    case 'U': _output.push_back(Field(code_dotusec)); break;
+                    case 'p': _output.push_back(Field(code_ampm)); break;
+                    case 'P': _output.push_back(Field(code_AMPM)); break;
+                    case '1': state = state_one; break;
+
+                    default:
+                        {
+                            char s[2] = { '%', ch };
+                            addLiteral(_output, s, 2);
+                        }
+                }
+
+                break;
+
+            case state_one:
+                state = state_0;
+                switch (ch)
+                {
+                    case 'd': _output.push_back(Field(code_day1)); break;
+                    case 'm': _output.push_back(Field(code_month1)); break;
+                    case 'H': _output.push_back(Field(code_hour1)); break;
+                    case 'I': _output.push_back(Field(code_hour12_1)); break;
+                    case 'M': _output.push_back(Field(code_minute1)); break;
+                    case 'S': _output.push_back(Field(code_second1)); break;
+
+                    default:
+                        {
+                            char s[3] = { '%', '1', ch };
+                            addLiteral(_output, s, 3);
+                            if (ch == '%')
+                                state = state_fmt;
+                        }
+                }
+
+                break;
+        }
+    }
+
+    if (state == state_fmt)
+        addLiteral(_output, "%", 1);
+}
+
+// The rules follow the parsing constructor of DateTime: unknown codes fail
+// when parsing reaches them.
+void DateTimeFormat::compileInput()
+{
+    enum {
+      state_0,
+      state_fmt,
+      state_two
+    } state = state_0;
+
+    for (std::string::const_iterator it = _pattern.begin(); it != _pattern.end(); ++it)
+    {
+        char ch = *it;
+        switch (state)
+        {
+            case state_0:
+                if (ch == '%')
+                    state = state_fmt;
+                else if (ch == '*')
+                    _input.push_back(Field(code_skipnondigit));
+                else if (ch == '#')
+                    _input.push_back(Field(code_skipword));
+                else if (ch == '?')
+                    _input.push_back(Field(code_anychar));
+                else
+                    addLiteral(_input, &ch, 1);
+                break;
+
+            case state_fmt:
+                state = state_0;
+                switch (ch)
+                {
+                    case 'Y': _input.push_back(Field(code_year4)); break;
+                    case 'y': _input.push_back(Field(code_year2)); break;
+                    case 'm': _input.push_back(Field(code_month)); break;
+                    case 'O': _input.push_back(Field(code_monthname)); break;
+                    case 'd': _input.push_back(Field(code_day)); break;
+                    case 'H':
+                    case 'I': _input.push_back(Field(code_hour)); break;
+                    case 'M': _input.push_back(Field(code_minute)); break;
+                    case 'S': _input.push_back(Field(code_second)); break;
+                    case 'j': _input.push_back(Field(code_fraction)); break;
+                    case 'J':
+                    case 'U': _input.push_back(Field(code_dotfraction)); break;
+                    case 'K': _input.push_back(Field(code_dotmsec)); break;
+                    case 'k': _input.push_back(Field(code_msec)); break;
+                    case 'u': _input.push_back(Field(code_usec)); break;
+                    case 'p': _input.push_back(Field(code_ampm)); break;
+                    case '2': state = state_two; break;
+                    default: _input.push_back(Field(code_invalid)); break;
+                }
+
+                break;
+
+            case state_two:
+                state = state_0;
+                switch (ch)
+                {
+                    case 'm': _input.push_back(Field(code_month2)); break;
+                    case 'd': _input.push_back(Field(code_day2)); break;
+                    case 'H':
+                    case 'I': _input.push_back(Field(code_hour2)); break;
+                    case 'M': _input.push_back(Field(code_minute2)); break;
+                    case 'S': _input.push_back(Field(code_second2)); break;
+                    default: _input.push_back(Field(code_invalid)); break;
+                }
+
+                break;
+        }
+    }
+}
+
+std::size_t DateTimeFormat::format(const DateTime& dt, char* buffer, std::size_t size) const
+{
+    int year;
+    unsigned month, day, hours, minutes, seconds, mseconds, useconds;
+
+    dt.get(year, month, day, hours, minutes, seconds, mseconds, useconds);
+
+    Writer w(buffer, size);
+
+    for (std::vector<Field>::const_iterator it = _output.begin(); it != _output.end(); ++it)
+    {
+        switch (it->code)
+        {
+            case code_literal:  w.put(_literals.data() + it->offset, it->length); break;
+            case code_year4:    w.putDn(4, year); break;
+            case code_year2:    w.putDn(2, year % 100); break;
+            case code_month:    w.putDn(2, month); break;
+            case code_monthname: w.put(monthnames[month - 1]); break;
+            case code_day:      w.putDn(2, day); break;
+            case code_weekday:  w.putDn(1, dt.dayOfWeek()); break;
+            case code_weekday7: { unsigned dow = dt.dayOfWeek(); w.putDn(1, dow == 0 ? 7u : dow); } break;
+            case code_dayname:  w.put(weekdaynames[dt.dayOfWeek()]); break;
+            case code_hour:     w.putDn(2, hours); break;
+            case code_hour12:   w.putDn(2, hours % 12); break;
+            case code_minute:   w.putDn(2, minutes); break;
+            case code_second:   w.putDn(2, seconds); break;
+
+            case code_fraction:
+                if (useconds != 0)
+                {
+                    w.put('.');
+                    w.putFraction(useconds);
+                }
+                // like DateTime::toString always did, the fraction consumes
+                // the microseconds, so a following %u prints zeros
+                useconds = 0;
+                break;
+
+            case code_dotfraction:
+                w.put('.');
+                w.putFraction(useconds);
+                useconds = 0;
+                break;
+
+            case code_msec:     w.putDn(3, mseconds); break;
+            case code_dotmsec:  w.put('.'); w.putDn(3, mseconds); break;
+            case code_usec:     w.putDn(6, useconds); break;
+            case code_dotusec:  w.put('.'); w.putDn(6, useconds); break;
+            case code_ampm:     w.put(hours < 12 ? "am" : "pm"); break;
+            case code_AMPM:     w.put(hours < 12 ? "AM" : "PM"); break;
+
+            case code_day1:     w.putDn(day < 10 ? 1 : 2, day); break;
+            case code_month1:   w.putDn(month < 10 ? 1 : 2, month); break;
+            case code_hour1:    w.putDn(hours < 10 ? 1 : 2, hours); break;
+            case code_hour12_1: w.putDn(hours % 12 < 10 ? 1 : 2, hours % 12); break;
+            case code_minute1:  w.putDn(minutes < 10 ? 1 : 2, minutes); break;
+            case code_second1:  w.putDn(seconds < 10 ? 1 : 2, seconds); break;
+        }
+    }
+
+    return w.pos();
+}
+
+void DateTimeFormat::format(const DateTime& dt, std::string& str) const
+{
+    char buffer[64];
+    std::size_t n = format(dt, buffer, sizeof(buffer));
+    if (n <= sizeof(buffer))
+    {
+        str.append(buffer, n);
+    }
+    else
+    {
+        std::string::size_type s = str.size();
+        str.resize(s + n);
+        format(dt, &str[s], n);
+    }
+}
+
+std::string DateTimeFormat::toString(const DateTime& dt) const
+{
+    std::string str;
+    format(dt, str);
+    return str;
+}
+
+DateTime DateTimeFormat::parse(const std::string& str) const
+{
+    DateTime dt;
+    std::string::size_type pos = doParse(str, dt);
+    if (pos != std::string::npos)
+        throw InvalidDate("string <" + str.substr(0, pos) + "(*)" + str.substr(pos) + "> does not match datetime format <" + _pattern + '>');
+    return dt;
+}
+
+bool DateTimeFormat::parse(const std::string& str, DateTime& dt) const
+{
+    return doParse(str, dt) == std::string::npos;
+}
+
+std::string::size_type DateTimeFormat::doParse(const std::string& str, DateTime& dt) const
+{
+    unsigned year = 0;
+    unsigned month = 1;
+    unsigned day = 1;
+    unsigned hours = 0;
+    unsigned minutes = 0;
+    unsigned seconds = 0;
+    unsigned useconds = 0;
+    bool am = true;
+
+    std::string::const_iterator dit = str.begin();
+    std::string::const_iterator e = str.end();
+
+    try
+    {
+        for (std::vector<Field>::const_iterator it = _input.begin(); it != _input.end(); ++it)
+        {
+            switch (it->code)
+            {
+                case code_literal:
+                    for (unsigned n = 0; n < it->length; ++n)
+                    {
+                        if (dit == e || *dit != _literals[it->offset + n])
+                            return dit - str.begin();
+                        ++dit;
+                    }
+                    break;
+
+                case code_anychar:
+                    if (dit == e)
+                        return dit - str.begin();
+                    ++dit;
+                    break;
+
+                case code_skipnondigit: skipNonDigit(dit, e); break;
+                case code_skipword:     skipWord(dit, e); break;
+
+                case code_year4:
+                    year = getInt(dit, e, 4);
+                    break;
+
+                case code_year2:
+                    year = getInt(dit, e, 2);
+                    year += (year < 50 ? 2000 : 1900);
+                    break;
+
+                case code_month:        month = getUnsigned(dit, e, 2); break;
+                case code_monthname:    month = getMonthFromName(dit, e); break;
+                case code_day:          day = getUnsigned(dit, e, 2); break;
+                case code_hour:         hours = getUnsigned(dit, e, 2); break;
+                case code_minute:       minutes = getUnsigned(dit, e, 2); break;
+                case code_second:       seconds = getUnsigned(dit, e, 2); break;
+
+                case code_fraction:
+                    if (dit != e && *dit == '.')
+                        ++dit;
+                    useconds = getMicroseconds(dit, e, 6);
+                    break;
+
+                case code_dotfraction:
+                    if (dit != e && *dit == '.')
+                    {
+                        ++dit;
+                        useconds = getMicroseconds(dit, e, 6);
+                    }
+                    break;
+
+                case code_dotmsec:
+                    if (dit != e && *dit == '.')
+                    {
+                        ++dit;
+                        useconds = getMicroseconds(dit, e, 3);
+                    }
+                    break;
+
+                case code_msec:         useconds = getMicroseconds(dit, e, 3); break;
+                case code_usec:         useconds = getMicroseconds(dit, e, 6); break;
+
+                case code_ampm:
+                    if (dit == e
+                      || dit + 1 == e
+                      || ((*dit != 'A'
+                        && *dit != 'a'
+                        && *dit != 'P'
+                        && *dit != 'p')
+                      || (*(dit + 1) != 'M'
+                        &&  *(dit + 1) != 'm')))
+                    {
+                        return dit - str.begin();
+                    }
+
+                    am = (*dit == 'A' || *dit == 'a');
+                    dit += 2;
+                    break;
+
+                case code_month2:       month = getUnsignedF(dit, e, 2); break;
+                case code_day2:         day = getUnsignedF(dit, e, 2); break;
+                case code_hour2:        hours = getUnsignedF(dit, e, 2); break;
+                case code_minute2:      minutes = getUnsignedF(dit, e, 2); break;
+                case code_second2:      seconds = getUnsignedF(dit, e, 2); break;
+
+                default:
+                    return dit - str.begin();
+            }
+        }
+
+        if (dit != e)
+            return dit - str.begin();
+
+        dt.set(year, month, day, am ? hours : hours + 12, minutes, seconds, 0, useconds);
+    }
+    catch (const std::invalid_argument&)
+    {
+        return dit - str.begin();
+    }
+
+    return std::string::npos;
+}
+
+}
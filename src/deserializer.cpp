@@ -33,7 +33,11 @@ namespace cxxtools
 {
     void Deserializer::begin()
     {
-        clear();
+        while (!_current.empty())
+            _current.pop();
+
+        // keep the nodes of the previous message for reuse
+        _si.reset();
         _current.push(&_si);
     }
 
@@ -0,0 +1,478 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "epollselectorimpl.h"
+#include "cxxtools/ioerror.h"
+#include "cxxtools/systemerror.h"
+#include "cxxtools/log.h"
+#include <cerrno>
+#include <limits>
+#include <unistd.h>
+
+log_define("cxxtools.selector.epoll")
+
+namespace cxxtools
+{
+
+namespace
+{
+    const uint64_t wakeData = std::numeric_limits<uint64_t>::max();
+
+    uint32_t toEpoll(short events)
+    {
+        uint32_t ret = 0;
+        if (events & POLLIN)
+            ret |= EPOLLIN;
+        if (events & POLLOUT)
+            ret |= EPOLLOUT;
+        return ret;
+    }
+
+    short toPoll(uint32_t events)
+    {
+        short ret = 0;
+        if (events & EPOLLIN)
+            ret |= POLLIN;
+        if (events & EPOLLOUT)
+            ret |= POLLOUT;
+        if (events & EPOLLERR)
+            ret |= POLLERR;
+        if (events & EPOLLHUP)
+            ret |= POLLHUP;
+        return ret;
+    }
+}
+
+EpollSelectorImpl::EpollSelectorImpl()
+: _epfd(-1),
+  _serial(0),
+  _events(64)
+{
+    _epfd = ::epoll_create1(EPOLL_CLOEXEC);
+    if (_epfd < 0)
+        throwSystemError("epoll_create1");
+
+    epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.u64 = wakeData;
+    if (::epoll_ctl(_epfd, EPOLL_CTL_ADD, _wakePipe[0], &ev) != 0)
+    {
+        int e = errno;
+        ::close(_epfd);
+        throw SystemError(e, "epoll_ctl");
+    }
+}
+
+
+EpollSelectorImpl::~EpollSelectorImpl()
+{
+    while (!_devices.empty())
+    {
+        Selectable* dev = _devices.begin()->first;
+        dev->setSelector(0);
+
+        // the device did not remove itself since it is disabled
+        if (_devices.find(dev) != _devices.end())
+            remove(*dev);
+    }
+
+    collect();
+
+    ::close(_epfd);
+}
+
+
+void EpollSelectorImpl::add(Selectable& dev)
+{
+    if (_devices.find(&dev) != _devices.end())
+        return;
+
+    Entry* e = new Entry(*this, dev);
+    initEntry(*e);
+    _devices[&dev] = e;
+}
+
+
+void EpollSelectorImpl::remove(Selectable& dev)
+{
+    std::unordered_map<Selectable*, Entry*>::iterator it = _devices.find(&dev);
+    if (it == _devices.end())
+        return;
+
+    Entry* e = it->second;
+    _devices.erase(it);
+
+    dev.simpl().setPollListener(0);
+
+    for (unsigned n = 0; n < e->registered.size(); ++n)
+        unregisterFd(*e, n);
+
+    // The device may still be referenced in the dirty or ready list. The
+    // entry is released at the start of the next wait.
+    e->dev = 0;
+    _garbage.push_back(e);
+}
+
+
+void EpollSelectorImpl::changed(Selectable& dev)
+{
+    SelectorImpl::changed(dev);
+
+    std::unordered_map<Selectable*, Entry*>::iterator it = _devices.find(&dev);
+    if (it != _devices.end())
+        markDirty(*it->second);
+}
+
+
+void EpollSelectorImpl::reinit(Selectable& dev)
+{
+    std::unordered_map<Selectable*, Entry*>::iterator it = _devices.find(&dev);
+    if (it == _devices.end())
+    {
+        add(dev);
+        return;
+    }
+
+    Entry& e = *it->second;
+    for (unsigned n = 0; n < e.registered.size(); ++n)
+        unregisterFd(e, n);
+
+    initEntry(e);
+}
+
+
+void EpollSelectorImpl::initEntry(Entry& e)
+{
+    SelectableImpl& simpl = e.dev->simpl();
+
+    pollfd pfd;
+    pfd.fd = -1;
+    pfd.events = 0;
+    pfd.revents = 0;
+
+    std::size_t pollSize = simpl.pollSize();
+    e.pollfds.assign(pollSize, pfd);
+    e.registered.assign(pollSize, Registration());
+
+    if (pollSize > 0)
+        simpl.initializePoll(&e.pollfds[0], pollSize);
+
+    simpl.setPollListener(&e);
+
+    markDirty(e);
+}
+
+
+void EpollSelectorImpl::markDirty(Entry& e)
+{
+    if (!e.dirty)
+    {
+        e.dirty = true;
+        _dirty.push_back(&e);
+    }
+}
+
+
+void EpollSelectorImpl::update(Entry& e)
+{
+    for (unsigned n = 0; n < e.pollfds.size(); ++n)
+    {
+        const pollfd& pfd = e.pollfds[n];
+        Registration& r = e.registered[n];
+
+        if (pfd.fd != r.fd)
+        {
+            unregisterFd(e, n);
+            registerFd(e, n);
+        }
+        else if (r.fd >= 0 && r.polled && (pfd.events & (POLLIN|POLLOUT)) != r.events)
+        {
+            Slot& slot = _slots[r.fd];
+            if (slot.entry != &e || slot.index != n)
+            {
+                // our file descriptor was closed and is now used by another device
+                continue;
+            }
+
+            r.events = pfd.events & (POLLIN|POLLOUT);
+
+            epoll_event ev;
+            ev.events = toEpoll(r.events);
+            ev.data.u64 = (static_cast<uint64_t>(slot.serial) << 32) | static_cast<uint32_t>(r.fd);
+
+            log_debug("epoll_ctl(MOD, " << r.fd << ", " << ev.events << ')');
+            if (::epoll_ctl(_epfd, EPOLL_CTL_MOD, r.fd, &ev) != 0)
+            {
+                // The file descriptor was closed and reopened with the same
+                // number, which removes it from the epoll set.
+                log_debug("epoll_ctl(MOD, " << r.fd << ") failed; errno=" << errno);
+                r.fd = -1;
+                registerFd(e, n);
+            }
+        }
+    }
+}
+
+
+void EpollSelectorImpl::registerFd(Entry& e, unsigned index)
+{
+    const pollfd& pfd = e.pollfds[index];
+    Registration& r = e.registered[index];
+
+    r.fd = pfd.fd;
+    r.events = pfd.events & (POLLIN|POLLOUT);
+    r.polled = true;
+
+    if (r.fd < 0)
+        return;
+
+    if (static_cast<std::size_t>(r.fd) >= _slots.size())
+        _slots.resize(r.fd + 1);
+
+    Slot& slot = _slots[r.fd];
+    slot.entry = &e;
+    slot.index = index;
+    slot.serial = ++_serial;
+
+    epoll_event ev;
+    ev.events = toEpoll(r.events);
+    ev.data.u64 = (static_cast<uint64_t>(slot.serial) << 32) | static_cast<uint32_t>(r.fd);
+
+    log_debug("epoll_ctl(ADD, " << r.fd << ", " << ev.events << ')');
+    int ret = ::epoll_ctl(_epfd, EPOLL_CTL_ADD, r.fd, &ev);
+    if (ret != 0 && errno == EEXIST)
+        ret = ::epoll_ctl(_epfd, EPOLL_CTL_MOD, r.fd, &ev);
+
+    if (ret != 0)
+    {
+        // epoll does not support regular files; they are always ready like
+        // with poll
+        log_debug("epoll_ctl(ADD, " << r.fd << ") failed; errno=" << errno);
+        if (errno != EPERM)
+            log_warn("failed to add fd " << r.fd << " to epoll set; errno=" << errno);
+
+        slot = Slot();
+        r.polled = false;
+        if (e.unpolled++ == 0)
+            _unpolled.insert(&e);
+    }
+}
+
+
+void EpollSelectorImpl::unregisterFd(Entry& e, unsigned index)
+{
+    Registration& r = e.registered[index];
+    if (r.fd < 0)
+        return;
+
+    if (!r.polled)
+    {
+        if (--e.unpolled == 0)
+            _unpolled.erase(&e);
+    }
+    else if (static_cast<std::size_t>(r.fd) < _slots.size()
+            && _slots[r.fd].entry == &e && _slots[r.fd].index == index)
+    {
+        log_debug("epoll_ctl(DEL, " << r.fd << ')');
+
+        // fails when the fd is already closed, which is fine
+        ::epoll_ctl(_epfd, EPOLL_CTL_DEL, r.fd, 0);
+        _slots[r.fd] = Slot();
+    }
+
+    r = Registration();
+}
+
+
+void EpollSelectorImpl::collect()
+{
+    for (unsigned n = 0; n < _dirty.size(); ++n)
+    {
+        Entry* e = _dirty[n];
+        e->dirty = false;
+        if (e->dev)
+            update(*e);
+    }
+
+    _dirty.clear();
+
+    for (unsigned n = 0; n < _garbage.size(); ++n)
+        delete _garbage[n];
+
+    _garbage.clear();
+}
+
+
+void EpollSelectorImpl::dispatchCleanup()
+{
+    for (unsigned n = 0; n < _ready.size(); ++n)
+    {
+        Entry* e = _ready[n];
+        e->pending = false;
+        for (unsigned i = 0; i < e->pollfds.size(); ++i)
+            e->pollfds[i].revents = 0;
+    }
+
+    _ready.clear();
+}
+
+
+bool EpollSelectorImpl::waitUntil(Timespan until)
+{
+    collect();
+
+    if (!_avail.empty())
+        until = Timespan(0);
+
+    for (std::set<Entry*>::const_iterator it = _unpolled.begin(); it != _unpolled.end(); ++it)
+    {
+        const Entry* e = *it;
+        for (unsigned n = 0; n < e->pollfds.size(); ++n)
+            if (!e->registered[n].polled && (e->pollfds[n].events & (POLLIN|POLLOUT)))
+                until = Timespan(0);
+    }
+
+    int pollTimeout = until == Timespan(0) ? 0 : -1;
+
+    int ret = -1;
+    while (true)
+    {
+        if (until > Timespan(0))
+        {
+            Timespan remaining = until - Timespan::gettimeofday();
+            if (remaining < Timespan(0))
+                remaining = Timespan(0);
+
+            if (Milliseconds(remaining) >= std::numeric_limits<int>::max())
+                pollTimeout = std::numeric_limits<int>::max();
+            else
+                pollTimeout = Milliseconds(remaining).ceil();
+
+            log_debug("remaining " << remaining);
+        }
+        else
+            log_debug("no timeout");
+
+        log_debug("epoll_wait with " << _devices.size() << " devices, timeout=" << pollTimeout << "ms");
+        ret = ::epoll_wait(_epfd, &_events[0], _events.size(), pollTimeout);
+        log_debug("epoll_wait returns " << ret);
+
+        if( ret != -1 )
+            break;
+
+        if( errno != EINTR )
+            throw IOError("Could not poll on file descriptors");
+    }
+
+    if (ret == 0 && _avail.empty() && _unpolled.empty())
+        return false;
+
+    bool avail = false;
+    try
+    {
+        for (int n = 0; n < ret; ++n)
+        {
+            const epoll_event& ev = _events[n];
+            if (ev.data.u64 == wakeData)
+            {
+                if (readWakePipe(toPoll(ev.events)))
+                    avail = true;
+                continue;
+            }
+
+            int fd = static_cast<int>(ev.data.u64 & 0xffffffff);
+            uint32_t serial = static_cast<uint32_t>(ev.data.u64 >> 32);
+
+            // skip events of fds, which were removed or reused in the meantime
+            if (static_cast<std::size_t>(fd) >= _slots.size() || _slots[fd].serial != serial)
+                continue;
+
+            Entry* e = _slots[fd].entry;
+            e->pollfds[_slots[fd].index].revents = toPoll(ev.events);
+            if (!e->pending)
+            {
+                e->pending = true;
+                _ready.push_back(e);
+            }
+        }
+
+        for (std::set<Selectable*>::const_iterator it = _avail.begin(); it != _avail.end(); ++it)
+        {
+            std::unordered_map<Selectable*, Entry*>::const_iterator dit = _devices.find(*it);
+            if (dit != _devices.end() && !dit->second->pending)
+            {
+                dit->second->pending = true;
+                _ready.push_back(dit->second);
+            }
+        }
+
+        for (std::set<Entry*>::const_iterator it = _unpolled.begin(); it != _unpolled.end(); ++it)
+        {
+            Entry* e = *it;
+            for (unsigned n = 0; n < e->pollfds.size(); ++n)
+            {
+                if (!e->registered[n].polled)
+                    e->pollfds[n].revents = e->pollfds[n].events & (POLLIN|POLLOUT);
+            }
+
+            if (!e->pending)
+            {
+                e->pending = true;
+                _ready.push_back(e);
+            }
+        }
+
+        // Callbacks may add and remove devices; removed entries are kept
+        // until the next wait, so the pointers in _ready stay valid.
+        for (unsigned n = 0; n < _ready.size(); ++n)
+        {
+            Entry* e = _ready[n];
+            Selectable* dev = e->dev;
+
+            if (dev && dev->enabled() && dev->simpl().checkPollEvent())
+                avail = true;
+
+            if (e->dev)
+                markDirty(*e);
+        }
+    }
+    catch (...)
+    {
+        dispatchCleanup();
+        throw;
+    }
+
+    dispatchCleanup();
+
+    if (static_cast<std::size_t>(ret) == _events.size() && _events.size() < 4096)
+        _events.resize(_events.size() * 2);
+
+    return avail;
+}
+
+} //namespace cxxtools
@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_SYSTEM_POSIX_EPOLLSELECTORIMPL_H
+#define CXXTOOLS_SYSTEM_POSIX_EPOLLSELECTORIMPL_H
+
+#include "selectorimpl.h"
+#include "selectableimpl.h"
+#include <sys/epoll.h>
+#include <sys/poll.h>
+#include <stdint.h>
+#include <vector>
+#include <set>
+#include <unordered_map>
+
+namespace cxxtools {
+
+/** @internal Selector backend using the linux epoll interface.
+
+    The file descriptors are registered in the epoll set when a device is
+    added or changes its poll events, so that the cost of a wait does not
+    depend on the number of idle devices. The devices still see the usual
+    pollfd structures. The poll events are level triggered, so that the
+    devices do not need to read or write until EAGAIN.
+ */
+class EpollSelectorImpl : public SelectorImpl
+{
+    public:
+        EpollSelectorImpl();
+
+        ~EpollSelectorImpl();
+
+        void add( Selectable& dev );
+
+        void remove( Selectable& dev );
+
+        void changed( Selectable& dev );
+
+        void reinit( Selectable& dev );
+
+        bool waitUntil(Timespan timeout);
+
+    private:
+        struct Registration
+        {
+            int fd;
+            short events;
+            bool polled;    // false if epoll does not support the fd (e.g. regular files)
+
+            Registration()
+                : fd(-1),
+                  events(0),
+                  polled(true)
+                { }
+        };
+
+        struct Entry : public SelectableImpl::PollListener
+        {
+            EpollSelectorImpl& selector;
+            Selectable* dev;
+            std::vector<pollfd> pollfds;
+            std::vector<Registration> registered;
+            unsigned unpolled;
+            bool dirty;
+            bool pending;
+
+            Entry(EpollSelectorImpl& selector_, Selectable& dev_)
+                : selector(selector_),
+                  dev(&dev_),
+                  unpolled(0),
+                  dirty(false),
+                  pending(false)
+                { }
+
+            void onPollChanged(SelectableImpl&)
+            { selector.markDirty(*this); }
+        };
+
+        struct Slot
+        {
+            Entry* entry;
+            unsigned index;
+            uint32_t serial;
+
+            Slot()
+                : entry(0),
+                  index(0),
+                  serial(0)
+                { }
+        };
+
+        void initEntry(Entry& e);
+        void markDirty(Entry& e);
+        void update(Entry& e);
+        void registerFd(Entry& e, unsigned index);
+        void unregisterFd(Entry& e, unsigned index);
+        void collect();
+        void dispatchCleanup();
+
+        int _epfd;
+        uint32_t _serial;
+        std::unordered_map<Selectable*, Entry*> _devices;
+        std::vector<Slot> _slots;
+        std::vector<Entry*> _dirty;
+        std::vector<Entry*> _ready;
+        std::vector<Entry*> _garbage;
+        std::set<Entry*> _unpolled;
+        std::vector<epoll_event> _events;
+};
+
+}//namespace cxxtools
+
+#endif
@@ -27,8 +27,10 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
 #include "selectorimpl.h"
+#include "eventqueue.h"
 #include "cxxtools/eventloop.h"
 #include "cxxtools/log.h"
+#include <atomic>
 #include <deque>
 #include <mutex>
 
@@ -56,39 +58,29 @@ class EventLoop::Impl
 public:
     Impl()
         : _exitLoop(false),
-          _selector(new SelectorImpl()),
+          _wakePending(false),
+          _selector(SelectorImpl::create()),
+          _priorityEvents(0),
           _eventsPerLoop(16)
         { }
     ~Impl();
 
     bool eventQueueEmpty() const
-    { return _eventQueue.empty() && _priorityEventQueue.empty() && _activeEventQueue.empty(); }
+    { return _eventQueue.empty() && _priorityEvents.load(std::memory_order_acquire) == 0; }
 
     unsigned pendingEvents() const
-    { return _eventQueue.size() + _priorityEventQueue.size() + _activeEventQueue.size(); }
+    { return _eventQueue.size() + _priorityEvents.load(std::memory_order_acquire); }
 
-    Event* front()
-    {
-        if (_priorityEventQueue.empty())
-            return _eventQueue.front();
-        else
-            return _priorityEventQueue.front();
-    }
+    std::atomic<bool> _exitLoop;
 
-    void pop_front()
-    {
-        if (_priorityEventQueue.empty())
-            _eventQueue.pop_front();
-        else
-            _priorityEventQueue.pop_front();
-    }
+    // set by the first commitEvent after the loop looked at the queues,
+    // so that only one wake up is sent for a batch of events
+    std::atomic<bool> _wakePending;
 
-    bool _exitLoop;
     SelectorImpl* _selector;
-    std::deque<Event*> _eventQueue;
+    EventQueue _eventQueue;
     std::deque<Event*> _priorityEventQueue;
-    std::deque<Event*> _activeEventQueue;
-    bool _activeEventQueueIsPriority;
+    std::atomic<unsigned> _priorityEvents;
     std::mutex _queueMutex;
     unsigned _eventsPerLoop;
 };
@@ -97,28 +89,12 @@ EventLoop::Impl::~Impl()
 {
     try
     {
-        while ( ! _eventQueue.empty() )
-        {
-            Event* ev = _eventQueue.front();
-            _eventQueue.pop_front();
-            ev->destroy();
-        }
-
         while ( ! _priorityEventQueue.empty() )
         {
             Event* ev = _priorityEventQueue.front();
             _priorityEventQueue.pop_front();
             ev->destroy();
         }
-
-        while ( ! _activeEventQueue.empty() )
-        {
-            Event* ev = _activeEventQueue.front();
-            _activeEventQueue.pop_front();
-            if (ev)
-                ev->destroy();
-        }
-
     }
     catch(...)
     {}
@@ -165,8 +141,9 @@ void EventLoop::onRemove( Selectable& s )
 }
 
 
-void EventLoop::onReinit(Selectable& /*s*/)
+void EventLoop::onReinit(Selectable& s)
 {
+    _impl->_selector->reinit(s);
 }
 
 
@@ -182,16 +159,13 @@ void EventLoop::onRun()
 
     while (true)
     {
-        std::unique_lock<std::mutex> lock(_impl->_queueMutex);
-
-        if (_impl->_exitLoop)
-        {
-            _impl->_exitLoop = false;
+        if (_impl->_exitLoop.exchange(false))
             break;
-        }
+
+        _impl->_wakePending.store(false);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
 
         bool eventQueueEmpty = _impl->eventQueueEmpty();
-        lock.unlock();
         if (!eventQueueEmpty)
         {
             processEvents(_impl->_eventsPerLoop);
@@ -219,15 +193,16 @@ void EventLoop::onRun()
 
 bool EventLoop::onWaitUntil(Timespan timeout)
 {
-    if (_impl->_selector->waitUntil(timeout))
-    {
-        std::unique_lock<std::mutex> lock(_impl->_queueMutex);
+    // Events committed from now on wake the selector again. Events, which
+    // are already queued, must not wait for the timeout.
+    _impl->_wakePending.store(false);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    bool pending = !_impl->eventQueueEmpty();
 
+    if (_impl->_selector->waitUntil(pending ? Timespan(0) : timeout) || pending)
+    {
         if (!_impl->eventQueueEmpty())
-        {
-            lock.unlock();
             processEvents(_impl->_eventsPerLoop);
-        }
 
         return true;
     }
@@ -246,10 +221,7 @@ void EventLoop::onExit()
 {
     log_debug("exit loop");
 
-    {
-        std::lock_guard<std::mutex> lock(_impl->_queueMutex);
-        _impl->_exitLoop = true;
-    }
+    _impl->_exitLoop.store(true);
 
     wake();
 }
@@ -258,23 +230,32 @@ void EventLoop::onQueueEvent(const Event& ev, bool priority)
 {
     log_debug("queue event");
 
-    std::lock_guard<std::mutex> lock( _impl->_queueMutex );
-
-    EvPtr cloned(ev.clone());
-
     if (priority)
+    {
+        std::lock_guard<std::mutex> lock( _impl->_queueMutex );
+
+        EvPtr cloned(ev.clone());
         _impl->_priorityEventQueue.push_back(cloned.ev);
-    else
-        _impl->_eventQueue.push_back(cloned.ev);
+        cloned.ev = 0;
 
-    cloned.ev = 0;
+        _impl->_priorityEvents.fetch_add(1, std::memory_order_release);
+    }
+    else
+    {
+        _impl->_eventQueue.push(ev);
+    }
 }
 
 
 void EventLoop::onCommitEvent(const Event& ev, bool priority)
 {
     onQueueEvent(ev, priority);
-    _impl->_selector->wake();
+
+    // pairs with the fence in onRun and onWaitUntil: either the loop sees
+    // the new event or we see, that it needs a wake up
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!_impl->_wakePending.exchange(true))
+        _impl->_selector->wake();
 }
 
 
@@ -282,69 +263,55 @@ void EventLoop::onProcessEvents(unsigned max)
 {
     unsigned count = 0;
 
-    bool& exitLoop = _impl->_exitLoop;
-    std::deque<Event*>& eventQueue = _impl->_eventQueue;
+    std::atomic<bool>& exitLoop = _impl->_exitLoop;
+    EventQueue& eventQueue = _impl->_eventQueue;
     std::deque<Event*>& priorityEventQueue = _impl->_priorityEventQueue;
-    std::deque<Event*>& activeEventQueue = _impl->_activeEventQueue;
-    bool& activeEventQueueIsPriority = _impl->_activeEventQueueIsPriority;
+    std::atomic<unsigned>& priorityEvents = _impl->_priorityEvents;
     auto& queueMutex = _impl->_queueMutex;
 
-    log_debug("processEvents(max:" << max << ") normal/priority/active(priority): " << eventQueue.size() << '/' << priorityEventQueue.size() << '/' << activeEventQueue.size() << '(' << activeEventQueueIsPriority << ')');
+    log_debug("processEvents(max:" << max << ") normal/priority: " << eventQueue.size() << '/' << priorityEvents.load());
 
-    if (!activeEventQueue.empty() && !activeEventQueueIsPriority)
+    while (!exitLoop.load(std::memory_order_relaxed))
     {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        if (!priorityEventQueue.empty())
+        // priority events bypass all normal events
+        if (priorityEvents.load(std::memory_order_acquire) > 0)
         {
-            log_debug("priority events bypass active events");
-
-            if (eventQueue.empty())
-            {
-                eventQueue.swap(activeEventQueue);
-            }
-            else
+            std::unique_lock<std::mutex> lock(queueMutex);
+            if (!priorityEventQueue.empty())
             {
-                eventQueue.insert(eventQueue.begin(), activeEventQueue.begin(), activeEventQueue.end()); 
-                activeEventQueue.clear();
-            }
+                EvPtr ev(priorityEventQueue.front());
+                priorityEventQueue.pop_front();
+                priorityEvents.fetch_sub(1, std::memory_order_release);
+                lock.unlock();
 
-            priorityEventQueue.swap(activeEventQueue);
-            activeEventQueueIsPriority = true;
-        }
-    }
+                ++count;
 
-    while (!exitLoop)
-    {
-        if (activeEventQueue.empty())
-        {
-            std::lock_guard<std::mutex> lock(queueMutex);
-            if (!priorityEventQueue.empty())
-            {
-                log_debug("move " << priorityEventQueue.size() << " priority events to active event queue");
-                activeEventQueueIsPriority = true;
-                activeEventQueue.swap(priorityEventQueue);
-            }
-            else if (!eventQueue.empty())
-            {
-                log_debug("move " << eventQueue.size() << " events to active event queue");
-                activeEventQueueIsPriority = false;
-                activeEventQueue.swap(eventQueue);
+                log_debug("send priority event " << count);
+                event.send(*ev.ev);
+
+                if (max != 0 && count >= max)
+                {
+                    log_debug("maximum number of events per loop " << max << " reached");
+                    break;
+                }
+
+                continue;
             }
         }
 
-        if (exitLoop || activeEventQueue.empty())
+        // The event is processed in place and released, when the entry
+        // goes out of scope. Handlers may process further events meanwhile.
+        EventQueue::Entry entry;
+        if (!eventQueue.take(entry))
         {
-            log_debug_if(activeEventQueue.empty(), "no events to process");
+            log_debug("no events to process");
             break;
         }
 
-        EvPtr ev(activeEventQueue.front());
-        activeEventQueue.pop_front();
-
         ++count;
 
         log_debug("send event " << count);
-        event.send(*ev.ev);
+        event.send(*entry.event());
 
         if (max != 0 && count >= max)
         {
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cxxtools/eventloopgroup.h>
+#include <cxxtools/log.h>
+#include <stdexcept>
+
+log_define("cxxtools.eventloopgroup")
+
+namespace cxxtools
+{
+
+EventLoopGroup::EventLoopGroup(unsigned size)
+    : _next(0)
+{
+    resize(size);
+}
+
+EventLoopGroup::~EventLoopGroup()
+{
+    stop();
+    resize(0);
+}
+
+void EventLoopGroup::resize(unsigned size)
+{
+    if (running())
+        throw std::logic_error("can't resize running event loop group");
+
+    while (_loops.size() > size)
+    {
+        delete _loops.back();
+        _loops.pop_back();
+    }
+
+    while (_loops.size() < size)
+        _loops.push_back(new EventLoop());
+}
+
+void EventLoopGroup::start()
+{
+    if (running())
+        return;
+
+    log_debug("start " << _loops.size() << " event loops");
+
+    for (unsigned n = 0; n < _loops.size(); ++n)
+        _threads.push_back(std::thread(&EventLoop::run, _loops[n]));
+}
+
+void EventLoopGroup::stop()
+{
+    if (!running())
+        return;
+
+    log_debug("stop " << _loops.size() << " event loops");
+
+    for (unsigned n = 0; n < _loops.size(); ++n)
+        _loops[n]->exit();
+
+    for (unsigned n = 0; n < _threads.size(); ++n)
+        _threads[n].join();
+
+    _threads.clear();
+}
+
+}
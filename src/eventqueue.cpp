@@ -0,0 +1,218 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "eventqueue.h"
+
+namespace cxxtools {
+
+void EventQueue::Entry::release()
+{
+    if (_event == 0)
+        return;
+
+    Event* ev = _event;
+    _event = 0;
+
+    if (_cell)
+    {
+        if (_cell->inplace())
+            ev->~Event();
+        else
+            ev->destroy();
+
+        _cell->event = 0;
+        _cell->sequence.store(_pos + _queue->_mask + 1, std::memory_order_release);
+        _cell = 0;
+    }
+    else
+    {
+        ev->destroy();
+    }
+}
+
+EventQueue::EventQueue(size_type capacity)
+    : _head(0),
+      _tail(0),
+      _mask(0),
+      _overflowSize(0)
+{
+    size_type size = 2;
+    while (size < capacity)
+        size <<= 1;
+
+    _cells.reset(new Cell[size]);
+    _mask = size - 1;
+
+    for (size_type n = 0; n < size; ++n)
+    {
+        _cells[n].sequence.store(n, std::memory_order_relaxed);
+        _cells[n].event = 0;
+    }
+}
+
+EventQueue::~EventQueue()
+{
+    try
+    {
+        Entry entry;
+        while (take(entry))
+            entry.release();
+    }
+    catch (...)
+    {
+    }
+}
+
+bool EventQueue::tryPush(const Event& ev)
+{
+    size_type pos = _head.load(std::memory_order_relaxed);
+    Cell* cell;
+
+    while (true)
+    {
+        cell = &_cells[pos & _mask];
+        size_type seq = cell->sequence.load(std::memory_order_acquire);
+        std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+        if (diff == 0)
+        {
+            if (_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0)
+            return false;
+        else
+            pos = _head.load(std::memory_order_relaxed);
+    }
+
+    try
+    {
+        cell->event = ev.cloneTo(cell->storage, BufferSize);
+        if (cell->event == 0)
+            cell->event = ev.clone();
+    }
+    catch (...)
+    {
+        // the cell is claimed already; publish it empty, so that the
+        // consumer skips it
+        cell->event = 0;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        throw;
+    }
+
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+void EventQueue::push(const Event& ev)
+{
+    if (_overflowSize.load(std::memory_order_acquire) == 0 && tryPush(ev))
+        return;
+
+    std::lock_guard<std::mutex> lock(_overflowMutex);
+
+    // The consumer may have emptied the overflow list or freed cells in the
+    // meantime. Once the list is empty, the ring may be used again.
+    if (_overflowSize.load(std::memory_order_relaxed) == 0 && tryPush(ev))
+        return;
+
+    Event* cloned = ev.clone();
+    try
+    {
+        _overflow.push_back(cloned);
+    }
+    catch (...)
+    {
+        cloned->destroy();
+        throw;
+    }
+
+    _overflowSize.fetch_add(1, std::memory_order_release);
+}
+
+bool EventQueue::take(Entry& entry)
+{
+    entry.release();
+
+    while (true)
+    {
+        size_type pos = _tail.load(std::memory_order_relaxed);
+        Cell& cell = _cells[pos & _mask];
+        if (cell.sequence.load(std::memory_order_acquire) != pos + 1)
+        {
+            // A producer has claimed the cell but not published its event
+            // yet. Events in the overflow list were pushed later, so they
+            // have to wait. The producer wakes the loop when it is done.
+            if (_head.load(std::memory_order_acquire) != pos)
+                return false;
+            break;
+        }
+
+        _tail.store(pos + 1, std::memory_order_release);
+
+        entry._queue = this;
+        entry._cell = &cell;
+        entry._pos = pos;
+        entry._event = cell.event;
+
+        if (entry._event)
+            return true;
+
+        // a producer failed to copy its event; just give the cell back
+        cell.sequence.store(pos + _mask + 1, std::memory_order_release);
+        entry._cell = 0;
+    }
+
+    if (_overflowSize.load(std::memory_order_acquire) == 0)
+        return false;
+
+    std::lock_guard<std::mutex> lock(_overflowMutex);
+    if (_overflow.empty())
+        return false;
+
+    entry._queue = this;
+    entry._cell = 0;
+    entry._event = _overflow.front();
+    _overflow.pop_front();
+    _overflowSize.fetch_sub(1, std::memory_order_release);
+
+    return true;
+}
+
+bool EventQueue::empty() const
+{
+    return size() == 0;
+}
+
+EventQueue::size_type EventQueue::size() const
+{
+    size_type tail = _tail.load(std::memory_order_acquire);
+    size_type head = _head.load(std::memory_order_acquire);
+    return (head > tail ? head - tail : 0) + _overflowSize.load(std::memory_order_acquire);
+}
+
+}
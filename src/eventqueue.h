@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_EVENTQUEUE_H
+#define CXXTOOLS_EVENTQUEUE_H
+
+#include <cxxtools/event.h>
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+namespace cxxtools {
+
+/** @internal Multi producer single consumer queue of events.
+
+    The events are copied into a preallocated ring buffer. Events, which
+    fit into the storage of a cell are constructed in place using
+    Event::cloneTo, larger events are cloned to the heap. Putting an event
+    into the ring and taking it out does not lock.
+
+    When the ring is full, events are cloned to a mutex protected overflow
+    list. While the overflow list is not empty, new events are appended
+    there too, so that the events of one producer keep their order.
+
+    The consumer processes the event in place. An event taken from the queue
+    is released when the Entry is released or destroyed, so the consumer may
+    take further events while processing one.
+ */
+class EventQueue
+{
+        EventQueue(const EventQueue&) = delete;
+        EventQueue& operator=(const EventQueue&) = delete;
+
+    public:
+        typedef std::size_t size_type;
+
+        /// Space for events constructed in place; fills a cell to 64 bytes.
+        static const size_type BufferSize = 48;
+
+        class Entry;
+
+    private:
+        struct Cell
+        {
+            std::atomic<size_type> sequence;
+            Event* event;
+            alignas(std::max_align_t) char storage[BufferSize];
+
+            bool inplace() const
+            {
+                const char* p = reinterpret_cast<const char*>(event);
+                return p >= storage && p < storage + BufferSize;
+            }
+        };
+
+    public:
+        /// An event taken from the queue.
+        class Entry
+        {
+                friend class EventQueue;
+
+                Entry(const Entry&) = delete;
+                Entry& operator=(const Entry&) = delete;
+
+                EventQueue* _queue;
+                Cell* _cell;
+                size_type _pos;
+                Event* _event;
+
+            public:
+                Entry()
+                    : _queue(0),
+                      _cell(0),
+                      _pos(0),
+                      _event(0)
+                { }
+
+                ~Entry()
+                { release(); }
+
+                Event* event() const
+                { return _event; }
+
+                /// Destroys the event and gives its storage back to the queue.
+                void release();
+        };
+
+        /// The capacity of the ring is rounded up to the next power of two.
+        explicit EventQueue(size_type capacity = 1024);
+        ~EventQueue();
+
+        /// Copies the event into the queue. May be called from any thread.
+        void push(const Event& ev);
+
+        /// Takes the next event. Must be called from the consumer thread only.
+        bool take(Entry& entry);
+
+        bool empty() const;
+
+        size_type size() const;
+
+    private:
+        bool tryPush(const Event& ev);
+
+        // keep producer and consumer positions on separate cache lines
+        char _pad0[64];
+        std::atomic<size_type> _head;
+        char _pad1[64 - sizeof(std::atomic<size_type>)];
+        std::atomic<size_type> _tail;
+        char _pad2[64 - sizeof(std::atomic<size_type>)];
+
+        std::unique_ptr<Cell[]> _cells;
+        size_type _mask;
+
+        std::atomic<size_type> _overflowSize;
+        std::mutex _overflowMutex;
+        std::deque<Event*> _overflow;
+};
+
+}
+
+#endif // CXXTOOLS_EVENTQUEUE_H
@@ -121,6 +121,11 @@ void Client::close()
         _impl->close();
 }
 
+bool Client::isConnected() const
+{
+    return _impl && _impl->isConnected();
+}
+
 const ReplyHeader& Client::execute(const Request& request, Milliseconds timeout, Milliseconds connectTimeout)
 {
     try
@@ -325,6 +325,8 @@ void ClientImpl::sendRequest(const Request& request)
     static const char* authorization = "Authorization";
     static const char* userAgent = "User-Agent";
 
+    std::string body = request.bodyStr();
+
     _stream << request.method() << ' '
             << request.url();
 
@@ -343,7 +345,7 @@ void ClientImpl::sendRequest(const Request& request)
 
     if (!request.header().hasHeader(contentLength))
     {
-        _stream << "Content-Length: " << request.bodySize() << "\r\n";
+        _stream << "Content-Length: " << body.size() << "\r\n";
     }
 
     if (!request.header().hasHeader(connection))
@@ -385,9 +387,9 @@ void ClientImpl::sendRequest(const Request& request)
 
     _stream << "\r\n";
 
-    log_debug("send body; " << request.bodySize() << " bytes");
+    log_debug("send body; " << body.size() << " bytes");
 
-    request.sendBody(_stream);
+    _stream.putSlice(std::move(body));
 }
 
 void ClientImpl::onConnect(net::TcpSocket& socket)
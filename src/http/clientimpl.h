@@ -142,6 +142,11 @@ class ClientImpl : public RefCounted, public Connectable
             _socket.close();
         }
 
+        bool isConnected() const
+        {
+            return _socket.isConnected();
+        }
+
         // Sends the passed request to the server and parses the headers.
         // The body must be read with readBody.
         // This method blocks or times out until the body is parsed.
@@ -0,0 +1,496 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cxxtools/http/clientpool.h>
+#include <cxxtools/net/addrinfo.h>
+#include <cxxtools/net/uri.h>
+#include <cxxtools/sslctx.h>
+#include <cxxtools/clock.h>
+#include <cxxtools/ioerror.h>
+#include <cxxtools/log.h>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+log_define("cxxtools.http.clientpool")
+
+namespace cxxtools
+{
+namespace http
+{
+
+class ClientPoolImpl
+{
+        struct IdleClient
+        {
+            Client* client;
+            Timespan since;
+
+            IdleClient(Client* client_, Timespan since_)
+                : client(client_),
+                  since(since_)
+                { }
+        };
+
+        struct Host
+        {
+            // most recently returned connections at the back
+            std::deque<IdleClient> idle;
+            unsigned leased;
+
+            Host()
+                : leased(0)
+                { }
+        };
+
+        typedef std::map<std::string, Host> Hosts;
+
+        // deletes clients after the mutex is released, since closing a ssl
+        // connection may take some time
+        class Garbage
+        {
+                std::vector<Client*> _clients;
+
+            public:
+                ~Garbage()
+                {
+                    for (unsigned n = 0; n < _clients.size(); ++n)
+                        delete _clients[n];
+                }
+
+                void add(Client* client)
+                { _clients.push_back(client); }
+
+                unsigned size() const
+                { return _clients.size(); }
+        };
+
+        mutable std::mutex _mutex;
+        std::condition_variable _returned;
+        Hosts _hosts;
+
+        SslCtx _sslCtx;
+        unsigned _maxPerHost;
+        Milliseconds _maxIdleTime;
+
+        unsigned long _hits;
+        unsigned long _misses;
+
+        void evictIdle(Host& host, Timespan now, Garbage& garbage);
+
+    public:
+        explicit ClientPoolImpl(const SslCtx& sslCtx)
+            : _sslCtx(sslCtx),
+              _maxPerHost(8),
+              _maxIdleTime(Seconds(60)),
+              _hits(0),
+              _misses(0)
+            { }
+
+        ~ClientPoolImpl();
+
+        Client* lease(const std::string& key, const std::string& host, unsigned short port,
+            bool ssl, Milliseconds timeout);
+        void release(const std::string& key, Client* client, bool keep);
+
+        void maxPerHost(unsigned n)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _maxPerHost = n;
+        }
+
+        unsigned maxPerHost() const
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _maxPerHost;
+        }
+
+        void maxIdleTime(Milliseconds t)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _maxIdleTime = t;
+        }
+
+        Milliseconds maxIdleTime() const
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _maxIdleTime;
+        }
+
+        unsigned evictIdle();
+        void clear();
+
+        unsigned long hits() const
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _hits;
+        }
+
+        unsigned long misses() const
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _misses;
+        }
+
+        unsigned idle() const;
+        unsigned leased() const;
+};
+
+ClientPoolImpl::~ClientPoolImpl()
+{
+    for (Hosts::iterator it = _hosts.begin(); it != _hosts.end(); ++it)
+    {
+        if (it->second.leased > 0)
+            log_warn(it->second.leased << " connections to " << it->first << " still leased when the pool is destroyed");
+
+        for (unsigned n = 0; n < it->second.idle.size(); ++n)
+            delete it->second.idle[n].client;
+    }
+}
+
+void ClientPoolImpl::evictIdle(Host& host, Timespan now, Garbage& garbage)
+{
+    while (!host.idle.empty() && now - host.idle.front().since > _maxIdleTime)
+    {
+        garbage.add(host.idle.front().client);
+        host.idle.pop_front();
+    }
+}
+
+Client* ClientPoolImpl::lease(const std::string& key, const std::string& hostName, unsigned short port,
+    bool ssl, Milliseconds timeout)
+{
+    Garbage garbage;
+    Client* client = 0;
+    SslCtx sslCtx;
+
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+
+        Host& host = _hosts[key];
+        Timespan now = Clock::getSystemTicks();
+        Timespan deadline = now + timeout;
+
+        while (true)
+        {
+            evictIdle(host, now, garbage);
+
+            // The most recently used connection is least likely closed by
+            // the server. A connection closed by the server later is
+            // reconnected by the client on the next request.
+            while (!host.idle.empty())
+            {
+                Client* c = host.idle.back().client;
+                host.idle.pop_back();
+                if (c->isConnected())
+                {
+                    client = c;
+                    break;
+                }
+
+                garbage.add(c);
+            }
+
+            if (client)
+            {
+                ++_hits;
+                break;
+            }
+
+            if (host.leased < _maxPerHost)
+            {
+                ++_misses;
+                break;
+            }
+
+            log_debug("all " << host.leased << " connections to " << key << " leased; wait");
+            if (timeout < Timespan(0))
+            {
+                _returned.wait(lock);
+            }
+            else
+            {
+                if (now >= deadline
+                    || _returned.wait_for(lock, std::chrono::milliseconds(static_cast<long>((deadline - now).totalMSecs()))) == std::cv_status::timeout)
+                {
+                    // another waiter may have got the connection
+                    if (host.leased >= _maxPerHost && host.idle.empty())
+                        throw IOTimeout();
+                }
+            }
+
+            now = Clock::getSystemTicks();
+        }
+
+        ++host.leased;
+
+        if (!client && ssl)
+        {
+            if (!_sslCtx.enabled())
+                _sslCtx.enable();
+            sslCtx = _sslCtx;
+        }
+    }
+
+    if (client)
+    {
+        log_debug("reuse connection to " << key);
+        return client;
+    }
+
+    log_debug("new connection to " << key);
+
+    try
+    {
+        client = new Client();
+        client->prepareConnect(net::AddrInfo(hostName, port), sslCtx);
+    }
+    catch (...)
+    {
+        delete client;
+        release(key, 0, false);
+        throw;
+    }
+
+    return client;
+}
+
+void ClientPoolImpl::release(const std::string& key, Client* client, bool keep)
+{
+    Garbage garbage;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        Host& host = _hosts[key];
+        --host.leased;
+
+        Timespan now = Clock::getSystemTicks();
+        evictIdle(host, now, garbage);
+
+        if (client)
+        {
+            if (keep && client->isConnected())
+                host.idle.push_back(IdleClient(client, now));
+            else
+                garbage.add(client);
+        }
+    }
+
+    _returned.notify_all();
+}
+
+unsigned ClientPoolImpl::evictIdle()
+{
+    Garbage garbage;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    Timespan now = Clock::getSystemTicks();
+    for (Hosts::iterator it = _hosts.begin(); it != _hosts.end(); ++it)
+        evictIdle(it->second, now, garbage);
+
+    log_debug_if(garbage.size() > 0, garbage.size() << " idle connections evicted");
+    return garbage.size();
+}
+
+void ClientPoolImpl::clear()
+{
+    Garbage garbage;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    for (Hosts::iterator it = _hosts.begin(); it != _hosts.end(); ++it)
+    {
+        for (unsigned n = 0; n < it->second.idle.size(); ++n)
+            garbage.add(it->second.idle[n].client);
+        it->second.idle.clear();
+    }
+}
+
+unsigned ClientPoolImpl::idle() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    unsigned count = 0;
+    for (Hosts::const_iterator it = _hosts.begin(); it != _hosts.end(); ++it)
+        count += it->second.idle.size();
+    return count;
+}
+
+unsigned ClientPoolImpl::leased() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    unsigned count = 0;
+    for (Hosts::const_iterator it = _hosts.begin(); it != _hosts.end(); ++it)
+        count += it->second.leased;
+    return count;
+}
+
+////////////////////////////////////////////////////////////////////////
+// ClientPool::Lease
+//
+ClientPool::Lease& ClientPool::Lease::operator=(Lease&& other)
+{
+    if (this != &other)
+    {
+        release();
+        _pool = other._pool;
+        _client = other._client;
+        _key = std::move(other._key);
+        other._client = 0;
+    }
+
+    return *this;
+}
+
+void ClientPool::Lease::release()
+{
+    if (_client)
+    {
+        Client* client = _client;
+        _client = 0;
+        _pool->release(_key, client, true);
+    }
+}
+
+void ClientPool::Lease::discard()
+{
+    if (_client)
+    {
+        Client* client = _client;
+        _client = 0;
+        _pool->release(_key, client, false);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////
+// ClientPool
+//
+ClientPool::ClientPool()
+    : _impl(new ClientPoolImpl(SslCtx()))
+{
+}
+
+ClientPool::ClientPool(const SslCtx& sslCtx)
+    : _impl(new ClientPoolImpl(sslCtx))
+{
+}
+
+ClientPool::~ClientPool()
+{
+    delete _impl;
+}
+
+ClientPool::Lease ClientPool::lease(const net::Uri& uri, Milliseconds timeout)
+{
+    if (uri.protocol() != "http" && uri.protocol() != "https")
+        throw std::runtime_error("only protocols http and https are supported by http client pool");
+
+    std::ostringstream key;
+    key << uri.protocol() << "://" << uri.host() << ':' << uri.port();
+
+    Lease lease(_impl, 0, key.str());
+    lease._client = _impl->lease(lease._key, uri.host(), uri.port(), uri.protocol() == "https", timeout);
+
+    if (uri.user().empty())
+        lease._client->clearAuth();
+    else
+        lease._client->auth(uri.user(), uri.password());
+
+    return lease;
+}
+
+ClientPool::Lease ClientPool::lease(const std::string& host, unsigned short port, Milliseconds timeout)
+{
+    std::ostringstream key;
+    key << "http://" << host << ':' << port;
+
+    Lease lease(_impl, 0, key.str());
+    lease._client = _impl->lease(lease._key, host, port, false, timeout);
+    lease._client->clearAuth();
+    return lease;
+}
+
+void ClientPool::maxPerHost(unsigned n)
+{
+    _impl->maxPerHost(n);
+}
+
+unsigned ClientPool::maxPerHost() const
+{
+    return _impl->maxPerHost();
+}
+
+void ClientPool::maxIdleTime(Milliseconds t)
+{
+    _impl->maxIdleTime(t);
+}
+
+Milliseconds ClientPool::maxIdleTime() const
+{
+    return _impl->maxIdleTime();
+}
+
+unsigned ClientPool::evictIdle()
+{
+    return _impl->evictIdle();
+}
+
+void ClientPool::clear()
+{
+    _impl->clear();
+}
+
+unsigned long ClientPool::hits() const
+{
+    return _impl->hits();
+}
+
+unsigned long ClientPool::misses() const
+{
+    return _impl->misses();
+}
+
+unsigned ClientPool::idle() const
+{
+    return _impl->idle();
+}
+
+unsigned ClientPool::leased() const
+{
+    return _impl->leased();
+}
+
+}
+}
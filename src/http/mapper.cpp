@@ -30,6 +30,7 @@
 #include <cxxtools/http/request.h>
 #include <cxxtools/log.h>
 #include "mapper.h"
+#include <cstring>
 
 log_define("cxxtools.http.mapper")
 
@@ -38,64 +39,302 @@ namespace cxxtools
 namespace http
 {
 
+namespace
+{
+    // Checks whether the regular expression matches just a literal prefix
+    // like "^/static/" or a literal url like "^/index.html$".
+    bool literalRegex(const Regex& regex, std::string& literal, bool& exact)
+    {
+        const std::string& pattern = regex.pattern();
+        if ((regex.cflags() & ~REG_NOSUB) != REG_EXTENDED
+            || pattern.empty() || pattern[0] != '^')
+            return false;
+
+        literal.clear();
+        exact = false;
+
+        for (std::string::size_type n = 1; n < pattern.size(); ++n)
+        {
+            char ch = pattern[n];
+            if (ch == '\\')
+            {
+                if (++n >= pattern.size())
+                    return false;
+
+                ch = pattern[n];
+                if (!std::strchr(".[]()*+?{}|^$\\/", ch))
+                    return false;
+            }
+            else if (ch == '$' && n + 1 == pattern.size())
+            {
+                exact = true;
+                break;
+            }
+            else if (std::strchr(".[]()*+?{}|^$", ch))
+            {
+                return false;
+            }
+
+            literal += ch;
+        }
+
+        return true;
+    }
+}
+
+Mapper::RouteTable::RouteTable(const std::vector<Entry>& entries)
+    : _trie(1)
+{
+    for (unsigned n = 0; n < entries.size(); ++n)
+    {
+        const Entry& entry = entries[n];
+        Route route = { n + 1, entry.service };
+
+        std::string literal;
+        bool exact;
+
+        if (!entry.regex)
+        {
+            _exact[entry.url].push_back(route);
+        }
+        else if (!literalRegex(*entry.regex, literal, exact))
+        {
+            RegexRoute regexRoute = { route, entry.regex };
+            _regex.push_back(regexRoute);
+        }
+        else if (exact)
+        {
+            _exact[literal].push_back(route);
+        }
+        else
+        {
+            unsigned node = 0;
+            for (std::string::size_type p = 0; p < literal.size(); ++p)
+            {
+                std::vector<std::pair<char, unsigned> >& children = _trie[node].children;
+                unsigned c = 0;
+                while (c < children.size() && children[c].first != literal[p])
+                    ++c;
+
+                if (c < children.size())
+                {
+                    node = children[c].second;
+                }
+                else
+                {
+                    children.push_back(std::make_pair(literal[p], unsigned(_trie.size())));
+                    node = _trie.size();
+                    _trie.push_back(TrieNode());
+                }
+            }
+
+            _trie[node].routes.push_back(route);
+        }
+    }
+
+    log_debug(entries.size() << " services; " << _exact.size() << " urls, "
+        << _trie.size() << " prefix nodes, " << _regex.size() << " regular expressions");
+}
+
+void Mapper::RouteTable::consider(const RouteList& routes, unsigned after, const Route*& best)
+{
+    // routes are sorted by order, so the first one after `after` is the candidate
+    for (RouteList::const_iterator it = routes.begin(); it != routes.end(); ++it)
+    {
+        if (it->order > after)
+        {
+            if (!best || it->order < best->order)
+                best = &*it;
+            break;
+        }
+    }
+}
+
+const Mapper::Route* Mapper::RouteTable::find(const std::string& url, unsigned after) const
+{
+    const Route* best = 0;
+
+    std::unordered_map<std::string, RouteList>::const_iterator e = _exact.find(url);
+    if (e != _exact.end())
+        consider(e->second, after, best);
+
+    unsigned node = 0;
+    consider(_trie[node].routes, after, best);
+    for (std::string::size_type p = 0; p < url.size(); ++p)
+    {
+        const std::vector<std::pair<char, unsigned> >& children = _trie[node].children;
+        unsigned c = 0;
+        while (c < children.size() && children[c].first != url[p])
+            ++c;
+
+        if (c >= children.size())
+            break;
+
+        node = children[c].second;
+        consider(_trie[node].routes, after, best);
+    }
+
+    for (std::vector<RegexRoute>::const_iterator it = _regex.begin(); it != _regex.end(); ++it)
+    {
+        if (it->route.order <= after)
+            continue;
+
+        // a later regular expression can't win against the found route
+        if (best && it->route.order > best->order)
+            break;
+
+        if (it->regex->match(url))
+            return &it->route;
+    }
+
+    return best;
+}
+
+// Registers a lookup in the reader count of the current phase, while it
+// uses the routing table.
+class Mapper::ReadLock
+{
+        Mapper& _mapper;
+        unsigned _phase;
+
+    public:
+        explicit ReadLock(Mapper& mapper)
+            : _mapper(mapper)
+        {
+            while (true)
+            {
+                _phase = _mapper._phase.load();
+                _mapper._readers[_phase].fetch_add(1);
+
+                // When the phase was switched meanwhile, the update may
+                // already have seen the old count, so we retry.
+                if (_mapper._phase.load() == _phase)
+                    break;
+
+                release();
+            }
+        }
+
+        ~ReadLock()
+        {
+            release();
+        }
+
+        const RouteTable& routes() const
+        {
+            return *_mapper._routes.load(std::memory_order_acquire);
+        }
+
+    private:
+        void release()
+        {
+            // only an update waiting for the readers of the old phase is woken
+            if (_mapper._readers[_phase].fetch_sub(1) == 1 && _mapper._phase.load() != _phase)
+            {
+                std::lock_guard<std::mutex> lock(_mapper._readersMutex);
+                _mapper._readersFinished.notify_all();
+            }
+        }
+};
+
+Mapper::Mapper()
+    : _routes(new RouteTable(_entries)),
+      _phase(0)
+{
+    _readers[0] = 0;
+    _readers[1] = 0;
+}
+
+Mapper::~Mapper()
+{
+    delete _routes.load();
+}
+
+void Mapper::rebuild()
+{
+    // called with _entriesMutex locked, so there is just one update at a time
+    const RouteTable* old = _routes.exchange(new RouteTable(_entries), std::memory_order_acq_rel);
+
+    unsigned phase = _phase.load();
+    _phase.store(phase ^ 1);
+
+    // Lookups of the old phase may still use the old table and create
+    // responders of a removed service.
+    std::unique_lock<std::mutex> lock(_readersMutex);
+    while (_readers[phase].load() > 0)
+        _readersFinished.wait(lock);
+    lock.unlock();
+
+    delete old;
+}
+
 void Mapper::addService(const std::string& url, Service& service)
 {
     log_debug("add service for url <" << url << '>');
 
-    WriteLockType serviceLock(_serviceMutex);
-    _services.push_back(ServicesType::value_type(url, &service));
+    std::lock_guard<std::mutex> lock(_entriesMutex);
+    Entry entry = { url, std::shared_ptr<const Regex>(), &service };
+    _entries.push_back(entry);
+    rebuild();
 }
 
 void Mapper::addService(Regex&& url, Service& service)
 {
-    log_debug("add service for regex");
+    log_debug("add service for regex <" << url.pattern() << '>');
 
-    WriteLockType serviceLock(_serviceMutex);
-    _services.push_back(ServicesType::value_type(std::move(url), &service));
+    std::lock_guard<std::mutex> lock(_entriesMutex);
+    Entry entry = { std::string(), std::make_shared<const Regex>(std::move(url)), &service };
+    _entries.push_back(entry);
+    rebuild();
 }
 
 void Mapper::removeService(Service& service)
 {
-    WriteLockType serviceLock(_serviceMutex);
-    service.waitIdle();
+    std::lock_guard<std::mutex> lock(_entriesMutex);
 
-    ServicesType::size_type n = 0;
-    while (n < _services.size())
+    std::vector<Entry>::size_type n = 0;
+    while (n < _entries.size())
     {
-        if (_services[n].second == &service)
+        if (_entries[n].service == &service)
         {
-            _services.erase(_services.begin() + n);
+            _entries.erase(_entries.begin() + n);
         }
         else
         {
             ++n;
         }
     }
+
+    // after rebuild no lookup creates a responder of the service any more
+    rebuild();
+
+    service.waitIdle();
 }
 
 Responder* Mapper::getResponder(const Request& request)
 {
     log_debug("get responder for url <" << request.url() << '>');
 
-    ReadLockType serviceLock(_serviceMutex);
+    ReadLock readLock(*this);
+    const RouteTable& routes = readLock.routes();
 
-    for (ServicesType::const_iterator it = _services.begin();
-         it != _services.end(); ++it)
+    unsigned after = 0;
+    while (const Route* route = routes.find(request.url(), after))
     {
-        if (it->first.match(request.url()))
+        Service* service = route->service;
+        if (!service->checkAuth(request))
         {
-            if (!it->second->checkAuth(request))
-            {
-                return _noAuthService.createResponder(request, it->second->realm(), it->second->authContent());
-            }
+            return _noAuthService.createResponder(request, service->realm(), service->authContent());
+        }
 
-            Responder* resp = it->second->doCreateResponder(request);
-            if (resp)
-            {
-                log_debug("got responder");
-                return resp;
-            }
+        Responder* resp = service->doCreateResponder(request);
+        if (resp)
+        {
+            log_debug("got responder");
+            return resp;
         }
+
+        after = route->order;
     }
 
     log_debug("use default responder");
@@ -31,23 +31,41 @@
 
 #include "notfoundservice.h"
 #include "notauthenticatedservice.h"
-#include <map>
 #include <cxxtools/regex.h>
-
-#if __cplusplus >= 201703L
-#include <shared_mutex>
-#else
+#include <atomic>
+#include <condition_variable>
+#include <memory>
 #include <mutex>
-#endif
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace cxxtools
 {
 namespace http
 {
 
+/**
+ Maps request urls to services.
+
+ The services are compiled into a routing table: plain urls and regular
+ expressions, which match just a literal url like "^/index.html$", are
+ found in a hash table, literal prefixes like "^/static/" in a trie. Only
+ the remaining regular expressions are matched one by one. When more
+ services match, the one added first wins.
+
+ The table is rebuilt on each change and replaced atomically. A lookup
+ does not take a lock but registers in a reader count of the current
+ phase. A change switches the phase and waits until the lookups of the
+ old phase are finished, before the old table is deleted. Lookups starting
+ meanwhile use the new table, so the wait is not extended by them.
+ */
 class Mapper
 {
     public:
+        Mapper();
+        ~Mapper();
+
         void addService(const std::string& url, Service& service);
         void addService(Regex&& url, Service& service);
         void removeService(Service& service);
@@ -57,34 +75,65 @@ class Mapper
             { return _defaultService.createResponder(request); }
 
     private:
-        struct Key
+        struct Entry
+        {
+            std::string url;
+            std::shared_ptr<const Regex> regex;
+            Service* service;
+        };
+
+        struct Route
         {
-          Regex regex;
-          std::string url;
-          Key() { }
-          Key(Regex&& regex_)
-            : regex(std::move(regex_))
-          { }
-          Key(const std::string& url_)
-            : url(url_)
-          { }
-          bool match(const std::string& u) const
-          { return regex.empty() ? url == u
-                                 : regex.match(u); }
+            unsigned order;
+            Service* service;
         };
-        typedef std::vector<std::pair<Key, Service*> > ServicesType;
-#if __cplusplus >= 201703L
-        typedef std::shared_mutex MutexType;
-        typedef std::shared_lock<std::shared_mutex> ReadLockType;
-        typedef std::unique_lock<std::shared_mutex> WriteLockType;
-#else
-        typedef std::mutex MutexType;
-        typedef std::unique_lock<std::mutex> ReadLockType;
-        typedef std::unique_lock<std::mutex> WriteLockType;
-#endif
-        MutexType _serviceMutex;
-
-        ServicesType _services;
+
+        typedef std::vector<Route> RouteList;
+
+        struct RegexRoute
+        {
+            Route route;
+            std::shared_ptr<const Regex> regex;
+        };
+
+        struct TrieNode
+        {
+            std::vector<std::pair<char, unsigned> > children;
+            RouteList routes;
+        };
+
+        class RouteTable
+        {
+                std::unordered_map<std::string, RouteList> _exact;
+                std::vector<TrieNode> _trie;
+                std::vector<RegexRoute> _regex;
+
+                static void consider(const RouteList& routes, unsigned after, const Route*& best);
+
+            public:
+                explicit RouteTable(const std::vector<Entry>& entries);
+
+                // returns the first matching route added after route number `after`
+                const Route* find(const std::string& url, unsigned after) const;
+        };
+
+        class ReadLock;
+
+        void rebuild();
+
+        // not implemented
+        Mapper(const Mapper&);
+        Mapper& operator=(const Mapper&);
+
+        std::mutex _entriesMutex;
+        std::vector<Entry> _entries;
+
+        std::atomic<const RouteTable*> _routes;
+        std::atomic<unsigned> _phase;
+        std::atomic<unsigned> _readers[2];
+        std::mutex _readersMutex;
+        std::condition_variable _readersFinished;
+
         NotFoundService _defaultService;
         NotAuthenticatedService _noAuthService;
 };
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cxxtools/http/reply.h>
+#include <cxxtools/systemerror.h>
+#include <cxxtools/log.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include "config.h"
+
+#if defined(HAVE_SENDFILE) && defined(HAVE_SYS_SENDFILE_H)
+#include <sys/sendfile.h>
+#endif
+
+log_define("cxxtools.http.reply")
+
+namespace cxxtools
+{
+namespace http
+{
+
+ssize_t BodySource::sendTo(int /*fd*/, std::size_t /*n*/)
+{
+    errno = ENOSYS;
+    return -1;
+}
+
+FileBodySource::FileBodySource(const std::string& path)
+    : _offset(0),
+      _closeFd(true)
+{
+    _fd = ::open(path.c_str(), O_RDONLY);
+    if (_fd < 0)
+        throwSystemError("open");
+
+    struct stat st;
+    if (::fstat(_fd, &st) != 0)
+    {
+        int errnum = errno;
+        ::close(_fd);
+        throwSystemError(errnum, "fstat");
+    }
+
+    _size = _remaining = st.st_size;
+    log_debug("stream file \"" << path << "\" with " << _size << " bytes");
+}
+
+FileBodySource::FileBodySource(int fd, off_t offset, std::size_t count, bool closeFd)
+    : _fd(fd),
+      _offset(offset),
+      _size(count),
+      _remaining(count),
+      _closeFd(closeFd)
+{
+}
+
+FileBodySource::~FileBodySource()
+{
+    if (_closeFd)
+        ::close(_fd);
+}
+
+std::size_t FileBodySource::read(char* buffer, std::size_t n)
+{
+    if (n > _remaining)
+        n = _remaining;
+
+    if (n == 0)
+        return 0;
+
+    ssize_t ret;
+    do
+    {
+        ret = ::pread(_fd, buffer, n, _offset);
+    } while (ret < 0 && errno == EINTR);
+
+    if (ret < 0)
+        throwSystemError("pread");
+
+    _offset += ret;
+    _remaining -= ret;
+    return ret;
+}
+
+ssize_t FileBodySource::sendTo(int fd, std::size_t n)
+{
+#if defined(HAVE_SENDFILE) && defined(HAVE_SYS_SENDFILE_H)
+    if (n > _remaining)
+        n = _remaining;
+
+    if (n == 0)
+        return 0;
+
+    ssize_t ret = ::sendfile(fd, _fd, &_offset, n);
+    if (ret > 0)
+        _remaining -= ret;
+    else if (ret == 0)
+        _remaining = 0;  // file was truncated
+
+    return ret;
+#else
+    return BodySource::sendTo(fd, n);
+#endif
+}
+
+} // namespace http
+} // namespace cxxtools
@@ -44,8 +44,12 @@ std::size_t Responder::readBody(std::istream& in)
 {
     std::streambuf* sb = in.rdbuf();
 
+    // data after the body belongs to the next pipelined request
+    std::size_t size = static_cast<std::size_t>(_request->body().tellp());
+    std::size_t contentLength = _request->header().contentLength();
+
     std::size_t ret = 0;
-    while (sb->in_avail() > 0)
+    while (size + ret < contentLength && sb->in_avail() > 0)
     {
         _request->body() << std::streambuf::traits_type::to_char_type(sb->sbumpc());
         ++ret;
@@ -54,6 +58,11 @@ std::size_t Responder::readBody(std::istream& in)
     return ret;
 }
 
+bool Responder::prepareReply(Request& /*request*/, const std::function<void()>& /*ready*/)
+{
+    return false;
+}
+
 void Responder::replyError(std::ostream& out, Request& /*request*/, Reply& reply, const std::exception& ex)
 {
     reply.httpReturn(500, "internal server error");
@@ -130,6 +130,36 @@ void Server::maxThreads(unsigned m)
     _impl->maxThreads(m);
 }
 
+unsigned Server::eventLoops() const
+{
+    return _impl->eventLoops();
+}
+
+void Server::eventLoops(unsigned n)
+{
+    _impl->eventLoops(n);
+}
+
+bool Server::eventDriven() const
+{
+    return _impl->eventDriven();
+}
+
+void Server::eventDriven(bool sw)
+{
+    _impl->eventDriven(sw);
+}
+
+unsigned Server::pipelineDepth() const
+{
+    return _impl->pipelineDepth();
+}
+
+void Server::pipelineDepth(unsigned n)
+{
+    _impl->pipelineDepth(n);
+}
+
 Delegate<bool, const SslCertificate&>& Server::acceptSslCertificate()
 {
     return _impl->acceptSslCertificate;
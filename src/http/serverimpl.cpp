@@ -44,13 +44,16 @@ namespace http
 class IdleSocketEvent : public BasicEvent<IdleSocketEvent>
 {
         Socket* _socket;
+        unsigned _loop;
 
     public:
-        explicit IdleSocketEvent(Socket* socket)
-            : _socket(socket)
+        IdleSocketEvent(Socket* socket, unsigned loop)
+            : _socket(socket),
+              _loop(loop)
             { }
 
         Socket* socket() const   { return _socket; }
+        unsigned loop() const    { return _loop; }
 
 };
 
@@ -113,7 +116,9 @@ class ActiveSocketEvent : public BasicEvent<ActiveSocketEvent>
 ServerImpl::ServerImpl(EventLoopBase& eventLoop, Signal<Server::Runmode>& runmodeChanged)
     : ServerImplBase(eventLoop, runmodeChanged),
       inputSlot(slot(*this, &ServerImpl::onInput)),
-      timeoutSlot(slot(*this, &ServerImpl::onTimeout))
+      timeoutSlot(slot(*this, &ServerImpl::onTimeout)),
+      _queue(1024, true),
+      _idleSockets(1)
 {
     _eventLoop.event.subscribe(slot(*this, &ServerImpl::onIdleSocket));
     _eventLoop.event.subscribe(slot(*this, &ServerImpl::onActiveSocket));
@@ -168,6 +173,26 @@ void ServerImpl::start()
     log_trace("start server");
     runmode(Server::Starting);
 
+    if (eventLoops() > 0)
+    {
+        log_debug("start " << eventLoops() << " event loops");
+
+        // loops kept from a previous start are already subscribed
+        unsigned subscribed = _loopGroup.size();
+        _loopGroup.resize(eventLoops());
+        _idleSockets.resize(eventLoops());
+
+        for (unsigned n = subscribed; n < _loopGroup.size(); ++n)
+        {
+            EventLoop& loop = _loopGroup.loop(n);
+            loop.event.subscribe(slot(*this, &ServerImpl::onIdleSocket));
+            loop.event.subscribe(slot(*this, &ServerImpl::onActiveSocket));
+            loop.event.subscribe(slot(*this, &ServerImpl::onKeepAliveTimeout));
+        }
+
+        _loopGroup.start();
+    }
+
     std::lock_guard<std::mutex> lock(_threadMutex);
     while (_threads.size() < minThreads())
     {
@@ -215,17 +240,42 @@ void ServerImpl::terminate()
             _terminatedThreads.clear();
         }
 
+        if (_loopGroup.running())
+        {
+            log_debug("stop " << _loopGroup.size() << " event loops");
+            _loopGroup.stop();
+
+            // sockets in pending events are moved to the queue or idle sockets
+            for (unsigned n = 0; n < _loopGroup.size(); ++n)
+                _loopGroup.loop(n).processEvents();
+        }
+
         log_debug("delete " << _listener.size() << " listeners");
         for (ServerImpl::ListenerType::iterator it = _listener.begin(); it != _listener.end(); ++it)
             delete *it;
         _listener.clear();
 
+        // Sockets are taken out of the set before deleting, so that
+        // replies getting ready now do not put them to the queue.
+        std::set<Socket*> deferredSockets;
+        {
+            std::lock_guard<std::mutex> deferredLock(_deferredMutex);
+            deferredSockets.swap(_deferredSockets);
+        }
+
+        log_debug("delete " << deferredSockets.size() << " sockets waiting for deferred replies");
+        for (std::set<Socket*>::iterator it = deferredSockets.begin(); it != deferredSockets.end(); ++it)
+            delete *it;
+
         while (!_queue.empty())
             delete _queue.get();
 
-        for (std::set<Socket*>::iterator it = _idleSockets.begin(); it != _idleSockets.end(); ++it)
-            delete *it;
-        _idleSockets.clear();
+        for (unsigned n = 0; n < _idleSockets.size(); ++n)
+        {
+            for (std::set<Socket*>::iterator it = _idleSockets[n].begin(); it != _idleSockets[n].end(); ++it)
+                delete *it;
+            _idleSockets[n].clear();
+        }
 
         runmode(Server::Stopped);
     }
@@ -264,7 +314,8 @@ void ServerImpl::addIdleSocket(Socket* socket)
 
     if (runmode() == Server::Running)
     {
-        _eventLoop.commitEvent(IdleSocketEvent(socket));
+        unsigned n = _loopGroup.size() > 0 ? _loopGroup.nextIndex() : 0;
+        idleLoop(n).commitEvent(IdleSocketEvent(socket, n));
     }
     else
     {
@@ -273,16 +324,66 @@ void ServerImpl::addIdleSocket(Socket* socket)
     }
 }
 
+void ServerImpl::addDeferredSocket(Socket* socket)
+{
+    std::lock_guard<std::mutex> lock(_deferredMutex);
+
+    if (socket->replyReady())
+    {
+        log_debug("deferred reply of socket " << static_cast<void*>(socket) << " already ready");
+        _queue.put(socket);
+    }
+    else
+    {
+        log_debug("park socket " << static_cast<void*>(socket) << " until reply is ready");
+        _deferredSockets.insert(socket);
+    }
+}
+
+void ServerImpl::onReplyReady(Socket* socket)
+{
+    // called from the thread, which completes the reply
+    std::lock_guard<std::mutex> lock(_deferredMutex);
+
+    socket->replyReady(true);
+    if (_deferredSockets.erase(socket))
+    {
+        log_debug("deferred reply of socket " << static_cast<void*>(socket) << " ready");
+        _queue.put(socket);
+    }
+}
+
 void ServerImpl::onIdleSocket(const IdleSocketEvent& event)
 {
     Socket* socket = event.socket();
 
-    log_debug("add idle socket " << static_cast<void*>(socket) << " to selector");
+    if (isTerminating())
+    {
+        log_debug("server is terminating; delete " << static_cast<void*>(socket));
+        delete socket;
+        return;
+    }
+
+    log_debug("add idle socket " << static_cast<void*>(socket) << " to selector " << event.loop());
+
+    _idleSockets[event.loop()].insert(socket);
+    socket->setSelector(&idleLoop(event.loop()));
 
-    _idleSockets.insert(socket);
-    socket->setSelector(&_eventLoop);
-    socket->inputConnection = socket->inputReady.connect(inputSlot);
-    socket->timeoutConnection = socket->timeout.connect(timeoutSlot);
+    if (eventDriven())
+    {
+        // The event loop processes the socket until the next request is
+        // read. The socket notifies the server directly, since the slots
+        // of the server must not be connected from several event loops.
+        // It must not be touched after resume, since it may be passed to
+        // a worker already.
+        socket->inputConnection = socket->buffer().inputReady.connect(socket->inputSlot);
+        socket->resume();
+    }
+    else
+    {
+        socket->inputConnection = socket->inputReady.connect(inputSlot);
+        socket->timeoutConnection = socket->timeout.connect(timeoutSlot);
+    }
 }
 
 void ServerImpl::onActiveSocket(const ActiveSocketEvent& event)
@@ -339,6 +440,14 @@ void ServerImpl::onThreadTerminated(const ThreadTerminatedEvent& event)
     delete event.worker();
 }
 
+unsigned ServerImpl::idleLoopIndex(const SelectorBase* selector)
+{
+    for (unsigned n = 0; n < _loopGroup.size(); ++n)
+        if (&_loopGroup.loop(n) == selector)
+            return n;
+    return 0;
+}
+
 void ServerImpl::onServerStart(const ServerStartEvent& event)
 {
     if (event.server() == this)
@@ -347,17 +456,30 @@ void ServerImpl::onServerStart(const ServerStartEvent& event)
     }
 }
 
-void ServerImpl::onInput(Socket& socket)
+bool ServerImpl::detachSocket(Socket& socket, unsigned& n)
 {
+    if (socket.selector() == 0)
+        return false;
+
+    n = idleLoopIndex(socket.selector());
     socket.removeSelector();
     log_debug("search socket " << static_cast<void*>(&socket) << " in idle sockets");
-    _idleSockets.erase(&socket);
+    bool found = _idleSockets[n].erase(&socket) > 0;
+
+    socket.inputConnection.close();
+    socket.timeoutConnection.close();
+
+    return found;
+}
+
+void ServerImpl::onInput(Socket& socket)
+{
+    unsigned n = 0;
+    detachSocket(socket, n);
 
     if (socket.isConnected())
     {
-        socket.inputConnection.close();
-        socket.timeoutConnection.close();
-        _eventLoop.commitEvent(ActiveSocketEvent(&socket));
+        idleLoop(n).commitEvent(ActiveSocketEvent(&socket));
     }
     else
     {
@@ -370,13 +492,38 @@ void ServerImpl::onTimeout(Socket& socket)
 {
     log_debug("timeout; socket " << static_cast<void*>(&socket));
 
-    _eventLoop.commitEvent(KeepAliveTimeoutEvent(&socket));
+    idleLoop(idleLoopIndex(socket.selector())).commitEvent(KeepAliveTimeoutEvent(&socket));
+}
+
+void ServerImpl::onRequestReady(Socket& socket)
+{
+    log_debug("request of socket " << static_cast<void*>(&socket) << " ready");
+
+    // We are called from a handler of the socket, so it is passed to the
+    // workers in a later event.
+    unsigned n;
+    if (detachSocket(socket, n))
+        idleLoop(n).commitEvent(ActiveSocketEvent(&socket));
+}
+
+void ServerImpl::onFinished(Socket& socket)
+{
+    log_debug("socket " << static_cast<void*>(&socket) << " finished");
+
+    // the socket is deleted in a later event for the same reason
+    unsigned n;
+    if (detachSocket(socket, n))
+        idleLoop(n).commitEvent(KeepAliveTimeoutEvent(&socket));
 }
 
 void ServerImpl::onKeepAliveTimeout(const KeepAliveTimeoutEvent& event)
 {
     Socket* socket = event.socket();
-    _idleSockets.erase(socket);
+
+    // sockets of the event driven mode are already detached
+    if (socket->selector())
+        _idleSockets[idleLoopIndex(socket->selector())].erase(socket);
+
     log_debug("onKeepAliveTimeout; delete " << static_cast<void*>(&socket));
     delete socket;
 }
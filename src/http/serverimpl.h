@@ -30,8 +30,9 @@
 #define CXXTOOLS_HTTP_SERVERIMPL_H
 
 #include "serverimplbase.h"
-#include <cxxtools/queue.h>
+#include <cxxtools/mpmcqueue.h>
 #include <cxxtools/event.h>
+#include <cxxtools/eventloopgroup.h>
 #include <cxxtools/http/server.h>
 
 #include <mutex>
@@ -77,12 +78,22 @@ class ServerImpl : public ServerImplBase, public Connectable
         // override from ServerImplBase
         void terminate();
 
+        // called by the responder of a deferred reply, when it is ready
+        void onReplyReady(Socket* socket);
+
+        // called by sockets in event driven mode, when the request is read
+        // or the connection is closed
+        void onRequestReady(Socket& socket);
+        void onFinished(Socket& socket);
+
     private:
         void noWaitingThreads();
         void onInput(Socket& _socket);
         void onTimeout(Socket& _socket);
+        bool detachSocket(Socket& _socket, unsigned& n);
 
         void addIdleSocket(Socket* socket);
+        void addDeferredSocket(Socket* socket);
         void onIdleSocket(const IdleSocketEvent& event);
         void onActiveSocket(const ActiveSocketEvent& event);
         void onKeepAliveTimeout(const KeepAliveTimeoutEvent& event);
@@ -91,6 +102,10 @@ class ServerImpl : public ServerImplBase, public Connectable
         void onServerStart(const ServerStartEvent& event);
         void start();
 
+        EventLoopBase& idleLoop(unsigned n)
+        { return _loopGroup.size() == 0 ? _eventLoop : _loopGroup.loop(n); }
+        unsigned idleLoopIndex(const SelectorBase* selector);
+
         friend class Worker;
 
         ////////////////////////////////////////////////////
@@ -98,8 +113,20 @@ class ServerImpl : public ServerImplBase, public Connectable
         MethodSlot<void, ServerImpl, Socket&> inputSlot;
         MethodSlot<void, ServerImpl, Socket&> timeoutSlot;
 
-        Queue<Socket*> _queue;
-        std::set<Socket*> _idleSockets;
+        // sockets ready for the workers; overflow enabled so that the event
+        // loop never blocks when putting sockets
+        MpmcQueue<Socket*> _queue;
+
+        // event loops watching idle sockets; empty when the main loop is used
+        EventLoopGroup _loopGroup;
+        // idle sockets of each event loop; in event driven mode all
+        // sockets, which are not processed by a worker
+        std::vector<std::set<Socket*> > _idleSockets;
+
+        // sockets waiting for a deferred reply; they are put to the queue
+        // again, when the responder signals, that the reply is ready
+        std::mutex _deferredMutex;
+        std::set<Socket*> _deferredSockets;
 
         ////////////////////////////////////////////////////
         typedef std::vector<net::TcpServer*> ListenerType;
@@ -55,6 +55,9 @@ class ServerImplBase
               _keepAliveTimeout(Seconds(30)),
               _minThreads(5),
               _maxThreads(200),
+              _eventLoops(0),
+              _eventDriven(false),
+              _pipelineDepth(16),
               _runmodeChanged(runmodeChanged),
               _runmode(Server::Stopped)
         { }
@@ -89,6 +92,15 @@ class ServerImplBase
         unsigned maxThreads() const           { return _maxThreads; }
         void maxThreads(unsigned m)           { _maxThreads = m; }
 
+        unsigned eventLoops() const           { return _eventLoops; }
+        void eventLoops(unsigned n)           { _eventLoops = n; }
+
+        bool eventDriven() const              { return _eventDriven; }
+        void eventDriven(bool sw)             { _eventDriven = sw; }
+
+        unsigned pipelineDepth() const        { return _pipelineDepth; }
+        void pipelineDepth(unsigned n)        { _pipelineDepth = n; }
+
         virtual void terminate()              { }
         Server::Runmode runmode() const
         { return _runmode; }
@@ -111,6 +123,9 @@ class ServerImplBase
 
         unsigned _minThreads;
         unsigned _maxThreads;
+        unsigned _eventLoops;
+        bool _eventDriven;
+        unsigned _pipelineDepth;
 
         Signal<Server::Runmode>& _runmodeChanged;
         Server::Runmode _runmode;
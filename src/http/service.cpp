@@ -38,8 +38,10 @@ namespace http
 Responder* Service::doCreateResponder(const Request& request)
 {
     std::lock_guard<std::mutex> lock(_mutex);
-    ++_responderCount;
-    return createResponder(request);
+    Responder* responder = createResponder(request);
+    if (responder)
+        ++_responderCount;
+    return responder;
 }
 
 void Service::doReleaseResponder(Responder* responder)
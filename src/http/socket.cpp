@@ -28,12 +28,32 @@
 
 #include "socket.h"
 #include "serverimpl.h"
+#include <cxxtools/ioerror.h>
+#include <cxxtools/systemerror.h>
 #include <cxxtools/log.h>
+#include <algorithm>
 #include <cassert>
+#include <functional>
+#include <errno.h>
+#include <sys/poll.h>
 #include "config.h"
 
 log_define("cxxtools.http.socket")
 
+namespace
+{
+    // size of a piece of a streamed body, which fits with the chunk
+    // header into the output buffer
+    const std::size_t bodyPartSize = 8000;
+
+    // data sent with one call to sendfile
+    const std::size_t sendfileSize = 1024 * 1024;
+
+    // replies of pipelined requests are collected, while the output buffer
+    // has room for another reply
+    const std::streamsize coalesceSize = 2048;
+}
+
 namespace cxxtools
 {
 
@@ -63,7 +83,14 @@ Socket::Socket(ServerImpl& server, net::TcpServer& tcpServer, const SslCtx& sslC
       _parseEvent(_request),
       _parser(_parseEvent, false),
       _responder(0),
-      _accepted(false)
+      _accepted(false),
+      _replyDeferred(false),
+      _replyReady(false),
+      _chunkedBody(false),
+      _sendfile(false),
+      _bodyRemaining(0),
+      _pipelined(0),
+      _readAfterWrite(false)
 {
     _stream.attachDevice(*this);
     cxxtools::connect(IODevice::inputReady, *this, &Socket::onIODeviceInput);
@@ -82,7 +109,14 @@ Socket::Socket(Socket& socket)
       _parseEvent(_request),
       _parser(_parseEvent, false),
       _responder(0),
-      _accepted(false)
+      _accepted(false),
+      _replyDeferred(false),
+      _replyReady(false),
+      _chunkedBody(false),
+      _sendfile(false),
+      _bodyRemaining(0),
+      _pipelined(0),
+      _readAfterWrite(false)
 {
     _stream.attachDevice(*this);
     cxxtools::connect(IODevice::inputReady, *this, &Socket::onIODeviceInput);
@@ -118,7 +152,10 @@ void Socket::postAccept()
 
     _accepted = true;
 
-    _stream.buffer().beginRead();
+    // in event driven mode reading starts, when the socket is attached
+    // to an event loop
+    if (!_server.eventDriven())
+        _stream.buffer().beginRead();
 
     log_debug("accepted");
 
@@ -151,7 +188,7 @@ void Socket::onInput(StreamBuffer& sb)
 
     if (sb.in_avail() == 0 || sb.device()->eof())
     {
-        close();
+        closeConnection();
         return;
     }
 
@@ -199,15 +236,14 @@ void Socket::onInput(StreamBuffer& sb)
             log_debug("content length of request is " << _contentLength);
             if (_contentLength == 0)
             {
-                _timer.stop();
-                doReply();
+                requestComplete();
                 return;
             }
 
         }
         else
         {
-            sb.beginRead();
+            readRequest(sb);
         }
     }
 
@@ -236,21 +272,113 @@ void Socket::onInput(StreamBuffer& sb)
 
         if (_contentLength <= 0)
         {
-            _timer.stop();
-            doReply();
+            requestComplete();
         }
         else
         {
-            sb.beginRead();
+            readRequest(sb);
         }
     }
 }
 
+void Socket::readRequest(StreamBuffer& sb)
+{
+    if (sb.out_avail())
+    {
+        // A pipelined request is received partially; the replies of the
+        // previous requests are sent, before reading on.
+        log_debug("send replies before reading pipelined request");
+        _readAfterWrite = true;
+        sb.beginWrite();
+        _timer.start(_server.writeTimeout());
+    }
+    else
+    {
+        sb.beginRead();
+    }
+}
+
+void Socket::nextRequest()
+{
+    _timer.start(_server.keepAliveTimeout());
+    _request.clear();
+    _reply.clear();
+    _parser.reset(false);
+}
+
+void Socket::requestComplete()
+{
+    _timer.stop();
+
+    // In event driven mode the server removes the socket from the event
+    // loop and passes it to a worker, which calls doReply.
+    if (_server.eventDriven())
+        _server.onRequestReady(*this);
+    else
+        doReply();
+}
+
+void Socket::flushReplies()
+{
+    StreamBuffer& sb = _stream.buffer();
+    if (!sb.out_avail())
+        return;
+
+    // Replies of pipelined requests processed ahead are still buffered.
+    // They are sent before the socket waits for a deferred reply, which
+    // may take long.
+    log_debug("send " << sb.out_avail() << " bytes of replies before waiting for deferred reply");
+
+    _pipelined = 0;
+
+    cxxtools::Timespan t = getTimeout();
+    setTimeout(_server.writeTimeout());
+
+    try
+    {
+        sb.pubsync();
+    }
+    catch (const std::exception& e)
+    {
+        // the connection is closed, when the deferred reply is sent
+        log_warn("failed to send replies to " << getPeerAddr() << ": " << e.what());
+    }
+
+    setTimeout(t);
+}
+
+void Socket::closeConnection()
+{
+    close();
+
+    // In event driven mode no worker checks the socket, so the server
+    // is notified to delete it.
+    if (_server.eventDriven())
+        _server.onFinished(*this);
+}
+
 bool Socket::doReply()
 {
     log_trace("http::Socket::doReply");
+
+    bool deferred = _replyDeferred;
+    _replyDeferred = false;
+
     try
     {
+        if (!deferred)
+        {
+            _replyReady = false;
+            if (_responder->prepareReply(_request, std::bind(&ServerImpl::onReplyReady, &_server, this)))
+            {
+                // The worker parks the socket after returning from here.
+                log_debug("reply deferred");
+                _replyDeferred = true;
+                flushReplies();
+                return true;
+            }
+        }
+
         _responder->reply(_reply.bodyStream(), _request, _reply);
     }
     catch (const std::exception& e)
@@ -265,9 +393,35 @@ bool Socket::doReply()
 
     sendReply();
 
+    // the event loop sends the reply, when the socket is attached again
+    if (_server.eventDriven())
+        return true;
+
     return onOutput(_stream.buffer());
 }
 
+void Socket::resume()
+{
+    log_trace("resume");
+
+    if (_stream.buffer().out_avail())
+    {
+        onOutput(_stream.buffer());
+        return;
+    }
+
+    try
+    {
+        _timer.start(_server.readTimeout());
+        _stream.buffer().beginRead();
+    }
+    catch (const std::exception& e)
+    {
+        log_warn("failed to read from " << getPeerAddr() << ": " << e.what());
+        closeConnection();
+    }
+}
+
 bool Socket::onOutput(StreamBuffer& sb)
 {
     log_trace("onOutput");
@@ -278,23 +432,46 @@ bool Socket::onOutput(StreamBuffer& sb)
     {
         sb.endWrite();
 
+        if (!sb.out_avail() && _reply.bodySource())
+            sendBodyPart();
+
+        if (sb.out_avail() && sb.in_avail() && !_reply.bodySource()
+            && !_readAfterWrite && keepAlive()
+            && _pipelined + 1 < _server.pipelineDepth()
+            && sb.out_avail() <= coalesceSize)
+        {
+            // The next request is received already. It is processed before
+            // sending the reply, so that the replies are sent together. The
+            // socket must not be touched after onInput, since in event
+            // driven mode it may be passed to a worker.
+            log_debug("process pipelined request");
+            ++_pipelined;
+            nextRequest();
+            onInput(sb);
+            return true;
+        }
+
         if ( sb.out_avail() )
         {
             sb.beginWrite();
             _timer.start(_server.writeTimeout());
         }
+        else if (_readAfterWrite)
+        {
+            log_debug("continue reading pipelined request");
+            _pipelined = 0;
+            _readAfterWrite = false;
+            _timer.start(_server.readTimeout());
+            sb.beginRead();
+        }
         else
         {
-            bool keepAlive = _request.header().keepAlive()
-                          && _reply.header().keepAlive();
+            _pipelined = 0;
 
-            if (keepAlive)
+            if (keepAlive())
             {
                 log_debug("do keep alive");
-                _timer.start(_server.keepAliveTimeout());
-                _request.clear();
-                _reply.clear();
-                _parser.reset(false);
+                nextRequest();
                 if (sb.in_avail())
                     onInput(sb);
                 else
@@ -303,7 +480,7 @@ bool Socket::onOutput(StreamBuffer& sb)
             else
             {
                 log_debug("don't do keep alive");
-                close();
+                closeConnection();
                 return false;
             }
         }
@@ -311,7 +488,7 @@ bool Socket::onOutput(StreamBuffer& sb)
     catch (const std::exception& e)
     {
         log_warn("exception occured when processing request: " << e.what());
-        close();
+        closeConnection();
         timeout(*this);
         return false;
     }
@@ -322,7 +499,10 @@ bool Socket::onOutput(StreamBuffer& sb)
 void Socket::onTimeout()
 {
     log_debug("timeout");
-    timeout(*this);
+    if (_server.eventDriven())
+        closeConnection();
+    else
+        timeout(*this);
 }
 
 void Socket::sendReply()
@@ -336,6 +516,18 @@ void Socket::sendReply()
         << " ready, returncode " << _reply.httpReturnCode() << ' '
         << _reply.httpReturnText());
 
+    BodySource* source = _reply.bodySource();
+    if (source)
+        _bodyRemaining = source->size();
+    bool http11 = _request.header().httpVersionMajor() == 1
+               && _request.header().httpVersionMinor() >= 1;
+
+    // Without length and chunked encoding the end of the body is signaled
+    // by closing the connection. This replaces a Connection header set by
+    // the responder, so that it is not sent twice.
+    if (source && _bodyRemaining < 0 && !http11)
+        _reply.setHeader(connection, "close");
+
     _stream << "HTTP/"
         << _reply.header().httpVersionMajor() << '.'
         << _reply.header().httpVersionMinor() << ' '
@@ -348,9 +540,31 @@ void Socket::sendReply()
         _stream << it->first << ": " << it->second << "\r\n";
     }
 
-    if (!_reply.header().hasHeader(contentLength))
+    std::string body;
+    if (!source)
+        body = _reply.body();
+
+    _chunkedBody = false;
+    if (source)
+    {
+        // sendfile waits for the socket when it is not ready, which would
+        // block the event loop in event driven mode
+        _sendfile = _bodyRemaining > 0 && !isSslConnected() && !_server.eventDriven();
+
+        if (_bodyRemaining >= 0)
+        {
+            if (!_reply.header().hasHeader(contentLength))
+                _stream << "Content-Length: " << _bodyRemaining << "\r\n";
+        }
+        else if (http11)
+        {
+            _stream << "Transfer-Encoding: chunked\r\n";
+            _chunkedBody = true;
+        }
+    }
+    else if (!_reply.header().hasHeader(contentLength))
     {
-        _stream << "Content-Length: " << _reply.bodySize() << "\r\n";
+        _stream << "Content-Length: " << body.size() << "\r\n";
     }
 
     if (!_reply.header().hasHeader(server))
@@ -373,8 +587,108 @@ void Socket::sendReply()
 
     _stream << "\r\n";
 
-    _reply.sendBody(_stream);
+    // The body is passed to the stream buffer instead of copying it, so
+    // that header and body are sent together. This never blocks, so it is
+    // fine in event driven mode also.
+    if (!source)
+        _stream.putSlice(std::move(body));
+}
+
+void Socket::sendBodyPart()
+{
+    BodySource* source = _reply.bodySource();
+
+    if (_sendfile)
+    {
+        // The header is already sent, so the data can go directly from
+        // the file to the socket. We block the worker thread here like a
+        // blocking write to the stream would do.
+        // The file may grow after its size is taken, so no more than the
+        // announced content length is sent.
+        while (_bodyRemaining > 0)
+        {
+            std::size_t count = std::min<long long>(sendfileSize, _bodyRemaining);
+            ssize_t n = source->sendTo(getFd(), count);
+            if (n > 0)
+            {
+                _bodyRemaining -= n;
+            }
+            else if (n == 0)
+            {
+                break;
+            }
+            else if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                pollfd pfd;
+                pfd.fd = getFd();
+                pfd.events = POLLOUT;
+                int ret = ::poll(&pfd, 1, _server.writeTimeout().ceil());
+                if (ret == 0)
+                    throw IOTimeout();
+                if (ret < 0 && errno != EINTR)
+                    throwSystemError("poll");
+            }
+            else if (errno == EINTR)
+            {
+                continue;
+            }
+            else if (errno == ENOSYS || errno == EINVAL)
+            {
+                log_debug("sendfile not supported; copy body");
+                _sendfile = false;
+                break;
+            }
+            else
+            {
+                throwSystemError("sendfile");
+            }
+        }
+
+        if (_sendfile)
+        {
+            _sendfile = false;
+            if (_bodyRemaining != 0)
+            {
+                log_warn("body source ended " << _bodyRemaining << " bytes early; close connection");
+                _reply.setHeader("Connection", "close");
+            }
+
+            _reply.bodySource(0);
+            return;
+        }
+    }
+
+    char buffer[bodyPartSize];
+    std::size_t count = sizeof(buffer);
+    if (_bodyRemaining >= 0 && !_chunkedBody)
+        count = std::min<long long>(count, _bodyRemaining);
 
+    std::size_t n = count > 0 ? source->read(buffer, count) : 0;
+    log_debug(n << " bytes of body read");
+
+    if (_chunkedBody)
+    {
+        _stream << std::hex << n << std::dec << "\r\n";
+        _stream.write(buffer, n);
+        _stream << "\r\n";
+    }
+    else
+    {
+        _stream.write(buffer, n);
+        if (_bodyRemaining > 0)
+            _bodyRemaining -= n;
+    }
+
+    if (n == 0)
+    {
+        if (_bodyRemaining > 0)
+        {
+            log_warn("body source ended " << _bodyRemaining << " bytes early; close connection");
+            _reply.setHeader("Connection", "close");
+        }
+
+        _reply.bodySource(0);
+    }
 }
 
 bool Socket::onAcceptSslCertificate(const SslCertificate& cert)
@@ -82,8 +82,23 @@ class Socket : public net::TcpSocket, public Connectable
         void onTimeout();
         bool onAcceptSslCertificate(const SslCertificate& cert);
 
+        // Starts the reply; when the responder defers it, the worker parks
+        // the socket and calls doReply again, when the reply is ready.
         bool doReply();
+        bool replyDeferred() const     { return _replyDeferred; }
+
+        // set by the server, when the deferred reply is ready; guarded by
+        // the mutex of the deferred sockets in the server
+        bool replyReady() const        { return _replyReady; }
+        void replyReady(bool r)        { _replyReady = r; }
+
+        // Event driven mode: continues processing, after the socket is
+        // attached to an event loop; sends a reply prepared by a worker or
+        // starts reading a new request
+        void resume();
+
         void sendReply();
+        void sendBodyPart();
         bool isReady() const
         { return _parser.end() && _contentLength == 0; }
 
@@ -101,6 +116,15 @@ class Socket : public net::TcpSocket, public Connectable
         Connection timeoutConnection;
 
     private:
+        void requestComplete();
+        void closeConnection();
+        void readRequest(StreamBuffer& sb);
+        void nextRequest();
+        void flushReplies();
+
+        bool keepAlive() const
+        { return _request.header().keepAlive() && _reply.header().keepAlive(); }
+
         net::TcpServer& _tcpServer;
         SslCtx _sslCtx;
         ServerImpl& _server;
@@ -118,6 +142,19 @@ class Socket : public net::TcpSocket, public Connectable
         int _sslVerifyLevel;
         std::string _sslCa;
         bool _accepted;
+        bool _replyDeferred;
+        bool _replyReady;
+
+        // state of a streamed reply body
+        bool _chunkedBody;
+        bool _sendfile;
+        long long _bodyRemaining;
+
+        // number of replies of pipelined requests held back in the output
+        // buffer and whether a partially received pipelined request is
+        // read on, when they are sent
+        unsigned _pipelined;
+        bool _readAfterWrite;
 };
 
 } // namespace http
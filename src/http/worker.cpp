@@ -93,6 +93,17 @@ void Worker::run()
                     throw;
                 }
             }
+            else if (socket->replyDeferred())
+            {
+                log_debug("send deferred reply to " << socket->getPeerAddr());
+                socket->doReply();
+            }
+            else if (_server.eventDriven())
+            {
+                // the event loop has read the request
+                log_debug("run responder for " << socket->getPeerAddr());
+                socket->doReply();
+            }
             else if (socket->isConnected())
             {
                 log_debug("process available input from " << socket->getPeerAddr());
@@ -106,12 +117,29 @@ void Worker::run()
                 continue;
             }
 
+            if (_server.eventDriven())
+            {
+                // reading the request and sending the reply is done
+                // in the event loops
+                if (socket->replyDeferred())
+                    _server.addDeferredSocket(socket);
+                else
+                    _server.addIdleSocket(socket);
+                continue;
+            }
+
             Connection inputConnection = socket->buffer().inputReady.connect(socket->inputSlot);
 
-            while (socket->wait(10) && socket->isConnected())
+            while (!socket->replyDeferred() && socket->wait(10) && socket->isConnected())
                 ;
 
-            if (socket->isConnected())
+            if (socket->replyDeferred())
+            {
+                log_debug("wait for deferred reply");
+                inputConnection.close();
+                _server.addDeferredSocket(socket);
+            }
+            else if (socket->isConnected())
             {
                 log_debug("timeout processing socket");
                 inputConnection.close();
@@ -41,6 +41,8 @@ IODevice::IODevice()
 , _wbuf(0)
 , _wbuflen(0)
 , _wavail(0)
+, _wvec(0)
+, _wveccount(0)
 { }
 
 size_t IODevice::onBeginRead(char* buffer, size_t n, bool& eof)
@@ -73,6 +75,16 @@ size_t IODevice::onWrite(const char* buffer, size_t count)
     return ioimpl().write(buffer, count);
 }
 
+size_t IODevice::onBeginWritev(const struct iovec* vec, size_t count)
+{
+    return ioimpl().beginWritev(vec, count);
+}
+
+size_t IODevice::onWritev(const struct iovec* vec, size_t count)
+{
+    return ioimpl().writev(vec, count);
+}
+
 void IODevice::onClose()
 {
     cancel();
@@ -222,6 +234,8 @@ size_t IODevice::endWrite()
         _wbuf = 0;
         _wbuflen = 0;
         _wavail = 0;
+        _wvec = 0;
+        _wveccount = 0;
         throw;
     }
 
@@ -235,6 +249,8 @@ size_t IODevice::endWrite()
     _wbuf = 0;
     _wbuflen = 0;
     _wavail = 0;
+    _wvec = 0;
+    _wveccount = 0;
 
     return n;
 }
@@ -267,6 +283,65 @@ size_t IODevice::write(const char* buffer, size_t n)
 }
 
 
+size_t IODevice::beginWrite(const struct iovec* vec, size_t count)
+{
+    if (!async())
+        throw std::logic_error("Device not in async mode");
+
+    if (!enabled())
+        throw std::logic_error("Device not enabled");
+
+    if (_wbuf)
+        throw IOPending("write operation pending");
+
+    size_t r = this->onBeginWritev(vec, count);
+
+    if (r > 0 || _ravail)
+        this->setState(Selectable::Avail);
+    else
+        this->setState(Selectable::Busy);
+
+    size_t n = 0;
+    for (size_t i = 0; i < count; ++i)
+        n += vec[i].iov_len;
+
+    _wbuf = static_cast<const char*>(vec[0].iov_base);
+    _wbuflen = n;
+    _wavail = r;
+    _wvec = vec;
+    _wveccount = count;
+
+    return r;
+}
+
+
+size_t IODevice::write(const struct iovec* vec, size_t count)
+{
+    if ( async() )
+    {
+        if ( _wbuf )
+        {
+            throw IOPending("write operation pending");
+        }
+
+        try
+        {
+            this->beginWrite(vec, count);
+            size_t c = endWrite();
+            _wbuf = 0; _wbuflen = 0; _wavail = 0; _wvec = 0; _wveccount = 0;
+            return c;
+        }
+        catch(...)
+        {
+            _wbuf = 0; _wbuflen = 0; _wavail = 0; _wvec = 0; _wveccount = 0;
+            throw;
+        }
+    }
+
+    return this->onWritev(vec, count);
+}
+
+
 void IODevice::cancel()
 {
     onCancel();
@@ -280,6 +355,8 @@ void IODevice::cancel()
     _wbuf = 0;
     _wbuflen = 0;
     _wavail = 0;
+    _wvec = 0;
+    _wveccount = 0;
 }
 
 
@@ -35,6 +35,7 @@
 #include <string.h>
 #include <fcntl.h>
 #include <sys/poll.h>
+#include <sys/uio.h>
 #include <cxxtools/log.h>
 #include <cxxtools/hexdump.h>
 #include <cxxtools/resetter.h>
@@ -169,6 +170,7 @@ size_t IODeviceImpl::beginRead(char* /*buffer*/, size_t /*n*/, bool& /*eof*/)
     if(_pfd)
     {
         _pfd->events |= POLLIN;
+        pollChanged();
     }
 
     return 0;
@@ -180,6 +182,7 @@ size_t IODeviceImpl::endRead(bool& eof)
     if(_pfd)
     {
         _pfd->events &= ~POLLIN;
+        pollChanged();
     }
 
     checkPendingException();
@@ -190,6 +193,12 @@ size_t IODeviceImpl::endRead(bool& eof)
         throw IOError("read error");
     }
 
+    if (_device.ravail() > 0)
+    {
+        log_debug("read pending " << _device.ravail());
+        return _device.ravail();
+    }
+
     return this->read( _device.rbuf(), _device.rbuflen(), eof );
 }
 
@@ -259,7 +268,10 @@ size_t IODeviceImpl::beginWrite(const char* buffer, size_t n)
             throw IOError("lost connection to peer");
 
         if (_pfd)
+        {
             _pfd->events |= POLLOUT;
+            pollChanged();
+        }
     }
     catch (const std::exception&)
     {
@@ -275,6 +287,7 @@ size_t IODeviceImpl::endWrite()
     if(_pfd)
     {
         _pfd->events &= ~POLLOUT;
+        pollChanged();
     }
 
     checkPendingException();
@@ -292,6 +305,9 @@ size_t IODeviceImpl::endWrite()
         return n;
     }
 
+    if (_device.wvec())
+        return this->writev( _device.wvec(), _device.wveccount() );
+
     return this->write( _device.wbuf(), _device.wbuflen() );
 }
 
@@ -335,6 +351,75 @@ size_t IODeviceImpl::write( const char* buffer, size_t count )
 }
 
 
+size_t IODeviceImpl::beginWritev(const struct iovec* vec, size_t count)
+{
+    log_debug("::writev(" << _fd << ", vec, " << count << ')');
+
+    try
+    {
+        ssize_t ret = ::writev(_fd, vec, count);
+        int e = errno;
+
+        log_debug("writev returned " << ret);
+        if (ret > 0)
+            return static_cast<size_t>(ret);
+
+        if (ret == 0 || e == ECONNRESET || e == EPIPE)
+            throw IOError("lost connection to peer");
+
+        if (_pfd)
+        {
+            _pfd->events |= POLLOUT;
+            pollChanged();
+        }
+    }
+    catch (const std::exception&)
+    {
+        _exception = std::current_exception();
+    }
+
+    return 0;
+}
+
+
+size_t IODeviceImpl::writev(const struct iovec* vec, size_t count)
+{
+    ssize_t ret = 0;
+
+    while(true)
+    {
+        log_debug("::writev(" << _fd << ", vec, " << count << ')');
+
+        ret = ::writev(_fd, vec, count);
+        int e = errno;
+        log_debug("writev returned " << ret);
+        if(ret > 0)
+            break;
+
+        if (ret == 0 || e == ECONNRESET || e == EPIPE)
+            throw IOError("lost connection to peer");
+
+        if (e == EINTR)
+            continue;
+
+        if (e != EAGAIN)
+            throw IOError(getErrnoString("writev"));
+
+        pollfd pfd;
+        pfd.fd = this->fd();
+        pfd.revents = 0;
+        pfd.events = POLLOUT;
+
+        if (!this->wait(_timeout, pfd))
+        {
+            throw IOTimeout();
+        }
+    }
+
+    return static_cast<size_t>(ret);
+}
+
+
 void IODeviceImpl::sigwrite(int sig)
 {
     ::write(_fd, (const void*)&sig, sizeof(sig));
@@ -346,6 +431,7 @@ void IODeviceImpl::cancel()
     if(_pfd)
     {
         _pfd->events &= ~(POLLIN|POLLOUT);
+        pollChanged();
     }
 }
 
@@ -455,7 +541,7 @@ bool IODeviceImpl::checkPollEvent(pollfd& pfd)
     if( !sentry )
         return avail;
 
-    if( pfd.revents & POLLIN_MASK )
+    if( _device.ravail() > 0 || (pfd.revents & POLLIN_MASK) )
     {
         inputReady();
         avail = true;
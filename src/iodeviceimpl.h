@@ -79,6 +79,10 @@ namespace cxxtools
 
             virtual size_t write( const char* buffer, size_t count );
 
+            virtual size_t beginWritev(const struct iovec* vec, size_t count);
+
+            virtual size_t writev(const struct iovec* vec, size_t count);
+
             void sigwrite(int sig);
 
             virtual void cancel();
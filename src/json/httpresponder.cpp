@@ -71,6 +71,15 @@ std::size_t HttpResponder::readBody(std::istream& is)
     return n;
 }
 
+bool HttpResponder::prepareReply(http::Request& /*request*/, const std::function<void()>& ready)
+{
+    if (!_responder.beginCall())
+        return false;
+
+    _responder.startCall(ready);
+    return true;
+}
+
 void HttpResponder::reply(std::ostream& os, http::Request& /*request*/, http::Reply& reply)
 {
     reply.setHeader("Content-Type", "application/json");
@@ -51,6 +51,8 @@ class HttpResponder : public http::Responder
 
         std::size_t readBody(std::istream& is);
 
+        bool prepareReply(http::Request& request, const std::function<void()>& ready);
+
         void reply(std::ostream& os, http::Request& request, http::Reply& reply);
 
     private:
@@ -47,12 +47,16 @@ const int Responder::InternalError;
 
 Responder::Responder(ServiceRegistry& serviceRegistry)
     : _serviceRegistry(serviceRegistry),
-      _failed(false)
+      _failed(false),
+      _proc(0),
+      _called(false)
 {
 }
 
 Responder::~Responder()
 {
+    if (_proc)
+        _serviceRegistry.releaseProcedure(_proc);
 }
 
 void Responder::begin()
@@ -61,12 +65,72 @@ void Responder::begin()
     _failed = false;
 }
 
+bool Responder::beginCall()
+{
+    log_trace("beginCall");
+
+    _called = true;
+
+    if (_failed)
+        return false;
+
+    try
+    {
+        _deserializer.si().getMember("method") >>= _methodName;
+
+        log_debug("method = " << _methodName);
+        _proc = _serviceRegistry.getProcedure(_methodName);
+        if( ! _proc )
+            throw RemoteException("Method \"" + _methodName + "\" not found", MethodNotFound);
+
+        // compose arguments
+        IComposer** args = _proc->beginCall();
+
+        // process args
+        const SerializationInfo* paramsPtr = _deserializer.si().findMember("params");
+
+        // params may be ommited in request
+        SerializationInfo emptyParams;
+
+        const SerializationInfo& params = paramsPtr ? *paramsPtr : emptyParams;
+
+        SerializationInfo::ConstIterator it = params.begin();
+        if (args)
+        {
+            for (int a = 0; args[a]; ++a)
+            {
+                if (it == params.end())
+                    throw RemoteException("missing parameters", InvalidParams);
+                args[a]->fixup(*it);
+                ++it;
+            }
+        }
+
+        if (it != params.end())
+            throw RemoteException("too many parameters", InvalidParams);
+
+        return _proc->isAsync();
+    }
+    catch (...)
+    {
+        // reported in finalize
+        _callError = std::current_exception();
+    }
+
+    return false;
+}
+
+void Responder::startCall(const std::function<void()>& finished)
+{
+    _proc->startCall(finished);
+}
+
 void Responder::finalize(std::ostream& out)
 {
     log_trace("finalize");
 
-    std::string methodName;
-    ServiceProcedure* proc = 0;
+    if (!_called)
+        beginCall();
 
     JsonFormatter formatter;
 
@@ -86,43 +150,13 @@ void Responder::finalize(std::ostream& out)
 
         try
         {
-            _deserializer.si().getMember("method") >>= methodName;
-
-            log_debug("method = " << methodName);
-            proc = _serviceRegistry.getProcedure(methodName);
-            if( ! proc )
-                throw RemoteException("Method \"" + methodName + "\" not found", MethodNotFound);
-
-            // compose arguments
-            IComposer** args = proc->beginCall();
-
-            // process args
-            const SerializationInfo* paramsPtr = _deserializer.si().findMember("params");
-
-            // params may be ommited in request
-            SerializationInfo emptyParams;
-
-            const SerializationInfo& params = paramsPtr ? *paramsPtr : emptyParams;
-
-            SerializationInfo::ConstIterator it = params.begin();
-            if (args)
-            {
-                for (int a = 0; args[a]; ++a)
-                {
-                    if (it == params.end())
-                        throw RemoteException("missing parameters", InvalidParams);
-                    args[a]->fixup(*it);
-                    ++it;
-                }
-            }
-
-            if (it != params.end())
-                throw RemoteException("too many parameters", InvalidParams);
+            if (_callError)
+                std::rethrow_exception(_callError);
 
             IDecomposer::formatEach(_deserializer.si().getMember("id"), formatter);
 
             IDecomposer* result;
-            result = proc->endCall();
+            result = _proc->endCall();
 
             formatter.beginValue("result");
             result->format(formatter);
@@ -130,7 +164,7 @@ void Responder::finalize(std::ostream& out)
         }
         catch (const RemoteException& e)
         {
-            log_debug("method \"" << methodName << "\" exited with RemoteException: " << e.what());
+            log_debug("method \"" << _methodName << "\" exited with RemoteException: " << e.what());
 
             formatter.beginObject("error", std::string());
 
@@ -150,7 +184,7 @@ void Responder::finalize(std::ostream& out)
         }
         catch (const std::exception& e)
         {
-            log_debug("method \"" << methodName << "\" exited with exception: " << e.what());
+            log_debug("method \"" << _methodName << "\" exited with exception: " << e.what());
 
             formatter.beginObject("error", std::string());
 
@@ -162,8 +196,15 @@ void Responder::finalize(std::ostream& out)
 
     formatter.finishObject();
 
-    if (proc)
-        _serviceRegistry.releaseProcedure(proc);
+    if (_proc)
+    {
+        _serviceRegistry.releaseProcedure(_proc);
+        _proc = 0;
+    }
+
+    _methodName.clear();
+    _called = false;
+    _callError = std::exception_ptr();
 }
 
 bool Responder::advance(char ch)
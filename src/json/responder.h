@@ -34,11 +34,14 @@
 #include <cxxtools/iostream.h>
 #include <cxxtools/jsonparser.h>
 #include <cxxtools/jsonformatter.h>
+#include <exception>
+#include <functional>
 
 namespace cxxtools
 {
 
 class ServiceRegistry;
+class ServiceProcedure;
 
 namespace json
 {
@@ -61,6 +64,14 @@ class Responder
 
         void begin();
         bool advance(char ch);
+
+        // Looks up the procedure and passes the arguments after the request
+        // is read. Returns true, when the procedure is asynchronous; it is
+        // started with startCall then and finalize is called, when it
+        // has finished.
+        bool beginCall();
+        void startCall(const std::function<void()>& finished);
+
         void finalize(std::ostream& out);
         bool failed() const
         { return _failed; }
@@ -72,6 +83,11 @@ class Responder
         bool _failed;
         int _errorCode;
         std::string _errorMessage;
+
+        std::string _methodName;
+        ServiceProcedure* _proc;
+        bool _called;
+        std::exception_ptr _callError;
 };
 }
 }
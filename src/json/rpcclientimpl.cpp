@@ -189,7 +189,7 @@ void RpcClientImpl::call(IComposer& r, IRemoteProcedure& method, IDecomposer** a
                 throw std::runtime_error("reading result failed");
             }
 
-            if (_deserializer.advance(ch))
+            if (_deserializer.advance(StreamBuffer::traits_type::to_char_type(ch)))
             {
                 _proc = 0;
                 _scanner.finalizeReply();
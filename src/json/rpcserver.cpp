@@ -99,6 +99,16 @@ void RpcServer::maxThreads(unsigned m)
     _impl->maxThreads(m);
 }
 
+unsigned RpcServer::eventLoops() const
+{
+    return _impl->eventLoops();
+}
+
+void RpcServer::eventLoops(unsigned n)
+{
+    _impl->eventLoops(n);
+}
+
 Delegate<bool, const SslCertificate&>& RpcServer::acceptSslCertificate()
 {
     return _impl->acceptSslCertificate;
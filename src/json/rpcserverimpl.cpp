@@ -46,13 +46,16 @@ namespace json
 class IdleSocketEvent : public BasicEvent<IdleSocketEvent>
 {
         Socket* _socket;
+        unsigned _loop;
 
     public:
-        explicit IdleSocketEvent(Socket* socket)
-            : _socket(socket)
+        IdleSocketEvent(Socket* socket, unsigned loop)
+            : _socket(socket),
+              _loop(loop)
             { }
 
         Socket* socket() const   { return _socket; }
+        unsigned loop() const    { return _loop; }
 
 };
 
@@ -99,7 +102,10 @@ RpcServerImpl::RpcServerImpl(EventLoopBase& eventLoop, Signal<RpcServer::Runmode
       inputSlot(slot(*this, &RpcServerImpl::onInput)),
       _serviceRegistry(serviceRegistry),
       _minThreads(5),
-      _maxThreads(200)
+      _maxThreads(200),
+      _eventLoops(0),
+      _queue(1024, true),
+      _idleSocket(1)
 {
     _eventLoop.event.subscribe(slot(*this, &RpcServerImpl::onIdleSocket));
     _eventLoop.event.subscribe(slot(*this, &RpcServerImpl::onNoWaitingThreads));
@@ -135,6 +141,21 @@ void RpcServerImpl::start()
     log_trace("start server");
     runmode(RpcServer::Starting);
 
+    if (eventLoops() > 0)
+    {
+        log_debug("start " << eventLoops() << " event loops");
+
+        // loops kept from a previous start are already subscribed
+        unsigned subscribed = _loopGroup.size();
+        _loopGroup.resize(eventLoops());
+        _idleSocket.resize(eventLoops());
+
+        for (unsigned n = subscribed; n < _loopGroup.size(); ++n)
+            _loopGroup.loop(n).event.subscribe(slot(*this, &RpcServerImpl::onIdleSocket));
+
+        _loopGroup.start();
+    }
+
     std::lock_guard<std::mutex> lock(_threadMutex);
     while (_threads.size() < minThreads())
     {
@@ -189,17 +210,42 @@ void RpcServerImpl::terminate()
             delete th;
         }
 
+        if (_loopGroup.running())
+        {
+            log_debug("stop " << _loopGroup.size() << " event loops");
+            _loopGroup.stop();
+
+            // pending idle sockets are moved to the idle socket sets
+            for (unsigned n = 0; n < _loopGroup.size(); ++n)
+                _loopGroup.loop(n).processEvents();
+        }
+
         for (unsigned n = 0; n < _listener.size(); ++n)
             delete _listener[n];
         _listener.clear();
 
+        // Sockets are taken out of the set before deleting, so that
+        // procedures finishing now do not put them to the queue.
+        std::set<Socket*> asyncSockets;
+        {
+            std::lock_guard<std::mutex> asyncLock(_asyncMutex);
+            asyncSockets.swap(_asyncSockets);
+        }
+
+        log_debug("delete " << asyncSockets.size() << " sockets waiting for asynchronous procedures");
+        for (std::set<Socket*>::iterator it = asyncSockets.begin(); it != asyncSockets.end(); ++it)
+            delete *it;
+
         while (!_queue.empty())
             delete _queue.get();
 
-        for (IdleSocket::iterator it = _idleSocket.begin(); it != _idleSocket.end(); ++it)
-            delete *it;
+        for (unsigned n = 0; n < _idleSocket.size(); ++n)
+        {
+            for (IdleSocket::iterator it = _idleSocket[n].begin(); it != _idleSocket[n].end(); ++it)
+                delete *it;
 
-        _idleSocket.clear();
+            _idleSocket[n].clear();
+        }
 
         runmode(RpcServer::Stopped);
     }
@@ -238,7 +284,8 @@ void RpcServerImpl::addIdleSocket(Socket* socket)
 
     if (runmode() == RpcServer::Running)
     {
-        _eventLoop.commitEvent(IdleSocketEvent(socket));
+        unsigned n = _loopGroup.size() > 0 ? _loopGroup.nextIndex() : 0;
+        idleLoop(n).commitEvent(IdleSocketEvent(socket, n));
     }
     else
     {
@@ -247,14 +294,43 @@ void RpcServerImpl::addIdleSocket(Socket* socket)
     }
 }
 
+void RpcServerImpl::addAsyncSocket(Socket* socket)
+{
+    std::lock_guard<std::mutex> lock(_asyncMutex);
+
+    if (socket->asyncFinished())
+    {
+        log_debug("asynchronous procedure of socket " << static_cast<void*>(socket) << " already finished");
+        _queue.put(socket);
+    }
+    else
+    {
+        log_debug("park socket " << static_cast<void*>(socket) << " until asynchronous procedure finishes");
+        _asyncSockets.insert(socket);
+    }
+}
+
+void RpcServerImpl::onAsyncFinished(Socket* socket)
+{
+    // called from the thread, which passes the result to the procedure
+    std::lock_guard<std::mutex> lock(_asyncMutex);
+
+    socket->asyncFinished(true);
+    if (_asyncSockets.erase(socket))
+    {
+        log_debug("asynchronous procedure of socket " << static_cast<void*>(socket) << " finished");
+        _queue.put(socket);
+    }
+}
+
 void RpcServerImpl::onIdleSocket(const IdleSocketEvent& event)
 {
     Socket* socket = event.socket();
 
-    log_debug("add idle socket " << static_cast<void*>(socket) << " to selector");
+    log_debug("add idle socket " << static_cast<void*>(socket) << " to selector " << event.loop());
 
-    _idleSocket.insert(socket);
-    socket->setSelector(&_eventLoop);
+    _idleSocket[event.loop()].insert(socket);
+    socket->setSelector(&idleLoop(event.loop()));
     socket->inputConnection = socket->inputReady.connect(inputSlot);
 }
 
@@ -307,6 +383,14 @@ void RpcServerImpl::onThreadTerminated(const ThreadTerminatedEvent& event)
     delete event.worker();
 }
 
+unsigned RpcServerImpl::idleLoopIndex(const SelectorBase* selector)
+{
+    for (unsigned n = 0; n < _loopGroup.size(); ++n)
+        if (&_loopGroup.loop(n) == selector)
+            return n;
+    return 0;
+}
+
 void RpcServerImpl::onServerStart(const ServerStartEvent& event)
 {
     if (event.server() == this)
@@ -317,9 +401,10 @@ void RpcServerImpl::onServerStart(const ServerStartEvent& event)
 
 void RpcServerImpl::onInput(Socket& socket)
 {
+    unsigned n = idleLoopIndex(socket.selector());
     socket.removeSelector();
     log_debug("search socket " << static_cast<void*>(&socket) << " in idle socket");
-    _idleSocket.erase(&socket);
+    _idleSocket[n].erase(&socket);
 
     if (socket.isConnected())
     {
@@ -31,10 +31,11 @@
 
 #include <cxxtools/json/rpcserver.h>
 #include <cxxtools/event.h>
-#include <cxxtools/queue.h>
+#include <cxxtools/mpmcqueue.h>
 #include <cxxtools/signal.h>
 #include <cxxtools/delegate.h>
 #include <cxxtools/connectable.h>
+#include <cxxtools/eventloopgroup.h>
 
 #include <mutex>
 #include <condition_variable>
@@ -45,6 +46,7 @@ namespace cxxtools
 {
 
 class EventLoopBase;
+class SelectorBase;
 class ServiceProcedure;
 class SslCtx;
 
@@ -86,6 +88,12 @@ namespace json
             void maxThreads(unsigned m)
             { _maxThreads = m; }
 
+            unsigned eventLoops() const
+            { return _eventLoops; }
+
+            void eventLoops(unsigned n)
+            { _eventLoops = n; }
+
             void terminate();
 
             RpcServer::Runmode runmode() const
@@ -104,11 +112,19 @@ namespace json
             Signal<RpcServer::Runmode>& _runmodeChanged;
 
             EventLoopBase& _eventLoop;
+            EventLoopGroup _loopGroup;
+
+            EventLoopBase& idleLoop(unsigned n)
+            { return _loopGroup.size() == 0 ? _eventLoop : _loopGroup.loop(n); }
+
+            unsigned idleLoopIndex(const SelectorBase* selector);
 
             void noWaitingThreads();
             void onInput(Socket& _socket);
 
             void addIdleSocket(Socket* socket);
+            void addAsyncSocket(Socket* socket);
+            void onAsyncFinished(Socket* socket);
             void onIdleSocket(const IdleSocketEvent& event);
             void onActiveSocket(const ActiveSocketEvent& event);
             void onNoWaitingThreads(const NoWaitingThreadsEvent& event);
@@ -126,12 +142,20 @@ namespace json
             ServiceRegistry& _serviceRegistry;
             unsigned _minThreads;
             unsigned _maxThreads;
+            unsigned _eventLoops;
 
             std::vector<net::TcpServer*> _listener;
-            Queue<Socket*> _queue;
+            // sockets ready for the workers; overflow enabled so that the
+            // event loop never blocks when putting sockets
+            MpmcQueue<Socket*> _queue;
 
             typedef std::set<Socket*> IdleSocket;
-            IdleSocket _idleSocket;
+            std::vector<IdleSocket> _idleSocket;
+
+            // sockets waiting for the result of an asynchronous procedure;
+            // they are put to the queue again, when the procedure finishes
+            std::mutex _asyncMutex;
+            std::set<Socket*> _asyncSockets;
 
             std::mutex _threadMutex;
             std::condition_variable _threadTerminated;
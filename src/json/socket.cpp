@@ -29,6 +29,7 @@
 #include "socket.h"
 #include "rpcserverimpl.h"
 #include <cxxtools/log.h>
+#include <functional>
 
 log_define("cxxtools.json.socket")
 
@@ -43,7 +44,9 @@ Socket::Socket(RpcServerImpl& rpcServerImpl, net::TcpServer& tcpServer, const Ss
       _tcpServer(tcpServer),
       _sslCtx(sslCtx),
       _responder(rpcServerImpl._serviceRegistry),
-      _accepted(false)
+      _accepted(false),
+      _asyncPending(false),
+      _asyncFinished(false)
 {
     _stream.attachDevice(*this);
     cxxtools::connect(IODevice::inputReady, *this, &Socket::onIODeviceInput);
@@ -60,7 +63,9 @@ Socket::Socket(Socket& socket)
       _tcpServer(socket._tcpServer),
       _sslCtx(socket._sslCtx),
       _responder(_rpcServerImpl._serviceRegistry),
-      _accepted(false)
+      _accepted(false),
+      _asyncPending(false),
+      _asyncFinished(false)
 {
     _stream.attachDevice(*this);
     cxxtools::connect(IODevice::inputReady, *this, &Socket::onIODeviceInput);
@@ -128,6 +133,16 @@ void Socket::onInput(StreamBuffer& sb)
     {
         if (_responder.advance(sb.sbumpc()))
         {
+            if (_responder.beginCall())
+            {
+                // The worker parks the socket after returning from here.
+                // Reading is resumed, when the reply is sent.
+                _asyncPending = true;
+                _asyncFinished = false;
+                _responder.startCall(std::bind(&RpcServerImpl::onAsyncFinished, &_rpcServerImpl, this));
+                return;
+            }
+
             _responder.finalize(_stream);
             buffer().beginWrite();
             onOutput(sb);
@@ -139,6 +154,15 @@ void Socket::onInput(StreamBuffer& sb)
 
 }
 
+void Socket::sendAsyncReply()
+{
+    log_debug("send reply of asynchronous procedure");
+    _asyncPending = false;
+    _responder.finalize(_stream);
+    buffer().beginWrite();
+    onOutput(buffer());
+}
+
 bool Socket::onOutput(StreamBuffer& sb)
 {
     log_trace("onOutput");
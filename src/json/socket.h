@@ -61,6 +61,16 @@ class Socket : public net::TcpSocket, public Connectable
         bool onOutput(StreamBuffer& sb);
         bool onAcceptSslCertificate(const SslCertificate& cert);
 
+        // an asynchronous procedure is running; the socket is parked by
+        // the worker until the result is available
+        bool asyncPending() const      { return _asyncPending; }
+        void sendAsyncReply();
+
+        // set by the server, when the procedure has finished; guarded by
+        // the mutex of the async sockets in the server
+        bool asyncFinished() const     { return _asyncFinished; }
+        void asyncFinished(bool f)     { _asyncFinished = f; }
+
         Signal<Socket&> inputReady;
 
         StreamBuffer& buffer()         { return _stream.buffer(); }
@@ -81,6 +91,8 @@ class Socket : public net::TcpSocket, public Connectable
         int _sslVerifyLevel;
         std::string _sslCa;
         bool _accepted;
+        bool _asyncPending;
+        bool _asyncFinished;
 };
 
 }
@@ -100,6 +100,10 @@ void Worker::run()
                     throw;
                 }
             }
+            else if (socket->asyncPending())
+            {
+                socket->sendAsyncReply();
+            }
             else if (socket->isConnected())
             {
                 log_debug("process available input from " << socket->getPeerAddr());
@@ -116,10 +120,16 @@ void Worker::run()
             Connection inputConnection = socket->buffer().inputReady.connect(
                 socket->inputSlot);
 
-            while (socket->wait(10) && socket->isConnected())
+            while (!socket->asyncPending() && socket->wait(10) && socket->isConnected())
                 ;
 
-            if (socket->isConnected())
+            if (socket->asyncPending())
+            {
+                log_debug("wait for asynchronous procedure");
+                inputConnection.close();
+                _server.addAsyncSocket(socket);
+            }
+            else if (socket->isConnected())
             {
                 log_debug("timeout processing socket");
                 inputConnection.close();
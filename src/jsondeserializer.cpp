@@ -56,6 +56,32 @@ JsonDeserializer::JsonDeserializer(std::istream& in, TextCodec<Char, char>* code
 {
     CodecReleaser r(codec);
 
+    if (dynamic_cast<Utf8Codec*>(codec))
+    {
+        // utf-8 is parsed byte by byte without decoding each character
+        begin();
+
+        std::streambuf* sb = in.rdbuf();
+        while (true)
+        {
+            std::streambuf::int_type ch = sb->sbumpc();
+            if (ch == std::streambuf::traits_type::eof())
+            {
+                in.setstate(std::ios::eofbit | std::ios::failbit);
+                break;
+            }
+
+            int ret = advance(std::streambuf::traits_type::to_char_type(ch));
+            if (ret == -1)
+                sb->sungetc();
+            if (ret != 0)
+                break;
+        }
+
+        finish();
+        return;
+    }
+
     char ibuf;
     Char obuf;
 
@@ -90,17 +90,17 @@ bool JsonParser::JsonStringParser::advance(Char ch)
         case state_esc:
             _state = state_0;
             if (ch == '"' || ch == '\\' || ch == '/')
-                _str += ch;
+                put(ch);
             else if (ch == 'b')
-                _str += '\b';
+                put('\b');
             else if (ch == 'f')
-                _str += '\f';
+                put('\f');
             else if (ch == 'n')
-                _str += '\n';
+                put('\n');
             else if (ch == 'r')
-                _str += '\r';
+                put('\r');
             else if (ch == 't')
-                _str += '\t';
+                put('\t');
             else if (ch == 'u')
             {
                 _value = 0;
@@ -141,7 +141,7 @@ bool JsonParser::JsonStringParser::advance(Char ch)
                         }
                         else
                         {
-                            _str += Char(static_cast<int32_t>(_value));
+                            put(Char(static_cast<int32_t>(_value)));
                             _state = state_0;
                         }
                         break;
@@ -150,7 +150,7 @@ bool JsonParser::JsonStringParser::advance(Char ch)
                         if ((_value & 0xfc00) != 0xd800)
                             _jsonParser->doThrow("expecting surrogate value \\ud8xx " + std::to_string(_value));
 
-                        _str += fromUtf16(_surrogateValue, _value);
+                        put(fromUtf16(_surrogateValue, _value));
                         _state = state_0;
                         break;
 
@@ -158,7 +158,7 @@ bool JsonParser::JsonStringParser::advance(Char ch)
                         if ((_value & 0xfc00) != 0xdc00)
                             _jsonParser->doThrow("expecting surrogate value \\uddxx " + std::to_string(_value));
 
-                        _str += fromUtf16(_value, _surrogateValue);
+                        put(fromUtf16(_value, _surrogateValue));
                         _state = state_0;
                         break;
 
@@ -190,8 +190,43 @@ bool JsonParser::JsonStringParser::advance(Char ch)
     return false;
 }
 
+void JsonParser::JsonStringParser::put(Char ch)
+{
+    if (!_utf8)
+    {
+        _str += ch;
+        return;
+    }
+
+    uint32_t v = ch.value();
+    if (v < 0x80)
+    {
+        _str8 += static_cast<char>(v);
+        return;
+    }
+
+    _ascii = false;
+    if (v < 0x800)
+    {
+        _str8 += static_cast<char>(0xc0 | (v >> 6));
+    }
+    else if (v < 0x10000)
+    {
+        _str8 += static_cast<char>(0xe0 | (v >> 12));
+        _str8 += static_cast<char>(0x80 | ((v >> 6) & 0x3f));
+    }
+    else
+    {
+        _str8 += static_cast<char>(0xf0 | (v >> 18));
+        _str8 += static_cast<char>(0x80 | ((v >> 12) & 0x3f));
+        _str8 += static_cast<char>(0x80 | ((v >> 6) & 0x3f));
+    }
+    _str8 += static_cast<char>(0x80 | (v & 0x3f));
+}
+
 JsonParser::JsonParser()
-    : _deserializer(0),
+    : _utf8(false),
+      _deserializer(0),
       _stringParser(this),
       _next(0),
       _lineNo(1)
@@ -202,7 +237,61 @@ JsonParser::~JsonParser()
     delete _next;
 }
 
-int JsonParser::advance(Char ch)
+void JsonParser::setPlainName()
+{
+    if (_utf8)
+        _stringParser.str8() = std::move(_token);
+    else
+        _stringParser.str(String(_token));
+    _token.clear();
+}
+
+void JsonParser::beginMember()
+{
+    if (_next == 0)
+        _next = new JsonParser();
+
+    if (_utf8)
+    {
+        log_debug("begin object member " << _stringParser.str8());
+        _deserializer->beginMember(_stringParser.str8(),
+                std::string(), SerializationInfo::Void);
+    }
+    else
+    {
+        log_debug("begin object member " << _stringParser.str());
+        _deserializer->beginMember(Utf8Codec::encode(_stringParser.str()),
+                std::string(), SerializationInfo::Void);
+    }
+
+    _next->begin(*_deserializer);
+    _stringParser.clear();
+    _state = state_object_value;
+}
+
+void JsonParser::setStringValue()
+{
+    if (!_utf8)
+    {
+        log_debug("set string value \"" << _stringParser.str() << '"');
+        _deserializer->setValue(_stringParser.str());
+    }
+    else if (_stringParser.ascii())
+    {
+        log_debug("set string value \"" << _stringParser.str8() << '"');
+        _deserializer->setValue(std::move(_stringParser.str8()));
+    }
+    else
+    {
+        log_debug("set string value \"" << _stringParser.str8() << '"');
+        _deserializer->setValue(Utf8Codec::decode(_stringParser.str8()));
+    }
+
+    _deserializer->setTypeName("string");
+    _stringParser.clear();
+}
+
+int JsonParser::doAdvance(Char ch)
 {
     int ret;
 
@@ -238,7 +327,7 @@ int JsonParser::advance(Char ch)
                 }
                 else if ((ch >= '0' && ch <= '9') || ch == '+' || ch == '-')
                 {
-                    _token = ch;
+                    _token = ch.narrow();
                     _state = state_number;
                     _deserializer->setCategory(SerializationInfo::Value);
                 }
@@ -249,7 +338,7 @@ int JsonParser::advance(Char ch)
                 }
                 else if (!std::isspace(ch.value()))
                 {
-                    _token = ch;
+                    _token = ch.narrow();
                     _state = state_token;
                 }
                 break;
@@ -272,7 +361,7 @@ int JsonParser::advance(Char ch)
                 }
                 else if (std::isalpha(ch.value()))
                 {
-                    _token = ch;
+                    _token = ch.narrow();
                     _state = state_object_plainname;
                 }
                 else if (!std::isspace(ch.value()))
@@ -281,23 +370,16 @@ int JsonParser::advance(Char ch)
 
             case state_object_plainname:
                 if (std::isalnum(ch.value()) || ch == 'l')
-                    _token += ch;
+                    _token += ch.narrow();
                 else if (std::isspace(ch.value()))
                 {
-                    _stringParser.str(std::move(_token));
+                    setPlainName();
                     _state = state_object_after_name;
                 }
                 else if (ch == ':')
                 {
-                    _stringParser.str(std::move(_token));
-                    if (_next == 0)
-                        _next = new JsonParser();
-                    log_debug("begin object member " << _stringParser.str());
-                    _deserializer->beginMember(Utf8Codec::encode(_stringParser.str()),
-                            std::string(), SerializationInfo::Void);
-                    _next->begin(*_deserializer);
-                    _stringParser.clear();
-                    _state = state_object_value;
+                    setPlainName();
+                    beginMember();
                 }
                 else
                     throwInvalidCharacter(ch);
@@ -305,22 +387,13 @@ int JsonParser::advance(Char ch)
                 break;
 
             case state_object_name:
-                if (_stringParser.advance(ch))
+                if (advanceString(ch))
                     _state = state_object_after_name;
                 break;
 
             case state_object_after_name:
                 if (ch == ':')
-                {
-                    if (_next == 0)
-                        _next = new JsonParser();
-                    log_debug("begin object member " << _stringParser.str());
-                    _deserializer->beginMember(Utf8Codec::encode(_stringParser.str()),
-                            std::string(), SerializationInfo::Void);
-                    _next->begin(*_deserializer);
-                    _stringParser.clear();
-                    _state = state_object_value;
-                }
+                    beginMember();
                 else if (ch == '/')
                 {
                     _nextState = _state;
@@ -331,7 +404,7 @@ int JsonParser::advance(Char ch)
                 break;
 
             case state_object_value:
-                ret = _next->advance(ch);
+                ret = advanceNext(ch);
 
                 if (ret != 0)
                 {
@@ -388,7 +461,7 @@ int JsonParser::advance(Char ch)
                 }
                 else if (std::isalpha(ch.value()))
                 {
-                    _token = ch;
+                    _token = ch.narrow();
                     _state = state_object_plainname;
                 }
                 else if (!std::isspace(ch.value()))
@@ -415,7 +488,7 @@ int JsonParser::advance(Char ch)
                     _deserializer->beginMember(std::string(),
                             std::string(), SerializationInfo::Void);
                     _next->begin(*_deserializer);
-                    _next->advance(ch);
+                    advanceNext(ch);
                     _state = state_array_value;
                 }
                 break;
@@ -440,7 +513,7 @@ int JsonParser::advance(Char ch)
                 // no break
 
             case state_array_value:
-                ret = _next->advance(ch);
+                ret = advanceNext(ch);
                 if (ret != 0)
                     _state = state_array_e;
                 if (ret != -1)
@@ -471,12 +544,9 @@ int JsonParser::advance(Char ch)
                 break;
 
             case state_string:
-                if (_stringParser.advance(ch))
+                if (advanceString(ch))
                 {
-                    log_debug("set string value \"" << _stringParser.str() << '"');
-                    _deserializer->setValue(_stringParser.str());
-                    _deserializer->setTypeName("string");
-                    _stringParser.clear();
+                    setStringValue();
                     _state = state_end;
                     return 1;
                 }
@@ -493,12 +563,12 @@ int JsonParser::advance(Char ch)
                 }
                 else if (ch == '.' || ch == 'e' || ch == 'E')
                 {
-                    _token += ch;
+                    _token += ch.narrow();
                     _state = state_float;
                 }
                 else if (ch >= '0' && ch <= '9')
                 {
-                    _token += ch;
+                    _token += ch.narrow();
                 }
                 else
                 {
@@ -521,7 +591,7 @@ int JsonParser::advance(Char ch)
                 }
                 else if ((ch >= '0' && ch <= '9') || ch == '+' || ch == '-'
                         || ch == '.' || ch == 'e' || ch == 'E')
-                    _token += ch;
+                    _token += ch.narrow();
                 else
                 {
                     log_debug("set double value \"" << _token << '"');
@@ -534,7 +604,7 @@ int JsonParser::advance(Char ch)
 
             case state_token:
                 if (std::isalpha(ch.value()))
-                    _token += Char(std::tolower(ch));
+                    _token += static_cast<char>(std::tolower(ch.value()));
                 else
                 {
                     if (_token == "true" || _token == "false")
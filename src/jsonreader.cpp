@@ -0,0 +1,473 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cxxtools/jsonreader.h>
+#include <cxxtools/jsonparser.h>
+#include <cxxtools/utf8codec.h>
+#include <cxxtools/log.h>
+
+#include <istream>
+#include <cctype>
+
+log_define("cxxtools.json.reader")
+
+namespace cxxtools
+{
+
+namespace
+{
+    typedef std::char_traits<char> traits;
+
+    inline bool isWs(int ch)
+    { return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r' || ch == '\f' || ch == '\v'; }
+}
+
+JsonReader::JsonReader(std::istream& in)
+    : _sb(in.rdbuf()),
+      _token(None),
+      _float(false),
+      _ascii(true),
+      _skipping(false),
+      _lineNo(1)
+{ }
+
+void JsonReader::doThrow(const std::string& msg)
+{
+    throw JsonParserError(msg, _lineNo);
+}
+
+void JsonReader::throwInvalidCharacter(int ch)
+{
+    if (ch == traits::eof())
+        doThrow("unexpected end of json");
+
+    log_debug("invalid character '" << static_cast<char>(ch) << "' in token " << _token);
+    doThrow(std::string("invalid character '") + static_cast<char>(ch) + '\'');
+}
+
+inline int JsonReader::getc()
+{
+    int ch = _sb->sbumpc();
+    if (ch == '\n')
+        ++_lineNo;
+    return ch;
+}
+
+inline int JsonReader::peekc()
+{
+    return _sb->sgetc();
+}
+
+// skips white space and comments and returns the next character without consuming it
+int JsonReader::skipWs()
+{
+    while (true)
+    {
+        int ch = peekc();
+        if (isWs(ch))
+        {
+            getc();
+        }
+        else if (ch == '/')
+        {
+            getc();
+            ch = getc();
+            if (ch == '/')
+            {
+                while ((ch = getc()) != '\n' && ch != traits::eof())
+                    ;
+            }
+            else if (ch == '*')
+            {
+                int prev = 0;
+                while ((ch = getc()) != traits::eof() && !(prev == '*' && ch == '/'))
+                    prev = ch;
+                if (ch == traits::eof())
+                    doThrow("unexpected end of json in comment");
+            }
+            else
+                throwInvalidCharacter(ch);
+        }
+        else
+            return ch;
+    }
+}
+
+JsonReader::Token JsonReader::next()
+{
+    int ch = skipWs();
+
+    if (_stack.empty())
+    {
+        _name.clear();
+
+        if (ch == traits::eof())
+            return _token = EndOfInput;
+
+        return _token = readValue();
+    }
+
+    Level& level = _stack.back();
+    char close = level.object ? '}' : ']';
+
+    if (ch == close)
+    {
+        getc();
+        _stack.pop_back();
+        _name.clear();
+        return _token = (close == '}' ? EndObject : EndArray);
+    }
+
+    if (!level.first)
+    {
+        if (ch != ',')
+            throwInvalidCharacter(ch);
+
+        getc();
+        ch = skipWs();
+
+        // a trailing comma is accepted like in JsonParser
+        if (ch == close)
+        {
+            getc();
+            _stack.pop_back();
+            _name.clear();
+            return _token = (close == '}' ? EndObject : EndArray);
+        }
+    }
+
+    level.first = false;
+
+    if (level.object)
+    {
+        if (ch == '"')
+        {
+            getc();
+            bool skipping = _skipping;
+            _skipping = false;
+            readString(_name);
+            _skipping = skipping;
+        }
+        else if (std::isalpha(ch))
+            readPlainName();
+        else
+            throwInvalidCharacter(ch);
+
+        ch = skipWs();
+        if (ch != ':')
+            throwInvalidCharacter(ch);
+        getc();
+        skipWs();
+    }
+
+    return _token = readValue();
+}
+
+JsonReader::Token JsonReader::readValue()
+{
+    int ch = peekc();
+
+    if (ch == '{' || ch == '[')
+    {
+        getc();
+        Level level;
+        level.object = (ch == '{');
+        level.first = true;
+        _stack.push_back(level);
+        return level.object ? BeginObject : BeginArray;
+    }
+    else if (ch == '"')
+    {
+        getc();
+        readString(_value);
+        return StringValue;
+    }
+    else if ((ch >= '0' && ch <= '9') || ch == '+' || ch == '-')
+    {
+        readNumber();
+        return NumberValue;
+    }
+    else if (std::isalpha(ch))
+    {
+        readWord();
+        if (_value == "true" || _value == "false")
+            return BoolValue;
+        else if (_value == "null")
+            return NullValue;
+        doThrow("invalid token '" + _value + '\'');
+    }
+
+    throwInvalidCharacter(ch);
+    return None;  // not reached
+}
+
+void JsonReader::appendUtf8(std::string& str, unsigned long code)
+{
+    if (code < 0x80)
+        str += static_cast<char>(code);
+    else
+    {
+        _ascii = false;
+        if (code < 0x800)
+        {
+            str += static_cast<char>(0xc0 | (code >> 6));
+        }
+        else
+        {
+            if (code < 0x10000)
+                str += static_cast<char>(0xe0 | (code >> 12));
+            else
+            {
+                str += static_cast<char>(0xf0 | (code >> 18));
+                str += static_cast<char>(0x80 | ((code >> 12) & 0x3f));
+            }
+            str += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+        }
+        str += static_cast<char>(0x80 | (code & 0x3f));
+    }
+}
+
+unsigned JsonReader::readHex4()
+{
+    unsigned value = 0;
+    for (unsigned n = 0; n < 4; ++n)
+    {
+        int ch = getc();
+        if (ch >= '0' && ch <= '9')
+            value = (value << 4) | (ch - '0');
+        else if (ch >= 'a' && ch <= 'f')
+            value = (value << 4) | (ch - 'a' + 10);
+        else if (ch >= 'A' && ch <= 'F')
+            value = (value << 4) | (ch - 'A' + 10);
+        else
+            doThrow(std::string("invalid character '") + static_cast<char>(ch) + "' in hex sequence");
+    }
+
+    return value;
+}
+
+// reads a string after the opening quote; when skipping, the characters
+// are not stored
+void JsonReader::readString(std::string& str)
+{
+    str.clear();
+    _ascii = true;
+
+    while (true)
+    {
+        int ch = getc();
+        if (ch == '"')
+            return;
+
+        if (ch == traits::eof())
+            doThrow("unexpected end of json in string");
+
+        if (ch != '\\')
+        {
+            if (!_skipping)
+            {
+                if (static_cast<unsigned char>(ch) >= 0x80)
+                    _ascii = false;
+                str += static_cast<char>(ch);
+            }
+            continue;
+        }
+
+        ch = getc();
+        switch (ch)
+        {
+            case '"':
+            case '\\':
+            case '/': if (!_skipping) str += static_cast<char>(ch); break;
+            case 'b': if (!_skipping) str += '\b'; break;
+            case 'f': if (!_skipping) str += '\f'; break;
+            case 'n': if (!_skipping) str += '\n'; break;
+            case 'r': if (!_skipping) str += '\r'; break;
+            case 't': if (!_skipping) str += '\t'; break;
+            case 'u':
+            {
+                unsigned long value = readHex4();
+                if ((value & 0xfc00) == 0xd800 || (value & 0xfc00) == 0xdc00)
+                {
+                    if (getc() != '\\' || getc() != 'u')
+                        doThrow("expecting start of surrogate pair");
+
+                    unsigned long value2 = readHex4();
+                    unsigned long hi = value;
+                    unsigned long lo = value2;
+                    if ((value & 0xfc00) == 0xdc00)
+                        std::swap(hi, lo);
+
+                    if ((hi & 0xfc00) != 0xd800 || (lo & 0xfc00) != 0xdc00)
+                        doThrow("invalid surrogate pair");
+
+                    value = (((hi & 0x3ff) << 10) | (lo & 0x3ff)) + 0x10000;
+                }
+
+                if (!_skipping)
+                    appendUtf8(str, value);
+                break;
+            }
+
+            default:
+                if (ch == traits::eof())
+                    doThrow("unexpected end of json in string");
+                doThrow(std::string("invalid character '") + static_cast<char>(ch) + "' in string");
+        }
+    }
+}
+
+void JsonReader::readPlainName()
+{
+    _name.clear();
+    int ch;
+    while (std::isalnum(ch = peekc()))
+        _name += static_cast<char>(getc());
+}
+
+void JsonReader::readNumber()
+{
+    _value.clear();
+    _float = false;
+
+    _value += static_cast<char>(getc());
+
+    int ch;
+    while (true)
+    {
+        ch = peekc();
+        if (ch >= '0' && ch <= '9')
+            ;
+        else if (ch == '.' || ch == 'e' || ch == 'E')
+            _float = true;
+        else if (_float && (ch == '+' || ch == '-'))
+            ;
+        else
+            break;
+
+        _value += static_cast<char>(getc());
+    }
+}
+
+void JsonReader::readWord()
+{
+    _value.clear();
+    int ch;
+    while (std::isalpha(ch = peekc()))
+        _value += static_cast<char>(std::tolower(getc()));
+}
+
+void JsonReader::skip()
+{
+    if (_token != BeginObject && _token != BeginArray)
+        return;
+
+    std::vector<Level>::size_type depth = _stack.size();
+
+    _skipping = true;
+    try
+    {
+        while (_stack.size() >= depth)
+            if (next() == EndOfInput)
+                doThrow("unexpected end of json");
+    }
+    catch (...)
+    {
+        _skipping = false;
+        throw;
+    }
+
+    _skipping = false;
+}
+
+const SerializationInfo& JsonReader::read()
+{
+    if (_token == None || _token == EndObject || _token == EndArray || _token == EndOfInput)
+        doThrow("no json value to read");
+
+    _deserializer.begin();
+    fill();
+    return _deserializer.si();
+}
+
+// fills the current node of the deserializer from the current token;
+// sets the same type names as JsonParser
+void JsonReader::fill()
+{
+    switch (_token)
+    {
+        case BeginObject:
+            _deserializer.setCategory(SerializationInfo::Object);
+            while (next() != EndObject)
+            {
+                _deserializer.beginMember(_name, std::string(), SerializationInfo::Void);
+                fill();
+                _deserializer.leaveMember();
+            }
+            break;
+
+        case BeginArray:
+            _deserializer.setCategory(SerializationInfo::Array);
+            while (next() != EndArray)
+            {
+                _deserializer.beginMember(std::string(), std::string(), SerializationInfo::Void);
+                fill();
+                _deserializer.leaveMember();
+            }
+            break;
+
+        case StringValue:
+            // non ascii strings are stored as unicode string like JsonParser does
+            if (_ascii)
+                _deserializer.setValue(std::string(_value));
+            else
+                _deserializer.setValue(Utf8Codec::decode(_value));
+            _deserializer.setTypeName("string");
+            break;
+
+        case NumberValue:
+            _deserializer.setValue(std::string(_value));
+            _deserializer.setTypeName(_float ? "double" : "int");
+            break;
+
+        case BoolValue:
+            _deserializer.setValue(std::string(_value));
+            _deserializer.setTypeName("bool");
+            break;
+
+        case NullValue:
+            _deserializer.setTypeName("null");
+            _deserializer.setNull();
+            break;
+
+        default:
+            doThrow("unexpected end of json");
+    }
+}
+
+}
@@ -38,10 +38,13 @@
 #include <cxxtools/split.h>
 #include <cxxtools/envsubst.h>
 #include <cxxtools/datetime.h>
+#include <cxxtools/datetimeformat.h>
 
 #include "dateutils.h"
 
 #include <mutex>
+#include <condition_variable>
+#include <thread>
 #include <memory>
 #include <atomic>
 #include <iterator>
@@ -171,8 +174,9 @@ namespace
         gettimeofday(&t, 0);
 
         // format date only once per second:
-        static char date[20];
-        static time_t psec = 0;
+        static const DateTimeFormat dateFormat("%Y-%m-%d %H:%M:%S.");
+        static thread_local char date[20];
+        static thread_local time_t psec = 0;
         time_t sec = static_cast<time_t>(t.tv_sec);
         if (sec != psec)
         {
@@ -181,28 +185,11 @@ namespace
                 gmtime_r(&sec, &tt);
             else
                 localtime_r(&sec, &tt);
-            int year = 1900 + tt.tm_year;
-            int mon = tt.tm_mon + 1;
-            date[0] = static_cast<char>('0' + year / 1000 % 10);
-            date[1] = static_cast<char>('0' + year / 100 % 10);
-            date[2] = static_cast<char>('0' + year / 10 % 10);
-            date[3] = static_cast<char>('0' + year % 10);
-            date[4] = '-';
-            date[5] = static_cast<char>('0' + mon / 10);
-            date[6] = static_cast<char>('0' + mon % 10);
-            date[7] = '-';
-            date[8] = static_cast<char>('0' + tt.tm_mday / 10);
-            date[9] = static_cast<char>('0' + tt.tm_mday % 10);
-            date[10] = ' ';
-            date[11] = static_cast<char>('0' + tt.tm_hour / 10);
-            date[12] = static_cast<char>('0' + tt.tm_hour % 10);
-            date[13] = ':';
-            date[14] = static_cast<char>('0' + tt.tm_min / 10);
-            date[15] = static_cast<char>('0' + tt.tm_min % 10);
-            date[16] = ':';
-            date[17] = static_cast<char>('0' + tt.tm_sec / 10);
-            date[18] = static_cast<char>('0' + tt.tm_sec % 10);
-            date[19] = '.';
+
+            // a leap second is shown as the last second of the minute
+            DateTime dt(1900 + tt.tm_year, tt.tm_mon + 1, tt.tm_mday,
+                        tt.tm_hour, tt.tm_min, tt.tm_sec < 60 ? tt.tm_sec : 59);
+            dateFormat.format(dt, date, sizeof(date));
 
             psec = sec;
         }
@@ -618,6 +605,349 @@ namespace
         _msg.clear();
     }
 
+    //////////////////////////////////////////////////////////////////////
+    // AsyncLogWriter - collects log entries in per thread ring buffers
+    // and passes them in batches to the appender in a background thread
+    //
+    class AsyncLogWriter
+    {
+        // Single producer single consumer ring. The producer is the logging
+        // thread and the consumer is the writer thread.
+        class Ring
+        {
+            std::vector<std::string> _slots;
+            std::size_t _mask;
+            std::atomic<std::size_t> _head;  // next entry to write
+            std::atomic<std::size_t> _tail;  // next free slot
+            std::atomic<bool> _closed;
+
+        public:
+            explicit Ring(unsigned capacity);
+
+            // Swaps the entry into the ring. The caller gets the string of
+            // a previously written entry back to reuse its memory.
+            bool put(std::string& entry)
+            {
+                std::size_t t = _tail.load(std::memory_order_relaxed);
+                if (t - _head.load(std::memory_order_acquire) > _mask)
+                    return false;
+                _slots[t & _mask].swap(entry);
+                _tail.store(t + 1, std::memory_order_release);
+                return true;
+            }
+
+            // Passes the entries to the appender and returns the position
+            // to release after the appender has written them.
+            std::size_t read(LogAppender& appender)
+            {
+                std::size_t h = _head.load(std::memory_order_relaxed);
+                std::size_t t = _tail.load(std::memory_order_acquire);
+                for (; h != t; ++h)
+                    appender.putMessage(_slots[h & _mask]);
+                return t;
+            }
+
+            void release(std::size_t pos)
+            { _head.store(pos, std::memory_order_release); }
+
+            bool empty() const
+            { return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire); }
+
+            void close()
+            { _closed = true; }
+
+            bool closed() const
+            { return _closed; }
+        };
+
+        // keeps the ring of the current thread
+        struct ThreadRing
+        {
+            std::shared_ptr<Ring> ring;
+            unsigned writer;
+
+            ThreadRing()
+                : writer(0)
+                { }
+
+            ~ThreadRing()
+            {
+                if (ring)
+                    ring->close();
+            }
+        };
+
+        static thread_local ThreadRing _threadRing;
+        static std::atomic<unsigned> _writerCount;
+        static std::atomic<bool> _forked;
+
+        LogAppender& _appender;
+        unsigned _bufferSize;
+        LogConfiguration::OverflowPolicy _overflow;
+        LogFormat _logFormat;
+        unsigned _id;
+
+        std::mutex _mutex;
+        std::condition_variable _writerCond;  // wakes the writer thread
+        std::condition_variable _readCond;    // wakes threads waiting for the writer
+        std::vector<std::shared_ptr<Ring> > _rings;
+        bool _ringsChanged;
+        bool _stop;
+        std::atomic<bool> _sleeping;
+        std::atomic<unsigned> _waiting;
+        std::atomic<unsigned long> _dropped;
+
+        std::thread _thread;
+
+        Ring& threadRing();
+        void wakeWriter();
+        void waitForWriter(std::unique_lock<std::mutex>& lock);
+        void run();
+
+        static void onFork();
+
+    public:
+        AsyncLogWriter(LogAppender& appender, unsigned bufferSize,
+            LogConfiguration::OverflowPolicy overflow, const LogFormat& logFormat);
+        ~AsyncLogWriter();
+
+        // Passes the entry to the writer thread. The string is replaced by
+        // a previously used buffer.
+        void putMessage(std::string& entry, bool flush);
+
+        // Writes the remaining entries and stops the writer thread.
+        void stop();
+
+        // The writer thread does not exist in a forked child.
+        static bool forked()
+        { return _forked; }
+
+        // called, when the child configures logging again
+        static void clearForked()
+        { _forked = false; }
+    };
+
+    thread_local AsyncLogWriter::ThreadRing AsyncLogWriter::_threadRing;
+    std::atomic<unsigned> AsyncLogWriter::_writerCount(0);
+    std::atomic<bool> AsyncLogWriter::_forked(false);
+
+    AsyncLogWriter::Ring::Ring(unsigned capacity)
+      : _head(0),
+        _tail(0),
+        _closed(false)
+    {
+        std::size_t size = 1;
+        while (size < capacity)
+            size <<= 1;
+        _slots.resize(size);
+        _mask = size - 1;
+    }
+
+    AsyncLogWriter::AsyncLogWriter(LogAppender& appender, unsigned bufferSize,
+            LogConfiguration::OverflowPolicy overflow, const LogFormat& logFormat)
+      : _appender(appender),
+        _bufferSize(bufferSize > 0 ? bufferSize : 1),
+        _overflow(overflow),
+        _logFormat(logFormat),
+        _id(++_writerCount),
+        _ringsChanged(false),
+        _stop(false),
+        _sleeping(false),
+        _waiting(0),
+        _dropped(0)
+    {
+        static std::once_flag atfork;
+        std::call_once(atfork, [] { pthread_atfork(0, 0, &AsyncLogWriter::onFork); });
+
+        _thread = std::thread(&AsyncLogWriter::run, this);
+    }
+
+    AsyncLogWriter::~AsyncLogWriter()
+    {
+        stop();
+    }
+
+    void AsyncLogWriter::onFork()
+    {
+        _forked = true;
+    }
+
+    AsyncLogWriter::Ring& AsyncLogWriter::threadRing()
+    {
+        if (_threadRing.writer != _id)
+        {
+            if (_threadRing.ring)
+                _threadRing.ring->close();
+
+            _threadRing.ring = std::make_shared<Ring>(_bufferSize);
+            _threadRing.writer = _id;
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            _rings.push_back(_threadRing.ring);
+            _ringsChanged = true;
+        }
+
+        return *_threadRing.ring;
+    }
+
+    void AsyncLogWriter::wakeWriter()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_sleeping.load(std::memory_order_relaxed))
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _writerCond.notify_one();
+        }
+    }
+
+    void AsyncLogWriter::waitForWriter(std::unique_lock<std::mutex>& lock)
+    {
+        _writerCond.notify_one();
+        _readCond.wait_for(lock, std::chrono::milliseconds(10));
+    }
+
+    void AsyncLogWriter::putMessage(std::string& entry, bool flush)
+    {
+        Ring& ring = threadRing();
+
+        if (!ring.put(entry))
+        {
+            // messages to flush are never dropped
+            if (_overflow != LogConfiguration::OverflowBlock && !flush)
+            {
+                ++_dropped;
+                return;
+            }
+
+            ++_waiting;
+            std::unique_lock<std::mutex> lock(_mutex);
+            while (!_stop && !ring.put(entry))
+                waitForWriter(lock);
+            --_waiting;
+        }
+
+        wakeWriter();
+
+        if (flush)
+        {
+            ++_waiting;
+            std::unique_lock<std::mutex> lock(_mutex);
+            while (!_stop && !ring.empty())
+                waitForWriter(lock);
+            --_waiting;
+        }
+    }
+
+    void AsyncLogWriter::stop()
+    {
+        if (_forked)
+        {
+            _thread.detach();
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_stop)
+                return;
+            _stop = true;
+            _writerCond.notify_one();
+        }
+
+        _thread.join();
+    }
+
+    void AsyncLogWriter::run()
+    {
+        std::vector<std::shared_ptr<Ring> > rings;
+        std::vector<std::size_t> positions;
+
+        while (true)
+        {
+            bool stop;
+
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (_ringsChanged)
+                {
+                    // forget rings of terminated threads
+                    unsigned n = 0;
+                    for (unsigned i = 0; i < _rings.size(); ++i)
+                        if (!_rings[i]->closed() || !_rings[i]->empty())
+                            _rings[n++] = _rings[i];
+                    _rings.resize(n);
+
+                    rings = _rings;
+                    positions.resize(rings.size());
+                    _ringsChanged = false;
+                }
+
+                stop = _stop;
+            }
+
+            bool found = false;
+            bool closed = false;
+            for (unsigned n = 0; n < rings.size(); ++n)
+            {
+                if (!rings[n]->empty())
+                    found = true;
+                else if (rings[n]->closed())
+                    closed = true;
+                positions[n] = rings[n]->read(_appender);
+            }
+
+            unsigned long dropped = _dropped.exchange(0);
+            if (dropped > 0 && _overflow == LogConfiguration::OverflowCount)
+            {
+                std::string msg;
+                logentry(msg, "WARN", "cxxtools.log", _logFormat);
+                msg += convert<std::string>(dropped);
+                msg += " log messages dropped";
+                _appender.putMessage(msg);
+                found = true;
+            }
+
+            if (found)
+            {
+                // one write for all collected entries
+                _appender.finish(true);
+
+                for (unsigned n = 0; n < rings.size(); ++n)
+                    rings[n]->release(positions[n]);
+
+                if (_waiting > 0)
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    _readCond.notify_all();
+                }
+
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            if (closed)
+                _ringsChanged = true;
+
+            if (stop)
+                break;
+
+            _sleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            bool empty = true;
+            for (unsigned n = 0; empty && n < rings.size(); ++n)
+                empty = rings[n]->empty();
+
+            if (empty && !_stop && !_ringsChanged)
+                _writerCond.wait_for(lock, std::chrono::milliseconds(100));
+
+            _sleeping.store(false, std::memory_order_relaxed);
+        }
+
+        _readCond.notify_all();
+    }
+
     //////////////////////////////////////////////////////////////////////
     int throwInvalidLogLevel(const std::string& level, const std::string& category)
     {
@@ -815,6 +1145,9 @@ private:
     bool _broadcast;
     bool _tostdout;  // flag for console output: true=stdout, false=stderr
     LogFormat _logFormat;
+    bool _async;
+    unsigned _asyncBufferSize;
+    LogConfiguration::OverflowPolicy _asyncOverflow;
 
     int _rootFlags;
     LogFlags _logFlags;
@@ -828,6 +1161,9 @@ public:
         _logport(0),
         _broadcast(true),
         _tostdout(false),
+        _async(false),
+        _asyncBufferSize(1024),
+        _asyncOverflow(LogConfiguration::OverflowBlock),
         _rootFlags(rootFlags)
     { }
 
@@ -839,6 +1175,9 @@ public:
     bool broadcast() const                    { return _broadcast; }
     bool tostdout() const                     { return _tostdout; }
     const LogFormat& logFormat() const        { return _logFormat; }
+    bool async() const                        { return _async; }
+    unsigned asyncBufferSize() const          { return _asyncBufferSize; }
+    LogConfiguration::OverflowPolicy asyncOverflow() const { return _asyncOverflow; }
 
     int rootFlags() const                     { return _rootFlags; }
     int logFlags(const std::string& category) const;
@@ -897,6 +1236,16 @@ public:
 
     void setLogFormat(const LogFormat& logFormat)
     { _logFormat = logFormat; }
+
+    void setAsync(unsigned bufferSize, LogConfiguration::OverflowPolicy overflow)
+    {
+        _async = true;
+        _asyncBufferSize = bufferSize;
+        _asyncOverflow = overflow;
+    }
+
+    void setSync()
+    { _async = false; }
 };
 
 int LogConfiguration::Impl::logFlags(const std::string& category) const
@@ -975,6 +1324,23 @@ void operator>>= (const SerializationInfo& si, LogConfiguration::Impl& impl)
 
     si.getMember("logFormat", impl._logFormat);
 
+    if (!si.getMember("async", impl._async))
+        impl._async = false;
+    si.getMember("asyncbuffer", impl._asyncBufferSize);
+
+    std::string overflow;
+    if (si.getMember("asyncoverflow", overflow))
+    {
+        if (compareIgnoreCase(overflow.c_str(), "block") == 0)
+            impl._asyncOverflow = LogConfiguration::OverflowBlock;
+        else if (compareIgnoreCase(overflow.c_str(), "drop") == 0)
+            impl._asyncOverflow = LogConfiguration::OverflowDrop;
+        else if (compareIgnoreCase(overflow.c_str(), "count") == 0)
+            impl._asyncOverflow = LogConfiguration::OverflowCount;
+        else
+            throw std::runtime_error("unknown overflow policy \"" + overflow + '"');
+    }
+
     std::string rootFlags;
     if (!si.getMember("rootlogger", rootFlags))
         impl._rootFlags = Logger::LOG_LEVEL_FATAL;
@@ -1059,6 +1425,15 @@ void operator<<= (SerializationInfo& si, const LogConfiguration::Impl& impl)
         si.addMember("tostdout") <<= true;
 
     si.addMember("logFormat") <<= impl._logFormat;
+
+    if (impl._async)
+    {
+        si.addMember("async") <<= true;
+        si.addMember("asyncbuffer") <<= impl._asyncBufferSize;
+        si.addMember("asyncoverflow") <<= (impl._asyncOverflow == LogConfiguration::OverflowDrop ? "drop"
+                                         : impl._asyncOverflow == LogConfiguration::OverflowCount ? "count"
+                                         : "block");
+    }
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -1154,6 +1529,31 @@ void LogConfiguration::setLogFormat(const LogFormat& logFormat)
     _impl->setLogFormat(logFormat);
 }
 
+bool LogConfiguration::async() const
+{
+    return _impl->async();
+}
+
+unsigned LogConfiguration::asyncBufferSize() const
+{
+    return _impl->asyncBufferSize();
+}
+
+LogConfiguration::OverflowPolicy LogConfiguration::asyncOverflow() const
+{
+    return _impl->asyncOverflow();
+}
+
+void LogConfiguration::setAsync(unsigned bufferSize, OverflowPolicy overflow)
+{
+    _impl->setAsync(bufferSize, overflow);
+}
+
+void LogConfiguration::setSync()
+{
+    _impl->setSync();
+}
+
 void operator>>= (const SerializationInfo& si, LogConfiguration& logConfiguration)
 {
     si >>= *logConfiguration.impl();
@@ -1171,6 +1571,16 @@ void operator<<= (SerializationInfo& si, const LogConfiguration& logConfiguratio
 class LogManager::Impl
 {
     std::unique_ptr<LogAppender> _appender;
+
+    // Threads passing a message to the writer register in the user count
+    // of the current phase. Replacing the writer switches the phase and
+    // waits until the users of the old phase are finished.
+    std::atomic<AsyncLogWriter*> _asyncWriter;
+    std::atomic<unsigned> _writerPhase;
+    std::atomic<unsigned> _writerUsers[2];
+    std::mutex _writerUsersMutex;
+    std::condition_variable _writerUsersFinished;
+
     LogConfiguration _config;
     typedef std::map<std::string, Logger*> Loggers;  // map category => logger
     Loggers _loggers;
@@ -1178,7 +1588,32 @@ class LogManager::Impl
     Impl(const Impl&) = delete;
     Impl& operator=(const Impl&) = delete;
 
+    void createAppender(const LogConfiguration& config);
+    void releaseAsyncWriter();
+
 public:
+    // Gives access to the asynchronous writer. It is not replaced, while
+    // the object exists, so it must not be kept while taking logMutex.
+    class AsyncWriterRef
+    {
+        Impl& _impl;
+        unsigned _phase;
+        AsyncLogWriter* _writer;
+
+        AsyncWriterRef(const AsyncWriterRef&) = delete;
+        AsyncWriterRef& operator=(const AsyncWriterRef&) = delete;
+
+        void release();
+
+    public:
+        explicit AsyncWriterRef(Impl& impl);
+        ~AsyncWriterRef();
+
+        // returns the writer when asynchronous logging is enabled
+        AsyncLogWriter* get() const
+        { return _writer; }
+    };
+
     explicit Impl(const LogConfiguration& config);
     ~Impl();
 
@@ -1189,6 +1624,7 @@ public:
     Logger* getLogger(const std::string& category);
     LogAppender& appender()
     { return *_appender; }
+
   
     int rootFlags() const
     { return _config.rootFlags(); }
@@ -1197,36 +1633,71 @@ public:
     { return _config.logFlags(category); }
 };
 
-LogManager::Impl::Impl(const LogConfiguration& config)
+LogManager::Impl::AsyncWriterRef::AsyncWriterRef(Impl& impl)
+  : _impl(impl),
+    _writer(0)
 {
-    if (config.impl()->fname().empty())
-    {
-        if (config.impl()->logport() != 0)
-        {
-            _appender.reset(new UdpAppender(config.impl()->loghost(), config.impl()->logport(), config.impl()->broadcast()));
-        }
-        else
-        {
-            _appender.reset(new FdAppender(config.impl()->tostdout() ? STDOUT_FILENO : STDERR_FILENO));
-        }
-    }
-    else if (config.impl()->maxfilesize() == 0)
+    // In a forked child the writer thread does not exist and the counts
+    // of the threads of the parent are left over.
+    if (AsyncLogWriter::forked())
+        return;
+
+    // Without asynchronous logging there is nothing to protect. Skipping the
+    // registration keeps the synchronous path free of writes to the shared
+    // counters.
+    if (_impl._asyncWriter.load(std::memory_order_acquire) == 0)
+        return;
+
+    while (true)
     {
-        _appender.reset(new FileAppender(config.impl()->fname()));
+        _phase = _impl._writerPhase.load();
+        _impl._writerUsers[_phase].fetch_add(1);
+
+        // When the phase was switched meanwhile, releaseAsyncWriter may
+        // already have seen the old count, so we retry.
+        if (_impl._writerPhase.load() == _phase)
+            break;
+
+        release();
     }
-    else
+
+    _writer = _impl._asyncWriter.load(std::memory_order_acquire);
+    if (!_writer)
+        release();
+}
+
+LogManager::Impl::AsyncWriterRef::~AsyncWriterRef()
+{
+    if (_writer)
+        release();
+}
+
+void LogManager::Impl::AsyncWriterRef::release()
+{
+    if (_impl._writerUsers[_phase].fetch_sub(1) == 1 && _impl._writerPhase.load() != _phase)
     {
-        _appender.reset(new RollingFileAppender(config.impl()->fname(), config.impl()->maxfilesize(), config.impl()->maxbackupindex(), config.impl()->logFormat()));
+        std::lock_guard<std::mutex> lock(_impl._writerUsersMutex);
+        _impl._writerUsersFinished.notify_all();
     }
+}
+
+LogManager::Impl::Impl(const LogConfiguration& config)
+  : _asyncWriter(0),
+    _writerPhase(0)
+{
+    _writerUsers[0] = 0;
+    _writerUsers[1] = 0;
+
+    createAppender(config);
 
     _config = config;
+
+    if (config.async())
+        _asyncWriter = new AsyncLogWriter(*_appender, config.asyncBufferSize(), config.asyncOverflow(), config.impl()->logFormat());
 }
 
-void LogManager::Impl::configure(const LogConfiguration& config)
+void LogManager::Impl::createAppender(const LogConfiguration& config)
 {
-    if (config.rootFlags() == 0)
-        return;
-
     if (config.impl()->fname().empty())
     {
         if (config.impl()->logport() != 0)
@@ -1246,15 +1717,65 @@ void LogManager::Impl::configure(const LogConfiguration& config)
     {
         _appender.reset(new RollingFileAppender(config.impl()->fname(), config.impl()->maxfilesize(), config.impl()->maxbackupindex(), config.impl()->logFormat()));
     }
+}
+
+// Removes the writer, after all messages passed to it are written to the
+// current appender.
+void LogManager::Impl::releaseAsyncWriter()
+{
+    AsyncLogWriter* writer = _asyncWriter.exchange(0);
+
+    if (AsyncLogWriter::forked())
+    {
+        // The writer thread does not exist in the forked child and the
+        // state of the writer is unknown, so it is abandoned. Threads of
+        // the child did not use it.
+        _writerUsers[0] = 0;
+        _writerUsers[1] = 0;
+        AsyncLogWriter::clearForked();
+        return;
+    }
+
+    if (!writer)
+        return;
+
+    unsigned phase = _writerPhase.load();
+    _writerPhase.store(phase ^ 1);
+
+    {
+        std::unique_lock<std::mutex> lock(_writerUsersMutex);
+        while (_writerUsers[phase].load() > 0)
+            _writerUsersFinished.wait(lock);
+    }
+
+    // nobody puts messages into the rings any more, so stop drains them
+    writer->stop();
+    delete writer;
+}
+
+void LogManager::Impl::configure(const LogConfiguration& config)
+{
+    if (config.rootFlags() == 0)
+        return;
+
+    releaseAsyncWriter();
+
+    createAppender(config);
 
     _config = config;
 
+    if (config.async())
+        _asyncWriter.store(new AsyncLogWriter(*_appender, config.asyncBufferSize(), config.asyncOverflow(), config.impl()->logFormat()),
+            std::memory_order_release);
+
     for (Loggers::iterator it = _loggers.begin(); it != _loggers.end(); ++it)
         it->second->setLogFlags(logFlags(it->second->getCategory()));
 }
 
 LogManager::Impl::~Impl()
 {
+    releaseAsyncWriter();
+
     for (Loggers::iterator it = _loggers.begin(); it != _loggers.end(); ++it)
         delete it->second;
 }
@@ -1377,8 +1898,8 @@ void LogManager::configure(const LogConfiguration& config)
 {
     std::lock_guard<std::mutex> lock(logMutex);
 
-    _enabled = false;
-
+    // Logging stays enabled on reconfiguration. Messages logged meanwhile
+    // wait for logMutex and are written with the new configuration.
     if (_impl == 0)
         _impl = new Impl(config);
     else
@@ -1504,6 +2025,19 @@ void LogMessage::Impl::finish()
         if (!LogManager::isEnabled())
             return;
 
+        {
+            LogManager::Impl::AsyncWriterRef asyncWriter(*LogManager::getInstance().impl());
+            if (asyncWriter.get())
+            {
+                logentry(_buffer, _level, _logger->getCategory(), _logger->logFormat());
+                _buffer += _msg.str();
+                asyncWriter.get()->putMessage(_buffer, strcmp(_level, "FATAL") == 0);
+                _buffer.clear();
+                clear();
+                return;
+            }
+        }
+
         ScopedAtomicIncrementer inc(mutexWaitCount);
         std::lock_guard<std::mutex> lock(logMutex);
 
@@ -1609,6 +2143,19 @@ void LogTracer::Impl::putmessage(const char* state) const
         if (!LogManager::isEnabled())
             return;
 
+        {
+            LogManager::Impl::AsyncWriterRef asyncWriter(*LogManager::getInstance().impl());
+            if (asyncWriter.get())
+            {
+                std::string msg;
+                logentry(msg, "TRACE", _logger->getCategory(), _logger->logFormat());
+                msg += state;
+                msg += _msg.str();
+                asyncWriter.get()->putMessage(msg, false);
+                return;
+            }
+        }
+
         ScopedAtomicIncrementer inc(mutexWaitCount);
         std::lock_guard<std::mutex> lock(logMutex);
 
@@ -0,0 +1,389 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "resolver.h"
+#include "addrinfoimpl.h"
+#include "error.h"
+#include <cxxtools/net/addrinfo.h>
+#include <cxxtools/systemerror.h>
+#include <cxxtools/clock.h>
+#include <cxxtools/log.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <sstream>
+#include <thread>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+log_define("cxxtools.net.resolver")
+
+namespace cxxtools
+{
+
+namespace net
+{
+
+namespace
+{
+    const unsigned maxCacheSize = 1024;
+
+    struct CacheEntry
+    {
+        std::shared_ptr<struct addrinfo> list;
+        int error;
+        Timespan expires;
+    };
+
+    struct ResolverState
+    {
+        std::mutex mutex;
+
+        std::map<std::string, CacheEntry> cache;
+        Timespan ttl;
+        Timespan negativeTtl;
+
+        std::condition_variable jobReady;
+        std::deque<std::shared_ptr<ResolverJob> > jobs;
+        unsigned threads;
+        unsigned idleThreads;
+
+        ResolverState()
+            : ttl(Seconds(60)),
+              negativeTtl(Seconds(10)),
+              threads(0),
+              idleThreads(0)
+            { }
+    };
+
+    // The state is never destroyed since detached resolver threads may still
+    // access it while static objects are destroyed.
+    ResolverState& state()
+    {
+        static ResolverState* s = new ResolverState();
+        return *s;
+    }
+
+    std::string cacheKey(const std::string& host, unsigned short port, const struct addrinfo& hints)
+    {
+        std::ostringstream key;
+        key << host << '\0' << port
+            << ':' << hints.ai_family
+            << ':' << hints.ai_socktype
+            << ':' << hints.ai_protocol
+            << ':' << hints.ai_flags;
+        return key.str();
+    }
+
+    // Only definite answers are cached. Temporary and system errors are
+    // retried on the next lookup.
+    bool isPermanentError(int ret)
+    {
+        return ret == EAI_NONAME
+            || ret == EAI_FAIL
+#ifdef EAI_NODATA
+            || ret == EAI_NODATA
+#endif
+            ;
+    }
+
+    void store(const std::string& key, const std::shared_ptr<struct addrinfo>& list, int error)
+    {
+        ResolverState& s = state();
+
+        std::lock_guard<std::mutex> lock(s.mutex);
+
+        Timespan ttl = list ? s.ttl : s.negativeTtl;
+        if (ttl <= Timespan(0))
+            return;
+
+        Timespan now = Clock::getSystemTicks();
+
+        if (s.cache.size() >= maxCacheSize)
+        {
+            for (auto it = s.cache.begin(); it != s.cache.end(); )
+            {
+                if (it->second.expires <= now)
+                    it = s.cache.erase(it);
+                else
+                    ++it;
+            }
+
+            if (s.cache.size() >= maxCacheSize)
+            {
+                log_debug("address cache full; clear");
+                s.cache.clear();
+            }
+        }
+
+        CacheEntry& entry = s.cache[key];
+        entry.list = list;
+        entry.error = error;
+        entry.expires = now + ttl;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////
+// ResolverJob
+//
+ResolverJob::ResolverJob(const std::string& host, unsigned short port, const struct addrinfo& hints)
+    : _host(host),
+      _port(port),
+      _hints(hints),
+      _finished(false)
+{
+    if (::pipe(_fds) != 0)
+        throw SystemError("pipe");
+
+    for (unsigned n = 0; n < 2; ++n)
+    {
+        ::fcntl(_fds[n], F_SETFL, ::fcntl(_fds[n], F_GETFL) | O_NONBLOCK);
+        ::fcntl(_fds[n], F_SETFD, FD_CLOEXEC);
+    }
+}
+
+ResolverJob::~ResolverJob()
+{
+    ::close(_fds[0]);
+    ::close(_fds[1]);
+}
+
+void ResolverJob::finish(const std::shared_ptr<struct addrinfo>& result, std::exception_ptr error)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _result = result;
+        _error = error;
+        _finished = true;
+    }
+
+    log_debug("lookup of " << _host << ':' << _port << " finished");
+
+    char ch = 'R';
+    while (::write(_fds[1], &ch, 1) < 0 && errno == EINTR)
+        ;
+}
+
+bool ResolverJob::finished() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _finished;
+}
+
+std::shared_ptr<struct addrinfo> ResolverJob::result() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_error)
+        std::rethrow_exception(_error);
+    return _result;
+}
+
+////////////////////////////////////////////////////////////////////////
+// Resolver
+//
+std::shared_ptr<struct addrinfo> Resolver::lookup(const std::string& host, unsigned short port,
+    const struct addrinfo& hints)
+{
+    std::shared_ptr<struct addrinfo> result;
+    if (lookupCached(host, port, hints, result))
+        return result;
+
+    log_debug("getaddrinfo(\"" << host << "\", " << port << ')');
+
+    std::ostringstream p;
+    p << port;
+
+    struct addrinfo* ai = 0;
+    int ret;
+    do
+    {
+        ret = ::getaddrinfo(host.empty() ? 0 : host.c_str(), p.str().c_str(), &hints, &ai);
+    } while (ret == EAI_AGAIN);
+
+    if (ret != 0)
+    {
+        AddrInfoError error(ret, host, port);
+        if (isPermanentError(ret))
+            store(cacheKey(host, port, hints), result, ret);
+        throw error;
+    }
+
+    if (ai == 0)
+        throw SystemError("getaddrinfo");
+
+    result.reset(ai, ::freeaddrinfo);
+    store(cacheKey(host, port, hints), result, 0);
+
+    return result;
+}
+
+bool Resolver::lookupCached(const std::string& host, unsigned short port,
+    const struct addrinfo& hints, std::shared_ptr<struct addrinfo>& result)
+{
+    ResolverState& s = state();
+    std::string key = cacheKey(host, port, hints);
+
+    int error;
+
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+
+        auto it = s.cache.find(key);
+        if (it == s.cache.end())
+            return false;
+
+        if (it->second.expires <= Clock::getSystemTicks())
+        {
+            s.cache.erase(it);
+            return false;
+        }
+
+        if (it->second.list)
+        {
+            result = it->second.list;
+            return true;
+        }
+
+        error = it->second.error;
+    }
+
+    log_debug("cached failure for " << host << ':' << port);
+    throw AddrInfoError(error, host, port);
+}
+
+void Resolver::worker()
+{
+    ResolverState& s = state();
+
+    log_debug("resolver thread started");
+
+    std::unique_lock<std::mutex> lock(s.mutex);
+    while (true)
+    {
+        while (s.jobs.empty())
+        {
+            ++s.idleThreads;
+            std::cv_status status = s.jobReady.wait_for(lock, std::chrono::seconds(10));
+            --s.idleThreads;
+
+            if (status == std::cv_status::timeout && s.jobs.empty())
+            {
+                --s.threads;
+                log_debug("resolver thread terminated");
+                return;
+            }
+        }
+
+        std::shared_ptr<ResolverJob> job = s.jobs.front();
+        s.jobs.pop_front();
+
+        lock.unlock();
+
+        std::shared_ptr<struct addrinfo> result;
+        std::exception_ptr error;
+        try
+        {
+            result = Resolver::lookup(job->_host, job->_port, job->_hints);
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+
+        job->finish(result, error);
+        job.reset();
+
+        lock.lock();
+    }
+}
+
+std::shared_ptr<ResolverJob> Resolver::resolve(const AddrInfoImpl& addrInfo)
+{
+    std::shared_ptr<ResolverJob> job(new ResolverJob(addrInfo.host(), addrInfo.port(), addrInfo.hints()));
+
+    ResolverState& s = state();
+
+    std::lock_guard<std::mutex> lock(s.mutex);
+
+    s.jobs.push_back(job);
+
+    if (s.idleThreads == 0 && s.threads < maxThreads)
+    {
+        std::thread(worker).detach();
+        ++s.threads;
+    }
+    else
+    {
+        s.jobReady.notify_one();
+    }
+
+    return job;
+}
+
+void Resolver::cacheTtl(Timespan ttl)
+{
+    ResolverState& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.ttl = ttl;
+}
+
+Timespan Resolver::cacheTtl()
+{
+    ResolverState& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    return s.ttl;
+}
+
+void Resolver::negativeCacheTtl(Timespan ttl)
+{
+    ResolverState& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.negativeTtl = ttl;
+}
+
+Timespan Resolver::negativeCacheTtl()
+{
+    ResolverState& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    return s.negativeTtl;
+}
+
+void Resolver::clearCache()
+{
+    ResolverState& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.cache.clear();
+}
+
+} // namespace net
+
+} // namespace cxxtools
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_NET_RESOLVER_H
+#define CXXTOOLS_NET_RESOLVER_H
+
+#include <cxxtools/timespan.h>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <netdb.h>
+
+namespace cxxtools
+{
+
+namespace net
+{
+
+class AddrInfoImpl;
+
+/// A single asynchronous name lookup.
+///
+/// The job is processed by the resolver threads. When finished, a byte is
+/// written to a pipe, so that the file descriptor returned by fd() can be
+/// polled in a selector.
+class ResolverJob
+{
+        friend class Resolver;
+
+        ResolverJob(const ResolverJob&) = delete;
+        ResolverJob& operator=(const ResolverJob&) = delete;
+
+        std::string _host;
+        unsigned short _port;
+        struct addrinfo _hints;
+
+        int _fds[2];
+
+        mutable std::mutex _mutex;
+        bool _finished;
+        std::shared_ptr<struct addrinfo> _result;
+        std::exception_ptr _error;
+
+        void finish(const std::shared_ptr<struct addrinfo>& result, std::exception_ptr error);
+
+    public:
+        ResolverJob(const std::string& host, unsigned short port, const struct addrinfo& hints);
+        ~ResolverJob();
+
+        /// Returns the file descriptor, which gets readable when the job is finished.
+        int fd() const    { return _fds[0]; }
+
+        bool finished() const;
+
+        /// Returns the resolved address list or throws the error of the lookup.
+        std::shared_ptr<struct addrinfo> result() const;
+};
+
+/// Process wide name resolution with a cache.
+///
+/// Successful lookups are cached for cacheTtl and failed lookups for
+/// negativeCacheTtl. Asynchronous lookups are done in a small pool of
+/// threads, which are started on demand and terminate when idle.
+class Resolver
+{
+        static void worker();
+
+    public:
+        static const unsigned maxThreads = 4;
+
+        /// Resolves the address using the cache; blocks when not found there.
+        static std::shared_ptr<struct addrinfo> lookup(const std::string& host, unsigned short port,
+            const struct addrinfo& hints);
+
+        /// Looks up the cache only. Returns true and sets result when found.
+        /// A cached failure is thrown as AddrInfoError.
+        static bool lookupCached(const std::string& host, unsigned short port,
+            const struct addrinfo& hints, std::shared_ptr<struct addrinfo>& result);
+
+        /// Starts a asynchronous lookup.
+        static std::shared_ptr<ResolverJob> resolve(const AddrInfoImpl& addrInfo);
+
+        static void cacheTtl(Timespan ttl);
+        static Timespan cacheTtl();
+
+        static void negativeCacheTtl(Timespan ttl);
+        static Timespan negativeCacheTtl();
+
+        static void clearCache();
+};
+
+} // namespace net
+
+} // namespace cxxtools
+
+#endif // CXXTOOLS_NET_RESOLVER_H
@@ -41,8 +41,29 @@ class Timespan;
 class SelectableImpl
 {
 public:
+    /** @internal Interface for selectors, which keep a copy of the poll
+        events outside the pollfd structures (e.g. in a epoll set).
+
+        The implementation notifies the listener, whenever it modifies the
+        events in the pollfd structures passed to initializePoll.
+     */
+    class PollListener
+    {
+    public:
+        virtual ~PollListener() = default;
+
+        virtual void onPollChanged(SelectableImpl& s) = 0;
+    };
+
+    SelectableImpl()
+        : _pollListener(0)
+        { }
+
     virtual ~SelectableImpl() = default;
 
+    void setPollListener(PollListener* listener)
+    { _pollListener = listener; }
+
     virtual void close() = 0;
 
     virtual bool wait(Timespan timeout)= 0;
@@ -52,6 +73,16 @@ public:
     virtual std::size_t initializePoll(pollfd* pfd, std::size_t pollSize) = 0;
 
     virtual bool checkPollEvent() = 0;
+
+protected:
+    void pollChanged()
+    {
+        if (_pollListener)
+            _pollListener->onPollChanged(*this);
+    }
+
+private:
+    PollListener* _pollListener;
 };
 
 } //namespace cxxtools
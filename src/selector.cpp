@@ -24,6 +24,7 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
 #include "selectorimpl.h"
+#include "timerwheel.h"
 #include "cxxtools/selector.h"
 #include "cxxtools/timer.h"
 #include "cxxtools/timespan.h"
@@ -37,11 +38,10 @@ const int SelectorBase::WaitInfinite;
 
 SelectorBase::~SelectorBase()
 {
-    while( _timers.size() )
-    {
-       Timer* timer = _timers.begin()->second;
+    while (Timer* timer = _timerWheel->any())
        timer->setSelector(0);
-    }
+
+    delete _timerWheel;
 }
 
 
@@ -74,75 +74,57 @@ void SelectorBase::remove( Timer& timer )
 void SelectorBase::onAddTimer(Timer& timer)
 {
     if( timer.active() )
-    {
-        TimerMap::value_type elem(timer.finished(), &timer);
-        _timers.insert(elem);
-        //_timers.insert( std::make_pair(timer.finished(), &timer) );
-    }
+        _timerWheel->add(timer);
 }
 
 
 void SelectorBase::onRemoveTimer( Timer& timer )
 {
-    std::multimap<Timespan, Timer*>::iterator it;
-    for(it = _timers.begin(); it != _timers.end(); ++it)
-    {
-        if(it->second == &timer)
-        {
-            _timers.erase(it);
-            return;
-        }
-    }
+    _timerWheel->remove(timer);
 }
 
 
 void SelectorBase::onTimerChanged(Timer& timer)
 {
+    _timerWheel->remove(timer);
+
     if( timer.active() )
-    {
-        TimerMap::value_type elem(timer.finished(), &timer);
-        _timers.insert(elem);
-        //_timers.insert( std::make_pair(timer.finished(), &timer) );
-    }
-    else
-    {
-        SelectorBase::onRemoveTimer(timer);
-    }
+        _timerWheel->add(timer);
 }
 
 
 bool SelectorBase::updateTimer(Timespan& lowestTimeout)
 {
-    if( _timers.empty() )
+    lowestTimeout = Timespan(Selector::WaitInfinite);
+
+    if( _timerWheel->empty() )
         return false;
 
     Timespan now = Timespan::gettimeofday();
-    Timer* timer = _timers.begin()->second;
-    bool timerActive = now >= timer->finished();
+    _timerWheel->advance(now);
 
-    while( ! _timers.empty() )
-    {
-        timer = _timers.begin()->second;
+    bool timerActive = false;
 
-        if ( now < timer->finished() )
-        {
-            lowestTimeout = timer->finished();
-            log_debug("lowestTimeout => " << lowestTimeout);
-            break;
-        }
+    while (Timer* timer = _timerWheel->due())
+    {
+        timerActive = true;
 
         timer->update(now);
 
-        if( ! _timers.empty() )
+        // The timer may have been stopped, restarted or destroyed by the
+        // signal handlers. Otherwise it is still the first due timer and is
+        // put back to the wheel with its next interval.
+        if (_timerWheel->due() == timer)
         {
-            timer = _timers.begin()->second;
-            _timers.erase( _timers.begin() );
-            TimerMap::value_type elem(timer->finished(), timer);
-            _timers.insert(elem);
-            //_timers.insert( std::make_pair(timer->finished(), timer) );
+            _timerWheel->remove(*timer);
+            if (timer->active())
+                _timerWheel->add(*timer);
         }
     }
 
+    lowestTimeout = _timerWheel->next();
+    log_debug("lowestTimeout => " << lowestTimeout);
+
     return timerActive;
 }
 
@@ -187,6 +169,11 @@ bool SelectorBase::waitUntil(Timespan t)
 
         if (updateTimer(timerTimeout))
             return true;
+
+        // The wheel may wake us up early to redistribute timers or the
+        // timer may have been stopped in the meantime.
+        if (timerTimeout < Timespan(0) || (t >= Timespan(0) && t < timerTimeout))
+            return onWaitUntil(t);
     }
 }
 
@@ -217,14 +204,27 @@ void SelectorBase::wake()
 }
 
 
+void SelectorBase::timerResolution(Milliseconds r)
+{
+    _timerWheel->resolution(r);
+}
+
+
+Milliseconds SelectorBase::timerResolution() const
+{
+    return _timerWheel->resolution();
+}
+
+
 SelectorBase::SelectorBase()
+    : _timerWheel(new TimerWheel())
 {}
 
 
 Selector::Selector()
 : _impl( 0 )
 {
-    _impl = new SelectorImpl();
+    _impl = SelectorImpl::create();
 }
 
 
@@ -252,8 +252,9 @@ void Selector::onChanged(Selectable& s)
 }
 
 
-void Selector::onReinit(Selectable& /*s*/)
+void Selector::onReinit(Selectable& s)
 {
+    _impl->reinit(s);
 }
 
 
@@ -26,21 +26,24 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+
 #include "selectorimpl.h"
-#include "selectableimpl.h"
+#include "pollselectorimpl.h"
 #include "cxxtools/ioerror.h"
 #include "cxxtools/systemerror.h"
-#include "cxxtools/selector.h"
 #include "cxxtools/log.h"
 #include <cerrno>
+#include <cstdlib>
+#include <cstring>
 #include <unistd.h>
 #include <fcntl.h>
-#include <cassert>
-#include <iostream>
-#include <limits>
 #include "config.h"
 #include "poll.h"
 
+#ifdef HAVE_SYS_EPOLL_H
+#include "epollselectorimpl.h"
+#endif
+
 log_define("cxxtools.selector.impl")
 
 namespace cxxtools
@@ -48,11 +51,40 @@ namespace cxxtools
 
 const short SelectorImpl::POLL_ERROR_MASK= POLLERR | POLLHUP | POLLNVAL;
 
-SelectorImpl::SelectorImpl()
-: _isDirty(true)
+SelectorImpl* SelectorImpl::create()
 {
-    _current = _devices.end();
+#ifdef HAVE_SYS_EPOLL_H
+#ifdef CXXTOOLS_EPOLL_DEFAULT
+    bool useEpoll = true;
+#else
+    bool useEpoll = false;
+#endif
+
+    const char* backend = ::getenv("CXXTOOLS_SELECTOR");
+    if (backend)
+    {
+        if (std::strcmp(backend, "epoll") == 0)
+            useEpoll = true;
+        else if (std::strcmp(backend, "poll") == 0)
+            useEpoll = false;
+        else
+            log_warn("unknown selector backend \"" << backend << "\" in CXXTOOLS_SELECTOR");
+    }
 
+    if (useEpoll)
+    {
+        log_debug("create epoll selector");
+        return new EpollSelectorImpl();
+    }
+#endif
+
+    log_debug("create poll selector");
+    return new PollSelectorImpl();
+}
+
+
+SelectorImpl::SelectorImpl()
+{
     //Open a pipe to send wake up message.
     if( ::pipe( _wakePipe ) )
         throwSystemError("pipe");
@@ -78,13 +110,6 @@ SelectorImpl::SelectorImpl()
 
 SelectorImpl::~SelectorImpl()
 {
-    std::set<Selectable*>::iterator it;
-    while( _devices.size() )
-    {
-        it = _devices.begin();
-        (*it)->setSelector(0);
-    }
-
     if( _wakePipe[0] != -1 && _wakePipe[1] != -1 )
     {
         ::close(_wakePipe[0]);
@@ -93,36 +118,6 @@ SelectorImpl::~SelectorImpl()
 }
 
 
-void SelectorImpl::add(Selectable& dev)
-{
-    _devices.insert(&dev);
-    _isDirty = true;
-}
-
-
-void SelectorImpl::remove(Selectable& dev)
-{
-   std::set<Selectable*>::iterator it = _devices.find( &dev );
-   if( it == _devices.end() )
-        return;
-
-    if (_current == _devices.end())
-    {
-        _devices.erase(it);
-    }
-    else if (*_current == *it)
-    {
-        _devices.erase(_current++);
-    }
-    else
-    {
-        _devices.erase(it);
-    }
-
-    _isDirty = true;
-}
-
-
 void SelectorImpl::changed( Selectable& s )
 {
     if( s.avail() )
@@ -136,164 +131,42 @@ void SelectorImpl::changed( Selectable& s )
 }
 
 
-bool SelectorImpl::waitUntil(Timespan until)
+void SelectorImpl::reinit( Selectable& /*s*/ )
 {
-    if (!_avail.empty())
-        until = Timespan(0);
-
-    if (_isDirty)
-    {
-        _pollfds.clear();
-
-        // recalculate size
-        size_t pollSize= 1;
-
-        std::set<Selectable*>::iterator iter;
-        for( iter= _devices.begin(); iter != _devices.end(); ++iter)
-        {
-            if( (*iter)->enabled() )
-                pollSize+= (*iter)->simpl().pollSize();
-        }
-
-        pollfd pfd;
-        pfd.fd = -1;
-        pfd.events = 0;
-        pfd.revents = 0;
-
-        _pollfds.assign(pollSize, pfd);
-
-        // add entries
-        pollfd* pCurr= &_pollfds[0];
-
-        // insert event pipe
-        pCurr->fd = _wakePipe[0];
-        pCurr->events = POLLIN;
-
-        ++pCurr;
-
-        for( iter= _devices.begin(); iter != _devices.end(); ++iter)
-        {
-            if( (*iter)->enabled() )
-            {
-                const size_t availableSpace= &_pollfds.back() - pCurr + 1;
-                size_t required = (*iter)->simpl().pollSize();
-                assert( required <= availableSpace);
-                pCurr+= (*iter)->simpl().initializePoll( pCurr, required);
-            }
-        }
+}
 
-        _isDirty= false;
-    }
 
-#ifdef HAVE_PPOLL
-    struct timespec pollTimeout = { 0, 0 };
-    struct timespec* pollTimeoutP = 0;
-    if (until >= Timespan(0))
-        pollTimeoutP = &pollTimeout;
-#else
-    int pollTimeout = until == Timespan(0) ? 0 : -1;
-#endif
+bool SelectorImpl::readWakePipe(short revents)
+{
+    if (revents == 0)
+        return false;
 
-    int ret = -1;
-    while (true)
+    if ( revents & POLL_ERROR_MASK)
     {
-        if (until > Timespan(0))
-        {
-            Timespan remaining = until - Timespan::gettimeofday();
-            if (remaining < Timespan(0))
-                remaining = Timespan(0);
-
-#ifdef HAVE_PPOLL
-            pollTimeout.tv_sec = remaining.totalUSecs() / 1000000;
-            pollTimeout.tv_nsec = (remaining.totalUSecs() % 1000000) * 1000;
-#else
-            if (Milliseconds(remaining) >= std::numeric_limits<int>::max())
-                pollTimeout = std::numeric_limits<int>::max();
-            else
-                pollTimeout = Milliseconds(remaining).ceil();
-#endif
-
-            log_debug("remaining " << remaining);
-        }
-        else
-            log_debug("no timeout");
-
-#ifdef HAVE_PPOLL
-        log_debug("ppoll with " << _pollfds.size() << " fds, timeout=" << pollTimeout.tv_sec << "s " << pollTimeout.tv_nsec << "ns");
-        ret = ::ppoll(&_pollfds[0], _pollfds.size(), pollTimeoutP, 0);
-        log_debug("ppoll returns " << ret);
-#else
-        log_debug("poll with " << _pollfds.size() << " fds, timeout=" << pollTimeout << "ms");
-        ret = ::poll(&_pollfds[0], _pollfds.size(), pollTimeout);
-        log_debug("poll returns " << ret);
-#endif
-        if( ret != -1 )
-            break;
-
-        if( errno != EINTR )
-            throw IOError("Could not poll on file descriptors");
-
+        throw IOError("poll error on event pipe");
     }
 
-    if( ret == 0 && _avail.empty() )
-        return false;
-
     bool avail = false;
-    try
+    static char buffer[1024];
+    while(true)
     {
-        if (_pollfds[0].revents != 0)
+        int ret = ::read(_wakePipe[0], buffer, sizeof(buffer));
+        if(ret > 0)
         {
-
-            if ( _pollfds[0].revents & POLL_ERROR_MASK)
-            {
-                throw IOError("poll error on event pipe");
-            }
-
-            static char buffer[1024];
-            while(true)
-            {
-                int ret = ::read(_wakePipe[0], buffer, sizeof(buffer));
-                if(ret > 0)
-                {
-                    avail = true;
-                    continue;
-                }
-
-                if (ret == -1)
-                {
-                    if(errno == EINTR)
-                        continue;
-
-                    if(errno == EAGAIN)
-                        break;
-                }
-
-                throw IOError("Could not read from pipe");
-            }
+            avail = true;
+            continue;
         }
 
-        for( _current = _devices.begin(); _current != _devices.end(); )
+        if (ret == -1)
         {
-            Selectable* dev = *_current;
-
-            if ( dev->enabled() && dev->simpl().checkPollEvent() )
-            {
-                avail = true;
-            }
-
-            if (_current != _devices.end())
-            {
-                if (*_current == dev)
-                {
-                    ++_current;
-                }
-            }
+            if(errno == EINTR)
+                continue;
+
+            if(errno == EAGAIN)
+                break;
         }
-    }
-    catch (...)
-    {
-        _current = _devices.end();
-        throw;
+
+        throw IOError("Could not read from pipe");
     }
 
     return avail;
@@ -26,45 +26,53 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+
 #ifndef CXXTOOLS_SYSTEM_POSIX_SELECTORIMPL_H
 #define CXXTOOLS_SYSTEM_POSIX_SELECTORIMPL_H
 
 #include <cxxtools/selectable.h>
 #include <cxxtools/timespan.h>
-#include <cxxtools/clock.h>
-#include <sys/poll.h>
-#include <vector>
 #include <set>
 
 namespace cxxtools {
 
+/** @internal Base class of the backends used by Selector and EventLoop
+
+    The backend is chosen in create(). By default the poll based backend is
+    used. When cxxtools is configured with --enable-epoll, epoll is the
+    default on Linux. The environment variable CXXTOOLS_SELECTOR may be set
+    to "poll" or "epoll" to override the default at runtime.
+ */
 class SelectorImpl
 {
     public:
-        SelectorImpl();
+        static SelectorImpl* create();
 
-        ~SelectorImpl();
+        virtual ~SelectorImpl();
 
-        void add( Selectable& dev );
+        virtual void add( Selectable& dev ) = 0;
 
-        void remove( Selectable& dev );
+        virtual void remove( Selectable& dev ) = 0;
 
-        void changed( Selectable& dev );
+        virtual void changed( Selectable& dev );
 
-        bool waitUntil(Timespan timeout);
+        virtual void reinit( Selectable& dev );
+
+        virtual bool waitUntil(Timespan timeout) = 0;
 
         void wake();
 
-    private:
+    protected:
+        SelectorImpl();
+
+        /// Reads all pending wake messages; returns true if there were any.
+        bool readWakePipe(short revents);
+
         static const short POLL_ERROR_MASK;
         int _wakePipe[2];
-        bool _isDirty;
-        std::vector<pollfd> _pollfds;
-        std::set<Selectable*>::iterator _current;
-        std::set<Selectable*> _devices;
         std::set<Selectable*> _avail;
 };
 
-}//namespace xpr
+}//namespace cxxtools
 
 #endif
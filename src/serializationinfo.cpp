@@ -34,14 +34,340 @@
 
 #include <stdexcept>
 #include <sstream>
+#include <mutex>
+#include <unordered_set>
 
 log_define("cxxtools.serializationinfo")
 
 namespace cxxtools
 {
 
+namespace
+{
+    // objects with at least that many members are searched using a hash index
+    const std::size_t memberIndexThreshold = 16;
+
+    // counts renames of indexed members; indexes built before are outdated
+    std::atomic<unsigned long> renameGeneration(0);
+
+    // longer names are not interned but owned by the node
+    const std::string::size_type maxInternedLength = 64;
+
+    // limits the memory used by interned names, which are never released
+    const std::size_t maxInternedNames = 4096;
+
+    // released member lists kept per thread for reuse
+    const std::size_t maxPooledNodeLists = 64;
+
+    class NameTable
+    {
+            std::mutex _mutex;
+            std::unordered_set<std::string> _names;
+            std::atomic<bool> _full;
+
+            // recently interned names of the thread by hash
+            static const unsigned cacheSize = 256;
+            static thread_local const std::string* _cache[cacheSize];
+
+        public:
+            NameTable()
+                : _full(false)
+            { }
+
+            // returns 0, when the name is not interned
+            const std::string* intern(const std::string& name);
+    };
+
+    thread_local const std::string* NameTable::_cache[NameTable::cacheSize];
+
+    const std::string* NameTable::intern(const std::string& name)
+    {
+        if (name.size() > maxInternedLength)
+            return 0;
+
+        const std::string*& cached = _cache[std::hash<std::string>()(name) % cacheSize];
+        if (cached && *cached == name)
+            return cached;
+
+        if (_full.load(std::memory_order_relaxed))
+            return 0;
+
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        std::unordered_set<std::string>::const_iterator it = _names.find(name);
+        if (it == _names.end())
+        {
+            if (_names.size() >= maxInternedNames)
+            {
+                _full.store(true, std::memory_order_relaxed);
+                return 0;
+            }
+
+            it = _names.insert(name).first;
+        }
+
+        cached = &*it;
+        return cached;
+    }
+
+    NameTable& nameTable()
+    {
+        // never destroyed, since static nodes may still use the names at exit
+        static NameTable* table = new NameTable();
+        return *table;
+    }
+}
+
+const std::string& SerializationInfo::Name::emptyName()
+{
+    static const std::string empty;
+    return empty;
+}
+
+SerializationInfo::Name::Name(const Name& name)
+    : _p(name._p)
+{
+    if (owned())
+        _p = reinterpret_cast<std::uintptr_t>(new std::string(*name.ptr())) | 1;
+}
+
+SerializationInfo::Name& SerializationInfo::Name::operator=(const Name& name)
+{
+    if (this != &name)
+    {
+        Name n(name);
+        swap(n);
+    }
+
+    return *this;
+}
+
+SerializationInfo::Name& SerializationInfo::Name::operator=(Name&& name) noexcept
+{
+    if (this != &name)
+    {
+        clear();
+        _p = name._p;
+        name._p = 0;
+    }
+
+    return *this;
+}
+
+SerializationInfo::Name& SerializationInfo::Name::operator=(const std::string& name)
+{
+    std::uintptr_t p = 0;
+    if (!name.empty())
+    {
+        const std::string* interned = nameTable().intern(name);
+        if (interned)
+            p = reinterpret_cast<std::uintptr_t>(interned);
+        else
+            p = reinterpret_cast<std::uintptr_t>(new std::string(name)) | 1;
+    }
+
+    // the name may be the old value itself, so it is released last
+    clear();
+    _p = p;
+    return *this;
+}
+
+SerializationInfo::Name& SerializationInfo::Name::operator=(std::string&& name)
+{
+    std::uintptr_t p = 0;
+    if (!name.empty())
+    {
+        const std::string* interned = nameTable().intern(name);
+        if (interned)
+            p = reinterpret_cast<std::uintptr_t>(interned);
+        else
+            p = reinterpret_cast<std::uintptr_t>(new std::string(std::move(name))) | 1;
+    }
+
+    clear();
+    _p = p;
+    return *this;
+}
+
+// Released member lists of the thread. The lists are cleared, but keep the
+// memory of the first block of nodes.
+class SerializationInfo::NodePool
+{
+        std::vector<NodeList*> _free;
+
+    public:
+        // set when the pool of the thread is destroyed; nodes destroyed
+        // later at exit release their lists directly
+        static thread_local bool destroyed;
+
+        NodePool()
+        { _free.reserve(maxPooledNodeLists); }
+
+        ~NodePool()
+        {
+            destroyed = true;
+            for (std::vector<NodeList*>::size_type n = 0; n < _free.size(); ++n)
+                delete _free[n];
+        }
+
+        NodeList* get()
+        {
+            if (_free.empty())
+                return new NodeList();
+
+            NodeList* nodeList = _free.back();
+            _free.pop_back();
+            return nodeList;
+        }
+
+        void put(NodeList* nodeList)
+        {
+            // releases the members, which may put their lists into the pool
+            nodeList->clear();
+
+            if (_free.size() < maxPooledNodeLists)
+                _free.push_back(nodeList);
+            else
+                delete nodeList;
+        }
+
+        static NodePool& instance()
+        {
+            static thread_local NodePool pool;
+            return pool;
+        }
+};
+
+thread_local bool SerializationInfo::NodePool::destroyed = false;
+
+// Open addressing hash table over the member names. For duplicate names
+// only the first member is indexed, so lookups find the first match like
+// the linear search does.
+//
+// The members are marked as indexed. Renaming one of them increments
+// renameGeneration, so that the index is replaced on the next lookup.
+class SerializationInfo::MemberIndex
+{
+        struct Slot
+        {
+            std::size_t hash;
+            Nodes::size_type idx;   // index + 1; 0 marks a empty slot
+        };
+
+        std::vector<Slot> _slots;
+        std::size_t _mask;
+        unsigned long _generation;
+
+    public:
+        // the outdated index replaced by this one; concurrent readers may
+        // still use it, so it is released together with this index
+        MemberIndex* stale;
+
+        MemberIndex(const Nodes& nodes, Nodes::size_type used);
+        ~MemberIndex()
+        { delete stale; }
+
+        bool outdated() const
+        { return _generation != renameGeneration.load(std::memory_order_relaxed); }
+
+        const SerializationInfo* find(const Nodes& nodes, const std::string& name, std::size_t hash) const;
+};
+
+SerializationInfo::MemberIndex::MemberIndex(const Nodes& nodes, Nodes::size_type used)
+    : _generation(renameGeneration.load(std::memory_order_relaxed)),
+      stale(0)
+{
+    std::size_t size = 2;
+    while (size < used * 2)
+        size <<= 1;
+
+    Slot empty = { 0, 0 };
+    _slots.resize(size, empty);
+    _mask = size - 1;
+
+    std::hash<std::string> hasher;
+    for (Nodes::size_type n = 0; n < used; ++n)
+    {
+        nodes[n]._indexed.store(true, std::memory_order_relaxed);
+
+        const std::string& name = nodes[n].name();
+        std::size_t hash = hasher(name);
+
+        std::size_t pos = hash & _mask;
+        while (_slots[pos].idx != 0
+            && !(_slots[pos].hash == hash && nodes[_slots[pos].idx - 1].name() == name))
+            pos = (pos + 1) & _mask;
+
+        if (_slots[pos].idx == 0)
+        {
+            _slots[pos].hash = hash;
+            _slots[pos].idx = n + 1;
+        }
+    }
+}
+
+const SerializationInfo* SerializationInfo::MemberIndex::find(const Nodes& nodes, const std::string& name, std::size_t hash) const
+{
+    for (std::size_t pos = hash & _mask; _slots[pos].idx != 0; pos = (pos + 1) & _mask)
+    {
+        const Slot& slot = _slots[pos];
+        if (slot.hash == hash && nodes[slot.idx - 1].name() == name)
+            return &nodes[slot.idx - 1];
+    }
+
+    return 0;
+}
+
+SerializationInfo::NodeList::~NodeList()
+{
+    delete index.load(std::memory_order_relaxed);
+}
+
+void SerializationInfo::NodeList::dropIndex()
+{
+    if (index.load(std::memory_order_relaxed))
+    {
+        delete index.exchange(0, std::memory_order_relaxed);
+        for (Nodes::size_type n = 0; n < used; ++n)
+            nodes[n]._indexed.store(false, std::memory_order_relaxed);
+    }
+}
+
+void SerializationInfo::NodeList::clear()
+{
+    delete index.exchange(0, std::memory_order_relaxed);
+    nodes.clear();
+    used = 0;
+}
+
+SerializationInfo::NodeList* SerializationInfo::newNodes()
+{
+    if (NodePool::destroyed)
+        return new NodeList();
+
+    return NodePool::instance().get();
+}
+
+void SerializationInfo::releaseNodes(NodeList* nodeList)
+{
+    if (!nodeList)
+        return;
+
+    if (NodePool::destroyed)
+        delete nodeList;
+    else
+        NodePool::instance().put(nodeList);
+}
+
+void SerializationInfo::_renamed()
+{
+    _indexed.store(false, std::memory_order_relaxed);
+    renameGeneration.fetch_add(1, std::memory_order_relaxed);
+}
+
 SerializationInfo::SerializationInfo(const SerializationInfo& si)
 : _category(si._category),
+  _indexed(false),
   _name(si._name),
   _type(si._type),
   _u(si._u),
@@ -61,7 +387,7 @@ SerializationInfo::SerializationInfo(const SerializationInfo& si)
     }
 
     if (si._nodes)
-        _nodes = new Nodes(*si._nodes);
+        _nodes = copyNodes(*si._nodes);
 }
 
 
@@ -71,6 +397,7 @@ SerializationInfo& SerializationInfo::operator=(const SerializationInfo& si)
         return *this;
 
     assignData(si);
+    _unindex();
     _name = si._name;
 
     return *this;
@@ -79,6 +406,7 @@ SerializationInfo& SerializationInfo::operator=(const SerializationInfo& si)
 
 SerializationInfo::SerializationInfo(SerializationInfo&& si) noexcept
     : _category(si._category),
+      _indexed(false),
       _name(std::move(si._name)),
       _type(std::move(si._type)),
       _u(si._u),
@@ -95,15 +423,18 @@ SerializationInfo::SerializationInfo(SerializationInfo&& si) noexcept
     }
 
     si._nodes = 0;
+    si._unindex();
 }
 
 
 SerializationInfo& SerializationInfo::operator=(SerializationInfo&& si)
 {
+    _unindex();
+    si._unindex();
     _category = si._category;
     _name = std::move(si._name);
     _type = std::move(si._type);
-    delete _nodes;
+    releaseNodes(_nodes);
     _nodes = si._nodes;
     si._nodes = 0;
 
@@ -143,7 +474,7 @@ SerializationInfo& SerializationInfo::operator=(SerializationInfo&& si)
 SerializationInfo::~SerializationInfo()
 {
     _releaseValue();
-    delete _nodes;
+    releaseNodes(_nodes);
 }
 
 SerializationInfo& SerializationInfo::addMember(const std::string& name)
@@ -151,8 +482,12 @@ SerializationInfo& SerializationInfo::addMember(const std::string& name)
     log_debug("addMember(\"" << name << "\")");
 
     Nodes& n = nodes();
-    n.push_back(SerializationInfo());
-    n.back().setName(name);
+    _nodes->dropIndex();
+    if (_nodes->used >= n.size())
+        n.push_back(SerializationInfo());
+
+    SerializationInfo& member = n[_nodes->used++];
+    member.setName(name);
 
     // category Array overrides Object
     // This is needed for xmldeserialization. In the xml file the root node of a array
@@ -162,7 +497,7 @@ SerializationInfo& SerializationInfo::addMember(const std::string& name)
     if (_category != Array && _category != Object)
         _category = name.empty() ? Array : Object;
 
-    return n.back();
+    return member;
 }
 
 
@@ -170,11 +505,23 @@ const SerializationInfo& SerializationInfo::getMember(const std::string& name) c
 {
     log_debug("getMember(\"" << name << "\")");
 
-    for (const auto& n: nodes())
-        if (n.name() == name)
-            return n;
+    const SerializationInfo* si = findMember(name);
+    if (si == 0)
+        throw SerializationMemberNotFound(*this, name);
 
-    throw SerializationMemberNotFound(*this, name);
+    return *si;
+}
+
+
+const SerializationInfo& SerializationInfo::getMember(const Key& key) const
+{
+    log_debug("getMember(\"" << key.name() << "\")");
+
+    const SerializationInfo* si = findMember(key.name(), key.hash());
+    if (si == 0)
+        throw SerializationMemberNotFound(*this, key.name());
+
+    return *si;
 }
 
 
@@ -182,12 +529,11 @@ SerializationInfo& SerializationInfo::getMember(const std::string& name)
 {
     log_debug("getMember(\"" << name << "\")");
 
-    if (_nodes)
-        for (auto& n: *_nodes)
-            if (n.name() == name)
-                return n;
+    const SerializationInfo* si = static_cast<const SerializationInfo&>(*this).findMember(name);
+    if (si == 0)
+        throw SerializationMemberNotFound(*this, name);
 
-    throw SerializationMemberNotFound(*this, name);
+    return const_cast<SerializationInfo&>(*si);
 }
 
 
@@ -196,12 +542,12 @@ SerializationInfo& SerializationInfo::getNthMember(const std::string& name, unsi
     log_debug("getNthMember(\"" << name << "\", " << nth << ')');
 
     unsigned n = 0;
-    for (auto& node: nodes())
+    for (auto it = begin(); it != end(); ++it)
     {
-        if (node.name() == name)
+        if (it->name() == name)
         {
             if (n == nth)
-                return node;
+                return *it;
             ++n;
         }
     }
@@ -215,12 +561,12 @@ const SerializationInfo& SerializationInfo::getNthMember(const std::string& name
     log_debug("getNthMember(\"" << name << "\", " << nth << ')');
 
     unsigned n = 0;
-    for (auto& node: nodes())
+    for (auto it = begin(); it != end(); ++it)
     {
-        if (node.name() == name)
+        if (it->name() == name)
         {
             if (n == nth)
-                return node;
+                return *it;
             ++n;
         }
     }
@@ -233,12 +579,10 @@ const SerializationInfo& SerializationInfo::getMember(unsigned idx) const
 {
     log_debug("getMember(" << idx << ')');
 
-    const Nodes& n = nodes();
-
-    if (idx >= n.size())
+    if (idx >= memberCount())
         throw SerializationMemberNotFound(*this, idx);
 
-    return n[idx];
+    return nodes()[idx];
 }
 
 
@@ -249,12 +593,10 @@ SerializationInfo& SerializationInfo::getMember(unsigned idx)
     if (!_nodes)
         throw SerializationMemberNotFound(*this, idx);
 
-    Nodes& n = *_nodes;
-
-    if (idx >= n.size())
+    if (idx >= _nodes->used)
         throw SerializationMemberNotFound(*this, idx);
 
-    return n[idx];
+    return _nodes->nodes[idx];
 }
 
 
@@ -262,9 +604,11 @@ const SerializationInfo* SerializationInfo::findMember(const std::string& name)
 {
     log_debug("findMember(\"" << name << "\")");
 
-    const Nodes& n = nodes();
+    const MemberIndex* index = memberIndex();
+    if (index)
+        return index->find(_nodes->nodes, name, std::hash<std::string>()(name));
 
-    for (Nodes::const_iterator it = n.begin(); it != n.end(); ++it)
+    for (ConstIterator it = begin(); it != end(); ++it)
     {
         if( it->name() == name )
             return &(*it);
@@ -273,50 +617,102 @@ const SerializationInfo* SerializationInfo::findMember(const std::string& name)
     return 0;
 }
 
-size_t SerializationInfo::memberCount(const std::string& name) const
+const SerializationInfo* SerializationInfo::findMember(const Key& key) const
 {
-    log_debug("memberCount(\"" << name << "\"); " << nodes().size() << " nodes");
+    log_debug("findMember(\"" << key.name() << "\")");
 
-    size_t result = 0;
-    for (const auto& n: nodes())
-        if (n.name() == name)
-            ++result;
-    return result;
+    return findMember(key.name(), key.hash());
 }
 
-SerializationInfo* SerializationInfo::findMember(const std::string& name)
+const SerializationInfo* SerializationInfo::findMember(const std::string& name, std::size_t hash) const
 {
-    log_debug("findMember(\"" << name << "\")");
+    const MemberIndex* index = memberIndex();
+    if (index)
+        return index->find(_nodes->nodes, name, hash);
 
-    Nodes& n = nodes();
+    for (ConstIterator it = begin(); it != end(); ++it)
+        if (it->name() == name)
+            return &(*it);
+
+    return 0;
+}
+
+const SerializationInfo::MemberIndex* SerializationInfo::memberIndex() const
+{
+    if (!_nodes || _nodes->used < memberIndexThreshold)
+        return 0;
 
-    for (Nodes::iterator it = n.begin(); it != n.end(); ++it)
+    MemberIndex* index = _nodes->index.load(std::memory_order_acquire);
+    while (index == 0 || index->outdated())
     {
-        if( it->name() == name )
-            return &(*it);
+        // concurrent readers may build the index at the same time; the
+        // first one wins
+        MemberIndex* newIndex = new MemberIndex(_nodes->nodes, _nodes->used);
+        newIndex->stale = index;
+        if (_nodes->index.compare_exchange_strong(index, newIndex, std::memory_order_acq_rel))
+            return newIndex;
+
+        newIndex->stale = 0;
+        delete newIndex;
     }
 
-    return 0;
+    return index;
+}
+
+size_t SerializationInfo::memberCount(const std::string& name) const
+{
+    log_debug("memberCount(\"" << name << "\"); " << memberCount() << " nodes");
+
+    size_t result = 0;
+    for (ConstIterator it = begin(); it != end(); ++it)
+        if (it->name() == name)
+            ++result;
+    return result;
+}
+
+SerializationInfo* SerializationInfo::findMember(const std::string& name)
+{
+    return const_cast<SerializationInfo*>(static_cast<const SerializationInfo&>(*this).findMember(name));
 }
 
 void SerializationInfo::clear()
 {
     _category = Void;
+    _unindex();
     _name.clear();
     _type.clear();
-    delete _nodes;
+    releaseNodes(_nodes);
     _nodes = nullptr;
     _releaseValue();
 }
 
+void SerializationInfo::reset()
+{
+    _category = Void;
+    _unindex();
+    _name.clear();
+    _type.clear();
+    _releaseValue();
+
+    if (_nodes)
+    {
+        _nodes->dropIndex();
+        for (Nodes::size_type n = 0; n < _nodes->used; ++n)
+            _nodes->nodes[n].reset();
+        _nodes->used = 0;
+    }
+}
+
 void SerializationInfo::swap(SerializationInfo& si)
 {
     if (this == &si)
         return;
 
+    _unindex();
+    si._unindex();
     std::swap(_category, si._category);
-    std::swap(_name, si._name);
-    std::swap(_type, si._type);
+    _name.swap(si._name);
+    _type.swap(si._type);
 
     if (_t == t_string)
     {
@@ -595,9 +991,9 @@ SerializationInfo SerializationInfo::path(const std::string& path) const
                 {
                     SerializationInfo ssi;
                     ssi.setTypeName("array");
-                    for (auto& n: parent->nodes())
-                        if (n.name() == memberName)
-                            ssi.addMember() = n;
+                    for (auto it = parent->begin(); it != parent->end(); ++it)
+                        if (it->name() == memberName)
+                            ssi.addMember() = *it;
 
                     ssi.swap(si);
                     log_debug(memberName << "{} => " << si);
@@ -691,7 +1087,7 @@ SerializationInfo SerializationInfo::path(const std::string& path) const
 void SerializationInfo::dump(std::ostream& out, const std::string& prefix) const
 {
     if (!_name.empty())
-        out << prefix << "name = \"" << _name << "\"\n";
+        out << prefix << "name = \"" << _name.str() << "\"\n";
 
     if (_t != t_none)
     {
@@ -724,14 +1120,14 @@ void SerializationInfo::dump(std::ostream& out, const std::string& prefix) const
     }
 
     if (!_type.empty())
-        out << prefix << "typeName = " << _type << '\n';
+        out << prefix << "typeName = " << _type.str() << '\n';
     out << prefix << "category = " << static_cast<unsigned>(_category) << '\n';
 
     const Nodes& n = nodes();
-    if (!n.empty())
+    if (memberCount() > 0)
     {
         std::string p = prefix + '\t';
-        for (Nodes::size_type i = 0; i < n.size(); ++i)
+        for (Nodes::size_type i = 0; i < memberCount(); ++i)
         {
             out << prefix << "node[" << i << "]\n";
             n[i].dump(out, p);
@@ -764,7 +1160,7 @@ void SerializationInfo::setNull()
     _releaseValue();
     _t = t_none;
     _category = Value;
-    delete _nodes;
+    releaseNodes(_nodes);
     _nodes = nullptr;
 }
 
@@ -1049,7 +1445,7 @@ SerializationInfo::int_type SerializationInfo::_getInt(const char* type, int_typ
                             std::ostringstream msg;
                             msg << "value " << ret << " does not fit into " << type;
                             if (!_name.empty())
-                                msg << " in node " << _name;
+                                msg << " in node " << _name.str();
                             throw std::range_error(msg.str());
                         }
                         ret = _u._u; break;
@@ -1063,7 +1459,7 @@ SerializationInfo::int_type SerializationInfo::_getInt(const char* type, int_typ
         std::ostringstream msg;
         msg << "value " << ret << " does not fit into " << type;
         if (!_name.empty())
-            msg << " in node " << _name;
+            msg << " in node " << _name.str();
         throw std::range_error(msg.str());
     }
 
@@ -1115,7 +1511,7 @@ SerializationInfo::unsigned_type SerializationInfo::_getUInt(const char* type, u
         std::ostringstream msg;
         msg << "value " << ret << " does not fit into " << type;
         if (!_name.empty())
-            msg << " in node " << _name;
+            msg << " in node " << _name.str();
         throw std::range_error(msg.str());
     }
 
@@ -1169,7 +1565,7 @@ float SerializationInfo::_getFloat() const
                 std::ostringstream msg;
                 msg << "value " << _u._d << " does not fit into float";
                 if (!_name.empty())
-                    msg << " in node " << _name;
+                    msg << " in node " << _name.str();
                 throw std::range_error(msg.str());
             }
             else
@@ -1189,7 +1585,7 @@ float SerializationInfo::_getFloat() const
                 std::ostringstream msg;
                 msg << "value " << _u._ld << " does not fit into float";
                 if (!_name.empty())
-                    msg << " in node " << _name;
+                    msg << " in node " << _name.str();
                 throw std::range_error(msg.str());
             }
             else
@@ -1248,7 +1644,7 @@ double SerializationInfo::_getDouble() const
                 std::ostringstream msg;
                 msg << "value " << _u._ld << " does not fit into double";
                 if (!_name.empty())
-                    msg << " in node " << _name;
+                    msg << " in node " << _name.str();
                 throw std::range_error(msg.str());
             }
             else
@@ -1301,10 +1697,12 @@ long double SerializationInfo::_getLongDouble() const
 
 SerializationInfo::Nodes& SerializationInfo::nodes()
 {
+    // the index stays valid, since changing the names of members through
+    // the returned nodes is noticed by the members themselves
     if (!_nodes)
-        _nodes = new Nodes;
+        _nodes = newNodes();
 
-    return *_nodes;
+    return _nodes->nodes;
 }
 
 const SerializationInfo::Nodes& SerializationInfo::nodes() const
@@ -1312,20 +1710,29 @@ const SerializationInfo::Nodes& SerializationInfo::nodes() const
     static const Nodes emptyNodes;
 
     if (_nodes)
-        return *_nodes;
+        return _nodes->nodes;
     else
         return emptyNodes;
 }
 
+SerializationInfo::NodeList* SerializationInfo::copyNodes(const NodeList& nodeList)
+{
+    // spare nodes kept for reuse are not copied
+    NodeList* ret = newNodes();
+    ret->nodes.assign(nodeList.nodes.begin(), nodeList.nodes.begin() + nodeList.used);
+    ret->used = nodeList.used;
+    return ret;
+}
+
 void SerializationInfo::assignData(const SerializationInfo& si)
 {
     _category = si._category;
     _type = si._type;
 
-    delete _nodes;
+    releaseNodes(_nodes);
     _nodes = 0;
     if (si._nodes)
-        _nodes = new Nodes(*si._nodes);
+        _nodes = copyNodes(*si._nodes);
 
     if (si._t == t_string)
         _setString( String(si._String()) );
@@ -122,6 +122,34 @@ SslCtx& SslCtx::setCipherServerPreference(bool sw)
     return *this;
 }
 
+SslCtx& SslCtx::setSessionCacheSize(unsigned n)
+{
+    impl()->setSessionCacheSize(n);
+    return *this;
+}
+
+SslCtx& SslCtx::setTicketKeyRotation(Milliseconds interval)
+{
+    impl()->setTicketKeyRotation(interval);
+    return *this;
+}
+
+SslCtx& SslCtx::rotateTicketKey()
+{
+    impl()->rotateTicketKey();
+    return *this;
+}
+
+unsigned long SslCtx::fullHandshakes() const
+{
+    return _impl ? _impl->fullHandshakes() : 0;
+}
+
+unsigned long SslCtx::resumedHandshakes() const
+{
+    return _impl ? _impl->resumedHandshakes() : 0;
+}
+
 SslCtx SslCtx::secure()
 {
     log_debug("SslCtx SslCtx::secure()");
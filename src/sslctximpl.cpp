@@ -29,6 +29,7 @@
 #include "sslctximpl.h"
 #include <cxxtools/systemerror.h>
 #include <cxxtools/fileinfo.h>
+#include <cxxtools/clock.h>
 #include <cxxtools/log.h>
 
 #include <mutex>
@@ -36,6 +37,9 @@
 #include <vector>
 
 #include <openssl/ssl.h>
+#include <openssl/rand.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
 
 #include <cstring>
 #include <stdlib.h>
@@ -43,6 +47,10 @@
 
 #include "config.h"
 
+#ifdef HAVE_SSL_CTX_SET_TLSEXT_TICKET_KEY_EVP_CB
+#include <openssl/core_names.h>
+#endif
+
 log_define("cxxtools.sslctx.impl")
 
 namespace cxxtools
@@ -61,7 +69,51 @@ static void pthreads_locking_callback(int mode, int n, const char* /* file */, i
         openssl_mutex[n].unlock();
 }
 
+namespace
+{
+    void freeSessionKey(void*, void* ptr, CRYPTO_EX_DATA*, int, long, void*)
+    {
+        delete static_cast<std::string*>(ptr);
+    }
+
+    // index of the ex data of client SSL objects, where the host:port of the
+    // peer is stored
+    int sessionKeyIndex()
+    {
+        static int index = SSL_get_ex_new_index(0, 0, 0, 0, freeSessionKey);
+        return index;
+    }
+
+    SslCtx::Impl* getImpl(SSL* ssl)
+    {
+        return static_cast<SslCtx::Impl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
+    }
+
+    // The SSL_CTX may outlive the Impl, when a connection is still open,
+    // so the Impl may be missing here.
+    int newSessionCallback(SSL* ssl, SSL_SESSION* session)
+    {
+        SslCtx::Impl* impl = getImpl(ssl);
+        return impl ? impl->newSession(ssl, session) : 0;
+    }
+
+#ifdef HAVE_SSL_CTX_SET_TLSEXT_TICKET_KEY_EVP_CB
+    int ticketKeyCallback(SSL* ssl, unsigned char* name, unsigned char* iv, EVP_CIPHER_CTX* cctx, EVP_MAC_CTX* hctx, int enc)
+#else
+    int ticketKeyCallback(SSL* ssl, unsigned char* name, unsigned char* iv, EVP_CIPHER_CTX* cctx, HMAC_CTX* hctx, int enc)
+#endif
+    {
+        SslCtx::Impl* impl = getImpl(ssl);
+        return impl ? impl->ticketKey(ssl, name, iv, cctx, hctx, enc) : 0;
+    }
+}
+
 SslCtx::Impl::Impl()
+    : _sessions(100),
+      _ticketKeysValid(false),
+      _ticketKeyRotation(Hours(1)),
+      _fullHandshakes(0),
+      _resumedHandshakes(0)
 {
     static std::once_flag initOnce;
     std::call_once(initOnce, []()
@@ -87,15 +139,222 @@ SslCtx::Impl::Impl()
 
     log_debug("ctx=" << static_cast<void*>(ctx()));
     SslError::checkSslError();
+
+    SSL_CTX_set_app_data(_ctx, this);
+
+    // Client sessions are kept in our own cache keyed by peer since openssl
+    // does not know, which session belongs to which server.
+    SSL_CTX_set_session_cache_mode(_ctx, SSL_SESS_CACHE_BOTH);
+    SSL_CTX_sess_set_new_cb(_ctx, newSessionCallback);
+
+#ifdef HAVE_SSL_CTX_SET_TLSEXT_TICKET_KEY_EVP_CB
+    SSL_CTX_set_tlsext_ticket_key_evp_cb(_ctx, ticketKeyCallback);
+#else
+    SSL_CTX_set_tlsext_ticket_key_cb(_ctx, ticketKeyCallback);
+#endif
 }
 
 SslCtx::Impl::~Impl()
 {
     log_debug("SSL_CTX_free(" << static_cast<void*>(_ctx) << ')');
+    SSL_CTX_set_app_data(_ctx, 0);
     SSL_CTX_free(_ctx);
 }
 
 
+void SslCtx::Impl::setSessionCacheSize(unsigned n)
+{
+    std::lock_guard<std::mutex> lock(_sessionMutex);
+    _sessions.setMaxElements(n);
+}
+
+void SslCtx::Impl::initClientSession(SSL* ssl, const std::string& peer) const
+{
+    std::shared_ptr<SSL_SESSION> session;
+
+    {
+        std::lock_guard<std::mutex> lock(_sessionMutex);
+        if (_sessions.getMaxElements() == 0)
+            return;
+
+        session = _sessions.get(peer);
+    }
+
+    SSL_set_ex_data(ssl, sessionKeyIndex(), new std::string(peer));
+
+    if (session)
+    {
+        log_debug("reuse ssl session for " << peer);
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+        // The connection gets a copy, since openssl marks its session as not
+        // resumable, when it is closed without ssl shutdown.
+        SSL_SESSION* copy = SSL_SESSION_dup(session.get());
+        if (copy)
+        {
+            SSL_set_session(ssl, copy);
+            SSL_SESSION_free(copy);
+        }
+#else
+        SSL_set_session(ssl, session.get());
+#endif
+    }
+}
+
+int SslCtx::Impl::newSession(SSL* ssl, SSL_SESSION* session)
+{
+    const std::string* peer = static_cast<const std::string*>(SSL_get_ex_data(ssl, sessionKeyIndex()));
+    if (peer == 0)
+        return 0;
+
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+    if (!SSL_SESSION_is_resumable(session))
+        return 0;
+#endif
+
+    log_debug("new ssl session for " << *peer);
+
+    std::lock_guard<std::mutex> lock(_sessionMutex);
+    if (_sessions.getMaxElements() == 0)
+        return 0;
+
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+    // Openssl marks the session as not resumable, when the connection is
+    // closed without ssl shutdown, so we keep a copy.
+    SSL_SESSION* copy = SSL_SESSION_dup(session);
+    if (copy)
+        _sessions.put(*peer, std::shared_ptr<SSL_SESSION>(copy, SSL_SESSION_free));
+    return 0;
+#else
+    // we take over the reference passed by openssl
+    _sessions.put(*peer, std::shared_ptr<SSL_SESSION>(session, SSL_SESSION_free));
+    return 1;
+#endif
+}
+
+void SslCtx::Impl::handshakeDone(SSL* ssl)
+{
+    if (SSL_session_reused(ssl))
+    {
+        log_debug("ssl session resumed");
+        ++_resumedHandshakes;
+    }
+    else
+    {
+        log_debug("full ssl handshake");
+        ++_fullHandshakes;
+    }
+}
+
+void SslCtx::Impl::setTicketKeyRotation(Timespan interval)
+{
+    std::lock_guard<std::mutex> lock(_ticketMutex);
+    _ticketKeyRotation = interval;
+}
+
+void SslCtx::Impl::rotateTicketKey()
+{
+    std::lock_guard<std::mutex> lock(_ticketMutex);
+    newTicketKey();
+}
+
+void SslCtx::Impl::newTicketKey()
+{
+    log_debug("new session ticket key");
+
+    TicketKey key;
+    if (RAND_bytes(key.name, sizeof(key.name)) <= 0
+        || RAND_bytes(key.aesKey, sizeof(key.aesKey)) <= 0
+        || RAND_bytes(key.hmacKey, sizeof(key.hmacKey)) <= 0)
+        SslError::checkSslError();
+
+    _ticketKeys[1] = _ticketKeys[0];
+    _ticketKeys[0] = key;
+    if (!_ticketKeysValid)
+        _ticketKeys[1] = key;
+    _ticketKeysValid = true;
+    _ticketKeyCreated = Clock::getSystemTicks();
+}
+
+bool SslCtx::Impl::getTicketKey(const unsigned char* name, bool enc, TicketKey& key, bool& renew)
+{
+    std::lock_guard<std::mutex> lock(_ticketMutex);
+
+    if (!_ticketKeysValid
+        || (_ticketKeyRotation > Timespan(0)
+            && Clock::getSystemTicks() - _ticketKeyCreated >= _ticketKeyRotation))
+        newTicketKey();
+
+    renew = false;
+
+    if (enc)
+    {
+        key = _ticketKeys[0];
+        return true;
+    }
+
+    for (unsigned n = 0; n < 2; ++n)
+    {
+        if (std::memcmp(name, _ticketKeys[n].name, sizeof(key.name)) == 0)
+        {
+            key = _ticketKeys[n];
+            renew = n > 0;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int SslCtx::Impl::ticketKey(SSL*, unsigned char* name, unsigned char* iv, EVP_CIPHER_CTX* cctx, void* hctx, int enc)
+{
+    TicketKey key;
+    bool renew;
+
+    try
+    {
+        if (!getTicketKey(name, enc, key, renew))
+        {
+            log_debug("unknown session ticket key");
+            return 0;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        log_error("failed to get session ticket key: " << e.what());
+        return -1;
+    }
+
+    if (enc)
+    {
+        std::memcpy(name, key.name, sizeof(key.name));
+        if (RAND_bytes(iv, EVP_CIPHER_iv_length(EVP_aes_256_cbc())) <= 0)
+            return -1;
+        if (!EVP_EncryptInit_ex(cctx, EVP_aes_256_cbc(), 0, key.aesKey, iv))
+            return -1;
+    }
+    else
+    {
+        if (!EVP_DecryptInit_ex(cctx, EVP_aes_256_cbc(), 0, key.aesKey, iv))
+            return -1;
+    }
+
+#ifdef HAVE_SSL_CTX_SET_TLSEXT_TICKET_KEY_EVP_CB
+    char digest[] = "sha256";
+    OSSL_PARAM params[3];
+    params[0] = OSSL_PARAM_construct_octet_string(OSSL_MAC_PARAM_KEY, key.hmacKey, sizeof(key.hmacKey));
+    params[1] = OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, digest, 0);
+    params[2] = OSSL_PARAM_construct_end();
+    if (!EVP_MAC_CTX_set_params(static_cast<EVP_MAC_CTX*>(hctx), params))
+        return -1;
+#else
+    if (!HMAC_Init_ex(static_cast<HMAC_CTX*>(hctx), key.hmacKey, sizeof(key.hmacKey), EVP_sha256(), 0))
+        return -1;
+#endif
+
+    return renew ? 2 : 1;
+}
+
+
 void SslCtx::Impl::loadCertificateFile(const std::string& certFile, const std::string& privateKeyFile)
 {
     log_debug("load ssl certificate file \"" << certFile << '"');
@@ -31,6 +31,13 @@
 
 #include <cxxtools/sslctx.h>
 #include <cxxtools/refcounted.h>
+#include <cxxtools/hashlrucache.h>
+#include <cxxtools/timespan.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
 
 #include <openssl/ssl.h>
 
@@ -40,6 +47,31 @@ class SslCtx::Impl : public cxxtools::AtomicRefCounted
 {
     SSL_CTX* _ctx;
 
+    // client sessions for resumption keyed by host:port
+    mutable std::mutex _sessionMutex;
+    mutable HashLruCache<std::string, std::shared_ptr<SSL_SESSION> > _sessions;
+
+    // server session ticket keys; tickets encrypted with the previous key
+    // are accepted and renewed after rotation
+    struct TicketKey
+    {
+        unsigned char name[16];
+        unsigned char aesKey[32];
+        unsigned char hmacKey[32];
+    };
+
+    std::mutex _ticketMutex;
+    TicketKey _ticketKeys[2];
+    bool _ticketKeysValid;
+    Timespan _ticketKeyCreated;
+    Timespan _ticketKeyRotation;
+
+    std::atomic<unsigned long> _fullHandshakes;
+    std::atomic<unsigned long> _resumedHandshakes;
+
+    void newTicketKey();
+    bool getTicketKey(const unsigned char* name, bool enc, TicketKey& key, bool& renew);
+
 public:
     Impl();
     Impl(const Impl&) = delete;
@@ -54,6 +86,23 @@ public:
     void setCiphers(const std::string& ciphers);
     void setCipherServerPreference();
     void clearCipherServerPreference();
+
+    void setSessionCacheSize(unsigned n);
+    void setTicketKeyRotation(Timespan interval);
+    void rotateTicketKey();
+
+    unsigned long fullHandshakes() const      { return _fullHandshakes; }
+    unsigned long resumedHandshakes() const   { return _resumedHandshakes; }
+
+    /// Prepares a client connection to the peer; reuses a cached session if available.
+    void initClientSession(SSL* ssl, const std::string& peer) const;
+
+    /// Counts a finished handshake.
+    void handshakeDone(SSL* ssl);
+
+    /// @internal callbacks from openssl
+    int newSession(SSL* ssl, SSL_SESSION* session);
+    int ticketKey(SSL* ssl, unsigned char* name, unsigned char* iv, EVP_CIPHER_CTX* cctx, void* hctx, int enc);
 };
 }
 
@@ -36,6 +36,16 @@ log_define("cxxtools.streambuffer")
 
 namespace cxxtools {
 
+namespace
+{
+    // smaller blocks are copied to the buffer, since sending a extra
+    // buffer costs more than copying
+    const size_t minSliceSize = 1024;
+
+    // maximum number of buffers passed to the device in one write
+    const size_t maxWvec = 16;
+}
+
 StreamBuffer::StreamBuffer(IODevice& ioDevice, size_t bufferSize, bool extend)
 : _ioDevice(&ioDevice),
   _ibufferSize(bufferSize+4),
@@ -43,7 +53,8 @@ StreamBuffer::StreamBuffer(IODevice& ioDevice, size_t bufferSize, bool extend)
   _obufferSize(bufferSize),
   _obuffer(0),
   _pbmax(4),
-  _oextend(extend)
+  _oextend(extend),
+  _slicesSize(0)
 {
     setg(0, 0, 0);
     setp(0, 0);
@@ -59,7 +70,8 @@ StreamBuffer::StreamBuffer(size_t bufferSize, bool extend)
   _obufferSize(bufferSize),
   _obuffer(0),
   _pbmax(4),
-  _oextend(extend)
+  _oextend(extend),
+  _slicesSize(0)
 {
     setg(0, 0, 0);
     setp(0, 0);
@@ -209,6 +221,12 @@ size_t StreamBuffer::beginWrite()
         return 0;
     }
 
+    if (!_slices.empty())
+    {
+        initWvec();
+        return _ioDevice->beginWrite(_wvec.data(), _wvec.size());
+    }
+
     if (pptr())
     {
         size_t avail = pptr() - pbase();
@@ -232,6 +250,53 @@ void StreamBuffer::discard()
 
     if (pptr())
         setp(_obuffer, _obuffer + _obufferSize);
+
+    _slices.clear();
+    _slicesSize = 0;
+}
+
+
+void StreamBuffer::discardOutput(std::streamsize keep)
+{
+    if (_ioDevice && _ioDevice->writing())
+    {
+        std::streamsize pending = 0;
+        if (_ioDevice->wveccount() > 0)
+        {
+            for (unsigned n = 0; n < _wvec.size(); ++n)
+                pending += _wvec[n].iov_len;
+        }
+        else
+            pending = _ioDevice->wbuflen();
+
+        if (keep < pending)
+            throw IOPending("discard failed - streambuffer is in use");
+    }
+
+    // the buffered data is sent after the slices, so it is discarded first
+    std::streamsize n = out_avail() - keep;
+
+    if (n > 0 && pptr())
+    {
+        std::streamsize b = std::min<std::streamsize>(n, pptr() - pbase());
+        pbump(-static_cast<int>(b));
+        n -= b;
+    }
+
+    while (n > 0 && !_slices.empty())
+    {
+        Slice& slice = _slices.back();
+        if (static_cast<size_t>(n) < slice.size)
+        {
+            slice.size -= n;
+            _slicesSize -= n;
+            break;
+        }
+
+        n -= slice.size;
+        _slicesSize -= slice.size;
+        _slices.pop_back();
+    }
 }
 
 
@@ -245,6 +310,16 @@ size_t StreamBuffer::endWrite()
 {
     log_trace("endWrite; out_avail=" << out_avail());
 
+    if (!_slices.empty())
+    {
+        size_t written = _ioDevice->endWrite();
+
+        log_debug(written << " bytes written; " << (out_avail() - written) << " left");
+
+        consumeOutput(written);
+        return written;
+    }
+
     size_t leftover = 0;
     size_t written = 0;
 
@@ -270,6 +345,119 @@ size_t StreamBuffer::endWrite()
 }
 
 
+void StreamBuffer::putSlice(std::string&& data)
+{
+    if (data.size() < minSliceSize || writing())
+    {
+        sputn(data.data(), data.size());
+        return;
+    }
+
+    Slice& slice = appendSlice();
+    slice.data = std::move(data);
+    slice.ptr = slice.data.data();
+    slice.size = slice.data.size();
+    _slicesSize += slice.size;
+}
+
+
+void StreamBuffer::putSlice(const char* data, size_t n)
+{
+    if (n < minSliceSize || writing())
+    {
+        sputn(data, n);
+        return;
+    }
+
+    Slice& slice = appendSlice();
+    slice.ptr = data;
+    slice.size = n;
+    _slicesSize += n;
+}
+
+
+StreamBuffer::Slice& StreamBuffer::appendSlice()
+{
+    // The buffered data is sent before the slices, so it is moved to a
+    // slice in front of the new one.
+    if (pptr() && pptr() > pbase())
+    {
+        _slices.emplace_back();
+        Slice& slice = _slices.back();
+        slice.data.assign(pbase(), pptr());
+        slice.ptr = slice.data.data();
+        slice.size = slice.data.size();
+        _slicesSize += slice.size;
+
+        setp(_obuffer, _obuffer + _obufferSize);
+    }
+
+    _slices.emplace_back();
+    return _slices.back();
+}
+
+
+void StreamBuffer::initWvec()
+{
+    _wvec.clear();
+
+    for (auto it = _slices.begin(); it != _slices.end() && _wvec.size() < maxWvec; ++it)
+    {
+        struct iovec v;
+        v.iov_base = const_cast<char*>(it->ptr);
+        v.iov_len = it->size;
+        _wvec.push_back(v);
+    }
+
+    if (_wvec.size() < maxWvec && pptr() && pptr() > pbase())
+    {
+        struct iovec v;
+        v.iov_base = pbase();
+        v.iov_len = pptr() - pbase();
+        _wvec.push_back(v);
+    }
+}
+
+
+void StreamBuffer::consumeOutput(size_t n)
+{
+    while (n > 0 && !_slices.empty())
+    {
+        Slice& slice = _slices.front();
+        if (n < slice.size)
+        {
+            slice.ptr += n;
+            slice.size -= n;
+            _slicesSize -= n;
+            return;
+        }
+
+        n -= slice.size;
+        _slicesSize -= slice.size;
+        _slices.pop_front();
+    }
+
+    if (n > 0)
+    {
+        size_t leftover = pptr() - pbase() - n;
+        if (leftover > 0)
+            traits_type::move(_obuffer, _obuffer + n, leftover);
+
+        setp(_obuffer, _obuffer + _obufferSize);
+        pbump( leftover );
+    }
+}
+
+
+void StreamBuffer::writeOutput()
+{
+    initWvec();
+    size_t written = _ioDevice->write(_wvec.data(), _wvec.size());
+    log_debug(written << " bytes written");
+    consumeOutput(written);
+}
+
+
 StreamBuffer::int_type StreamBuffer::overflow(int_type ch)
 {
     log_trace("overflow(" << ch << ')');
@@ -334,6 +522,11 @@ StreamBuffer::int_type StreamBuffer::overflow(int_type ch)
         log_debug("finish writing");
         endWrite();
     }
+    else if (!_slices.empty())
+    {
+        log_debug("blocking overflow");
+        writeOutput();
+    }
     else
     {
         // normal blocking overflow case
@@ -351,6 +544,11 @@ StreamBuffer::int_type StreamBuffer::overflow(int_type ch)
         pbump( leftover );
     }
 
+    // The slices are written before the buffer, so the buffer may still be
+    // full after writing.
+    while (pptr() == epptr() && !traits_type::eq_int_type(ch, traits_type::eof()))
+        writeOutput();
+
     // if the overflow char is not EOF put it in buffer
     if (traits_type::eq_int_type(ch, traits_type::eof()) ==  false)
     {
@@ -375,9 +573,9 @@ int StreamBuffer::sync()
     if (! _ioDevice)
         return 0;
 
-    if (pptr())
+    if (pptr() || !_slices.empty())
     {
-        while (pptr() > pbase())
+        while (out_avail() > 0)
         {
             const int_type ch = overflow( traits_type::eof() );
             if (ch == traits_type::eof())
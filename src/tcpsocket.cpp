@@ -146,7 +146,7 @@ void TcpSocket::connect(const AddrInfo& addrinfo)
 bool TcpSocket::beginConnect(const AddrInfo& addrinfo)
 {
     close();
-    bool ret = _impl->beginConnect(addrinfo);
+    bool ret = _impl->beginConnect(addrinfo, selector() != 0);
     setEnabled(true);
     setAsync(true);
     setEof(false);
@@ -282,6 +282,14 @@ size_t TcpSocket::onBeginWrite(const char* buffer, size_t n)
     return _impl->beginWrite(buffer, n);
 }
 
+size_t TcpSocket::onBeginWritev(const struct iovec* vec, size_t count)
+{
+    if (!_impl->isConnected())
+        throw IOError("socket not connected when trying to write");
+
+    return _impl->beginWritev(vec, count);
+}
+
 IODeviceImpl& TcpSocket::ioimpl()
 {
     return *_impl;
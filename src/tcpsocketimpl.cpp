@@ -53,6 +53,7 @@
 #include <cerrno>
 #include <cstring>
 #include <cassert>
+#include <algorithm>
 #include <fcntl.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
@@ -181,6 +182,8 @@ void TcpSocketImpl::checkSslOperation(int ret, const char* fn, pollfd* pfd)
             {
                 pfd->events |= POLLIN;
                 pfd->events &= ~POLLOUT;
+                if (pfd == _pfd)
+                    pollChanged();
             }
             break;
 
@@ -192,6 +195,8 @@ void TcpSocketImpl::checkSslOperation(int ret, const char* fn, pollfd* pfd)
             {
                 pfd->events |= POLLOUT;
                 pfd->events &= ~POLLIN;
+                if (pfd == _pfd)
+                    pollChanged();
             }
             break;
 
@@ -253,6 +258,15 @@ void TcpSocketImpl::initSsl(const SslCtx& sslCtx)
     SSL_set_fd(_ssl, _fd);
 }
 
+void TcpSocketImpl::sslHandshakeDone()
+{
+    _state = SSLCONNECTED;
+
+    SslCtx::Impl* impl = static_cast<SslCtx::Impl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(_ssl)));
+    if (impl)
+        impl->handshakeDone(_ssl);
+}
+
 TcpSocketImpl::TcpSocketImpl(TcpSocket& socket)
 : IODeviceImpl(socket),
   _socket(socket),
@@ -279,6 +293,21 @@ TcpSocketImpl::~TcpSocketImpl()
 void TcpSocketImpl::close()
 {
     log_debug("close socket " << _fd);
+
+    // the pipe of a resolver job is polled instead of the socket and after a
+    // failed resolve there is no socket at all, so IODeviceImpl::close does
+    // not release the poll entry
+    if (_pfd && (_resolverJob || _fd < 0))
+    {
+        _pfd->fd = -1;
+        _pfd->events = 0;
+        _pfd->revents = 0;
+        pollChanged();
+        _pfd = 0;
+    }
+
+    _resolverJob.reset();
+
     IODeviceImpl::close();
     _state = IDLE;
     _peerCertificate.clear();
@@ -418,14 +447,61 @@ std::string TcpSocketImpl::tryConnect()
 }
 
 
-bool TcpSocketImpl::beginConnect(const AddrInfo& addrInfo)
+bool TcpSocketImpl::beginConnect(const AddrInfo& addrInfo, bool async)
 {
     log_trace("begin connect");
 
     assert(_state == IDLE);
 
     _connectFailedMessages.clear();
+    _connectResult.clear();
     _addrInfo = addrInfo;
+
+    if (async)
+    {
+        try
+        {
+            if (!_addrInfo.impl()->resolveCached())
+            {
+                log_debug("resolve \"" << _addrInfo.host() << "\" asynchronously");
+                _resolverJob = Resolver::resolve(*_addrInfo.impl());
+                _state = RESOLVING;
+                return false;
+            }
+        }
+        catch (const std::exception& e)
+        {
+            _connectResult = e.what();
+            return true;
+        }
+    }
+
+    _addrInfoPtr = _addrInfo.impl()->begin();
+    _state = CONNECTING;
+    _connectResult = tryConnect();
+    return _state == CONNECTED || !_connectResult.empty();
+}
+
+
+bool TcpSocketImpl::continueConnect()
+{
+    log_trace("continue connect");
+
+    std::shared_ptr<ResolverJob> job;
+    job.swap(_resolverJob);
+    _state = IDLE;
+
+    try
+    {
+        _addrInfo.impl()->setResolved(job->result());
+    }
+    catch (const std::exception& e)
+    {
+        log_debug("resolving \"" << _addrInfo.host() << "\" failed: " << e.what());
+        _connectResult = e.what();
+        return true;
+    }
+
     _addrInfoPtr = _addrInfo.impl()->begin();
     _state = CONNECTING;
     _connectResult = tryConnect();
@@ -437,9 +513,33 @@ void TcpSocketImpl::endConnect()
 {
     log_trace("ending connect");
 
+    if (_state == RESOLVING)
+    {
+        pollfd pfd;
+        pfd.fd = _resolverJob->fd();
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+
+        if (!_resolverJob->finished() && !wait(timeout(), pfd))
+        {
+            log_debug("timeout while resolving \"" << _addrInfo.host() << '"');
+            close();
+            throw IOTimeout();
+        }
+
+        continueConnect();
+
+        if (_pfd)
+        {
+            initializePoll(_pfd, 1);
+            pollChanged();
+        }
+    }
+
     if (_pfd && ! _socket.wbuf())
     {
         _pfd->events &= ~POLLOUT;
+        pollChanged();
     }
 
     checkPendingError();
@@ -537,6 +637,15 @@ void TcpSocketImpl::accept(const TcpServer& server, unsigned flags)
 
 void TcpSocketImpl::initWait(pollfd& pfd)
 {
+    if (_state == RESOLVING)
+    {
+        log_debug("resolving, wait for resolver job");
+        pfd.fd = _resolverJob->fd();
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        return;
+    }
+
     IODeviceImpl::initWait(pfd);
 
     if (!isConnected())
@@ -553,6 +662,27 @@ bool TcpSocketImpl::checkPollEvent(pollfd& pfd)
 
     DestructionSentry sentry(_sentry);
 
+    if (_state == RESOLVING)
+    {
+        if (!_resolverJob->finished())
+            return false;
+
+        bool done = continueConnect();
+
+        // the socket is polled now instead of the pipe of the resolver job
+        initializePoll(&pfd, 1);
+        pollChanged();
+
+        if (done)
+        {
+            log_debug_if(_state == CONNECTED, "connected successfully");
+            log_debug_if(!_connectResult.empty(), "connection failed: " << _connectResult);
+            _socket.connected(_socket);
+        }
+
+        return true;
+    }
+
     if (isConnected())
     {
         // check for error while neither reading nor writing
@@ -574,7 +704,7 @@ bool TcpSocketImpl::checkPollEvent(pollfd& pfd)
             int ret = SSL_connect(_ssl);
             if (ret == 1)
             {
-                _state = SSLCONNECTED;
+                sslHandshakeDone();
                 _socket.sslConnected(_socket);
             }
             else
@@ -599,7 +729,7 @@ bool TcpSocketImpl::checkPollEvent(pollfd& pfd)
             int ret = SSL_accept(_ssl);
             if (ret == 1)
             {
-                _state = SSLCONNECTED;
+                sslHandshakeDone();
                 _socket.sslAccepted(_socket);
             }
             else
@@ -711,21 +841,35 @@ bool TcpSocketImpl::checkPollEvent(pollfd& pfd)
 
 size_t TcpSocketImpl::callSend(const char* buffer, size_t n)
 {
-    log_debug("::send(" << _fd << ", buffer, " << n << ')');
     log_finer(hexDump(buffer, n));
 
+    struct iovec vec;
+    vec.iov_base = const_cast<char*>(buffer);
+    vec.iov_len = n;
+    return callSendmsg(&vec, 1);
+}
+
+size_t TcpSocketImpl::callSendmsg(const struct iovec* vec, size_t count)
+{
+    log_debug("::sendmsg(" << _fd << ", msg, " << count << ')');
+
+    struct msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = const_cast<struct iovec*>(vec);
+    msg.msg_iovlen = count;
+
 #if defined(HAVE_MSG_NOSIGNAL)
 
     ssize_t ret;
     do {
-        ret = ::send(_fd, (const void*)buffer, n, MSG_NOSIGNAL);
+        ret = ::sendmsg(_fd, &msg, MSG_NOSIGNAL);
     } while (ret == -1 && errno == EINTR);
 
 #elif defined(HAVE_SO_NOSIGPIPE)
 
     ssize_t ret;
     do {
-        ret = ::send(_fd, (const void*)buffer, n, 0);
+        ret = ::sendmsg(_fd, &msg, 0);
     } while (ret == -1 && errno == EINTR);
 
 #else
@@ -739,7 +883,7 @@ size_t TcpSocketImpl::callSend(const char* buffer, size_t n)
     // execute send
     ssize_t ret;
     do {
-        ret = ::send(_fd, (const void*)buffer, n, 0);
+        ret = ::sendmsg(_fd, &msg, 0);
     } while (ret == -1 && errno == EINTR);
 
     // clear possible SIGPIPE
@@ -760,7 +904,7 @@ size_t TcpSocketImpl::callSend(const char* buffer, size_t n)
 
     int e = errno;
 
-    log_debug("send returned " << ret);
+    log_debug("sendmsg returned " << ret);
     if (ret > 0)
         return static_cast<size_t>(ret);
 
@@ -773,6 +917,30 @@ size_t TcpSocketImpl::callSend(const char* buffer, size_t n)
 }
 
 
+size_t TcpSocketImpl::sslBatch(const struct iovec* vec, size_t count, const char*& data)
+{
+    // SSL_write encrypts at most 16k into one record. Smaller buffers are
+    // collected, so that they are not sent in records of their own.
+    static const size_t maxRecordSize = 16384;
+
+    if (count == 1 || vec[0].iov_len >= maxRecordSize)
+    {
+        data = static_cast<const char*>(vec[0].iov_base);
+        return vec[0].iov_len;
+    }
+
+    _sslWriteBuffer.clear();
+    for (size_t i = 0; i < count && _sslWriteBuffer.size() < maxRecordSize; ++i)
+    {
+        const char* p = static_cast<const char*>(vec[i].iov_base);
+        size_t n = std::min(vec[i].iov_len, maxRecordSize - _sslWriteBuffer.size());
+        _sslWriteBuffer.insert(_sslWriteBuffer.end(), p, p + n);
+    }
+
+    data = _sslWriteBuffer.data();
+    return _sslWriteBuffer.size();
+}
+
 size_t TcpSocketImpl::beginWrite(const char* buffer, size_t n)
 {
     if (_state == CONNECTED)
@@ -783,7 +951,10 @@ size_t TcpSocketImpl::beginWrite(const char* buffer, size_t n)
             return ret;
 
         if (_pfd)
+        {
             _pfd->events |= POLLOUT;
+            pollChanged();
+        }
     }
     else if (_state == SSLCONNECTED)
     {
@@ -855,6 +1026,97 @@ size_t TcpSocketImpl::write(const char* buffer, size_t n)
     return static_cast<size_t>(ret);
 }
 
+size_t TcpSocketImpl::beginWritev(const struct iovec* vec, size_t count)
+{
+    if (_state == CONNECTED)
+    {
+        size_t ret = callSendmsg(vec, count);
+
+        if (ret > 0)
+            return ret;
+
+        if (_pfd)
+        {
+            _pfd->events |= POLLOUT;
+            pollChanged();
+        }
+    }
+    else if (_state == SSLCONNECTED)
+    {
+        const char* buffer;
+        size_t n = sslBatch(vec, count, buffer);
+
+        log_debug("SSL_write(" << _fd << ", buffer, " << n << ')');
+        log_finer(hexDump(buffer, n));
+
+        int ret = SSL_write(_ssl, buffer, n);
+        log_debug("SSL_write returned " << ret);
+        if (ret > 0)
+            return ret;
+
+        try
+        {
+            checkSslOperation(ret, "SSL_write", _pfd);
+        }
+        catch (const std::exception&)
+        {
+            _exception = std::current_exception();
+        }
+    }
+    else
+    {
+        log_error("Device not connected when trying to write; state=" << _state);
+        throw std::logic_error("Device not connected when trying to write");
+    }
+
+    return 0;
+}
+
+
+size_t TcpSocketImpl::writev(const struct iovec* vec, size_t count)
+{
+    ssize_t ret = 0;
+
+    while (true)
+    {
+        if (_state == CONNECTED)
+        {
+            ret = callSendmsg(vec, count);
+            if (ret > 0)
+                break;
+
+            if (errno != EAGAIN)
+                throw IOError(getErrnoString("sendmsg"));
+
+            pollfd pfd;
+            pfd.fd = _fd;
+            pfd.revents = 0;
+            pfd.events = POLLOUT;
+
+            if (!wait(_timeout, pfd))
+                throw IOTimeout();
+        }
+        else if (_state == SSLCONNECTED)
+        {
+            const char* buffer;
+            size_t n = sslBatch(vec, count, buffer);
+
+            log_debug("SSL_write");
+            ret = SSL_write(_ssl, buffer, n);
+            if (ret > 0)
+                break;
+            waitSslOperation(ret, timeout());
+        }
+        else
+        {
+            log_error("Device not connected when trying to write; state=" << _state);
+            throw std::logic_error("Device not connected when trying to write");
+        }
+    }
+
+    return static_cast<size_t>(ret);
+}
+
 void TcpSocketImpl::inputReady()
 {
     log_trace("inputReady; state=" << static_cast<int>(_state));
@@ -862,6 +1124,7 @@ void TcpSocketImpl::inputReady()
     switch (_state)
     {
         case IDLE:
+        case RESOLVING:
         case CONNECTING:
             break;
 
@@ -896,6 +1159,7 @@ void TcpSocketImpl::outputReady()
     switch (_state)
     {
         case IDLE:
+        case RESOLVING:
         case CONNECTING:
             break;
 
@@ -925,6 +1189,24 @@ void TcpSocketImpl::outputReady()
     }
 }
 
+size_t TcpSocketImpl::beginRead(char* buffer, size_t n, bool& eof)
+{
+    // A ssl record may be larger than the buffer. The rest is kept decrypted
+    // by openssl, which is not signaled by poll, so it is read immediately.
+    if (_state == SSLCONNECTED && SSL_pending(_ssl) > 0)
+    {
+        int ret = SSL_read(_ssl, buffer, n);
+        log_debug("SSL_read(" << _fd << ", " << n << ") returned " << ret);
+        if (ret > 0)
+        {
+            log_finer(hexDump(buffer, ret));
+            return ret;
+        }
+    }
+
+    return IODeviceImpl::beginRead(buffer, n, eof);
+}
+
 size_t TcpSocketImpl::read(char* buffer, size_t count, bool& eof)
 {
     if (_state == CONNECTED)
@@ -993,7 +1275,18 @@ bool TcpSocketImpl::beginSslConnect(const SslCtx& ctx)
     }
 
     _state = SSLCONNECTING;
-    initSsl(ctx);
+
+    if (!_ssl)
+    {
+        initSsl(ctx);
+
+        if (_addrInfo.impl())
+        {
+            std::ostringstream peer;
+            peer << _addrInfo.host() << ':' << _addrInfo.port();
+            ctx.impl()->initClientSession(_ssl, peer.str());
+        }
+    }
 
     return continueSslConnect();
 }
@@ -1005,7 +1298,7 @@ bool TcpSocketImpl::continueSslConnect()
     if (ret == 1)
     {
         log_debug("SSL connection successful");
-        _state = SSLCONNECTED;
+        sslHandshakeDone();
         return true;
     }
 
@@ -1026,7 +1319,10 @@ void TcpSocketImpl::endSslConnect()
     log_trace("ending ssl connect");
 
     if (_pfd && !_socket.wbuf())
+    {
         _pfd->events &= ~POLLOUT;
+        pollChanged();
+    }
 
     if (_state == THROWING)
         throw;
@@ -1063,7 +1359,7 @@ void TcpSocketImpl::endSslConnect()
                     "validity: " << _socket.getSslPeerCertificate().getNotBefore().toString() <<
                     " - " << _socket.getSslPeerCertificate().getNotAfter().toString());
             verifySslCertificate();
-            _state = SSLCONNECTED;
+            sslHandshakeDone();
             return;
         }
 
@@ -1095,7 +1391,7 @@ bool TcpSocketImpl::continueSslAccept()
     {
         log_debug_to(ssl, "SSL accepted");
         log_debug_to_if(ssl, _socket.hasSslPeerCertificate(), "peer subject: \"" << _socket.getSslPeerCertificate().getSubject() << "\" validity: " << _socket.getSslPeerCertificate().getNotBefore().toString() << " - " << _socket.getSslPeerCertificate().getNotAfter().toString());
-        _state = SSLCONNECTED;
+        sslHandshakeDone();
         return true;
     }
 
@@ -1116,7 +1412,10 @@ void TcpSocketImpl::endSslAccept()
     log_trace_to(ssl, "ending ssl accept");
 
     if (_pfd && !_socket.wbuf())
+    {
         _pfd->events &= ~POLLOUT;
+        pollChanged();
+    }
 
     if (_state == THROWING)
         throw;
@@ -1149,7 +1448,7 @@ void TcpSocketImpl::endSslAccept()
         {
             log_debug_to(ssl, "SSL accepted");
             verifySslCertificate();
-            _state = SSLCONNECTED;
+            sslHandshakeDone();
             return;
         }
 
@@ -1192,7 +1491,10 @@ void TcpSocketImpl::endSslShutdown()
     log_trace_to(ssl, "ending ssl shutdown");
 
     if (_pfd && !_socket.wbuf())
+    {
         _pfd->events &= ~POLLOUT;
+        pollChanged();
+    }
 
     if (_state == CONNECTED)
         return;
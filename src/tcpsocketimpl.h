@@ -33,9 +33,11 @@
 #include <cxxtools/net/addrinfo.h>
 #include <cxxtools/sslcertificate.h>
 #include "addrinfoimpl.h"
+#include "resolver.h"
 
 #include <openssl/ssl.h>
 
+#include <memory>
 #include <string>
 #include <vector>
 #include <sys/types.h>
@@ -86,6 +88,7 @@ class TcpSocketImpl : public IODeviceImpl
         TcpSocket& _socket;
         enum State {
             IDLE,
+            RESOLVING,
             CONNECTING,
             CONNECTED,
             SSLACCEPTING,
@@ -99,24 +102,30 @@ class TcpSocketImpl : public IODeviceImpl
         struct sockaddr_storage _peeraddr;
         AddrInfo _addrInfo;
         AddrInfoImpl::const_iterator _addrInfoPtr;
+        std::shared_ptr<ResolverJob> _resolverJob;
         std::string _connectResult;
         std::vector<std::string> _connectFailedMessages;
         DestructionSentry* _sentry;
         SSL* _ssl;
         mutable bool _peerCertificateLoaded;
         mutable SslCertificate _peerCertificate;
+        std::vector<char> _sslWriteBuffer;
 
         // methods
         int checkConnect();
         size_t callSend(const char* buffer, size_t n);
+        size_t callSendmsg(const struct iovec* vec, size_t count);
+        size_t sslBatch(const struct iovec* vec, size_t count, const char*& data);
         void checkPendingError();
         std::string tryConnect();
+        bool continueConnect();
         std::string connectFailedMessages();
 
         void checkSslOperation(int ret, const char* fn, pollfd* pfd);
         void waitSslOperation(int ret, cxxtools::Timespan timeout);
 
         void initSsl(const SslCtx& sslCtx);
+        void sslHandshakeDone();
 
     public:
         explicit TcpSocketImpl(TcpSocket& socket);
@@ -135,7 +144,10 @@ class TcpSocketImpl : public IODeviceImpl
         bool isSslConnected() const
         { return _state == SSLCONNECTED; }
 
-        bool beginConnect(const AddrInfo& addrinfo);
+        /// Starts connecting. When async is set and the name is not yet
+        /// resolved, the lookup is done in the resolver threads and the
+        /// connect continues when the selector reports the result.
+        bool beginConnect(const AddrInfo& addrinfo, bool async = false);
 
         void endConnect();
 
@@ -155,6 +167,15 @@ class TcpSocketImpl : public IODeviceImpl
         // override write to use send(2) instead of write(2)
         size_t write(const char* buffer, size_t count) override;
 
+        // override beginWritev to use sendmsg(2) instead of writev(2)
+        size_t beginWritev(const struct iovec* vec, size_t count) override;
+
+        // override writev to use sendmsg(2) instead of writev(2)
+        size_t writev(const struct iovec* vec, size_t count) override;
+
+        // override for ssl
+        size_t beginRead(char* buffer, size_t n, bool& eof) override;
+
         // override for ssl
         size_t read(char* buffer, size_t count, bool& eof) override;
 
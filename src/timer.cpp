@@ -27,6 +27,7 @@
 #include "cxxtools/clock.h"
 #include "cxxtools/selector.h"
 #include "cxxtools/datetime.h"
+#include "timerwheel.h"
 #include <stdexcept>
 #include <time.h>
 
@@ -68,6 +69,12 @@ Timer::Timer(SelectorBase* selector)
 , _selector(0)
 , _active(false)
 , _finished(0)
+, _once(false)
+, _wheelNext(0)
+, _wheelPrev(0)
+, _wheelTick(0)
+, _wheelSeq(0)
+, _wheelSlot(TimerWheel::NotLinked)
 {
     if (selector)
         setSelector(selector);
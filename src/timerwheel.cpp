@@ -0,0 +1,341 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "timerwheel.h"
+#include <cxxtools/timer.h>
+#include <cxxtools/log.h>
+#include <stdexcept>
+
+log_define("cxxtools.timerwheel")
+
+namespace cxxtools {
+
+namespace
+{
+    inline unsigned lowestBit(uint64_t bits)
+    {
+#ifdef __GNUC__
+        return __builtin_ctzll(bits);
+#else
+        unsigned n = 0;
+        while ((bits & 1) == 0)
+        {
+            bits >>= 1;
+            ++n;
+        }
+        return n;
+#endif
+    }
+
+    inline bool before(const Timer* a, const Timer* b, uint64_t aSeq, uint64_t bSeq)
+    {
+        return a->finished() < b->finished()
+            || (a->finished() == b->finished() && aSeq < bSeq);
+    }
+}
+
+TimerWheel::TimerWheel(Timespan resolution)
+    : _resolution(resolution.totalUSecs()),
+      _current(0),
+      _seq(0),
+      _size(0),
+      _dueHead(0),
+      _dueTail(0)
+{
+    if (_resolution <= 0)
+        throw std::invalid_argument("timer resolution must be positive");
+
+    for (unsigned n = 0; n < Levels; ++n)
+        _occupied[n] = 0;
+    for (unsigned n = 0; n < Levels * Slots; ++n)
+        _slots[n] = 0;
+
+    int64_t now = Timespan::gettimeofday().totalUSecs();
+    _current = static_cast<uint64_t>(now / _resolution);
+}
+
+void TimerWheel::resolution(Timespan r)
+{
+    int64_t resolution = r.totalUSecs();
+    if (resolution <= 0)
+        throw std::invalid_argument("timer resolution must be positive");
+
+    if (resolution == _resolution)
+        return;
+
+    uint64_t current = static_cast<uint64_t>(static_cast<int64_t>(_current) * _resolution / resolution);
+    _resolution = resolution;
+    rebuild(current);
+}
+
+void TimerWheel::add(Timer& timer)
+{
+    int64_t finished = timer.finished().totalUSecs();
+    timer._wheelTick = finished <= 0 ? 0
+                     : static_cast<uint64_t>((finished + _resolution - 1) / _resolution);
+    timer._wheelSeq = _seq++;
+    link(timer);
+    ++_size;
+}
+
+void TimerWheel::remove(Timer& timer)
+{
+    if (timer._wheelSlot == NotLinked)
+        return;
+
+    unlink(timer);
+    --_size;
+}
+
+void TimerWheel::link(Timer& timer)
+{
+    uint64_t tick = timer._wheelTick < _current ? _current : timer._wheelTick;
+
+    // find the lowest level, where the tick fits into the current window
+    unsigned level = 0;
+    while (level < Levels && (tick >> (Bits * level)) - (_current >> (Bits * level)) >= Slots)
+        ++level;
+
+    if (level == Levels)
+    {
+        // beyond the range of the wheel; park it in the last slot of the
+        // top level, from where it is redistributed when that is reached
+        level = Levels - 1;
+        tick = ((_current >> (Bits * level)) + Slots - 1) << (Bits * level);
+    }
+
+    unsigned slot = (tick >> (Bits * level)) & (Slots - 1);
+    unsigned idx = level * Slots + slot;
+
+    Timer*& head = _slots[idx];
+    timer._wheelPrev = 0;
+    timer._wheelNext = head;
+    if (head)
+        head->_wheelPrev = &timer;
+    head = &timer;
+    timer._wheelSlot = idx;
+    _occupied[level] |= uint64_t(1) << slot;
+}
+
+void TimerWheel::unlink(Timer& timer)
+{
+    unsigned idx = timer._wheelSlot;
+    Timer*& head = idx == Due ? _dueHead : _slots[idx];
+
+    if (timer._wheelPrev)
+        timer._wheelPrev->_wheelNext = timer._wheelNext;
+    else
+        head = timer._wheelNext;
+
+    if (timer._wheelNext)
+        timer._wheelNext->_wheelPrev = timer._wheelPrev;
+
+    if (idx == Due)
+    {
+        if (_dueTail == &timer)
+            _dueTail = timer._wheelPrev;
+    }
+    else if (head == 0)
+    {
+        _occupied[idx / Slots] &= ~(uint64_t(1) << (idx % Slots));
+    }
+
+    timer._wheelNext = timer._wheelPrev = 0;
+    timer._wheelSlot = NotLinked;
+}
+
+void TimerWheel::rebuild(uint64_t current)
+{
+    log_debug("rebuild timer wheel; " << _size << " timers");
+
+    Timer* list = 0;
+    for (unsigned idx = 0; idx < Levels * Slots; ++idx)
+    {
+        while (Timer* timer = _slots[idx])
+        {
+            _slots[idx] = timer->_wheelNext;
+            timer->_wheelNext = list;
+            list = timer;
+        }
+    }
+
+    for (unsigned n = 0; n < Levels; ++n)
+        _occupied[n] = 0;
+
+    _current = current;
+
+    while (list)
+    {
+        Timer* timer = list;
+        list = timer->_wheelNext;
+
+        int64_t finished = timer->finished().totalUSecs();
+        timer->_wheelTick = finished <= 0 ? 0
+                          : static_cast<uint64_t>((finished + _resolution - 1) / _resolution);
+        link(*timer);
+    }
+}
+
+bool TimerWheel::nextSlot(uint64_t& start, unsigned& idx) const
+{
+    bool found = false;
+
+    // Higher levels are checked first, so that on equal start ticks a higher
+    // level slot is redistributed before the lower level slot is expired.
+    for (unsigned level = Levels; level-- > 0; )
+    {
+        uint64_t bits = _occupied[level];
+        if (bits == 0)
+            continue;
+
+        unsigned shift = Bits * level;
+        uint64_t base = _current >> shift;
+        unsigned cur = base & (Slots - 1);
+        uint64_t rotated = cur == 0 ? bits : (bits >> cur) | (bits << (Slots - cur));
+        unsigned k = lowestBit(rotated);
+        uint64_t s = (base + k) << shift;
+
+        if (!found || s < start)
+        {
+            found = true;
+            start = s;
+            idx = level * Slots + ((cur + k) & (Slots - 1));
+        }
+    }
+
+    return found;
+}
+
+Timer* TimerWheel::sort(Timer* list)
+{
+    if (list == 0 || list->_wheelNext == 0)
+        return list;
+
+    Timer* slow = list;
+    Timer* fast = list->_wheelNext;
+    while (fast && fast->_wheelNext)
+    {
+        slow = slow->_wheelNext;
+        fast = fast->_wheelNext->_wheelNext;
+    }
+
+    Timer* a = sort(slow->_wheelNext);
+    slow->_wheelNext = 0;
+    Timer* b = sort(list);
+
+    Timer* result = 0;
+    Timer** tail = &result;
+    while (a && b)
+    {
+        Timer*& n = before(b, a, b->_wheelSeq, a->_wheelSeq) ? b : a;
+        *tail = n;
+        tail = &n->_wheelNext;
+        n = n->_wheelNext;
+    }
+
+    *tail = a ? a : b;
+    return result;
+}
+
+void TimerWheel::advance(Timespan now)
+{
+    uint64_t current = static_cast<uint64_t>(now.totalUSecs() / _resolution);
+
+    if (current < _current)
+    {
+        // the clock went backwards
+        rebuild(current);
+    }
+
+    uint64_t start;
+    unsigned idx;
+    while (nextSlot(start, idx) && start <= current)
+    {
+        if (start > _current)
+            _current = start;
+
+        Timer* list = _slots[idx];
+        _slots[idx] = 0;
+        _occupied[idx / Slots] &= ~(uint64_t(1) << (idx % Slots));
+
+        if (idx < Slots)
+        {
+            // expired slot of level 0; append the timers to the due list
+            for (Timer* timer = sort(list); timer; timer = timer->_wheelNext)
+            {
+                timer->_wheelPrev = _dueTail;
+                timer->_wheelSlot = Due;
+                if (_dueTail)
+                    _dueTail->_wheelNext = timer;
+                else
+                    _dueHead = timer;
+                _dueTail = timer;
+            }
+        }
+        else
+        {
+            while (list)
+            {
+                Timer* timer = list;
+                list = timer->_wheelNext;
+                link(*timer);
+            }
+        }
+    }
+
+    _current = current;
+}
+
+Timespan TimerWheel::next() const
+{
+    if (_dueHead)
+        return Timespan(0);
+
+    uint64_t start;
+    unsigned idx;
+    if (!nextSlot(start, idx))
+        return Timespan(-1);
+
+    return Timespan(static_cast<int64_t>(start) * _resolution);
+}
+
+Timer* TimerWheel::any() const
+{
+    if (_dueHead)
+        return _dueHead;
+
+    for (unsigned level = 0; level < Levels; ++level)
+    {
+        if (_occupied[level])
+            return _slots[level * Slots + lowestBit(_occupied[level])];
+    }
+
+    return 0;
+}
+
+}
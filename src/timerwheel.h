@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_TIMERWHEEL_H
+#define CXXTOOLS_TIMERWHEEL_H
+
+#include <cxxtools/timespan.h>
+#include <stdint.h>
+
+namespace cxxtools {
+
+class Timer;
+
+/** @internal Hierarchical timing wheel holding the active timers of a selector.
+
+    Time is divided into ticks of the configured resolution. A timer is due
+    at the first tick boundary at or after its finish time, so timers
+    finishing within the same tick are coalesced and fire together.
+
+    The wheel has `Levels` levels of `Slots` slots each. A slot on level n
+    spans Slots^n ticks. Timers are kept in intrusive lists, so adding and
+    removing a timer is O(1) and does not allocate. When the current time
+    reaches a slot on a higher level, its timers are redistributed to the
+    lower levels.
+
+    Due timers are moved to a separate list ordered by finish time and
+    insertion order, which is the order, in which the selector fires them.
+ */
+class TimerWheel
+{
+        TimerWheel(const TimerWheel&) = delete;
+        TimerWheel& operator=(const TimerWheel&) = delete;
+
+    public:
+        static const unsigned Bits = 6;
+        static const unsigned Slots = 1 << Bits;
+        static const unsigned Levels = 6;
+
+        /// Slot index of a timer, which is not in the wheel.
+        static const unsigned NotLinked = static_cast<unsigned>(-1);
+
+        explicit TimerWheel(Timespan resolution = Milliseconds(1));
+
+        Timespan resolution() const
+        { return Timespan(_resolution); }
+
+        /// Sets the tick length; timers already in the wheel are redistributed.
+        void resolution(Timespan r);
+
+        bool empty() const
+        { return _size == 0; }
+
+        unsigned size() const
+        { return _size; }
+
+        /// Adds an active timer, which is not yet in the wheel.
+        void add(Timer& timer);
+
+        /// Removes the timer from the wheel or the due list if it is there.
+        void remove(Timer& timer);
+
+        /// Moves all timers, which are due at `now` to the due list.
+        void advance(Timespan now);
+
+        /// Returns the first timer of the due list or 0.
+        Timer* due() const
+        { return _dueHead; }
+
+        /// Returns the time, when advance needs to be called next.
+        /// A negative value is returned when there are no timers.
+        Timespan next() const;
+
+        /// Returns some timer in the wheel or 0 if empty.
+        Timer* any() const;
+
+    private:
+        static const unsigned Due = Levels * Slots;
+
+        void link(Timer& timer);
+        void unlink(Timer& timer);
+        void rebuild(uint64_t current);
+        bool nextSlot(uint64_t& start, unsigned& slot) const;
+        static Timer* sort(Timer* list);
+
+        int64_t _resolution;
+        uint64_t _current;
+        uint64_t _seq;
+        unsigned _size;
+        uint64_t _occupied[Levels];
+        Timer* _slots[Levels * Slots];
+        Timer* _dueHead;
+        Timer* _dueTail;
+};
+
+}
+
+#endif // CXXTOOLS_TIMERWHEEL_H
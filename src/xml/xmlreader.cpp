@@ -25,6 +25,7 @@
  */
 #include "cxxtools/xml/xmlreader.h"
 #include <cxxtools/xml/enddocument.h>
+#include "xml/xmltokenizer.h"
 #include "cxxtools/xml/entityresolver.h"
 #include <cxxtools/xml/doctypedeclaration.h>
 #include "cxxtools/xml/startelement.h"
@@ -49,8 +50,8 @@ namespace xml {
 
 class XmlReaderImpl
 {
-    XmlReaderImpl(const XmlReaderImpl&) { }
-    XmlReaderImpl& operator=(const XmlReaderImpl&) { return *this; }
+    XmlReaderImpl(const XmlReaderImpl&) = delete;
+    XmlReaderImpl& operator=(const XmlReaderImpl&) = delete;
 
     struct State
     {
@@ -1570,6 +1571,7 @@ class XmlReaderImpl
     , _line(1)
     , _state(0)
     , _current(0)
+    , _tokenizer(_resolver)
     {
         _state = XmlReaderImpl::OnDocumentBegin::instance();
     }
@@ -1583,10 +1585,10 @@ class XmlReaderImpl
     , _line(1)
     , _state(0)
     , _current(0)
+    , _tokenizer(_resolver)
     {
         _state = XmlReaderImpl::OnDocumentBegin::instance();
-        _buffer = new TextBuffer( &is, new cxxtools::Utf8Codec() );
-        _textBuffer = _buffer;
+        _tokenizer.reset(is.rdbuf());
     }
 
     ~XmlReaderImpl()
@@ -1613,8 +1615,9 @@ class XmlReaderImpl
     void reset(std::istream& is, int flags)
     {
         delete _buffer;
-        _buffer = new TextBuffer( &is, new cxxtools::Utf8Codec() );
-        _textBuffer = _buffer;
+        _buffer = 0;
+        _textBuffer = 0;
+        _tokenizer.reset(is.rdbuf());
 
         _state = XmlReaderImpl::OnDocumentBegin::instance();
         _flags = flags;
@@ -1628,6 +1631,12 @@ class XmlReaderImpl
 
     const cxxtools::String& version() const
     {
+        if (!_textBuffer)
+        {
+            const_cast<XmlTokenizer&>(_tokenizer).readProlog();
+            return _tokenizer.version();
+        }
+
         if (_state == XmlReaderImpl::OnDocumentBegin::instance())
             const_cast<XmlReaderImpl*>(this)->readProlog();
         return _version;
@@ -1635,6 +1644,12 @@ class XmlReaderImpl
 
     const cxxtools::String& encoding() const
     {
+        if (!_textBuffer)
+        {
+            const_cast<XmlTokenizer&>(_tokenizer).readProlog();
+            return _tokenizer.encoding();
+        }
+
         if (_state == XmlReaderImpl::OnDocumentBegin::instance())
             const_cast<XmlReaderImpl*>(this)->readProlog();
         return _encoding;
@@ -1642,6 +1657,12 @@ class XmlReaderImpl
 
     bool standalone() const
     {
+        if (!_textBuffer)
+        {
+            const_cast<XmlTokenizer&>(_tokenizer).readProlog();
+            return _tokenizer.standalone();
+        }
+
         if (_state == XmlReaderImpl::OnDocumentBegin::instance())
             const_cast<XmlReaderImpl*>(this)->readProlog();
         return _standalone;
@@ -1659,16 +1680,28 @@ class XmlReaderImpl
 
     size_t depth() const
     {
+        if (!_textBuffer)
+            return _tokenizer.depth();
+
         return _depth;
     }
 
     std::size_t line() const
     {
+        if (!_textBuffer)
+            return _tokenizer.line();
+
         return _line;
     }
 
     Node& get()
     {
+        if (!_textBuffer)
+        {
+            Node* current = _tokenizer.current();
+            return current ? *current : *_tokenizer.next();
+        }
+
         if( ! _current )
         {
             this->next();
@@ -1679,6 +1712,9 @@ class XmlReaderImpl
 
     Node& next()
     {
+        if (!_textBuffer)
+            return *_tokenizer.next();
+
         _current = 0;
         do
         {
@@ -1706,6 +1742,9 @@ class XmlReaderImpl
 
     bool advance()
     {
+        if (!_textBuffer)
+            return _tokenizer.advance() != 0;
+
         _current = 0;
         while( ! _current && _textBuffer->in_avail() > 0 )
         {
@@ -1762,6 +1801,9 @@ class XmlReaderImpl
     Characters _chars;
     Attribute _attr;
     EndDocument _endDoc;
+
+    // parses utf-8 input, when no text buffer is set
+    XmlTokenizer _tokenizer;
 };
 
 
@@ -0,0 +1,759 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "xml/xmltokenizer.h"
+#include <cxxtools/xml/entityresolver.h>
+#include <cxxtools/xml/xmlerror.h>
+#include <cxxtools/utf8codec.h>
+#include <cxxtools/log.h>
+#include <sstream>
+
+log_define("cxxtools.xml.tokenizer")
+
+namespace cxxtools {
+
+namespace xml {
+
+namespace
+{
+    enum State
+    {
+        DocumentBegin,
+        DeclTag,
+        DeclPITarget,
+        XmlDeclBeforeAttr,
+        XmlDeclAttr,
+        XmlDeclAfterName,
+        XmlDeclBeforeValue,
+        XmlDeclValue,
+        XmlDeclEnd,
+        Misc,
+        Content,
+        EntityRef,
+        Tag,
+        TagExclam,
+        Keyword,
+        CommentStart,
+        Comment,
+        CommentDash,
+        CommentDashDash,
+        CData,
+        CDataBracket,
+        CDataBracket2,
+        DocType,
+        PITarget,
+        PIData,
+        PIQuest,
+        StartTagName,
+        BeforeAttribute,
+        AttributeName,
+        AfterAttributeName,
+        BeforeAttributeValue,
+        AttributeValue,
+        AttributeEntityRef,
+        EmptyElement,
+        EndTagStart,
+        EndTagName,
+        AfterEndTagName,
+        NumStates
+    };
+
+    enum CharClass
+    {
+        Other,
+        Space,
+        Lt,
+        Gt,
+        Slash,
+        Eq,
+        Quote,
+        Excl,
+        Quest,
+        Amp,
+        Minus,
+        LBracket,
+        RBracket,
+        Semicolon,
+        NumClasses
+    };
+
+    enum Action
+    {
+        Error,
+        // actions, which just collect bytes; transitions with these actions,
+        // which do not change the state are processed in bulk
+        Skip,
+        AppendName,
+        AppendValue,
+        AppendText,
+        AppendEntity,
+        // other actions
+        BeginStartTag,
+        BeginEndTag,
+        BeginPI,
+        BeginKeyword,
+        MatchKeyword,
+        EndComment,
+        CDataBracketOther,
+        CDataBracket2Other,
+        EmitDocType,
+        DeclTargetEnd,
+        PIQuestOther,
+        EmitPI,
+        BeginAttribute,
+        BeginValue,
+        EndDeclValue,
+        ElementName,
+        EmitStartElement,
+        EmitEmptyElement,
+        EmitEmptyEnd,
+        EndAttributeValue,
+        ResolveTextEntity,
+        ResolveValueEntity,
+        EmitEndElement
+    };
+
+    struct Transition
+    {
+        unsigned char state;
+        unsigned char action;
+    };
+
+    class TransitionTable
+    {
+            unsigned char _charClass[256];
+            Transition _transitions[NumStates][NumClasses];
+            unsigned char _plain[NumStates][256];
+
+            void on(State s, CharClass c, State next, Action a)
+            {
+                _transitions[s][c].state = next;
+                _transitions[s][c].action = a;
+            }
+
+            void onAll(State s, State next, Action a)
+            {
+                for (unsigned c = 0; c < NumClasses; ++c)
+                    on(s, static_cast<CharClass>(c), next, a);
+            }
+
+            void onName(State s, State next, Action a)
+            {
+                on(s, Other, next, a);
+                on(s, Minus, next, a);
+            }
+
+        public:
+            TransitionTable();
+
+            const Transition& transition(unsigned state, char ch) const
+            { return _transitions[state][_charClass[static_cast<unsigned char>(ch)]]; }
+
+            // Returns for each byte the collecting action, when the byte
+            // does not leave the state and 0 otherwise.
+            const unsigned char* plain(unsigned state) const
+            { return _plain[state]; }
+    };
+
+    TransitionTable::TransitionTable()
+    {
+        for (unsigned ch = 0; ch < 256; ++ch)
+            _charClass[ch] = Other;
+
+        _charClass[static_cast<unsigned char>(' ')] = Space;
+        _charClass[static_cast<unsigned char>('\t')] = Space;
+        _charClass[static_cast<unsigned char>('\r')] = Space;
+        _charClass[static_cast<unsigned char>('\n')] = Space;
+        _charClass[static_cast<unsigned char>('<')] = Lt;
+        _charClass[static_cast<unsigned char>('>')] = Gt;
+        _charClass[static_cast<unsigned char>('/')] = Slash;
+        _charClass[static_cast<unsigned char>('=')] = Eq;
+        _charClass[static_cast<unsigned char>('"')] = Quote;
+        _charClass[static_cast<unsigned char>('\'')] = Quote;
+        _charClass[static_cast<unsigned char>('!')] = Excl;
+        _charClass[static_cast<unsigned char>('?')] = Quest;
+        _charClass[static_cast<unsigned char>('&')] = Amp;
+        _charClass[static_cast<unsigned char>('-')] = Minus;
+        _charClass[static_cast<unsigned char>('[')] = LBracket;
+        _charClass[static_cast<unsigned char>(']')] = RBracket;
+        _charClass[static_cast<unsigned char>(';')] = Semicolon;
+
+        for (unsigned s = 0; s < NumStates; ++s)
+            onAll(static_cast<State>(s), static_cast<State>(s), Error);
+
+        // document begin and xml declaration
+        on(DocumentBegin, Space, Misc, Skip);
+        on(DocumentBegin, Lt, DeclTag, Skip);
+
+        onName(DeclTag, StartTagName, BeginStartTag);
+        on(DeclTag, Excl, TagExclam, Skip);
+        on(DeclTag, Quest, DeclPITarget, BeginPI);
+
+        onName(DeclPITarget, DeclPITarget, AppendName);
+        on(DeclPITarget, Space, PIData, DeclTargetEnd);
+        on(DeclPITarget, Quest, PIQuest, Skip);
+
+        on(XmlDeclBeforeAttr, Space, XmlDeclBeforeAttr, Skip);
+        onName(XmlDeclBeforeAttr, XmlDeclAttr, BeginAttribute);
+        on(XmlDeclBeforeAttr, Quest, XmlDeclEnd, Skip);
+
+        onName(XmlDeclAttr, XmlDeclAttr, AppendName);
+        on(XmlDeclAttr, Space, XmlDeclAfterName, Skip);
+        on(XmlDeclAttr, Eq, XmlDeclBeforeValue, Skip);
+
+        on(XmlDeclAfterName, Space, XmlDeclAfterName, Skip);
+        on(XmlDeclAfterName, Eq, XmlDeclBeforeValue, Skip);
+
+        on(XmlDeclBeforeValue, Space, XmlDeclBeforeValue, Skip);
+        on(XmlDeclBeforeValue, Quote, XmlDeclValue, BeginValue);
+
+        onAll(XmlDeclValue, XmlDeclValue, AppendValue);
+        on(XmlDeclValue, Quote, XmlDeclBeforeAttr, EndDeclValue);
+
+        on(XmlDeclEnd, Gt, Misc, Skip);
+
+        // outside of the root element
+        on(Misc, Space, Misc, Skip);
+        on(Misc, Lt, Tag, Skip);
+
+        // character data
+        onAll(Content, Content, AppendText);
+        on(Content, Lt, Tag, Skip);
+        on(Content, Amp, EntityRef, Skip);
+
+        onAll(EntityRef, EntityRef, AppendEntity);
+        on(EntityRef, Semicolon, Content, ResolveTextEntity);
+
+        // markup
+        onName(Tag, StartTagName, BeginStartTag);
+        on(Tag, Slash, EndTagStart, BeginEndTag);
+        on(Tag, Excl, TagExclam, Skip);
+        on(Tag, Quest, PITarget, BeginPI);
+
+        on(TagExclam, Minus, CommentStart, Skip);
+        on(TagExclam, LBracket, Keyword, BeginKeyword);
+        on(TagExclam, Other, Keyword, BeginKeyword);
+
+        onAll(Keyword, Keyword, MatchKeyword);
+
+        on(CommentStart, Minus, Comment, Skip);
+
+        onAll(Comment, Comment, Skip);
+        on(Comment, Minus, CommentDash, Skip);
+
+        onAll(CommentDash, Comment, Skip);
+        on(CommentDash, Minus, CommentDashDash, Skip);
+
+        on(CommentDashDash, Gt, Misc, EndComment);
+
+        onAll(CData, CData, AppendText);
+        on(CData, RBracket, CDataBracket, Skip);
+
+        onAll(CDataBracket, CData, CDataBracketOther);
+        on(CDataBracket, RBracket, CDataBracket2, Skip);
+
+        onAll(CDataBracket2, CData, CDataBracket2Other);
+        on(CDataBracket2, RBracket, CDataBracket2, AppendText);
+        on(CDataBracket2, Gt, Content, Skip);
+
+        onAll(DocType, DocType, AppendValue);
+        on(DocType, Gt, Misc, EmitDocType);
+
+        onName(PITarget, PITarget, AppendName);
+        on(PITarget, Space, PIData, Skip);
+        on(PITarget, Quest, PIQuest, Skip);
+
+        onAll(PIData, PIData, AppendValue);
+        on(PIData, Quest, PIQuest, Skip);
+
+        onAll(PIQuest, PIData, PIQuestOther);
+        on(PIQuest, Quest, PIQuest, AppendValue);
+        on(PIQuest, Gt, Misc, EmitPI);
+
+        // elements
+        onName(StartTagName, StartTagName, AppendName);
+        on(StartTagName, Space, BeforeAttribute, ElementName);
+        on(StartTagName, Gt, Content, EmitStartElement);
+        on(StartTagName, Slash, EmptyElement, EmitEmptyElement);
+
+        on(BeforeAttribute, Space, BeforeAttribute, Skip);
+        onName(BeforeAttribute, AttributeName, BeginAttribute);
+        on(BeforeAttribute, Gt, Content, EmitStartElement);
+        on(BeforeAttribute, Slash, EmptyElement, EmitEmptyElement);
+
+        onName(AttributeName, AttributeName, AppendName);
+        on(AttributeName, Space, AfterAttributeName, Skip);
+        on(AttributeName, Eq, BeforeAttributeValue, Skip);
+
+        on(AfterAttributeName, Space, AfterAttributeName, Skip);
+        on(AfterAttributeName, Eq, BeforeAttributeValue, Skip);
+
+        on(BeforeAttributeValue, Space, BeforeAttributeValue, Skip);
+        on(BeforeAttributeValue, Quote, AttributeValue, BeginValue);
+
+        onAll(AttributeValue, AttributeValue, AppendValue);
+        on(AttributeValue, Quote, BeforeAttribute, EndAttributeValue);
+        on(AttributeValue, Amp, AttributeEntityRef, Skip);
+
+        onAll(AttributeEntityRef, AttributeEntityRef, AppendEntity);
+        on(AttributeEntityRef, Semicolon, AttributeValue, ResolveValueEntity);
+
+        on(EmptyElement, Space, EmptyElement, Skip);
+        on(EmptyElement, Gt, Content, EmitEmptyEnd);
+
+        onName(EndTagStart, EndTagName, AppendName);
+
+        onName(EndTagName, EndTagName, AppendName);
+        on(EndTagName, Space, AfterEndTagName, Skip);
+        on(EndTagName, Gt, Content, EmitEndElement);
+
+        on(AfterEndTagName, Space, AfterEndTagName, Skip);
+        on(AfterEndTagName, Gt, Content, EmitEndElement);
+
+        // Line feeds are never plain, so that the main loop can count lines.
+        for (unsigned s = 0; s < NumStates; ++s)
+        {
+            for (unsigned ch = 0; ch < 256; ++ch)
+            {
+                const Transition& t = _transitions[s][_charClass[ch]];
+                _plain[s][ch] = ch != '\n'
+                             && t.state == s
+                             && t.action >= Skip
+                             && t.action <= AppendEntity ? t.action : 0;
+            }
+        }
+    }
+
+    const TransitionTable& transitionTable()
+    {
+        static const TransitionTable table;
+        return table;
+    }
+
+    // Converts utf-8 to unicode. Pure ascii is just widened.
+    void decode(String& s, const std::string& utf8)
+    {
+        for (std::string::const_iterator it = utf8.begin(); it != utf8.end(); ++it)
+        {
+            if (*it & 0x80)
+            {
+                s = Utf8Codec::decode(utf8);
+                return;
+            }
+        }
+
+        s.assign(utf8.data(), utf8.size());
+    }
+
+    bool inDeclaration(unsigned state)
+    {
+        return state <= XmlDeclEnd;
+    }
+}
+
+XmlTokenizer::XmlTokenizer(EntityResolver& resolver)
+: _sb(0)
+, _p(0)
+, _end(0)
+, _resolver(resolver)
+, _standalone(true)
+, _depth(0)
+, _line(1)
+, _state(DocumentBegin)
+, _current(0)
+, _quote('"')
+, _keyword("")
+, _keywordState(Misc)
+{
+}
+
+void XmlTokenizer::reset(std::streambuf* sb)
+{
+    if (_buffer.empty())
+        _buffer.resize(8192);
+
+    _sb = sb;
+    _p = _end = &_buffer[0];
+    _version.clear();
+    _encoding.clear();
+    _standalone = true;
+    _depth = 0;
+    _line = 1;
+    _state = DocumentBegin;
+    _current = 0;
+    _name.clear();
+    _value.clear();
+    _text.clear();
+    _entity.clear();
+}
+
+Node* XmlTokenizer::next()
+{
+    _current = 0;
+    do
+    {
+        if (_p == _end && !fill(true))
+        {
+            log_finer("eof");
+            onEof();
+            break;
+        }
+
+        process(_end);
+    }
+    while (!_current);
+
+    return _current;
+}
+
+Node* XmlTokenizer::advance()
+{
+    _current = 0;
+    while (!_current && (_p < _end || fill(false)))
+        process(_end);
+
+    return _current;
+}
+
+void XmlTokenizer::readProlog()
+{
+    while (inDeclaration(_state))
+    {
+        if (_p == _end && !fill(true))
+        {
+            onEof();
+            break;
+        }
+
+        process(_p + 1);
+    }
+}
+
+bool XmlTokenizer::fill(bool block)
+{
+    std::streamsize n = _sb->in_avail();
+    if (n <= 0)
+    {
+        if (!block || _sb->sgetc() == std::streambuf::traits_type::eof())
+            return false;
+
+        n = _sb->in_avail();
+        if (n <= 0)
+            n = 1;
+    }
+
+    if (n > static_cast<std::streamsize>(_buffer.size()))
+        n = _buffer.size();
+
+    n = _sb->sgetn(&_buffer[0], n);
+    log_finer(n << " bytes read");
+
+    _p = &_buffer[0];
+    _end = _p + n;
+    return n > 0;
+}
+
+void XmlTokenizer::process(const char* end)
+{
+    const TransitionTable& table = transitionTable();
+
+    while (_p < end)
+    {
+        const unsigned char* plain = table.plain(_state);
+        unsigned char a = plain[static_cast<unsigned char>(*_p)];
+        if (a)
+        {
+            const char* q = _p + 1;
+            while (q < end && plain[static_cast<unsigned char>(*q)] == a)
+                ++q;
+
+            switch (a)
+            {
+                case AppendName:   _name.append(_p, q); break;
+                case AppendValue:  _value.append(_p, q); break;
+                case AppendText:   _text.append(_p, q); break;
+                case AppendEntity: _entity.append(_p, q); break;
+            }
+
+            _p = q;
+            if (_p == end)
+                break;
+        }
+
+        char ch = *_p++;
+        const Transition& t = table.transition(_state, ch);
+        _state = t.state;
+        if (t.action != Skip)
+            action(t.action, ch);
+
+        if (ch == '\n')
+            ++_line;
+
+        if (_current)
+            break;
+    }
+}
+
+void XmlTokenizer::action(unsigned char a, char ch)
+{
+    switch (a)
+    {
+        case Error:
+        {
+            std::ostringstream msg;
+            msg << "unexpected char '" << ch << '\'';
+            syntaxError(msg.str());
+            break;
+        }
+
+        case AppendName:
+            _name += ch;
+            break;
+
+        case AppendValue:
+            _value += ch;
+            break;
+
+        case AppendText:
+            _text += ch;
+            break;
+
+        case AppendEntity:
+            _entity += ch;
+            break;
+
+        case BeginStartTag:
+            flushCharacters();
+            _startElem.clear();
+            _name.assign(1, ch);
+            break;
+
+        case BeginEndTag:
+            flushCharacters();
+            _name.clear();
+            break;
+
+        case BeginPI:
+            _name.clear();
+            _value.clear();
+            break;
+
+        case BeginKeyword:
+            if (ch == '[' && _depth > 0)
+            {
+                _keyword = "CDATA[";
+                _keywordState = CData;
+            }
+            else if (ch == 'D' && _depth == 0)
+            {
+                _keyword = "OCTYPE";
+                _keywordState = DocType;
+                _value = "DOCTYPE";
+            }
+            else
+                syntaxError(_depth > 0 ? "CDATA expected" : "DOCTYPE expected");
+            break;
+
+        case MatchKeyword:
+            if (ch != *_keyword)
+                syntaxError(_keywordState == CData ? "CDATA expected" : "DOCTYPE expected");
+            if (*++_keyword == '\0')
+                _state = _keywordState;
+            break;
+
+        case EndComment:
+            afterMarkup();
+            break;
+
+        case CDataBracketOther:
+            _text += ']';
+            _text += ch;
+            break;
+
+        case CDataBracket2Other:
+            _text += "]]";
+            _text += ch;
+            break;
+
+        case EmitDocType:
+            _docType.clear();
+            decode(_docType.content(), _value);
+            _current = &_docType;
+            break;
+
+        case DeclTargetEnd:
+            if (_name == "xml")
+                _state = XmlDeclBeforeAttr;
+            break;
+
+        case PIQuestOther:
+            _value += '?';
+            _value += ch;
+            break;
+
+        case EmitPI:
+            _procInstr.clear();
+            decode(_procInstr.target(), _name);
+            decode(_procInstr.data(), _value);
+            _current = &_procInstr;
+            afterMarkup();
+            break;
+
+        case BeginAttribute:
+            _name.assign(1, ch);
+            break;
+
+        case BeginValue:
+            _quote = ch;
+            _value.clear();
+            break;
+
+        case EndDeclValue:
+            if (ch != _quote)
+            {
+                _value += ch;
+                _state = XmlDeclValue;
+            }
+            else if (_name == "version")
+                decode(_version, _value);
+            else if (_name == "encoding")
+                decode(_encoding, _value);
+            else if (_name == "standalone")
+                _standalone = _value != "no";
+            break;
+
+        case ElementName:
+            setElementName();
+            break;
+
+        case EmitStartElement:
+        case EmitEmptyElement:
+            setElementName();
+            _current = &_startElem;
+            ++_depth;
+            break;
+
+        case EmitEmptyEnd:
+            _endElem.name() = _startElem.name();
+            _current = &_endElem;
+            --_depth;
+            afterMarkup();
+            break;
+
+        case EndAttributeValue:
+            if (ch != _quote)
+            {
+                _value += ch;
+                _state = AttributeValue;
+            }
+            else
+            {
+                decode(_attr.name(), _name);
+                decode(_attr.value(), _value);
+                _startElem.addAttribute(_attr);
+            }
+            break;
+
+        case ResolveTextEntity:
+            resolveEntity(_text);
+            break;
+
+        case ResolveValueEntity:
+            resolveEntity(_value);
+            break;
+
+        case EmitEndElement:
+            if (_depth == 0)
+                syntaxError("unexpected end element");
+            _endElem.clear();
+            decode(_endElem.name(), _name);
+            _current = &_endElem;
+            --_depth;
+            afterMarkup();
+            break;
+    }
+}
+
+void XmlTokenizer::onEof()
+{
+    if (_state != Misc)
+        syntaxError("unexpected end of file");
+
+    _current = &_endDoc;
+}
+
+void XmlTokenizer::flushCharacters()
+{
+    if (!_text.empty())
+    {
+        String&& content = _chars.content();
+        decode(content, _text);
+        _text.clear();
+        _current = &_chars;
+    }
+}
+
+void XmlTokenizer::resolveEntity(std::string& target)
+{
+    String entity;
+    decode(entity, _entity);
+
+    try
+    {
+        target += Utf8Codec::encode(_resolver.resolveEntity(entity));
+    }
+    catch (const std::exception&)
+    {
+        throw XmlError("invalid entity " + _entity, _line);
+    }
+
+    _entity.clear();
+}
+
+void XmlTokenizer::setElementName()
+{
+    if (_startElem.name().empty())
+        decode(_startElem.name(), _name);
+}
+
+void XmlTokenizer::afterMarkup()
+{
+    _state = _depth > 0 ? Content : Misc;
+}
+
+void XmlTokenizer::syntaxError(const std::string& msg) const
+{
+    std::ostringstream s;
+    s << msg << " while parsing xml in line " << _line;
+    log_warn(s.str());
+    throw XmlError(s.str(), _line);
+}
+
+} // namespace xml
+
+} // namespace cxxtools
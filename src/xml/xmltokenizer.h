@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef cxxtools_Xml_XmlTokenizer_h
+#define cxxtools_Xml_XmlTokenizer_h
+
+#include <cxxtools/string.h>
+#include <cxxtools/xml/doctypedeclaration.h>
+#include <cxxtools/xml/processinginstruction.h>
+#include <cxxtools/xml/startelement.h>
+#include <cxxtools/xml/endelement.h>
+#include <cxxtools/xml/characters.h>
+#include <cxxtools/xml/enddocument.h>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace cxxtools {
+
+namespace xml {
+
+class EntityResolver;
+
+/** @brief Byte oriented xml tokenizer used by XmlReader for utf-8 input.
+
+    The tokenizer reads chunks of bytes from a stream buffer and feeds
+    them through a table of state transitions indexed by state and
+    character class. Runs of bytes, which do not change the state, like
+    character data or attribute values, are appended in bulk. Names and
+    content are collected as utf-8 and decoded once, when a node is
+    complete.
+ */
+class XmlTokenizer
+{
+        XmlTokenizer(const XmlTokenizer&) = delete;
+        XmlTokenizer& operator=(const XmlTokenizer&) = delete;
+
+    public:
+        explicit XmlTokenizer(EntityResolver& resolver);
+
+        void reset(std::streambuf* sb);
+
+        /// Parses the next node. Blocks until the node is complete.
+        Node* next();
+
+        /// Parses the next node from the data available without blocking.
+        /// Returns 0, if more data is needed.
+        Node* advance();
+
+        /// Parses the xml declaration if not done yet.
+        void readProlog();
+
+        Node* current() const
+        { return _current; }
+
+        const String& version() const
+        { return _version; }
+
+        const String& encoding() const
+        { return _encoding; }
+
+        bool standalone() const
+        { return _standalone; }
+
+        size_t depth() const
+        { return _depth; }
+
+        std::size_t line() const
+        { return _line; }
+
+    private:
+        bool fill(bool block);
+        void process(const char* end);
+        void action(unsigned char a, char ch);
+        void onEof();
+
+        void flushCharacters();
+        void resolveEntity(std::string& target);
+        void setElementName();
+        void afterMarkup();
+        void syntaxError(const std::string& msg) const;
+
+        std::streambuf* _sb;
+        std::vector<char> _buffer;
+        const char* _p;
+        const char* _end;
+
+        EntityResolver& _resolver;
+
+        String _version;
+        String _encoding;
+        bool _standalone;
+        size_t _depth;
+        std::size_t _line;
+
+        unsigned char _state;
+        Node* _current;
+
+        std::string _name;
+        std::string _value;
+        std::string _text;
+        std::string _entity;
+        char _quote;
+        const char* _keyword;
+        unsigned char _keywordState;
+        Attribute _attr;
+
+        DocTypeDeclaration _docType;
+        ProcessingInstruction _procInstr;
+        StartElement _startElem;
+        EndElement _endElem;
+        Characters _chars;
+        EndDocument _endDoc;
+};
+
+}
+
+}
+
+#endif
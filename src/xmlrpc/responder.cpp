@@ -122,6 +122,17 @@ std::size_t XmlRpcResponder::readBody(std::istream& /*is*/)
 }
 
 
+bool XmlRpcResponder::prepareReply(http::Request& /*request*/, const std::function<void()>& ready)
+{
+    // invalid requests are reported by reply
+    if (!_proc || !_proc->isAsync() || (_args && *(_args + 1)))
+        return false;
+
+    _proc->startCall(ready);
+    return true;
+}
+
+
 void XmlRpcResponder::replyError(std::ostream& os, http::Request& /*request*/,
                                      http::Reply& reply, const std::exception& ex)
 {
@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include "cxxtools/net/addrinfo.h"
+#include "cxxtools/net/tcpserver.h"
+#include "cxxtools/net/tcpsocket.h"
+#include "cxxtools/selector.h"
+#include "cxxtools/ioerror.h"
+#include <sstream>
+#include <stdlib.h>
+
+class AddrInfoTest : public cxxtools::unit::TestSuite
+{
+        unsigned short _port;
+        bool _connected;
+        bool _failed;
+
+    public:
+        AddrInfoTest()
+            : cxxtools::unit::TestSuite("addrinfo"),
+              _port(8001),
+              _connected(false),
+              _failed(false)
+        {
+            registerMethod("Lazy", *this, &AddrInfoTest::Lazy);
+            registerMethod("Cache", *this, &AddrInfoTest::Cache);
+            registerMethod("CacheDisabled", *this, &AddrInfoTest::CacheDisabled);
+            registerMethod("AsyncConnect", *this, &AddrInfoTest::AsyncConnect);
+            registerMethod("AsyncConnectFailed", *this, &AddrInfoTest::AsyncConnectFailed);
+            registerMethod("UnknownHost", *this, &AddrInfoTest::UnknownHost);
+            registerMethod("AsyncConnectUnknownHost", *this, &AddrInfoTest::AsyncConnectUnknownHost);
+
+            char* PORT = getenv("UTEST_PORT");
+            if (PORT)
+            {
+                std::istringstream s(PORT);
+                s >> _port;
+            }
+        }
+
+        void setUp()
+        {
+            cxxtools::net::AddrInfo::clearCache();
+            _connected = false;
+            _failed = false;
+        }
+
+        void Lazy()
+        {
+            cxxtools::net::AddrInfo ai("localhost", _port);
+            CXXTOOLS_UNIT_ASSERT(!ai.resolved());
+
+            ai.resolve();
+            CXXTOOLS_UNIT_ASSERT(ai.resolved());
+        }
+
+        void Cache()
+        {
+            cxxtools::net::AddrInfo ai("localhost", _port);
+            ai.resolve();
+
+            cxxtools::net::AddrInfo ai2("localhost", _port);
+            CXXTOOLS_UNIT_ASSERT(ai2.resolved());
+
+            cxxtools::net::AddrInfo::clearCache();
+            cxxtools::net::AddrInfo ai3("localhost", _port);
+            CXXTOOLS_UNIT_ASSERT(!ai3.resolved());
+        }
+
+        void CacheDisabled()
+        {
+            cxxtools::Milliseconds ttl = cxxtools::net::AddrInfo::cacheTtl();
+            cxxtools::net::AddrInfo::cacheTtl(0);
+
+            cxxtools::net::AddrInfo ai("localhost", _port);
+            ai.resolve();
+
+            cxxtools::net::AddrInfo ai2("localhost", _port);
+            bool resolved = ai2.resolved();
+
+            cxxtools::net::AddrInfo::cacheTtl(ttl);
+
+            CXXTOOLS_UNIT_ASSERT(!resolved);
+        }
+
+        void AsyncConnect()
+        {
+            cxxtools::net::TcpServer server("", _port);
+
+            cxxtools::Selector selector;
+            cxxtools::net::TcpSocket client;
+            selector.add(client);
+            connect(client.connected, *this, &AddrInfoTest::onConnected);
+
+            // the name is resolved in a resolver thread
+            CXXTOOLS_UNIT_ASSERT(!client.beginConnect(cxxtools::net::AddrInfo("localhost", _port)));
+
+            for (unsigned n = 0; n < 10 && !_connected && !_failed; ++n)
+                selector.wait(1000);
+
+            CXXTOOLS_UNIT_ASSERT(_connected);
+            CXXTOOLS_UNIT_ASSERT(client.isConnected());
+        }
+
+        void AsyncConnectFailed()
+        {
+            cxxtools::Selector selector;
+            cxxtools::net::TcpSocket client;
+            selector.add(client);
+            connect(client.connected, *this, &AddrInfoTest::onConnected);
+
+            client.beginConnect(cxxtools::net::AddrInfo("localhost", _port + 1));
+
+            for (unsigned n = 0; n < 10 && !_connected && !_failed; ++n)
+                selector.wait(1000);
+
+            CXXTOOLS_UNIT_ASSERT(_failed);
+        }
+
+        void UnknownHost()
+        {
+            // the constructor does not resolve, so the error is reported on
+            // first use; a space makes the name invalid without asking a dns server
+            cxxtools::net::AddrInfo ai("no such host", _port);
+            CXXTOOLS_UNIT_ASSERT(!ai.resolved());
+            CXXTOOLS_UNIT_ASSERT_THROW(ai.resolve(), cxxtools::net::AddrInfoError);
+
+            cxxtools::net::TcpSocket client;
+            CXXTOOLS_UNIT_ASSERT_THROW(client.connect(cxxtools::net::AddrInfo("no such host", _port)),
+                                       cxxtools::net::AddrInfoError);
+        }
+
+        void AsyncConnectUnknownHost()
+        {
+            cxxtools::Selector selector;
+            cxxtools::net::TcpSocket client;
+            selector.add(client);
+            connect(client.connected, *this, &AddrInfoTest::onConnected);
+
+            client.beginConnect(cxxtools::net::AddrInfo("no such host", _port));
+
+            for (unsigned n = 0; n < 10 && !_connected && !_failed; ++n)
+                selector.wait(1000);
+
+            CXXTOOLS_UNIT_ASSERT(_failed);
+            CXXTOOLS_UNIT_ASSERT(!_connected);
+        }
+
+        void onConnected(cxxtools::net::TcpSocket& socket)
+        {
+            try
+            {
+                socket.endConnect();
+                _connected = true;
+            }
+            catch (const cxxtools::IOError&)
+            {
+                _failed = true;
+            }
+        }
+};
+
+cxxtools::unit::RegisterTest<AddrInfoTest> register_AddrInfoTest;
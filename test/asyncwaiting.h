@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef CXXTOOLS_ASYNCWAITING_H
+#define CXXTOOLS_ASYNCWAITING_H
+
+#include <cxxtools/asyncserviceprocedure.h>
+#include <cxxtools/remoteprocedure.h>
+#include <cxxtools/connectable.h>
+#include <cxxtools/unit/assertion.h>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Asynchronous procedure for the rpc tests. The calls wait until the test
+// releases them, so that they overlap as long as the test needs it.
+class AsyncWaiting : public cxxtools::Connectable
+{
+        std::mutex _mutex;
+        std::vector<std::pair<cxxtools::AsyncResult<int>, int> > _waiting;
+
+    public:
+        // results of finished calls in the order they arrived at the client
+        std::vector<int> finished;
+
+        // the procedure; the result is value multiplied by the factor passed
+        // to release
+        void wait(cxxtools::AsyncResult<int> result, int value)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _waiting.push_back(std::make_pair(result, value));
+        }
+
+        unsigned count()
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _waiting.size();
+        }
+
+        // passes the results of all waiting calls; returns false, when no
+        // call is waiting
+        bool release(int factor)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_waiting.empty())
+                return false;
+
+            for (unsigned n = 0; n < _waiting.size(); ++n)
+                _waiting[n].first.set(_waiting[n].second * factor);
+            _waiting.clear();
+            return true;
+        }
+
+        // passes the result of the call with the value
+        bool releaseValue(int value, int factor)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            for (unsigned n = 0; n < _waiting.size(); ++n)
+            {
+                if (_waiting[n].second == value)
+                {
+                    _waiting[n].first.set(value * factor);
+                    _waiting.erase(_waiting.begin() + n);
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        // slot for the finished signal of the remote procedures
+        void onFinished(cxxtools::RemoteResult<int>& result)
+        {
+            finished.push_back(result.value());
+        }
+
+        // calls the procedure release until a waiting call has arrived at
+        // the server
+        static void callRelease(cxxtools::RemoteProcedure<bool, int>& release, int factor)
+        {
+            for (int n = 0; n < 100; ++n)
+            {
+                release.begin(factor);
+                if (release.end(2000))
+                    return;
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+
+            CXXTOOLS_UNIT_ASSERT_MSG(false, "asynchronous procedure not called");
+        }
+};
+
+#endif // CXXTOOLS_ASYNCWAITING_H
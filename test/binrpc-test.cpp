@@ -36,9 +36,13 @@
 #include "cxxtools/ioerror.h"
 #include "cxxtools/net/uri.h"
 #include "cxxtools/net/addrinfo.h"
+#include "cxxtools/net/tcpserver.h"
+#include "cxxtools/net/tcpstream.h"
 #include <stdlib.h>
 #include <sstream>
+#include <thread>
 
+#include "asyncwaiting.h"
 #include "color.h"
 
 log_define("cxxtools.test.binrpc")
@@ -60,6 +64,9 @@ class BinRpcTest : public cxxtools::unit::TestSuite
         std::string _listen;
         unsigned short _port;
 
+        // procedures waiting for "release"
+        AsyncWaiting _waiting;
+
     public:
         BinRpcTest()
         : cxxtools::unit::TestSuite("binrpc"),
@@ -89,6 +96,19 @@ class BinRpcTest : public cxxtools::unit::TestSuite
             registerMethod("PrepareConnect", *this, &BinRpcTest::PrepareConnect);
             registerMethod("Connect", *this, &BinRpcTest::Connect);
             registerMethod("Multiple", *this, &BinRpcTest::Multiple);
+            registerMethod("EventLoops", *this, &BinRpcTest::EventLoops);
+            registerMethod("Multiplex", *this, &BinRpcTest::Multiplex);
+            registerMethod("MultiplexFault", *this, &BinRpcTest::MultiplexFault);
+            registerMethod("MultiplexCancel", *this, &BinRpcTest::MultiplexCancel);
+            registerMethod("OutOfOrder", *this, &BinRpcTest::OutOfOrder);
+            registerMethod("Async", *this, &BinRpcTest::Async);
+            registerMethod("AsyncOverlap", *this, &BinRpcTest::AsyncOverlap);
+            registerMethod("AsyncFault", *this, &BinRpcTest::AsyncFault);
+            registerMethod("AsyncTerminate", *this, &BinRpcTest::AsyncTerminate);
+            registerMethod("Dictionary", *this, &BinRpcTest::Dictionary);
+            registerMethod("DictionaryFull", *this, &BinRpcTest::DictionaryFull);
+            registerMethod("DictionaryDeclined", *this, &BinRpcTest::DictionaryDeclined);
+            registerMethod("DictionaryReconnect", *this, &BinRpcTest::DictionaryReconnect);
 
             char* PORT = getenv("UTEST_PORT");
             if (PORT)
@@ -804,6 +824,410 @@ class BinRpcTest : public cxxtools::unit::TestSuite
 
         }
 
+        ////////////////////////////////////////////////////////////
+        // EventLoops
+        //
+        void EventLoops()
+        {
+            _server->eventLoops(2);
+            _server->registerMethod("multiply", *this, &BinRpcTest::multiplyInt);
+
+            typedef cxxtools::RemoteProcedure<int, int, int> Multiply;
+
+            std::vector<cxxtools::bin::RpcClient> clients;
+            std::vector<Multiply> procs;
+
+            clients.reserve(4);
+            procs.reserve(4);
+
+            for (unsigned i = 0; i < 4; ++i)
+            {
+                clients.push_back(cxxtools::bin::RpcClient(_loop, _listen, _port));
+                procs.push_back(Multiply(clients.back(), "multiply"));
+            }
+
+            // the second round is served from connections, which were idle
+            // in one of the event loops of the server
+            for (int round = 0; round < 3; ++round)
+            {
+                for (unsigned i = 0; i < 4; ++i)
+                    procs[i].begin(i, round);
+
+                for (unsigned i = 0; i < 4; ++i)
+                    CXXTOOLS_UNIT_ASSERT_EQUALS(procs[i].end(2000), static_cast<int>(i) * round);
+            }
+        }
+
+        ////////////////////////////////////////////////////////////
+        // Multiplex
+        //
+        void Multiplex()
+        {
+            _server->registerMethod("multiply", *this, &BinRpcTest::multiplyInt);
+
+            typedef cxxtools::RemoteProcedure<int, int, int> Multiply;
+
+            cxxtools::bin::RpcClient client(_loop, _listen, _port);
+            std::vector<Multiply> procs;
+            procs.reserve(100);
+
+            // all calls run at the same time on one connection
+            for (int round = 0; round < 2; ++round)
+            {
+                procs.clear();
+                for (int i = 0; i < 100; ++i)
+                {
+                    procs.push_back(Multiply(client, "multiply"));
+                    procs.back().begin(i, round + 2);
+                }
+
+                for (int i = 0; i < 100; ++i)
+                    CXXTOOLS_UNIT_ASSERT_EQUALS(procs[i].end(2000), i * (round + 2));
+            }
+        }
+
+        ////////////////////////////////////////////////////////////
+        // MultiplexFault
+        //
+        void MultiplexFault()
+        {
+            _server->registerMethod("multiply", *this, &BinRpcTest::multiplyInt);
+            _server->registerMethod("fault", *this, &BinRpcTest::throwFault);
+
+            cxxtools::bin::RpcClient client(_loop, _listen, _port);
+            cxxtools::RemoteProcedure<int, int, int> multiply1(client, "multiply");
+            cxxtools::RemoteProcedure<bool> fault(client, "fault");
+            cxxtools::RemoteProcedure<int, int, int> multiply2(client, "multiply");
+
+            multiply1.begin(2, 3);
+            fault.begin();
+            multiply2.begin(4, 5);
+
+            // a fault finishes just the failed call
+            CXXTOOLS_UNIT_ASSERT_EQUALS(multiply1.end(2000), 6);
+            CXXTOOLS_UNIT_ASSERT_THROW(fault.end(2000), cxxtools::RemoteException);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(multiply2.end(2000), 20);
+        }
+
+        ////////////////////////////////////////////////////////////
+        // MultiplexCancel
+        //
+        void MultiplexCancel()
+        {
+            _server->registerMethod("multiply", *this, &BinRpcTest::multiplyInt);
+
+            cxxtools::bin::RpcClient client(_loop, _listen, _port);
+            cxxtools::RemoteProcedure<int, int, int> multiply1(client, "multiply");
+            cxxtools::RemoteProcedure<int, int, int> multiply2(client, "multiply");
+
+            {
+                cxxtools::RemoteProcedure<int, int, int> cancelled(client, "multiply");
+                multiply1.begin(2, 3);
+                cancelled.begin(3, 4);
+                multiply2.begin(4, 5);
+            }
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(multiply1.end(2000), 6);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(multiply2.end(2000), 20);
+
+            // the connection is still usable
+            multiply1.begin(5, 6);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(multiply1.end(2000), 30);
+        }
+
+        ////////////////////////////////////////////////////////////
+        // OutOfOrder
+        //
+        static void readRequest(std::istream& in)
+        {
+            // requests without parameters end with the first 0xff
+            char ch;
+            while (in.get(ch) && ch != '\xff')
+                ;
+        }
+
+        static void replyOutOfOrder(cxxtools::net::TcpServer& server)
+        {
+            cxxtools::net::TcpStream conn(server);
+
+            // first request is untagged, second has request id 1
+            readRequest(conn);
+            readRequest(conn);
+
+            static const char reply[] =
+                "\xc4\x00\x00\x00\x01" "\xc2\x00\x00\x00\x02" "second\0\xff"
+                "\xc2\x00\x00\x00\x01" "first\0\xff";
+
+            conn.write(reply, sizeof(reply) - 1);
+            conn.flush();
+
+            char ch;
+            conn.get(ch);
+        }
+
+        void OutOfOrder()
+        {
+            cxxtools::net::TcpServer server(_listen, _port + 2);
+            std::thread thread(replyOutOfOrder, std::ref(server));
+
+            cxxtools::bin::RpcClient client(_loop, _listen, _port + 2);
+            cxxtools::RemoteProcedure<bool> first(client, "first");
+            cxxtools::RemoteProcedure<bool> second(client, "second");
+
+            first.begin();
+            second.begin();
+
+            try
+            {
+                first.end(2000);
+                CXXTOOLS_UNIT_ASSERT_MSG(false, "cxxtools::RemoteException exception expected");
+            }
+            catch (const cxxtools::RemoteException& e)
+            {
+                CXXTOOLS_UNIT_ASSERT_EQUALS(e.rc(), 1);
+                CXXTOOLS_UNIT_ASSERT_EQUALS(e.text(), "first");
+            }
+
+            try
+            {
+                second.end(2000);
+                CXXTOOLS_UNIT_ASSERT_MSG(false, "cxxtools::RemoteException exception expected");
+            }
+            catch (const cxxtools::RemoteException& e)
+            {
+                CXXTOOLS_UNIT_ASSERT_EQUALS(e.rc(), 2);
+                CXXTOOLS_UNIT_ASSERT_EQUALS(e.text(), "second");
+            }
+
+            client.close();
+            thread.join();
+        }
+
+        ////////////////////////////////////////////////////////////
+        // Async
+        //
+        void Async()
+        {
+            // one of the workers blocks in accept, so the other one must not
+            // be blocked by the waiting procedure
+            _server->maxThreads(2);
+            _server->registerAsyncMethod("wait", _waiting, &AsyncWaiting::wait);
+            _server->registerMethod("release", _waiting, &AsyncWaiting::release);
+
+            cxxtools::bin::RpcClient client1(_loop, _listen, _port);
+            cxxtools::bin::RpcClient client2(_loop, _listen, _port);
+            cxxtools::RemoteProcedure<int, int> wait(client1, "wait");
+            cxxtools::RemoteProcedure<bool, int> release(client2, "release");
+
+            wait.begin(21);
+            AsyncWaiting::callRelease(release, 2);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(wait.end(2000), 42);
+
+            // the connection is usable after the asynchronous call
+            wait.begin(5);
+            AsyncWaiting::callRelease(release, 3);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(wait.end(2000), 15);
+        }
+
+        ////////////////////////////////////////////////////////////
+        // AsyncOverlap
+        //
+        void AsyncOverlap()
+        {
+            _server->registerAsyncMethod("wait", _waiting, &AsyncWaiting::wait);
+
+            cxxtools::bin::RpcClient client(_loop, _listen, _port);
+            cxxtools::RemoteProcedure<int, int> wait1(client, "wait");
+            cxxtools::RemoteProcedure<int, int> wait2(client, "wait");
+            connect(wait1.finished, _waiting, &AsyncWaiting::onFinished);
+            connect(wait2.finished, _waiting, &AsyncWaiting::onFinished);
+            _waiting.finished.clear();
+
+            // both calls run at the same time on one connection
+            wait1.begin(2);
+            wait2.begin(3);
+
+            for (int n = 0; n < 200 && _waiting.count() < 2; ++n)
+                _loop.wait(10);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_waiting.count(), 2u);
+
+            // the second call finishes first
+            _waiting.releaseValue(3, 10);
+
+            for (int n = 0; n < 200 && _waiting.finished.empty(); ++n)
+                _loop.wait(10);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_waiting.finished.size(), 1u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_waiting.finished[0], 30);
+
+            _waiting.releaseValue(2, 10);
+            client.wait(2000);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_waiting.finished.size(), 2u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_waiting.finished[1], 20);
+        }
+
+        ////////////////////////////////////////////////////////////
+        // AsyncFault
+        //
+        void AsyncFault()
+        {
+            _server->registerAsyncMethod("fault", *this, &BinRpcTest::asyncFault);
+            _server->registerMethod("multiply", *this, &BinRpcTest::multiplyInt);
+
+            cxxtools::bin::RpcClient client(_loop, _listen, _port);
+            cxxtools::RemoteProcedure<int, int> fault(client, "fault");
+            cxxtools::RemoteProcedure<int, int, int> multiply(client, "multiply");
+
+            fault.begin(7);
+
+            try
+            {
+                fault.end(2000);
+                CXXTOOLS_UNIT_ASSERT_MSG(false, "cxxtools::RemoteException exception expected");
+            }
+            catch (const cxxtools::RemoteException& e)
+            {
+                CXXTOOLS_UNIT_ASSERT_EQUALS(e.rc(), 7);
+                CXXTOOLS_UNIT_ASSERT_EQUALS(e.text(), "async fault");
+            }
+
+            multiply.begin(2, 3);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(multiply.end(2000), 6);
+        }
+
+        void asyncFault(cxxtools::AsyncResult<int> result, int rc)
+        {
+            result.setError(cxxtools::RemoteException("async fault", rc));
+        }
+
+        ////////////////////////////////////////////////////////////
+        // AsyncTerminate
+        //
+        void AsyncTerminate()
+        {
+            _server->registerAsyncMethod("wait", _waiting, &AsyncWaiting::wait);
+
+            {
+                cxxtools::bin::RpcClient client(_loop, _listen, _port);
+                cxxtools::RemoteProcedure<int, int> wait(client, "wait");
+
+                wait.begin(1);
+
+                for (int n = 0; n < 200 && _waiting.count() == 0; ++n)
+                    _loop.wait(10);
+
+                CXXTOOLS_UNIT_ASSERT(_waiting.count() > 0);
+
+                // the server is stopped while the procedure is running
+                delete _server;
+                _server = 0;
+            }
+
+            // passing the result later must not access the deleted server
+            _waiting.release(2);
+        }
+
+        ////////////////////////////////////////////////////////////
+        // Dictionary
+        //
+        void dictionaryCalls(cxxtools::bin::RpcClient& client)
+        {
+            typedef cxxtools::RemoteProcedure<Color, Color, Color> Multiply;
+
+            std::vector<Multiply> procs;
+            procs.reserve(10);
+
+            for (int round = 0; round < 3; ++round)
+            {
+                procs.clear();
+                for (int i = 0; i < 10; ++i)
+                {
+                    Color a;
+                    a.red = i;
+                    a.green = round;
+                    a.blue = 2;
+
+                    Color b;
+                    b.red = 2;
+                    b.green = 3;
+                    b.blue = i;
+
+                    procs.push_back(Multiply(client, "multiply"));
+                    procs.back().begin(a, b);
+                }
+
+                for (int i = 0; i < 10; ++i)
+                {
+                    Color r = procs[i].end(2000);
+                    CXXTOOLS_UNIT_ASSERT_EQUALS(r.red, i * 2);
+                    CXXTOOLS_UNIT_ASSERT_EQUALS(r.green, round * 3);
+                    CXXTOOLS_UNIT_ASSERT_EQUALS(r.blue, i * 2);
+                }
+            }
+        }
+
+        void Dictionary()
+        {
+            _server->registerMethod("multiply", *this, &BinRpcTest::multiplyColor);
+
+            cxxtools::bin::RpcClient client(_loop, _listen, _port);
+            client.dictionarySize(100);
+
+            dictionaryCalls(client);
+        }
+
+        void DictionaryFull()
+        {
+            _server->registerMethod("multiply", *this, &BinRpcTest::multiplyColor);
+
+            // the type and member names do not fit into the dictionary
+            cxxtools::bin::RpcClient client(_loop, _listen, _port);
+            client.dictionarySize(2);
+
+            dictionaryCalls(client);
+        }
+
+        void DictionaryDeclined()
+        {
+            _server->registerMethod("multiply", *this, &BinRpcTest::multiplyColor);
+            _server->dictionarySize(0);
+
+            cxxtools::bin::RpcClient client(_loop, _listen, _port);
+            client.dictionarySize(100);
+
+            dictionaryCalls(client);
+        }
+
+        void DictionaryReconnect()
+        {
+            _server->registerMethod("multiply", *this, &BinRpcTest::multiplyColor);
+
+            cxxtools::bin::RpcClient client(_loop, _listen, _port);
+            client.dictionarySize(100);
+            cxxtools::RemoteProcedure<Color, Color, Color> multiply(client, "multiply");
+
+            Color a;
+            a.red = 2;
+            a.green = 3;
+            a.blue = 4;
+
+            for (int n = 0; n < 3; ++n)
+            {
+                multiply.begin(a, a);
+                Color r = multiply.end(2000);
+                CXXTOOLS_UNIT_ASSERT_EQUALS(r.green, 9);
+
+                multiply.begin(a, a);
+                r = multiply.end(2000);
+                CXXTOOLS_UNIT_ASSERT_EQUALS(r.blue, 16);
+
+                // a new connection starts with an empty dictionary
+                client.close();
+            }
+        }
+
 };
 
 cxxtools::unit::RegisterTest<BinRpcTest> register_BinRpcTest;
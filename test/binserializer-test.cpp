@@ -159,6 +159,7 @@ class BinSerializerTest : public cxxtools::unit::TestSuite
             registerMethod("testDatetime", *this, &BinSerializerTest::testDatetime);
             registerMethod("testTimespan", *this, &BinSerializerTest::testTimespan);
             registerMethod("testRawString", *this, &BinSerializerTest::testRawString);
+            registerMethod("testSessionDictionary", *this, &BinSerializerTest::testSessionDictionary);
             //registerMethod("testBigString", *this, &BinSerializerTest::testBigString);
         }
 
@@ -461,6 +462,7 @@ class BinSerializerTest : public cxxtools::unit::TestSuite
 
         void testReuse();
         void testNamedVector();
+        void testSessionDictionary();
 
         void testDate()
         {
@@ -651,4 +653,57 @@ void BinSerializerTest::testNamedVector()
     CXXTOOLS_UNIT_ASSERT_EQUALS(f2.data[1], 12);
 }
 
+void BinSerializerTest::testSessionDictionary()
+{
+    TestObject obj;
+    obj.intValue = 17;
+    obj.stringValue = "foobar";
+    obj.doubleValue = 3.125;
+    obj.boolValue = true;
+    obj.nullValue = true;
+
+    cxxtools::SerializationInfo si;
+    si <<= obj;
+
+    cxxtools::bin::Formatter formatter;
+    formatter.sessionDictionary(100);
+
+    std::stringbuf data1;
+    formatter.begin(data1);
+    formatter.format(si);
+    formatter.finish();
+
+    std::stringbuf data2;
+    formatter.begin(data2);
+    formatter.format(si);
+    formatter.finish();
+
+    log_debug("first message:\n" << cxxtools::hexDump(data1.str()));
+    log_debug("second message:\n" << cxxtools::hexDump(data2.str()));
+
+    // the names are sent just in the first message
+    CXXTOOLS_UNIT_ASSERT(data2.str().size() < data1.str().size());
+
+    cxxtools::bin::Deserializer d;
+    d.resetDictionary(100);
+
+    TestObject obj2;
+    d.begin(false);
+    CXXTOOLS_UNIT_ASSERT(d.advance(data1));
+    d.deserialize(obj2);
+    CXXTOOLS_UNIT_ASSERT(obj == obj2);
+
+    TestObject obj3;
+    d.begin(false);
+    CXXTOOLS_UNIT_ASSERT(d.advance(data2));
+    d.deserialize(obj3);
+    CXXTOOLS_UNIT_ASSERT(obj == obj3);
+
+    // the second message can't be read without the first one
+    cxxtools::bin::Deserializer d2;
+    std::stringbuf data3(data2.str());
+    d2.begin();
+    CXXTOOLS_UNIT_ASSERT_THROW(d2.advance(data3), cxxtools::SerializationError);
+}
+
 cxxtools::unit::RegisterTest<BinSerializerTest> register_BinSerializerTest;
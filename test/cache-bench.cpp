@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/*
+ * Measures the cache implementations with random access. Each operation
+ * looks up a key and puts it into the cache on a miss. The keys are drawn
+ * from a skewed distribution, so that some keys are found more often than
+ * others.
+ */
+
+#include <cxxtools/arg.h>
+#include <cxxtools/clock.h>
+#include <cxxtools/cache.h>
+#include <cxxtools/lrucache.h>
+#include <cxxtools/hashcache.h>
+#include <cxxtools/hashlrucache.h>
+#include <cxxtools/shardedcache.h>
+#include <cxxtools/convert.h>
+
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace bench
+{
+    template <typename Key>
+    Key makeKey(unsigned n);
+
+    template <>
+    unsigned makeKey<unsigned>(unsigned n)
+    { return n; }
+
+    template <>
+    std::string makeKey<std::string>(unsigned n)
+    { return "/some/path/to/a/resource/" + cxxtools::convert<std::string>(n); }
+
+    template <typename Key>
+    std::vector<Key> randomKeys(unsigned long count, unsigned keys, unsigned seed)
+    {
+        // squaring a uniform distribution makes small numbers more likely
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<double> dist(0, 1);
+
+        std::vector<Key> values;
+        values.reserve(count);
+        for (unsigned long n = 0; n < count; ++n)
+        {
+            double d = dist(rng);
+            values.push_back(makeKey<Key>(static_cast<unsigned>(d * d * keys)));
+        }
+
+        return values;
+    }
+
+    template <typename CacheType>
+    void access(CacheType& cache, const std::vector<typename CacheType::key_type>& keys)
+    {
+        for (unsigned n = 0; n < keys.size(); ++n)
+        {
+            if (!cache.getx(keys[n]).first)
+                cache.put(keys[n], n);
+        }
+    }
+
+    template <typename CacheType>
+    void run(const char* what, CacheType& cache, const std::vector<typename CacheType::key_type>& keys)
+    {
+        cxxtools::Clock cl;
+        cl.start();
+        access(cache, keys);
+        double t = cxxtools::Seconds(cl.stop());
+
+        std::cout << what << '\t' << std::fixed << std::setprecision(1)
+                  << (t * 1e9 / keys.size()) << " ns/op\thit ratio "
+                  << std::setprecision(3) << cache.hitRatio() << std::endl;
+    }
+
+    template <typename CacheType>
+    void runThreads(const char* what, CacheType& cache, const std::vector<std::vector<typename CacheType::key_type> >& keys)
+    {
+        unsigned long count = 0;
+        cxxtools::Clock cl;
+        cl.start();
+
+        std::vector<std::thread> threads;
+        for (unsigned n = 0; n < keys.size(); ++n)
+        {
+            threads.push_back(std::thread(access<CacheType>, std::ref(cache), std::cref(keys[n])));
+            count += keys[n].size();
+        }
+
+        for (unsigned n = 0; n < threads.size(); ++n)
+            threads[n].join();
+
+        double t = cxxtools::Seconds(cl.stop());
+
+        std::cout << what << '\t' << std::fixed << std::setprecision(1)
+                  << (t * 1e9 / count) << " ns/op\thit ratio "
+                  << std::setprecision(3) << cache.hitRatio() << std::endl;
+    }
+
+    template <typename Key>
+    void runAll(unsigned long count, unsigned size, unsigned keys, unsigned numThreads)
+    {
+        std::vector<Key> k = randomKeys<Key>(count, keys, 4711);
+
+        {
+            cxxtools::Cache<Key, unsigned> cache(size);
+            run("Cache         ", cache, k);
+        }
+
+        {
+            cxxtools::HashCache<Key, unsigned> cache(size);
+            run("HashCache     ", cache, k);
+        }
+
+        {
+            cxxtools::LruCache<Key, unsigned> cache(size);
+            run("LruCache      ", cache, k);
+        }
+
+        {
+            cxxtools::HashLruCache<Key, unsigned> cache(size);
+            run("HashLruCache  ", cache, k);
+        }
+
+        std::vector<std::vector<Key> > tk;
+        for (unsigned n = 0; n < numThreads; ++n)
+            tk.push_back(randomKeys<Key>(count / numThreads, keys, 4711 + n));
+
+        {
+            cxxtools::ShardedCache<cxxtools::HashCache<Key, unsigned> > cache(size, 1);
+            runThreads("Sharded 1     ", cache, tk);
+        }
+
+        {
+            cxxtools::ShardedCache<cxxtools::HashCache<Key, unsigned> > cache(size);
+            runThreads("Sharded 16    ", cache, tk);
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        cxxtools::Arg<unsigned long> count(argc, argv, 'n', 1000000);
+        cxxtools::Arg<unsigned> size(argc, argv, 's', 1000);
+        cxxtools::Arg<unsigned> keys(argc, argv, 'k', 10000);
+        cxxtools::Arg<unsigned> threads(argc, argv, 't', 4);
+
+        std::cout << "integer keys:" << std::endl;
+        bench::runAll<unsigned>(count, size, keys, threads);
+
+        std::cout << "string keys:" << std::endl;
+        bench::runAll<std::string>(count, size, keys, threads);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return -1;
+    }
+}
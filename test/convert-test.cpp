@@ -32,6 +32,7 @@
 #include "cxxtools/string.h"
 #include "cxxtools/log.h"
 #include <limits>
+#include <random>
 #include <string.h>
 
 log_define("cxxtools.test.convert")
@@ -57,6 +58,7 @@ class ConvertTest : public cxxtools::unit::TestSuite
             registerMethod("infTest", *this, &ConvertTest::infTest);
             registerMethod("emptyTest", *this, &ConvertTest::emptyTest);
             registerMethod("floatTest", *this, &ConvertTest::floatTest);
+            registerMethod("shortestFloatTest", *this, &ConvertTest::shortestFloatTest);
         }
 
         void successTest()
@@ -281,6 +283,58 @@ class ConvertTest : public cxxtools::unit::TestSuite
           t(12);
         }
 
+        void shortestFloatTest()
+        {
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(0.1), "0.1");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(0.1f), "0.1");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(-1.5), "-1.5");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(100.0), "100");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(0.30000000000000004), "0.30000000000000004");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(1.7976931348623157e308), "1.7976931348623157e308");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(5e-324), "5e-324");
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(1.5e-7), "1.5e-7");
+
+          // Grisu can't decide this, so the fallback finds the shortest digits
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<std::string>(-3.5561693938148423e-26), "-3.556169393814842e-26");
+
+          // exact parsing, also when more digits than significant are given
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<double>("0.1"), 0.1);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<double>("2.2250738585072014e-308"), 2.2250738585072014e-308);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<double>("9007199254740993"), 9007199254740992.0);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<double>("9007199254740993.0000000000000001"), 9007199254740994.0);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<double>("123456789012345678901234567890"), 1.2345678901234568e29);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<double>("1e400"), std::numeric_limits<double>::infinity());
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<double>("1e-400"), 0.0);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<double>("1e"), 1.0);
+          CXXTOOLS_UNIT_ASSERT_THROW(cxxtools::convert<double>("1e+"), cxxtools::ConversionError);
+          CXXTOOLS_UNIT_ASSERT_THROW(cxxtools::convert<double>("."), cxxtools::ConversionError);
+
+          // formatted values read back unchanged
+          std::mt19937_64 rng(42);
+          for (unsigned n = 0; n < 10000; ++n)
+          {
+            uint64_t bits = rng();
+            double d;
+            memcpy(&d, &bits, sizeof(d));
+            if (d != d || d == std::numeric_limits<double>::infinity() || d == -std::numeric_limits<double>::infinity())
+              continue;
+
+            std::string s = cxxtools::convert<std::string>(d);
+            double r = cxxtools::convert<double>(s);
+            if (r != d)
+              CXXTOOLS_UNIT_ASSERT_EQUALS(s, cxxtools::convert<std::string>(r));
+
+            float f;
+            uint32_t fbits = static_cast<uint32_t>(bits);
+            memcpy(&f, &fbits, sizeof(f));
+            if (f != f || f == std::numeric_limits<float>::infinity() || f == -std::numeric_limits<float>::infinity())
+              continue;
+
+            s = cxxtools::convert<std::string>(f);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::convert<float>(s), f);
+          }
+        }
+
 };
 
 cxxtools::unit::RegisterTest<ConvertTest> register_ConvertTest;
@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/datetimeformat.h"
+#include "cxxtools/datetime.h"
+
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+
+class DateTimeFormatTest : public cxxtools::unit::TestSuite
+{
+    public:
+        DateTimeFormatTest()
+        : cxxtools::unit::TestSuite("datetimeformat")
+        {
+            registerMethod("format", *this, &DateTimeFormatTest::format);
+            registerMethod("formatBuffer", *this, &DateTimeFormatTest::formatBuffer);
+            registerMethod("formatCodes", *this, &DateTimeFormatTest::formatCodes);
+            registerMethod("parse", *this, &DateTimeFormatTest::parse);
+            registerMethod("parseFailed", *this, &DateTimeFormatTest::parseFailed);
+            registerMethod("reuse", *this, &DateTimeFormatTest::reuse);
+        }
+
+        void format()
+        {
+            cxxtools::DateTimeFormat fmt("%Y-%m-%d %H:%M:%S%j");
+            cxxtools::DateTime dt(2013, 5, 3, 17, 1, 14, 342);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(fmt.toString(dt), "2013-05-03 17:01:14.342");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(fmt.toString(cxxtools::DateTime(2013, 5, 3, 17, 1, 14)), "2013-05-03 17:01:14");
+
+            std::string str = "at ";
+            fmt.format(dt, str);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(str, "at 2013-05-03 17:01:14.342");
+        }
+
+        void formatBuffer()
+        {
+            cxxtools::DateTimeFormat fmt("%d.%m.%Y");
+            cxxtools::DateTime dt(2013, 5, 3, 17, 1, 14);
+
+            char buffer[16];
+            std::size_t n = fmt.format(dt, buffer, sizeof(buffer));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(std::string(buffer, n), "03.05.2013");
+
+            // the return value tells the needed size
+            n = fmt.format(dt, buffer, 5);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(n, 10u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(std::string(buffer, 5), "03.05");
+        }
+
+        void formatCodes()
+        {
+            cxxtools::DateTime dt(2013, 5, 3, 7, 1, 4, 12, 345);
+
+            const char* fmts[] = {
+                "%1d.%1m.%y %1H:%1M:%1S",
+                "%O %N %w %W",
+                "%I %1I %p %P",
+                "%J %k %K %u %U",
+                "%% %x %1x %",
+                0 };
+
+            for (unsigned n = 0; fmts[n]; ++n)
+                CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::DateTimeFormat(fmts[n]).toString(dt), dt.toString(fmts[n]));
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::DateTimeFormat("%1d.%1m.%y %1H:%1M:%1S").toString(dt), "3.5.13 7:1:4");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::DateTimeFormat("%O %N %w %W").toString(dt), "May Fri 5 5");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::DateTimeFormat("%J %k %U").toString(dt), ".012345 012 .000000");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::DateTimeFormat("%k %U %j").toString(dt), "012 .012345 .012345");
+        }
+
+        void parse()
+        {
+            cxxtools::DateTimeFormat fmt("%Y-%m-%d %H:%M:%S%j");
+
+            cxxtools::DateTime dt = fmt.parse("2013-05-03 17:01:14.342");
+            CXXTOOLS_UNIT_ASSERT(dt == cxxtools::DateTime(2013, 5, 3, 17, 1, 14, 342));
+
+            dt = cxxtools::DateTimeFormat("%2d.%2m.%y %I:%M %p").parse("03.05.13 5:01 pm");
+            CXXTOOLS_UNIT_ASSERT(dt == cxxtools::DateTime(2013, 5, 3, 17, 1, 0));
+
+            dt = cxxtools::DateTimeFormat("*%Y-%m?%d #").parse("at 2013-05x03 Friday");
+            CXXTOOLS_UNIT_ASSERT(dt == cxxtools::DateTime(2013, 5, 3, 0, 0, 0));
+
+            CXXTOOLS_UNIT_ASSERT(fmt.parse("2013-05-03 17:01:14.342", dt));
+            CXXTOOLS_UNIT_ASSERT(dt == cxxtools::DateTime(2013, 5, 3, 17, 1, 14, 342));
+        }
+
+        void parseFailed()
+        {
+            cxxtools::DateTimeFormat fmt("%Y-%m-%d %H:%M:%S");
+
+            cxxtools::DateTime dt;
+            CXXTOOLS_UNIT_ASSERT(!fmt.parse("2013-05-03 17:01", dt));
+            CXXTOOLS_UNIT_ASSERT(!fmt.parse("2013-05-03 17:01:14 ", dt));
+            CXXTOOLS_UNIT_ASSERT(!fmt.parse("2013-13-03 17:01:14", dt));
+            CXXTOOLS_UNIT_ASSERT_THROW(fmt.parse("2013-05-03x17:01:14"), cxxtools::InvalidDate);
+
+            // unknown format codes do not match anything
+            CXXTOOLS_UNIT_ASSERT_THROW(cxxtools::DateTimeFormat("%Y%q").parse("2013"), cxxtools::InvalidDate);
+
+            try
+            {
+                fmt.parse("2013-05-03x17:01:14");
+            }
+            catch (const cxxtools::InvalidDate& e)
+            {
+                CXXTOOLS_UNIT_ASSERT_EQUALS(std::string(e.what()),
+                    "string <2013-05-03(*)x17:01:14> does not match datetime format <%Y-%m-%d %H:%M:%S>");
+            }
+        }
+
+        void reuse()
+        {
+            cxxtools::DateTimeFormat fmt("%H:%M");
+
+            // formats are copyable values
+            cxxtools::DateTimeFormat fmt2;
+            fmt2 = fmt;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(fmt2.pattern(), "%H:%M");
+
+            for (unsigned h = 0; h < 24; ++h)
+            {
+                cxxtools::DateTime dt(2013, 5, 3, h, 30, 0);
+                std::string s = fmt2.toString(dt);
+                CXXTOOLS_UNIT_ASSERT_EQUALS(s, dt.toString("%H:%M"));
+                CXXTOOLS_UNIT_ASSERT(fmt2.parse(s).time() == dt.time());
+            }
+        }
+};
+
+cxxtools::unit::RegisterTest<DateTimeFormatTest> register_DateTimeFormatTest;
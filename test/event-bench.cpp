@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/*
+ * Measures the throughput of cross thread events: a number of producer
+ * threads commit events to an event loop running in its own thread.
+ */
+
+#include <cxxtools/arg.h>
+#include <cxxtools/clock.h>
+#include <cxxtools/event.h>
+#include <cxxtools/eventloop.h>
+
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <vector>
+
+namespace bench
+{
+    class CountEvent : public cxxtools::BasicEvent<CountEvent>
+    {
+        unsigned long _value;
+
+    public:
+        explicit CountEvent(unsigned long value)
+            : _value(value)
+        { }
+
+        unsigned long value() const
+        { return _value; }
+    };
+
+    class Consumer : public cxxtools::Connectable
+    {
+        cxxtools::EventLoop& _loop;
+        unsigned long _total;
+        unsigned long _count;
+
+        void onCountEvent(const CountEvent&)
+        {
+            if (++_count >= _total)
+                _loop.exit();
+        }
+
+    public:
+        Consumer(cxxtools::EventLoop& loop, unsigned long total)
+            : _loop(loop),
+              _total(total),
+              _count(0)
+        {
+            loop.event.subscribe(cxxtools::slot(*this, &Consumer::onCountEvent));
+        }
+    };
+
+    double run(unsigned numThreads, unsigned long count)
+    {
+        cxxtools::EventLoop loop;
+        Consumer consumer(loop, count * numThreads);
+
+        cxxtools::Clock cl;
+        cl.start();
+
+        std::thread loopThread([&loop]() { loop.run(); });
+
+        std::vector<std::thread> threads;
+        for (unsigned p = 0; p < numThreads; ++p)
+        {
+            threads.push_back(std::thread([&loop, count]() {
+                for (unsigned long i = 0; i < count; ++i)
+                    loop.commitEvent(CountEvent(i));
+            }));
+        }
+
+        for (unsigned t = 0; t < threads.size(); ++t)
+            threads[t].join();
+
+        loopThread.join();
+
+        cxxtools::Seconds T = cl.stop();
+        return count * numThreads / T;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        cxxtools::Arg<unsigned long> count(argc, argv, 'n', 200000);  // events per producer
+        cxxtools::Arg<unsigned> maxThreads(argc, argv, 't', 8);
+
+        std::cout << "producers\tevents/s" << std::endl;
+
+        for (unsigned numThreads = 1; numThreads <= maxThreads; numThreads <<= 1)
+        {
+            double r = bench::run(numThreads, count);
+            std::cout << numThreads << '\t' << std::fixed << std::setprecision(0) << r << std::endl;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return -1;
+    }
+}
@@ -31,6 +31,9 @@
 #include "cxxtools/unit/registertest.h"
 #include "cxxtools/event.h"
 #include "cxxtools/eventloop.h"
+#include <atomic>
+#include <thread>
+#include <vector>
 
 namespace
 {
@@ -39,12 +42,75 @@ namespace
 
     class TestEvent2 : public cxxtools::BasicEvent<TestEvent2>
     { };
+
+    std::atomic<int> numSeqEvents(0);
+
+    // counts its instances to verify, that queued copies are released
+    class SeqEvent : public cxxtools::BasicEvent<SeqEvent>
+    {
+        unsigned _producer;
+        unsigned _seq;
+
+    public:
+        SeqEvent(unsigned producer, unsigned seq)
+            : _producer(producer),
+              _seq(seq)
+        { ++numSeqEvents; }
+
+        SeqEvent(const SeqEvent& ev)
+            : cxxtools::BasicEvent<SeqEvent>(ev),
+              _producer(ev._producer),
+              _seq(ev._seq)
+        { ++numSeqEvents; }
+
+        ~SeqEvent()
+        { --numSeqEvents; }
+
+        unsigned producer() const  { return _producer; }
+        unsigned seq() const       { return _seq; }
+    };
+
+    std::atomic<bool> stallCopy(false);
+    std::atomic<bool> copyStalled(false);
+
+    // stalls the producer after it claimed a cell in the event queue
+    class StallEvent : public cxxtools::BasicEvent<StallEvent>
+    {
+    public:
+        StallEvent()
+        { }
+
+        StallEvent(const StallEvent& ev)
+            : cxxtools::BasicEvent<StallEvent>(ev)
+        {
+            copyStalled = true;
+            while (stallCopy.load())
+                std::this_thread::yield();
+        }
+    };
+
+    // too large to be stored in place in the event queue
+    class LargeEvent : public cxxtools::BasicEvent<LargeEvent>
+    {
+        char _data[256];
+        unsigned _seq;
+
+    public:
+        explicit LargeEvent(unsigned seq)
+            : _seq(seq)
+        { _data[0] = '\0'; }
+
+        unsigned seq() const       { return _seq; }
+    };
 }
 
 class EventLoopTest : public cxxtools::unit::TestSuite
 {
     cxxtools::EventLoop _loop;
     std::string _events;
+    std::vector<unsigned> _received;
+    std::vector<unsigned> _sequence;
+    unsigned _orderErrors;
 
     void onTestEvent1(const TestEvent1&)
     {
@@ -56,20 +122,53 @@ class EventLoopTest : public cxxtools::unit::TestSuite
         _events += "2";
     }
 
+    void onSeqEvent(const SeqEvent& ev)
+    {
+        if (ev.producer() >= _received.size())
+            _received.resize(ev.producer() + 1);
+
+        if (ev.seq() != _received[ev.producer()])
+            ++_orderErrors;
+
+        _received[ev.producer()] = ev.seq() + 1;
+        _sequence.push_back(ev.seq());
+    }
+
+    void onLargeEvent(const LargeEvent& ev)
+    {
+        _sequence.push_back(ev.seq());
+    }
+
+    void onStallEvent(const StallEvent&)
+    {
+        _events += "X";
+    }
+
 public:
     EventLoopTest()
     : cxxtools::unit::TestSuite("eventloop")
     {
         registerMethod("commitEvent", *this, &EventLoopTest::commitEvent);
         registerMethod("priorityEvent", *this, &EventLoopTest::priorityEvent);
+        registerMethod("largeEvent", *this, &EventLoopTest::largeEvent);
+        registerMethod("overflow", *this, &EventLoopTest::overflow);
+        registerMethod("producerThreads", *this, &EventLoopTest::producerThreads);
+        registerMethod("releasePending", *this, &EventLoopTest::releasePending);
+        registerMethod("stalledProducer", *this, &EventLoopTest::stalledProducer);
 
         _loop.event.subscribe(slot(*this, &EventLoopTest::onTestEvent1));
         _loop.event.subscribe(slot(*this, &EventLoopTest::onTestEvent2));
+        _loop.event.subscribe(slot(*this, &EventLoopTest::onSeqEvent));
+        _loop.event.subscribe(slot(*this, &EventLoopTest::onLargeEvent));
+        _loop.event.subscribe(slot(*this, &EventLoopTest::onStallEvent));
     }
 
     void setUp()
     {
         _events.clear();
+        _received.clear();
+        _sequence.clear();
+        _orderErrors = 0;
     }
 
     void commitEvent()
@@ -88,6 +187,111 @@ public:
         CXXTOOLS_UNIT_ASSERT_EQUALS(_events, "21");
     }
 
+    void largeEvent()
+    {
+        // large events are cloned to the heap but keep their order
+        _loop.commitEvent(SeqEvent(0, 0));
+        _loop.commitEvent(LargeEvent(1));
+        _loop.commitEvent(SeqEvent(0, 2));
+        _loop.commitEvent(LargeEvent(3));
+        _loop.processEvents();
+
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_sequence.size(), 4u);
+        for (unsigned n = 0; n < _sequence.size(); ++n)
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_sequence[n], n);
+    }
+
+    void overflow()
+    {
+        // more events than the ring buffer holds
+        const unsigned count = 5000;
+        for (unsigned n = 0; n < count; ++n)
+            _loop.queueEvent(SeqEvent(0, n));
+
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_loop.pendingEvents(), count);
+
+        // the ring is freed partly while events are still in the overflow list
+        _loop.processEvents(1500);
+        for (unsigned n = count; n < 2 * count; ++n)
+            _loop.queueEvent(SeqEvent(0, n));
+
+        _loop.processEvents();
+
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_sequence.size(), 2 * count);
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_orderErrors, 0u);
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_loop.pendingEvents(), 0u);
+        CXXTOOLS_UNIT_ASSERT_EQUALS(numSeqEvents.load(), 0);
+    }
+
+    void producerThreads()
+    {
+        const unsigned numThreads = 4;
+        const unsigned count = 20000;
+
+        std::vector<std::thread> threads;
+        for (unsigned p = 0; p < numThreads; ++p)
+        {
+            threads.push_back(std::thread([this, p, count]() {
+                for (unsigned n = 0; n < count; ++n)
+                    _loop.commitEvent(SeqEvent(p, n));
+            }));
+        }
+
+        while (_sequence.size() < numThreads * count)
+            _loop.wait(1000);
+
+        for (unsigned t = 0; t < threads.size(); ++t)
+            threads[t].join();
+
+        _loop.processEvents();
+
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_sequence.size(), numThreads * count);
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_orderErrors, 0u);
+        CXXTOOLS_UNIT_ASSERT_EQUALS(numSeqEvents.load(), 0);
+    }
+
+    void releasePending()
+    {
+        {
+            cxxtools::EventLoop loop;
+            for (unsigned n = 0; n < 2000; ++n)
+                loop.queueEvent(SeqEvent(0, n));
+            loop.queuePriorityEvent(SeqEvent(1, 0));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(numSeqEvents.load(), 2001);
+        }
+
+        CXXTOOLS_UNIT_ASSERT_EQUALS(numSeqEvents.load(), 0);
+    }
+
+    void stalledProducer()
+    {
+        // fill the ring of the event queue, which holds 1024 events, but one cell
+        const std::string filled(1023, '1');
+        for (unsigned n = 0; n < filled.size(); ++n)
+            _loop.queueEvent(TestEvent1());
+
+        // the producer claims the last cell and stalls while copying its event
+        stallCopy = true;
+        copyStalled = false;
+        std::thread producer([this]() { _loop.commitEvent(StallEvent()); });
+        while (!copyStalled.load())
+            std::this_thread::yield();
+
+        // the ring is full, so this goes to the overflow list, which must
+        // wait for the stalled producer
+        _loop.queueEvent(TestEvent2());
+        _loop.processEvents();
+        std::string events = _events;
+
+        stallCopy = false;
+        producer.join();
+
+        CXXTOOLS_UNIT_ASSERT_EQUALS(events, filled);
+
+        _loop.processEvents();
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_events, filled + "X2");
+    }
+
 };
 
 cxxtools::unit::RegisterTest<EventLoopTest> register_EventLoopTest;
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/*
+ * Measures formatting and parsing of random doubles with cxxtools::putFloat
+ * and cxxtools::getFloat compared to snprintf and strtod. All values are
+ * checked to read back unchanged.
+ */
+
+#include <cxxtools/arg.h>
+#include <cxxtools/clock.h>
+#include <cxxtools/convert.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace bench
+{
+    std::vector<double> randomDoubles(unsigned long count, bool bits)
+    {
+        std::mt19937_64 rng(4711);
+        std::uniform_real_distribution<double> dist(-1e6, 1e6);
+
+        std::vector<double> values;
+        values.reserve(count);
+        while (values.size() < count)
+        {
+            double d;
+            if (bits)
+            {
+                // random bit patterns cover the full exponent range
+                uint64_t b = rng();
+                std::memcpy(&d, &b, sizeof(d));
+                if (!std::isfinite(d))
+                    continue;
+            }
+            else
+                d = dist(rng);
+
+            values.push_back(d);
+        }
+
+        return values;
+    }
+
+    void report(const char* what, unsigned long count, cxxtools::Seconds T)
+    {
+        double t = T;
+        std::cout << what << '\t' << std::fixed << std::setprecision(0)
+                  << (count / t) << " values/s\t"
+                  << std::setprecision(1) << (t * 1e9 / count) << " ns/value" << std::endl;
+    }
+
+    unsigned long run(const std::vector<double>& values)
+    {
+        std::vector<std::string> strings(values.size());
+        std::vector<double> results(values.size());
+        cxxtools::Clock cl;
+
+        cl.start();
+        for (unsigned n = 0; n < values.size(); ++n)
+        {
+            strings[n].clear();
+            cxxtools::putFloat(std::back_inserter(strings[n]), values[n]);
+        }
+        report("putFloat", values.size(), cl.stop());
+
+        cl.start();
+        for (unsigned n = 0; n < strings.size(); ++n)
+        {
+            bool ok;
+            cxxtools::getFloat(strings[n].begin(), strings[n].end(), ok, results[n]);
+        }
+        report("getFloat", values.size(), cl.stop());
+
+        unsigned long errors = 0;
+        for (unsigned n = 0; n < values.size(); ++n)
+        {
+            if (results[n] != values[n])
+            {
+                if (errors++ < 10)
+                    std::cerr << "round trip failed: " << std::setprecision(17) << values[n]
+                              << " => \"" << strings[n] << "\" => " << results[n] << std::endl;
+            }
+        }
+
+        cl.start();
+        for (unsigned n = 0; n < values.size(); ++n)
+        {
+            char buffer[32];
+            snprintf(buffer, sizeof(buffer), "%.17g", values[n]);
+            strings[n] = buffer;
+        }
+        report("snprintf", values.size(), cl.stop());
+
+        cl.start();
+        for (unsigned n = 0; n < strings.size(); ++n)
+            results[n] = strtod(strings[n].c_str(), 0);
+        report("strtod  ", values.size(), cl.stop());
+
+        return errors;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        cxxtools::Arg<unsigned long> count(argc, argv, 'n', 1000000);
+
+        std::cout << "random bit patterns:" << std::endl;
+        unsigned long errors = bench::run(bench::randomDoubles(count, true));
+
+        std::cout << "uniform in [-1e6, 1e6]:" << std::endl;
+        errors += bench::run(bench::randomDoubles(count, false));
+
+        if (errors > 0)
+        {
+            std::cerr << errors << " values did not read back unchanged" << std::endl;
+            return 1;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return -1;
+    }
+}
@@ -0,0 +1,245 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include "cxxtools/http/clientpool.h"
+#include "cxxtools/http/server.h"
+#include "cxxtools/http/responder.h"
+#include "cxxtools/http/service.h"
+#include "cxxtools/http/request.h"
+#include "cxxtools/http/reply.h"
+#include "cxxtools/net/uri.h"
+#include "cxxtools/eventloop.h"
+#include "cxxtools/ioerror.h"
+#include "cxxtools/log.h"
+#include <atomic>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <stdlib.h>
+
+log_define("cxxtools.test.httpclientpool")
+
+namespace
+{
+    class EchoResponder : public cxxtools::http::Responder
+    {
+        public:
+            explicit EchoResponder(cxxtools::http::Service& service)
+                : cxxtools::http::Responder(service)
+                { }
+
+            void reply(std::ostream& out, cxxtools::http::Request& request, cxxtools::http::Reply&)
+            {
+                out << request.qparams();
+            }
+    };
+}
+
+class HttpClientPoolTest : public cxxtools::unit::TestSuite
+{
+    private:
+        cxxtools::EventLoop _loop;
+        std::thread _loopThread;
+        cxxtools::http::Server* _server;
+        cxxtools::http::CachedService<EchoResponder> _service;
+        std::string _listen;
+        unsigned short _port;
+
+        cxxtools::net::Uri uri() const
+        {
+            std::ostringstream s;
+            s << "http://" << (_listen.empty() ? "localhost" : _listen) << ':' << _port << '/';
+            return cxxtools::net::Uri(s.str());
+        }
+
+    public:
+        HttpClientPoolTest()
+        : cxxtools::unit::TestSuite("httpclientpool"),
+          _port(8001)
+        {
+            registerMethod("Reuse", *this, &HttpClientPoolTest::Reuse);
+            registerMethod("Discard", *this, &HttpClientPoolTest::Discard);
+            registerMethod("MaxPerHost", *this, &HttpClientPoolTest::MaxPerHost);
+            registerMethod("EvictIdle", *this, &HttpClientPoolTest::EvictIdle);
+            registerMethod("Threads", *this, &HttpClientPoolTest::Threads);
+
+            char* PORT = getenv("UTEST_PORT");
+            if (PORT)
+            {
+                std::istringstream s(PORT);
+                s >> _port;
+            }
+
+            char* LISTEN = getenv("UTEST_LISTEN");
+            if (LISTEN)
+                _listen = LISTEN;
+        }
+
+        void setUp()
+        {
+            _server = new cxxtools::http::Server(_loop, _listen, _port);
+            _server->minThreads(1);
+            _server->addService("/echo", _service);
+            _loop.processEvents();
+
+            // keep alive connections are parked in the event loop of the
+            // server while idle, so the loop has to run for the pool to
+            // reuse them
+            _loopThread = std::thread([this] { _loop.run(); });
+        }
+
+        void tearDown()
+        {
+            _loop.exit();
+            _loopThread.join();
+            _server->removeService(_service);
+            delete _server;
+        }
+
+        void Reuse()
+        {
+            cxxtools::http::ClientPool pool;
+
+            for (unsigned n = 0; n < 3; ++n)
+            {
+                cxxtools::http::ClientPool::Lease client = pool.lease(uri());
+                CXXTOOLS_UNIT_ASSERT_EQUALS(pool.leased(), 1u);
+                CXXTOOLS_UNIT_ASSERT_EQUALS(client->get("/echo?hello").body(), "hello");
+            }
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(pool.misses(), 1u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(pool.hits(), 2u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(pool.leased(), 0u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(pool.idle(), 1u);
+
+            pool.clear();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(pool.idle(), 0u);
+        }
+
+        void Discard()
+        {
+            cxxtools::http::ClientPool pool;
+
+            {
+                cxxtools::http::ClientPool::Lease client = pool.lease(uri());
+                client->get("/echo?a");
+                client.discard();
+                CXXTOOLS_UNIT_ASSERT(!client);
+            }
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(pool.idle(), 0u);
+
+            cxxtools::http::ClientPool::Lease client = pool.lease(uri());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(pool.misses(), 2u);
+        }
+
+        void MaxPerHost()
+        {
+            cxxtools::http::ClientPool pool;
+            pool.maxPerHost(1);
+
+            cxxtools::http::ClientPool::Lease first = pool.lease(uri());
+            first->get("/echo?1");
+
+            CXXTOOLS_UNIT_ASSERT_THROW(pool.lease(uri(), 50), cxxtools::IOTimeout);
+
+            // other servers are not limited
+            std::string host = _listen.empty() ? "localhost" : _listen;
+            cxxtools::http::ClientPool::Lease other = pool.lease(host, _port + 1, 50);
+            CXXTOOLS_UNIT_ASSERT(other);
+            other.release();
+
+            first.release();
+            cxxtools::http::ClientPool::Lease second = pool.lease(uri(), 50);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(second->get("/echo?2").body(), "2");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(pool.hits(), 1u);
+        }
+
+        void EvictIdle()
+        {
+            cxxtools::http::ClientPool pool;
+
+            {
+                cxxtools::http::ClientPool::Lease client = pool.lease(uri());
+                client->get("/echo?a");
+            }
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(pool.evictIdle(), 0u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(pool.idle(), 1u);
+
+            pool.maxIdleTime(cxxtools::Milliseconds(1));
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(pool.evictIdle(), 1u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(pool.idle(), 0u);
+        }
+
+        void Threads()
+        {
+            cxxtools::http::ClientPool pool;
+            pool.maxPerHost(2);
+
+            std::atomic<unsigned> failures(0);
+            std::vector<std::thread> threads;
+            cxxtools::net::Uri u = uri();
+
+            for (unsigned t = 0; t < 4; ++t)
+            {
+                threads.push_back(std::thread([&pool, &failures, &u, t] {
+                    for (unsigned n = 0; n < 20; ++n)
+                    {
+                        std::ostringstream q;
+                        q << t << '-' << n;
+                        try
+                        {
+                            cxxtools::http::ClientPool::Lease client = pool.lease(u);
+                            if (client->get("/echo?" + q.str()).body() != q.str())
+                                ++failures;
+                        }
+                        catch (const std::exception& e)
+                        {
+                            log_error(e.what());
+                            ++failures;
+                        }
+                    }
+                }));
+            }
+
+            for (unsigned t = 0; t < threads.size(); ++t)
+                threads[t].join();
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(failures.load(), 0u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(pool.hits() + pool.misses(), 80u);
+            CXXTOOLS_UNIT_ASSERT(pool.misses() <= 2u);
+            CXXTOOLS_UNIT_ASSERT(pool.idle() <= 2u);
+        }
+};
+
+cxxtools::unit::RegisterTest<HttpClientPoolTest> register_HttpClientPoolTest;
@@ -0,0 +1,691 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include "cxxtools/http/server.h"
+#include "cxxtools/http/client.h"
+#include "cxxtools/http/responder.h"
+#include "cxxtools/http/service.h"
+#include "cxxtools/http/request.h"
+#include "cxxtools/http/reply.h"
+#include "cxxtools/eventloop.h"
+#include "cxxtools/net/tcpstream.h"
+#include "cxxtools/regex.h"
+#include "cxxtools/log.h"
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <stdlib.h>
+#include <unistd.h>
+
+log_define("cxxtools.test.httpserver")
+
+namespace
+{
+    const char* fileName = "httpserver-test.data";
+
+    std::string content(std::size_t size)
+    {
+        std::string s;
+        s.reserve(size);
+        for (std::size_t n = 0; n < size; ++n)
+            s += static_cast<char>('a' + n % 26);
+        return s;
+    }
+
+    // reads a reply with content length from a raw connection and returns the body
+    std::string readBody(std::istream& in)
+    {
+        std::string line;
+        std::size_t contentLength = 0;
+        while (std::getline(in, line) && line != "\r")
+        {
+            if (line.compare(0, 15, "Content-Length:") == 0)
+                std::istringstream(line.substr(15)) >> contentLength;
+        }
+
+        std::string body(contentLength, '\0');
+        in.read(&body[0], contentLength);
+        return body;
+    }
+
+    // generates a body of unknown size, so that it is sent chunked
+    class PatternSource : public cxxtools::http::BodySource
+    {
+            std::size_t _size;
+            std::size_t _pos;
+
+        public:
+            explicit PatternSource(std::size_t size)
+                : _size(size),
+                  _pos(0)
+                { }
+
+            std::size_t read(char* buffer, std::size_t n)
+            {
+                std::size_t count = 0;
+                while (count < n && _pos < _size)
+                    buffer[count++] = static_cast<char>('a' + _pos++ % 26);
+                return count;
+            }
+    };
+
+    // announces less than it generates like a file, which grows while it is sent
+    class GrowingSource : public PatternSource
+    {
+            std::size_t _announced;
+
+        public:
+            explicit GrowingSource(std::size_t announced)
+                : PatternSource(announced + 5000),
+                  _announced(announced)
+                { }
+
+            long long size() const
+                { return _announced; }
+    };
+
+    class GrowingResponder : public cxxtools::http::Responder
+    {
+        public:
+            explicit GrowingResponder(cxxtools::http::Service& service)
+                : cxxtools::http::Responder(service)
+                { }
+
+            void reply(std::ostream&, cxxtools::http::Request& request, cxxtools::http::Reply& reply)
+            {
+                std::size_t size = 0;
+                std::istringstream(request.qparams()) >> size;
+                reply.bodySource(new GrowingSource(size));
+            }
+    };
+
+    // asks for keep alive, which is not possible without content length in HTTP/1.0
+    class KeepAliveResponder : public cxxtools::http::Responder
+    {
+        public:
+            explicit KeepAliveResponder(cxxtools::http::Service& service)
+                : cxxtools::http::Responder(service)
+                { }
+
+            void reply(std::ostream&, cxxtools::http::Request& request, cxxtools::http::Reply& reply)
+            {
+                std::size_t size = 0;
+                std::istringstream(request.qparams()) >> size;
+                reply.setHeader("Connection", "keep-alive");
+                reply.bodySource(new PatternSource(size));
+            }
+    };
+
+    class FileResponder : public cxxtools::http::Responder
+    {
+        public:
+            explicit FileResponder(cxxtools::http::Service& service)
+                : cxxtools::http::Responder(service)
+                { }
+
+            void reply(std::ostream&, cxxtools::http::Request&, cxxtools::http::Reply& reply)
+            {
+                reply.setHeader("Content-Type", "application/octet-stream");
+                reply.bodyFile(fileName);
+            }
+    };
+
+    class NameResponder : public cxxtools::http::Responder
+    {
+            std::string _name;
+
+        public:
+            NameResponder(cxxtools::http::Service& service, const std::string& name)
+                : cxxtools::http::Responder(service),
+                  _name(name)
+                { }
+
+            void reply(std::ostream& out, cxxtools::http::Request&, cxxtools::http::Reply&)
+            {
+                out << _name;
+            }
+    };
+
+    // service, which replies its name or declines when it has no name
+    class NameService : public cxxtools::http::Service
+    {
+            std::string _name;
+
+        public:
+            explicit NameService(const std::string& name)
+                : _name(name)
+                { }
+
+        protected:
+            cxxtools::http::Responder* createResponder(const cxxtools::http::Request&)
+            {
+                return _name.empty() ? 0 : new NameResponder(*this, _name);
+            }
+
+            void releaseResponder(cxxtools::http::Responder* responder)
+            {
+                delete responder;
+            }
+    };
+
+    // replies the request body or a body of the size passed as query
+    class EchoResponder : public cxxtools::http::Responder
+    {
+        public:
+            explicit EchoResponder(cxxtools::http::Service& service)
+                : cxxtools::http::Responder(service)
+                { }
+
+            void reply(std::ostream& out, cxxtools::http::Request& request, cxxtools::http::Reply&)
+            {
+                if (request.bodySize() > 0)
+                {
+                    out << request.bodyStr();
+                }
+                else
+                {
+                    std::size_t size = 0;
+                    std::istringstream(request.qparams()) >> size;
+                    out << content(size);
+                }
+            }
+    };
+
+    // replies, when the test calls the function passed to prepareReply
+    std::mutex deferredMutex;
+    std::function<void()> deferredReady;
+
+    class DeferredResponder : public cxxtools::http::Responder
+    {
+        public:
+            explicit DeferredResponder(cxxtools::http::Service& service)
+                : cxxtools::http::Responder(service)
+                { }
+
+            bool prepareReply(cxxtools::http::Request&, const std::function<void()>& ready)
+            {
+                std::lock_guard<std::mutex> lock(deferredMutex);
+                deferredReady = ready;
+                return true;
+            }
+
+            void reply(std::ostream& out, cxxtools::http::Request&, cxxtools::http::Reply&)
+            {
+                out << "deferred";
+            }
+    };
+
+    class PatternResponder : public cxxtools::http::Responder
+    {
+        public:
+            explicit PatternResponder(cxxtools::http::Service& service)
+                : cxxtools::http::Responder(service)
+                { }
+
+            void reply(std::ostream&, cxxtools::http::Request& request, cxxtools::http::Reply& reply)
+            {
+                std::size_t size = 0;
+                std::istringstream(request.qparams()) >> size;
+                reply.setHeader("Content-Type", "text/plain");
+                reply.bodySource(new PatternSource(size));
+            }
+    };
+}
+
+class HttpServerTest : public cxxtools::unit::TestSuite
+{
+    private:
+        cxxtools::EventLoop _loop;
+        cxxtools::http::Server* _server;
+        std::string _listen;
+        unsigned short _port;
+
+    public:
+        HttpServerTest()
+        : cxxtools::unit::TestSuite("httpserver"),
+          _port(8001)
+        {
+            registerMethod("FileBody", *this, &HttpServerTest::FileBody);
+            registerMethod("ChunkedBody", *this, &HttpServerTest::ChunkedBody);
+            registerMethod("GrowingBody", *this, &HttpServerTest::GrowingBody);
+            registerMethod("Http10Body", *this, &HttpServerTest::Http10Body);
+            registerMethod("KeepAlive", *this, &HttpServerTest::KeepAlive);
+            registerMethod("Routing", *this, &HttpServerTest::Routing);
+            registerMethod("EventDriven", *this, &HttpServerTest::EventDriven);
+            registerMethod("EventDrivenSlowClients", *this, &HttpServerTest::EventDrivenSlowClients);
+            registerMethod("EventDrivenTimeout", *this, &HttpServerTest::EventDrivenTimeout);
+            registerMethod("Pipelining", *this, &HttpServerTest::Pipelining);
+            registerMethod("PipeliningDepth", *this, &HttpServerTest::PipeliningDepth);
+            registerMethod("EventDrivenPipelining", *this, &HttpServerTest::EventDrivenPipelining);
+            registerMethod("PipeliningDeferred", *this, &HttpServerTest::PipeliningDeferred);
+            registerMethod("EventDrivenPipeliningDeferred", *this, &HttpServerTest::EventDrivenPipeliningDeferred);
+            registerMethod("PostBody", *this, &HttpServerTest::PostBody);
+            registerMethod("EventDrivenPostBody", *this, &HttpServerTest::EventDrivenPostBody);
+
+            char* PORT = getenv("UTEST_PORT");
+            if (PORT)
+            {
+                std::istringstream s(PORT);
+                s >> _port;
+            }
+
+            char* LISTEN = getenv("UTEST_LISTEN");
+            if (LISTEN)
+                _listen = LISTEN;
+        }
+
+        void setUp()
+        {
+            _server = new cxxtools::http::Server(_loop, _listen, _port);
+            _server->minThreads(1);
+            _loop.processEvents();
+        }
+
+        void tearDown()
+        {
+            delete _server;
+            ::unlink(fileName);
+        }
+
+        void startEventDriven()
+        {
+            delete _server;
+            _server = new cxxtools::http::Server(_loop, _listen, _port);
+            _server->minThreads(2);
+            _server->eventDriven(true);
+            _server->eventLoops(2);
+            _loop.processEvents();
+        }
+
+        void FileBody()
+        {
+            std::string data = content(3 * 1024 * 1024 + 17);
+            std::ofstream(fileName) << data;
+
+            cxxtools::http::CachedService<FileResponder> service;
+            _server->addService("/file", service);
+
+            cxxtools::http::Client client(_listen, _port);
+            const cxxtools::http::Reply& reply = client.get("/file");
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reply.httpReturnCode(), 200u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reply.header().contentLength(), data.size());
+            CXXTOOLS_UNIT_ASSERT(reply.body() == data);
+
+            _server->removeService(service);
+        }
+
+        void ChunkedBody()
+        {
+            cxxtools::http::CachedService<PatternResponder> service;
+            _server->addService("/pattern", service);
+
+            cxxtools::http::Client client(_listen, _port);
+            const cxxtools::http::Reply& reply = client.get("/pattern?100000");
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reply.httpReturnCode(), 200u);
+            CXXTOOLS_UNIT_ASSERT(reply.header().chunkedTransferEncoding());
+            CXXTOOLS_UNIT_ASSERT(reply.body() == content(100000));
+
+            _server->removeService(service);
+        }
+
+        void GrowingBody()
+        {
+            cxxtools::http::CachedService<GrowingResponder> service;
+            _server->addService("/growing", service);
+
+            // no more than the content length is sent, so that the next
+            // reply on the connection is not corrupted
+            cxxtools::http::Client client(_listen, _port);
+            for (unsigned n = 0; n < 3; ++n)
+            {
+                CXXTOOLS_UNIT_ASSERT(client.get("/growing?20000").body() == content(20000));
+                CXXTOOLS_UNIT_ASSERT_EQUALS(client.get("/growing?10").body(), content(10));
+            }
+
+            _server->removeService(service);
+        }
+
+        void Http10Body()
+        {
+            cxxtools::http::CachedService<KeepAliveResponder> service;
+            _server->addService("/keepalive", service);
+
+            // the body of unknown size ends with the connection, which
+            // overrides the Connection header of the responder
+            cxxtools::net::TcpStream client(_listen, _port);
+            client << "GET /keepalive?1000 HTTP/1.0\r\nConnection: keep-alive\r\n\r\n" << std::flush;
+
+            std::string line;
+            unsigned connectionHeaders = 0;
+            while (std::getline(client, line) && line != "\r")
+            {
+                if (line.compare(0, 11, "Connection:") == 0)
+                {
+                    CXXTOOLS_UNIT_ASSERT_EQUALS(line, "Connection: close\r");
+                    ++connectionHeaders;
+                }
+            }
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(connectionHeaders, 1u);
+
+            std::ostringstream body;
+            body << client.rdbuf();
+            CXXTOOLS_UNIT_ASSERT(body.str() == content(1000));
+
+            _server->removeService(service);
+        }
+
+        void KeepAlive()
+        {
+            std::string data = content(20000);
+            std::ofstream(fileName) << data;
+
+            cxxtools::http::CachedService<FileResponder> fileService;
+            cxxtools::http::CachedService<PatternResponder> patternService;
+            _server->addService("/file", fileService);
+            _server->addService("/pattern", patternService);
+
+            cxxtools::http::Client client(_listen, _port);
+            for (unsigned n = 0; n < 3; ++n)
+            {
+                CXXTOOLS_UNIT_ASSERT(client.get("/pattern?10").body() == content(10));
+                CXXTOOLS_UNIT_ASSERT(client.get("/file").body() == data);
+                CXXTOOLS_UNIT_ASSERT(client.get("/pattern?0").body().empty());
+            }
+
+            _server->removeService(fileService);
+            _server->removeService(patternService);
+        }
+
+        void Routing()
+        {
+            NameService declining("");
+            NameService exact("exact");
+            NameService prefix("prefix");
+            NameService longPrefix("longPrefix");
+            NameService literal("literal");
+            NameService regex("regex");
+
+            // the service added first wins
+            _server->addService(cxxtools::Regex("^/static/"), declining);
+            _server->addService(cxxtools::Regex("^/static/img/"), longPrefix);
+            _server->addService("/static/index.html", exact);
+            _server->addService(cxxtools::Regex("^/static/"), prefix);
+            _server->addService(cxxtools::Regex("^/lit\\.txt$"), literal);
+            _server->addService(cxxtools::Regex("^/[a-z]+\\.txt$"), regex);
+
+            cxxtools::http::Client client(_listen, _port);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(client.get("/static/index.html").body(), "exact");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(client.get("/static/img/a.png").body(), "longPrefix");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(client.get("/static/a.css").body(), "prefix");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(client.get("/lit.txt").body(), "literal");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(client.get("/other.txt").body(), "regex");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(client.get("/litXtxt").httpReturnCode(), 404u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(client.get("/stat").httpReturnCode(), 404u);
+
+            _server->removeService(longPrefix);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(client.get("/static/img/a.png").body(), "prefix");
+
+            _server->removeService(declining);
+            _server->removeService(exact);
+            _server->removeService(prefix);
+            _server->removeService(literal);
+            _server->removeService(regex);
+        }
+
+        void EventDriven()
+        {
+            startEventDriven();
+
+            std::string data = content(3 * 1024 * 1024 + 17);
+            std::ofstream(fileName) << data;
+
+            cxxtools::http::CachedService<FileResponder> fileService;
+            cxxtools::http::CachedService<PatternResponder> patternService;
+            cxxtools::http::CachedService<EchoResponder> echoService;
+            _server->addService("/file", fileService);
+            _server->addService("/pattern", patternService);
+            _server->addService("/echo", echoService);
+
+            cxxtools::http::Client client(_listen, _port);
+            for (unsigned n = 0; n < 3; ++n)
+            {
+                CXXTOOLS_UNIT_ASSERT(client.get("/file").body() == data);
+                CXXTOOLS_UNIT_ASSERT(client.get("/pattern?100000").body() == content(100000));
+                CXXTOOLS_UNIT_ASSERT_EQUALS(client.get("/echo?10").body(), content(10));
+                CXXTOOLS_UNIT_ASSERT(client.get("/echo?200000").body() == content(200000));
+                CXXTOOLS_UNIT_ASSERT_EQUALS(client.get("/nothing").httpReturnCode(), 404u);
+            }
+
+            _server->removeService(fileService);
+            _server->removeService(patternService);
+            _server->removeService(echoService);
+        }
+
+        void EventDrivenSlowClients()
+        {
+            startEventDriven();
+            _server->maxThreads(2);
+
+            cxxtools::http::CachedService<EchoResponder> echoService;
+            _server->addService("/echo", echoService);
+
+            // the incomplete requests must not occupy the worker threads
+            std::vector<std::unique_ptr<cxxtools::net::TcpStream> > clients;
+            for (unsigned n = 0; n < 100; ++n)
+            {
+                clients.emplace_back(new cxxtools::net::TcpStream(_listen, _port));
+                *clients.back() << "POST /echo HTTP/1.1\r\n"
+                                   "Host: localhost\r\n"
+                                   "Content-Length: 8\r\n" << std::flush;
+            }
+
+            cxxtools::http::Client client(_listen, _port);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(client.get("/echo?5").body(), content(5));
+
+            for (unsigned n = 0; n < clients.size(); ++n)
+                *clients[n] << "\r\nbody" << std::flush;
+
+            for (unsigned n = 0; n < clients.size(); ++n)
+            {
+                std::ostringstream body;
+                body << "b" << n % 10 << "dy";
+                *clients[n] << body.str() << std::flush;
+
+                std::string line;
+                std::getline(*clients[n], line);
+                CXXTOOLS_UNIT_ASSERT_EQUALS(line, "HTTP/1.1 200 OK\r");
+
+                while (std::getline(*clients[n], line) && line != "\r")
+                    ;
+
+                char reply[8];
+                clients[n]->read(reply, sizeof(reply));
+                CXXTOOLS_UNIT_ASSERT_EQUALS(std::string(reply, sizeof(reply)), "body" + body.str());
+            }
+
+            _server->removeService(echoService);
+        }
+
+        void EventDrivenTimeout()
+        {
+            startEventDriven();
+            _server->readTimeout(cxxtools::Milliseconds(100));
+
+            cxxtools::net::TcpStream client(_listen, _port);
+            client << "GET /echo HTTP/1.1\r\n" << std::flush;
+
+            // the server closes the connection without reply
+            std::string line;
+            CXXTOOLS_UNIT_ASSERT(!std::getline(client, line));
+        }
+
+        void pipeline()
+        {
+            cxxtools::http::CachedService<EchoResponder> echoService;
+            _server->addService("/echo", echoService);
+
+            cxxtools::net::TcpStream client(_listen, _port);
+            client << "GET /echo?1 HTTP/1.1\r\nHost: localhost\r\n\r\n"
+                      "GET /echo?20000 HTTP/1.1\r\nHost: localhost\r\n\r\n"
+                      "POST /echo HTTP/1.1\r\nHost: localhost\r\nContent-Length: 4\r\n\r\nbody"
+                      "GET /echo?3 HTTP/1.1\r\nHost: localhost\r\n\r\n"
+                      "GET /echo?4 HTTP/1.1\r\nHo" << std::flush;
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(readBody(client), content(1));
+            CXXTOOLS_UNIT_ASSERT(readBody(client) == content(20000));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(readBody(client), "body");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(readBody(client), content(3));
+
+            // the rest of the partially sent request
+            client << "st: localhost\r\n\r\n" << std::flush;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(readBody(client), content(4));
+
+            // many small requests, which are replied together
+            std::ostringstream requests;
+            for (unsigned n = 0; n < 40; ++n)
+                requests << "GET /echo?" << n << " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+            client << requests.str() << std::flush;
+
+            for (unsigned n = 0; n < 40; ++n)
+                CXXTOOLS_UNIT_ASSERT_EQUALS(readBody(client), content(n));
+
+            _server->removeService(echoService);
+        }
+
+        void Pipelining()
+        {
+            pipeline();
+        }
+
+        void PipeliningDepth()
+        {
+            _server->pipelineDepth(1);
+            pipeline();
+        }
+
+        void EventDrivenPipelining()
+        {
+            startEventDriven();
+            pipeline();
+        }
+
+        void pipelineDeferred()
+        {
+            cxxtools::http::CachedService<EchoResponder> echoService;
+            cxxtools::http::CachedService<DeferredResponder> deferredService;
+            _server->addService("/echo", echoService);
+            _server->addService("/deferred", deferredService);
+
+            // the reply of the first request is sent without waiting for
+            // the deferred one
+            cxxtools::net::TcpStream client(_listen, _port, 0, cxxtools::Seconds(5));
+            client << "GET /echo?5 HTTP/1.1\r\nHost: localhost\r\n\r\n"
+                      "GET /deferred HTTP/1.1\r\nHost: localhost\r\n\r\n"
+                      "GET /echo?7 HTTP/1.1\r\nHost: localhost\r\n\r\n" << std::flush;
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(readBody(client), content(5));
+
+            std::function<void()> ready;
+            {
+                std::lock_guard<std::mutex> lock(deferredMutex);
+                ready.swap(deferredReady);
+            }
+
+            CXXTOOLS_UNIT_ASSERT(ready);
+            ready();
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(readBody(client), "deferred");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(readBody(client), content(7));
+
+            _server->removeService(deferredService);
+            _server->removeService(echoService);
+        }
+
+        void PipeliningDeferred()
+        {
+            // the event loop is not run during the test, so a spare thread
+            // is needed, which sends the deferred reply, while the other
+            // one is waiting for connections
+            delete _server;
+            _server = new cxxtools::http::Server(_loop, _listen, _port);
+            _server->minThreads(2);
+            _loop.processEvents();
+            pipelineDeferred();
+        }
+
+        void EventDrivenPipeliningDeferred()
+        {
+            startEventDriven();
+            pipelineDeferred();
+        }
+
+        void postBody()
+        {
+            cxxtools::http::CachedService<EchoResponder> echoService;
+            _server->addService("/echo", echoService);
+
+            // the bodies are sent by client and server without copying
+            // them to the stream buffer, when they are large enough
+            static const std::size_t sizes[] = { 10, 1500, 300000 };
+
+            cxxtools::http::Client client(_listen, _port);
+            for (unsigned n = 0; n < sizeof(sizes) / sizeof(sizes[0]); ++n)
+            {
+                cxxtools::http::Request request("/echo");
+                request.method("POST");
+                request.body() << content(sizes[n]);
+
+                client.execute(request);
+                client.readBody();
+                CXXTOOLS_UNIT_ASSERT(client.body() == content(sizes[n]));
+            }
+
+            _server->removeService(echoService);
+        }
+
+        void PostBody()
+        {
+            postBody();
+        }
+
+        void EventDrivenPostBody()
+        {
+            startEventDriven();
+            postBody();
+        }
+};
+
+cxxtools::unit::RegisterTest<HttpServerTest> register_HttpServerTest;
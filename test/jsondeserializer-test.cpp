@@ -114,6 +114,7 @@ class JsonDeserializerTest : public cxxtools::unit::TestSuite
             registerMethod("testTrailingComma", *this, &JsonDeserializerTest::testTrailingComma);
             registerMethod("testIStreamEof", *this, &JsonDeserializerTest::testIStreamEof);
             registerMethod("testIStreamFail", *this, &JsonDeserializerTest::testIStreamFail);
+            registerMethod("testAdvanceUtf8", *this, &JsonDeserializerTest::testAdvanceUtf8);
         }
 
         void testInt()
@@ -433,6 +434,40 @@ class JsonDeserializerTest : public cxxtools::unit::TestSuite
             CXXTOOLS_UNIT_ASSERT_NOTHROW(in >> cxxtools::Json(si));
             CXXTOOLS_UNIT_ASSERT(in.fail());
         }
+
+        void testAdvanceUtf8()
+        {
+            std::string json = "{\"a\": \"hello\", \"b\": \"M\xc3\xa4kitalo\", \"\xc3\xa4\": \"\\u00e4\\ud834\\udd1e\", c: 42}";
+
+            cxxtools::JsonDeserializer deserializer;
+            deserializer.begin();
+            for (std::string::const_iterator it = json.begin(); it != json.end(); ++it)
+                if (deserializer.advance(*it))
+                    break;
+            deserializer.finish();
+
+            const cxxtools::SerializationInfo& si = deserializer.si();
+
+            CXXTOOLS_UNIT_ASSERT(si.getMember("a").isString8());
+            std::string a;
+            si.getMember("a") >>= a;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(a, "hello");
+
+            cxxtools::String b;
+            si.getMember("b") >>= b;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(b.size(), 8u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(static_cast<int32_t>(b[1].value()), 0xe4);
+
+            cxxtools::String u;
+            si.getMember("\xc3\xa4") >>= u;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(u.size(), 2u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(static_cast<int32_t>(u[0].value()), 0xe4);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(static_cast<int32_t>(u[1].value()), 0x1d11e);
+
+            int c = 0;
+            si.getMember("c") >>= c;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(c, 42);
+        }
 };
 
 cxxtools::unit::RegisterTest<JsonDeserializerTest> register_JsonDeserializerTest;
@@ -0,0 +1,241 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include "cxxtools/jsonreader.h"
+#include "cxxtools/jsonparser.h"
+#include "cxxtools/serializationinfo.h"
+#include <sstream>
+#include <vector>
+
+namespace
+{
+    struct Record
+    {
+        int id;
+        std::string name;
+        std::vector<double> values;
+
+        Record()
+            : id(0)
+            { }
+    };
+
+    inline void operator>>= (const cxxtools::SerializationInfo& si, Record& r)
+    {
+        si.getMember("id") >>= r.id;
+        si.getMember("name") >>= r.name;
+        si.getMember("values") >>= r.values;
+    }
+}
+
+class JsonReaderTest : public cxxtools::unit::TestSuite
+{
+    public:
+        JsonReaderTest()
+            : cxxtools::unit::TestSuite("jsonreader")
+        {
+            registerMethod("testTokens", *this, &JsonReaderTest::testTokens);
+            registerMethod("testRecords", *this, &JsonReaderTest::testRecords);
+            registerMethod("testSkip", *this, &JsonReaderTest::testSkip);
+            registerMethod("testScalar", *this, &JsonReaderTest::testScalar);
+            registerMethod("testUnicode", *this, &JsonReaderTest::testUnicode);
+            registerMethod("testComments", *this, &JsonReaderTest::testComments);
+            registerMethod("testMultipleDocuments", *this, &JsonReaderTest::testMultipleDocuments);
+            registerMethod("testInvalid", *this, &JsonReaderTest::testInvalid);
+        }
+
+        void testTokens()
+        {
+            std::istringstream in("{\"a\": 1, \"b\": [true, null, \"x\\ty\"], c: -2.5e3}");
+            cxxtools::JsonReader reader(in);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.next(), cxxtools::JsonReader::BeginObject);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.next(), cxxtools::JsonReader::NumberValue);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.name(), "a");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.value(), "1");
+            CXXTOOLS_UNIT_ASSERT(!reader.isFloat());
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.next(), cxxtools::JsonReader::BeginArray);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.name(), "b");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.depth(), 2u);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.next(), cxxtools::JsonReader::BoolValue);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.value(), "true");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.next(), cxxtools::JsonReader::NullValue);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.next(), cxxtools::JsonReader::StringValue);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.value(), "x\ty");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.next(), cxxtools::JsonReader::EndArray);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.next(), cxxtools::JsonReader::NumberValue);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.name(), "c");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.value(), "-2.5e3");
+            CXXTOOLS_UNIT_ASSERT(reader.isFloat());
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.next(), cxxtools::JsonReader::EndObject);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.next(), cxxtools::JsonReader::EndOfInput);
+        }
+
+        void testRecords()
+        {
+            std::istringstream in(
+                "[ {\"id\": 1, \"name\": \"foo\", \"values\": [1.5, 2]},\n"
+                "  {\"id\": 2, \"name\": \"bar\", \"values\": []},\n"
+                "  {\"id\": 3, \"name\": \"baz\", \"values\": [3]} ]");
+            cxxtools::JsonReader reader(in);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.next(), cxxtools::JsonReader::BeginArray);
+
+            std::vector<Record> records;
+            while (reader.next() != cxxtools::JsonReader::EndArray)
+            {
+                Record r;
+                reader.get(r);
+                records.push_back(r);
+            }
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(records.size(), 3u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(records[0].id, 1);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(records[0].name, "foo");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(records[0].values.size(), 2u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(records[0].values[0], 1.5);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(records[1].name, "bar");
+            CXXTOOLS_UNIT_ASSERT(records[1].values.empty());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(records[2].id, 3);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(records[2].values[0], 3);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.next(), cxxtools::JsonReader::EndOfInput);
+        }
+
+        void testSkip()
+        {
+            std::istringstream in("{\"big\": {\"a\": [1, {\"b\": \"]}\"}], \"c\": {}}, \"id\": 42}");
+            cxxtools::JsonReader reader(in);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.next(), cxxtools::JsonReader::BeginObject);
+
+            int id = 0;
+            while (reader.next() != cxxtools::JsonReader::EndObject)
+            {
+                if (reader.name() == "id")
+                    reader.get(id);
+                else
+                    reader.skip();
+            }
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(id, 42);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.next(), cxxtools::JsonReader::EndOfInput);
+        }
+
+        void testScalar()
+        {
+            std::istringstream in("\"hello\"");
+            cxxtools::JsonReader reader(in);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.next(), cxxtools::JsonReader::StringValue);
+
+            const cxxtools::SerializationInfo& si = reader.read();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(si.typeName(), "string");
+
+            std::string value;
+            si >>= value;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(value, "hello");
+        }
+
+        void testUnicode()
+        {
+            std::istringstream in("[\"\\u00e4\", \"\\ud834\\udd1e\", \"\xc3\xb6\"]");
+            cxxtools::JsonReader reader(in);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.next(), cxxtools::JsonReader::BeginArray);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.next(), cxxtools::JsonReader::StringValue);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.value(), "\xc3\xa4");
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.next(), cxxtools::JsonReader::StringValue);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.value(), "\xf0\x9d\x84\x9e");
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.next(), cxxtools::JsonReader::StringValue);
+            cxxtools::String s;
+            reader.get(s);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(s.size(), 1u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(s[0], cxxtools::Char(0xf6));
+        }
+
+        void testComments()
+        {
+            std::istringstream in("// leading comment\n[ 1, /* two */ 2 ]");
+            cxxtools::JsonReader reader(in);
+
+            std::vector<int> values;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.next(), cxxtools::JsonReader::BeginArray);
+            reader.get(values);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(values.size(), 2u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(values[1], 2);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(reader.lineNo(), 2u);
+        }
+
+        void testMultipleDocuments()
+        {
+            std::istringstream in("{\"v\": 1}\n{\"v\": 2}\n{\"v\": 3}\n");
+            cxxtools::JsonReader reader(in);
+
+            int sum = 0;
+            while (reader.next() != cxxtools::JsonReader::EndOfInput)
+            {
+                int v;
+                reader.read().getMember("v") >>= v;
+                sum += v;
+            }
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(sum, 6);
+        }
+
+        void testInvalid()
+        {
+            {
+                std::istringstream in("[1 2]");
+                cxxtools::JsonReader reader(in);
+                reader.next();
+                reader.next();
+                CXXTOOLS_UNIT_ASSERT_THROW(reader.next(), cxxtools::JsonParserError);
+            }
+
+            {
+                std::istringstream in("{\"a\": [1, 2");
+                cxxtools::JsonReader reader(in);
+                reader.next();
+                reader.next();
+                CXXTOOLS_UNIT_ASSERT_THROW(reader.skip(), cxxtools::JsonParserError);
+            }
+        }
+};
+
+cxxtools::unit::RegisterTest<JsonReaderTest> register_JsonReaderTest;
@@ -39,6 +39,8 @@
 #include <stdlib.h>
 #include <sstream>
 
+#include "asyncwaiting.h"
+
 log_define("cxxtools.test.jsonrpc")
 
 namespace
@@ -83,6 +85,9 @@ class JsonRpcTest : public cxxtools::unit::TestSuite
         std::string _listen;
         unsigned short _port;
 
+        // procedures waiting for "release"
+        AsyncWaiting _waiting;
+
     public:
         JsonRpcTest()
         : cxxtools::unit::TestSuite("jsonrpc"),
@@ -111,6 +116,9 @@ class JsonRpcTest : public cxxtools::unit::TestSuite
             registerMethod("PrepareConnect", *this, &JsonRpcTest::PrepareConnect);
             registerMethod("Connect", *this, &JsonRpcTest::Connect);
             registerMethod("Multiple", *this, &JsonRpcTest::Multiple);
+            registerMethod("Async", *this, &JsonRpcTest::Async);
+            registerMethod("AsyncOverlap", *this, &JsonRpcTest::AsyncOverlap);
+            registerMethod("AsyncFault", *this, &JsonRpcTest::AsyncFault);
 
             char* PORT = getenv("UTEST_PORT");
             if (PORT)
@@ -803,6 +811,104 @@ class JsonRpcTest : public cxxtools::unit::TestSuite
 
         }
 
+        ////////////////////////////////////////////////////////////
+        // Async
+        //
+        void Async()
+        {
+            // one of the workers blocks in accept, so the other one must not
+            // be blocked by the waiting procedure
+            _server->maxThreads(2);
+            _server->registerAsyncMethod("wait", _waiting, &AsyncWaiting::wait);
+            _server->registerMethod("release", _waiting, &AsyncWaiting::release);
+
+            cxxtools::json::RpcClient client1(_loop, _listen, _port);
+            cxxtools::json::RpcClient client2(_loop, _listen, _port);
+            cxxtools::RemoteProcedure<int, int> wait(client1, "wait");
+            cxxtools::RemoteProcedure<bool, int> release(client2, "release");
+
+            wait.begin(21);
+            AsyncWaiting::callRelease(release, 2);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(wait.end(2000), 42);
+
+            // the connection is usable after the asynchronous call
+            wait.begin(5);
+            AsyncWaiting::callRelease(release, 3);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(wait.end(2000), 15);
+        }
+
+        ////////////////////////////////////////////////////////////
+        // AsyncOverlap
+        //
+        void AsyncOverlap()
+        {
+            // one of the workers blocks in accept, so the other one must not
+            // be blocked by the waiting procedures
+            _server->maxThreads(2);
+            _server->registerAsyncMethod("wait", _waiting, &AsyncWaiting::wait);
+
+            cxxtools::json::RpcClient client1(_loop, _listen, _port);
+            cxxtools::json::RpcClient client2(_loop, _listen, _port);
+            cxxtools::RemoteProcedure<int, int> wait1(client1, "wait");
+            cxxtools::RemoteProcedure<int, int> wait2(client2, "wait");
+            connect(wait1.finished, _waiting, &AsyncWaiting::onFinished);
+            connect(wait2.finished, _waiting, &AsyncWaiting::onFinished);
+            _waiting.finished.clear();
+
+            wait1.begin(2);
+            wait2.begin(3);
+
+            for (int n = 0; n < 200 && _waiting.count() < 2; ++n)
+                _loop.wait(10);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_waiting.count(), 2u);
+
+            // the second call finishes first
+            _waiting.releaseValue(3, 10);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(wait2.end(2000), 30);
+
+            _waiting.releaseValue(2, 10);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(wait1.end(2000), 20);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_waiting.finished.size(), 2u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_waiting.finished[0], 30);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_waiting.finished[1], 20);
+        }
+
+        ////////////////////////////////////////////////////////////
+        // AsyncFault
+        //
+        void AsyncFault()
+        {
+            _server->registerAsyncMethod("fault", *this, &JsonRpcTest::asyncFault);
+            _server->registerMethod("multiply", *this, &JsonRpcTest::multiplyInt);
+
+            cxxtools::json::RpcClient client(_loop, _listen, _port);
+            cxxtools::RemoteProcedure<int, int> fault(client, "fault");
+            cxxtools::RemoteProcedure<int, int, int> multiply(client, "multiply");
+
+            fault.begin(7);
+
+            try
+            {
+                fault.end(2000);
+                CXXTOOLS_UNIT_ASSERT_MSG(false, "cxxtools::RemoteException exception expected");
+            }
+            catch (const cxxtools::RemoteException& e)
+            {
+                CXXTOOLS_UNIT_ASSERT_EQUALS(e.rc(), 7);
+                CXXTOOLS_UNIT_ASSERT_EQUALS(e.text(), "async fault");
+            }
+
+            multiply.begin(2, 3);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(multiply.end(2000), 6);
+        }
+
+        void asyncFault(cxxtools::AsyncResult<int> result, int rc)
+        {
+            result.setError(cxxtools::RemoteException("async fault", rc));
+        }
+
 };
 
 cxxtools::unit::RegisterTest<JsonRpcTest> register_JsonRpcTest;
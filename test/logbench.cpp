@@ -55,12 +55,14 @@ namespace bench
             Logtester(unsigned long count,
                                 unsigned long loops,
                                 unsigned long enabled)
-                : _thread(&Logtester::run, this),
-                  _count(count),
+                : _count(count),
                   _loops(loops),
                   _enabled(enabled)
                   { }
 
+            void start()
+            { _thread = std::thread(&Logtester::run, this); }
+
             void join()
             { _thread.join(); }
 
@@ -98,6 +100,8 @@ int main(int argc, char* argv[])
         cxxtools::Arg<unsigned short> udpport(argc, argv, 'u');
         cxxtools::Arg<std::string> logfile(argc, argv, 'f', "/dev/null");
         cxxtools::Arg<bool> norollingfile(argc, argv, 'r');
+        cxxtools::Arg<bool> async(argc, argv, 'a');
+        cxxtools::Arg<unsigned> asyncBufferSize(argc, argv, 'b', 1024);
 
         cxxtools::LogConfiguration logConfiguration;
         logConfiguration.setRootLevel(cxxtools::Logger::LOG_LEVEL_INFO);
@@ -129,6 +133,9 @@ int main(int argc, char* argv[])
                 logConfiguration.setFile(logfile, 1024*1024, 0);
         }
 
+        if (async)
+            logConfiguration.setAsync(asyncBufferSize);
+
         log_init(logConfiguration);
 
         unsigned long count = 1;
@@ -154,6 +161,8 @@ int main(int argc, char* argv[])
             }
             else
             {
+                for (Threads::iterator it = threads.begin(); it != threads.end(); ++it)
+                    (*it)->start();
                 for (Threads::iterator it = threads.begin(); it != threads.end(); ++it)
                     (*it)->join();
             }
@@ -29,8 +29,65 @@
 #include "cxxtools/log.h"
 #include "cxxtools/unit/testsuite.h"
 #include "cxxtools/unit/registertest.h"
+#include <fstream>
 #include <sstream>
+#include <thread>
+#include <vector>
 #include <cxxtools/properties.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+log_define("logconfiguration")
+
+namespace
+{
+  const char* logFileName = "logconfiguration-test.log";
+
+  // Logs from some threads while reconfiguring and from a forked child.
+  // Returns the exit code of the process.
+  int logAsyncReconfigure()
+  {
+    cxxtools::LogConfiguration config;
+    config.setRootLevel(cxxtools::Logger::LOG_LEVEL_FATAL);
+    config.setLogLevel("logconfiguration", cxxtools::Logger::LOG_LEVEL_INFO);
+    config.setFile(logFileName);
+    config.setAsync(16);
+    log_init(config);
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < 4; ++t)
+      threads.emplace_back([] {
+        for (unsigned n = 0; n < 1000; ++n)
+          log_info("message " << n);
+      });
+
+    for (unsigned n = 0; n < 20; ++n)
+      log_init(config);
+
+    for (unsigned t = 0; t < threads.size(); ++t)
+      threads[t].join();
+
+    pid_t pid = ::fork();
+    if (pid == 0)
+    {
+      log_init(config);
+      log_info("message from child");
+      config.setSync();
+      log_init(config);
+      ::_exit(0);
+    }
+
+    int status;
+    if (pid < 0 || ::waitpid(pid, &status, 0) != pid
+        || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+      return 1;
+
+    // writes the remaining messages
+    config.setSync();
+    log_init(config);
+    return 0;
+  }
+}
 
 class LogconfigurationTest : public cxxtools::unit::TestSuite
 {
@@ -45,6 +102,8 @@ class LogconfigurationTest : public cxxtools::unit::TestSuite
       registerMethod("rootLevelTest", *this, &LogconfigurationTest::rootLevelTest);
       registerMethod("hierachicalTest", *this, &LogconfigurationTest::hierachicalTest);
       registerMethod("convertLogFlagsTest", *this, &LogconfigurationTest::convertLogFlagsTest);
+      registerMethod("asyncTest", *this, &LogconfigurationTest::asyncTest);
+      registerMethod("asyncReconfigureTest", *this, &LogconfigurationTest::asyncReconfigureTest);
     }
 
     void logLevelTest();
@@ -54,6 +113,8 @@ class LogconfigurationTest : public cxxtools::unit::TestSuite
     void rootLevelTest();
     void hierachicalTest();
     void convertLogFlagsTest();
+    void asyncTest();
+    void asyncReconfigureTest();
 };
 
 void LogconfigurationTest::logLevelTest()
@@ -257,5 +318,76 @@ void LogconfigurationTest::convertLogFlagsTest()
   CXXTOOLS_UNIT_ASSERT_THROW(cxxtools::LogConfiguration::strToLogFlags("blah"), std::runtime_error);
 }
 
+void LogconfigurationTest::asyncTest()
+{
+  {
+    std::istringstream properties(
+      "rootlogger=WARN\n");
+
+    cxxtools::LogConfiguration config;
+    properties >> cxxtools::Properties(config);
+
+    CXXTOOLS_UNIT_ASSERT(!config.async());
+  }
+
+  {
+    std::istringstream properties(
+      "rootlogger=WARN\n"
+      "async=true\n"
+      "asyncbuffer=256\n"
+      "asyncoverflow=count\n");
+
+    cxxtools::LogConfiguration config;
+    properties >> cxxtools::Properties(config);
+
+    CXXTOOLS_UNIT_ASSERT(config.async());
+    CXXTOOLS_UNIT_ASSERT_EQUALS(config.asyncBufferSize(), 256u);
+    CXXTOOLS_UNIT_ASSERT_EQUALS(config.asyncOverflow(), cxxtools::LogConfiguration::OverflowCount);
+  }
+
+  {
+    std::istringstream properties(
+      "rootlogger=WARN\n"
+      "async=true\n"
+      "asyncoverflow=sometimes\n");
+
+    cxxtools::LogConfiguration config;
+    CXXTOOLS_UNIT_ASSERT_THROW(properties >> cxxtools::Properties(config), std::runtime_error);
+  }
+}
+
+void LogconfigurationTest::asyncReconfigureTest()
+{
+  // logging is configured in a child process, so that the other tests
+  // are not affected
+  ::unlink(logFileName);
+
+  pid_t pid = ::fork();
+  if (pid == 0)
+    ::_exit(logAsyncReconfigure());
+
+  int status;
+  CXXTOOLS_UNIT_ASSERT_EQUALS(::waitpid(pid, &status, 0), pid);
+  CXXTOOLS_UNIT_ASSERT(WIFEXITED(status));
+  CXXTOOLS_UNIT_ASSERT_EQUALS(WEXITSTATUS(status), 0);
+
+  // no message is lost, when the writer is replaced
+  unsigned messages = 0;
+  bool childMessage = false;
+  std::ifstream in(logFileName);
+  std::string line;
+  while (std::getline(in, line))
+  {
+    if (line.find("message from child") != std::string::npos)
+      childMessage = true;
+    else if (line.find("message ") != std::string::npos)
+      ++messages;
+  }
+
+  CXXTOOLS_UNIT_ASSERT_EQUALS(messages, 4000u);
+  CXXTOOLS_UNIT_ASSERT(childMessage);
+
+  ::unlink(logFileName);
+}
 
 cxxtools::unit::RegisterTest<LogconfigurationTest> register_LogconfigurationTest;
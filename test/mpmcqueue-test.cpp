@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/mpmcqueue.h"
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+
+#include <thread>
+#include <vector>
+
+class MpmcQueueTest : public cxxtools::unit::TestSuite
+{
+    public:
+        MpmcQueueTest()
+        : cxxtools::unit::TestSuite("mpmcqueue")
+        {
+            registerMethod("testFifo", *this, &MpmcQueueTest::testFifo);
+            registerMethod("testCapacity", *this, &MpmcQueueTest::testCapacity);
+            registerMethod("testOverflow", *this, &MpmcQueueTest::testOverflow);
+            registerMethod("testTimeout", *this, &MpmcQueueTest::testTimeout);
+            registerMethod("testThreads", *this, &MpmcQueueTest::testThreads);
+        }
+
+        void testFifo()
+        {
+            cxxtools::MpmcQueue<int> queue(4);
+
+            CXXTOOLS_UNIT_ASSERT(queue.empty());
+
+            queue.put(1);
+            queue.put(2);
+            queue.put(3);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(queue.size(), 3u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(queue.get(), 1);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(queue.get(), 2);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(queue.tryGet().first, 3);
+
+            std::pair<int, bool> r = queue.tryGet();
+            CXXTOOLS_UNIT_ASSERT(!r.second);
+            CXXTOOLS_UNIT_ASSERT(queue.empty());
+        }
+
+        void testCapacity()
+        {
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::MpmcQueue<int>(1).capacity(), 2u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::MpmcQueue<int>(5).capacity(), 8u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cxxtools::MpmcQueue<int>(16).capacity(), 16u);
+        }
+
+        void testOverflow()
+        {
+            cxxtools::MpmcQueue<int> queue(2, true);
+
+            for (int i = 0; i < 10; ++i)
+                queue.put(i);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(queue.size(), 10u);
+
+            for (int i = 0; i < 10; ++i)
+                CXXTOOLS_UNIT_ASSERT_EQUALS(queue.get(), i);
+
+            CXXTOOLS_UNIT_ASSERT(queue.empty());
+        }
+
+        void testTimeout()
+        {
+            cxxtools::MpmcQueue<int> queue;
+
+            std::pair<int, bool> r = queue.get(cxxtools::Milliseconds(10));
+            CXXTOOLS_UNIT_ASSERT(!r.second);
+
+            queue.put(42);
+            r = queue.get(cxxtools::Milliseconds(10));
+            CXXTOOLS_UNIT_ASSERT(r.second);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(r.first, 42);
+        }
+
+        void testThreads()
+        {
+            // small capacity, so that producers and consumers both block
+            cxxtools::MpmcQueue<unsigned> queue(4);
+
+            const unsigned numThreads = 4;
+            const unsigned count = 10000;
+
+            std::vector<unsigned long> sums(numThreads);
+            std::vector<std::thread> threads;
+
+            for (unsigned t = 0; t < numThreads; ++t)
+                threads.push_back(std::thread([&queue, &sums, t]() {
+                    unsigned long sum = 0;
+                    for (unsigned n = 0; n < count; ++n)
+                        sum += queue.get();
+                    sums[t] = sum;
+                }));
+
+            for (unsigned t = 0; t < numThreads; ++t)
+                threads.push_back(std::thread([&queue]() {
+                    for (unsigned n = 1; n <= count; ++n)
+                        queue.put(n);
+                }));
+
+            for (unsigned t = 0; t < threads.size(); ++t)
+                threads[t].join();
+
+            unsigned long sum = 0;
+            for (unsigned t = 0; t < numThreads; ++t)
+                sum += sums[t];
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(sum, numThreads * (static_cast<unsigned long>(count) * (count + 1) / 2));
+            CXXTOOLS_UNIT_ASSERT(queue.empty());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(queue.numWaiting(), 0u);
+        }
+
+};
+
+cxxtools::unit::RegisterTest<MpmcQueueTest> register_MpmcQueueTest;
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/*
+ * Measures the throughput of cxxtools::Queue and cxxtools::MpmcQueue
+ * with an increasing number of threads. Half of the threads put
+ * elements to the queue and the other half fetches them.
+ */
+
+#include <cxxtools/arg.h>
+#include <cxxtools/clock.h>
+#include <cxxtools/queue.h>
+#include <cxxtools/mpmcqueue.h>
+
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <vector>
+
+namespace bench
+{
+    template <typename QueueType>
+    double run(QueueType& queue, unsigned numThreads, unsigned long count)
+    {
+        unsigned producers = (numThreads + 1) / 2;
+        unsigned consumers = numThreads - producers;
+        if (consumers == 0)
+            consumers = 1;
+
+        unsigned long total = count * producers;
+
+        std::vector<std::thread> threads;
+
+        cxxtools::Clock cl;
+        cl.start();
+
+        for (unsigned c = 0; c < consumers; ++c)
+        {
+            unsigned long n = total / consumers + (c < total % consumers ? 1 : 0);
+            threads.push_back(std::thread([&queue, n]() {
+                for (unsigned long i = 0; i < n; ++i)
+                    queue.get();
+            }));
+        }
+
+        for (unsigned p = 0; p < producers; ++p)
+        {
+            threads.push_back(std::thread([&queue, count]() {
+                for (unsigned long i = 0; i < count; ++i)
+                    queue.put(i);
+            }));
+        }
+
+        for (unsigned t = 0; t < threads.size(); ++t)
+            threads[t].join();
+
+        cxxtools::Seconds T = cl.stop();
+        return total / T;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        cxxtools::Arg<unsigned long> count(argc, argv, 'n', 100000);  // elements per producer
+        cxxtools::Arg<unsigned> maxThreads(argc, argv, 't', 64);
+        cxxtools::Arg<unsigned> capacity(argc, argv, 'c', 1024);
+
+        std::cout << "threads\tQueue msg/s\tMpmcQueue msg/s" << std::endl;
+
+        for (unsigned numThreads = 1; numThreads <= maxThreads; numThreads <<= 1)
+        {
+            cxxtools::Queue<unsigned long> queue;
+            queue.maxSize(capacity);
+            double q = bench::run(queue, numThreads, count);
+
+            cxxtools::MpmcQueue<unsigned long> mpmcQueue(capacity);
+            double m = bench::run(mpmcQueue, numThreads, count);
+
+            std::cout << numThreads << '\t'
+                      << std::fixed << std::setprecision(0) << q << '\t'
+                      << m << std::endl;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return -1;
+    }
+}
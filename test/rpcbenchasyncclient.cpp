@@ -281,13 +281,18 @@ class BenchClient : public cxxtools::Connectable
     }
 
 public:
-    explicit BenchClient(ClientCreator& clientCreator, unsigned numClients)
+    BenchClient(ClientCreator& clientCreator, unsigned numClients, bool multiplex)
         : _thread(&cxxtools::EventLoop::run, &_loop)
     {
-        while (_clients.size() < numClients)
+        cxxtools::RemoteClient* client = 0;
+        while (executors.size() < numClients)
         {
-            cxxtools::RemoteClient* client = clientCreator.create(_loop);
-            _clients.insert(client);
+            // in multiplex mode all requests share one connection
+            if (client == 0 || !multiplex)
+            {
+                client = clientCreator.create(_loop);
+                _clients.insert(client);
+            }
 
             RemoteExecutor* executor;
 
@@ -310,10 +315,11 @@ public:
 
     ~BenchClient()
     {
-        for (std::set<cxxtools::RemoteClient*>::iterator it = _clients.begin(); it != _clients.end(); ++it)
-            delete *it;
+        // the procedures of the executors refer to the clients
         for (std::set<RemoteExecutor*>::iterator it = executors.begin(); it != executors.end(); ++it)
             delete *it;
+        for (std::set<cxxtools::RemoteClient*>::iterator it = _clients.begin(); it != _clients.end(); ++it)
+            delete *it;
     }
 
     static unsigned numRequests()
@@ -368,12 +374,13 @@ int main(int argc, char* argv[])
         cxxtools::Arg<bool> binary(argc, argv, 'b');
         cxxtools::Arg<bool> json(argc, argv, 'j');
         cxxtools::Arg<bool> jsonhttp(argc, argv, 'J');
+        cxxtools::Arg<bool> multiplex(argc, argv, 'm');
         cxxtools::Arg<unsigned short> port(argc, argv, 'p', binary ? 7003 : json ? 7004 : 7002);
         BenchClient::numRequests(cxxtools::Arg<unsigned>(argc, argv, 'n', 10000));
         BenchClient::vectorSize(cxxtools::Arg<unsigned>(argc, argv, 'v', 0));
         BenchClient::objectsSize(cxxtools::Arg<unsigned>(argc, argv, 'o', 0));
 
-        if (!xmlrpc && !binary && !json && !jsonhttp)
+        if ((!xmlrpc && !binary && !json && !jsonhttp) || (multiplex && !binary))
         {
                 std::cerr << "usage: " << argv[0] << " [options]\n"
                              "options:\n"
@@ -384,6 +391,7 @@ int main(int argc, char* argv[])
                              "     -j                 use json rpc protocol\n"
                              "     -J                 use json rpc over http protocol\n"
                              "     -c number    concurrent request per thread (default: 4)\n"
+                             "     -m                 send concurrent requests of a thread on one connection (binary only)\n"
                              "     -t number    set number of threads (default: 4)\n"
                              "     -n number    set number of requests (default: 10000)\n"
                              "one protocol must be selected\n"
@@ -407,7 +415,7 @@ int main(int argc, char* argv[])
 
         while (clients.size() < threads)
         {
-            clients.emplace_back(new BenchClient(clientCreator, concurrentRequestsPerThread));
+            clients.emplace_back(new BenchClient(clientCreator, concurrentRequestsPerThread, multiplex));
         }
 
         for (auto& cl: clients)
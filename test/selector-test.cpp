@@ -0,0 +1,375 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include "cxxtools/selector.h"
+#include "cxxtools/timer.h"
+#include "cxxtools/clock.h"
+#include "cxxtools/net/tcpserver.h"
+#include "cxxtools/net/tcpsocket.h"
+#include <vector>
+#include <memory>
+#include <stdlib.h>
+
+class TimerProbe : public cxxtools::Connectable
+{
+    unsigned _n;
+    std::vector<unsigned>& _fired;
+
+    void onTimeout()
+    {
+        _fired.push_back(_n);
+    }
+
+public:
+    cxxtools::Timer timer;
+
+    TimerProbe(cxxtools::Selector& selector, unsigned n, std::vector<unsigned>& fired)
+        : _n(n),
+          _fired(fired),
+          timer(&selector)
+    {
+        cxxtools::connect(timer.timeout, *this, &TimerProbe::onTimeout);
+    }
+};
+
+class SelectorTest : public cxxtools::unit::TestSuite
+{
+    unsigned short _port;
+    std::string _backend;
+    unsigned _inputReady;
+    std::vector<std::unique_ptr<cxxtools::net::TcpSocket>> _accepted;
+    std::vector<unsigned> _fired;
+    std::unique_ptr<TimerProbe> _victim;
+
+    void onConnectionPending(cxxtools::net::TcpServer& server)
+    {
+        _accepted.emplace_back(new cxxtools::net::TcpSocket(server));
+    }
+
+    void onInputReady(cxxtools::IODevice&)
+    {
+        ++_inputReady;
+    }
+
+    void onStopVictim()
+    {
+        _fired.push_back(0);
+        _victim->timer.stop();
+    }
+
+    void onDestroyVictim()
+    {
+        _fired.push_back(0);
+        _victim.reset();
+    }
+
+    void waitFired(cxxtools::Selector& selector, unsigned count)
+    {
+        cxxtools::Timespan deadline = cxxtools::Timespan::gettimeofday() + cxxtools::Seconds(5);
+        while (_fired.size() < count && cxxtools::Timespan::gettimeofday() < deadline)
+            selector.wait(1000);
+    }
+
+    void setBackend(const char* backend)
+    {
+        ::setenv("CXXTOOLS_SELECTOR", backend, 1);
+    }
+
+    void readReady(const char* backend)
+    {
+        setBackend(backend);
+
+        cxxtools::Selector selector;
+        cxxtools::net::TcpServer server("127.0.0.1", _port);
+        cxxtools::connect(server.connectionPending, *this, &SelectorTest::onConnectionPending);
+        selector.add(server);
+
+        std::vector<std::unique_ptr<cxxtools::net::TcpSocket>> clients;
+        for (unsigned n = 0; n < 20; ++n)
+        {
+            clients.emplace_back(new cxxtools::net::TcpSocket("127.0.0.1", _port));
+            while (_accepted.size() <= n)
+                CXXTOOLS_UNIT_ASSERT(selector.wait(1000));
+        }
+
+        char buffer[16];
+        for (unsigned n = 0; n < _accepted.size(); ++n)
+        {
+            cxxtools::connect(_accepted[n]->inputReady, *this, &SelectorTest::onInputReady);
+            selector.add(*_accepted[n]);
+            _accepted[n]->beginRead(buffer, sizeof(buffer));
+        }
+
+        // nothing to read yet
+        CXXTOOLS_UNIT_ASSERT(!selector.wait(10));
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_inputReady, 0);
+
+        clients[7]->write("A", 1);
+        CXXTOOLS_UNIT_ASSERT(selector.wait(1000));
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_inputReady, 1);
+
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_accepted[7]->endRead(), 1);
+        CXXTOOLS_UNIT_ASSERT_EQUALS(buffer[0], 'A');
+
+        // not reading any more, so the pending data must not be reported
+        clients[7]->write("B", 1);
+        CXXTOOLS_UNIT_ASSERT(!selector.wait(10));
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_inputReady, 1);
+
+        _accepted[7]->beginRead(buffer, sizeof(buffer));
+        CXXTOOLS_UNIT_ASSERT(selector.wait(1000));
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_inputReady, 2);
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_accepted[7]->endRead(), 1);
+        CXXTOOLS_UNIT_ASSERT_EQUALS(buffer[0], 'B');
+
+        // removed devices are not reported
+        selector.remove(*_accepted[3]);
+        clients[3]->write("C", 1);
+        CXXTOOLS_UNIT_ASSERT(!selector.wait(10));
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_inputReady, 2);
+
+        _accepted.clear();
+    }
+
+    void wake(const char* backend)
+    {
+        setBackend(backend);
+
+        cxxtools::Selector selector;
+        selector.wake();
+        CXXTOOLS_UNIT_ASSERT(selector.wait(1000));
+        CXXTOOLS_UNIT_ASSERT(!selector.wait(0));
+    }
+
+public:
+    SelectorTest()
+        : cxxtools::unit::TestSuite("selector"),
+          _port(7011),
+          _inputReady(0)
+    {
+        registerMethod("pollReadReady", *this, &SelectorTest::pollReadReady);
+        registerMethod("pollWake", *this, &SelectorTest::pollWake);
+        registerMethod("epollReadReady", *this, &SelectorTest::epollReadReady);
+        registerMethod("epollWake", *this, &SelectorTest::epollWake);
+        registerMethod("timerOrder", *this, &SelectorTest::timerOrder);
+        registerMethod("timerCoalescing", *this, &SelectorTest::timerCoalescing);
+        registerMethod("timerLong", *this, &SelectorTest::timerLong);
+        registerMethod("timerStop", *this, &SelectorTest::timerStop);
+        registerMethod("timerStopInHandler", *this, &SelectorTest::timerStopInHandler);
+        registerMethod("timerDestroyInHandler", *this, &SelectorTest::timerDestroyInHandler);
+        registerMethod("timerWaitTimeout", *this, &SelectorTest::timerWaitTimeout);
+    }
+
+    void setUp()
+    {
+        const char* backend = ::getenv("CXXTOOLS_SELECTOR");
+        _backend = backend ? backend : "";
+        _inputReady = 0;
+        _accepted.clear();
+        _fired.clear();
+    }
+
+    void tearDown()
+    {
+        _accepted.clear();
+
+        if (_backend.empty())
+            ::unsetenv("CXXTOOLS_SELECTOR");
+        else
+            ::setenv("CXXTOOLS_SELECTOR", _backend.c_str(), 1);
+    }
+
+    void pollReadReady()
+    { readReady("poll"); }
+
+    void pollWake()
+    { wake("poll"); }
+
+    void epollReadReady()
+    { readReady("epoll"); }
+
+    void epollWake()
+    { wake("epoll"); }
+
+    void timerOrder()
+    {
+        cxxtools::Selector selector;
+
+        static const unsigned delays[] = { 40, 10, 25, 10, 25, 1 };
+        static const unsigned expected[] = { 5, 1, 3, 2, 4, 0 };
+        const unsigned count = sizeof(delays) / sizeof(delays[0]);
+
+        std::vector<std::unique_ptr<TimerProbe>> timers;
+        for (unsigned n = 0; n < count; ++n)
+            timers.emplace_back(new TimerProbe(selector, n, _fired));
+
+        // timers 1 and 3 resp. 2 and 4 are due at the same time
+        cxxtools::Timespan now = cxxtools::Clock::getSystemTicks();
+        for (unsigned n = 0; n < count; ++n)
+            timers[n]->timer.after(cxxtools::Milliseconds(delays[n]));
+
+        waitFired(selector, count);
+
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_fired.size(), count);
+        for (unsigned n = 0; n < count; ++n)
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_fired[n], expected[n]);
+
+        CXXTOOLS_UNIT_ASSERT(cxxtools::Clock::getSystemTicks() - now >= cxxtools::Milliseconds(40));
+    }
+
+    void timerCoalescing()
+    {
+        cxxtools::Selector selector;
+        selector.timerResolution(100);
+        CXXTOOLS_UNIT_ASSERT_EQUALS(selector.timerResolution(), cxxtools::Milliseconds(100));
+
+        TimerProbe t1(selector, 1, _fired);
+        TimerProbe t2(selector, 2, _fired);
+
+        // wait for the start of a tick, so that both timers fall into the next one
+        cxxtools::Timespan start;
+        while (cxxtools::Timespan::gettimeofday().totalUSecs() / 1000 % 100 > 10)
+            selector.wait(1);
+
+        start = cxxtools::Timespan::gettimeofday();
+        t2.timer.after(50);
+        t1.timer.after(20);
+
+        CXXTOOLS_UNIT_ASSERT(selector.wait(1000));
+
+        // both timers fire on the same wakeup, but never early
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_fired.size(), 2);
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_fired[0], 1);
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_fired[1], 2);
+        CXXTOOLS_UNIT_ASSERT(cxxtools::Timespan::gettimeofday() - start >= cxxtools::Milliseconds(50));
+    }
+
+    void timerLong()
+    {
+        // the timer is placed on a higher level of the wheel first
+        cxxtools::Selector selector;
+        TimerProbe probe(selector, 1, _fired);
+
+        cxxtools::Timespan start = cxxtools::Clock::getSystemTicks();
+        probe.timer.start(150);
+
+        waitFired(selector, 2);
+
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_fired.size(), 2);
+        CXXTOOLS_UNIT_ASSERT(cxxtools::Clock::getSystemTicks() - start >= cxxtools::Milliseconds(300));
+    }
+
+    void timerStop()
+    {
+        cxxtools::Selector selector;
+
+        std::vector<std::unique_ptr<TimerProbe>> timers;
+        for (unsigned n = 0; n < 1000; ++n)
+        {
+            timers.emplace_back(new TimerProbe(selector, n, _fired));
+            timers[n]->timer.after(5000);
+        }
+
+        // restart every other timer, stop the rest
+        for (unsigned n = 0; n < timers.size(); ++n)
+        {
+            if (n % 2 == 0)
+                timers[n]->timer.after(20 + n % 7);
+            else
+                timers[n]->timer.stop();
+        }
+
+        // destroyed timers are removed from the selector
+        for (unsigned n = 0; n < timers.size(); n += 4)
+            timers[n].reset();
+
+        waitFired(selector, 250);
+        CXXTOOLS_UNIT_ASSERT(!selector.wait(50));
+
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_fired.size(), 250);
+        for (unsigned n = 0; n < _fired.size(); ++n)
+            CXXTOOLS_UNIT_ASSERT_EQUALS(_fired[n] % 4, 2);
+    }
+
+    void timerStopInHandler()
+    {
+        cxxtools::Selector selector;
+        selector.timerResolution(50);
+
+        cxxtools::Timer timer(&selector);
+        _victim.reset(new TimerProbe(selector, 1, _fired));
+        cxxtools::connect(timer.timeout, *this, &SelectorTest::onStopVictim);
+
+        timer.after(1);
+        _victim->timer.after(2);
+
+        CXXTOOLS_UNIT_ASSERT(selector.wait(1000));
+        CXXTOOLS_UNIT_ASSERT(!selector.wait(100));
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_fired.size(), 1);
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_fired[0], 0);
+
+        _victim.reset();
+    }
+
+    void timerDestroyInHandler()
+    {
+        cxxtools::Selector selector;
+        selector.timerResolution(50);
+
+        cxxtools::Timer timer(&selector);
+        _victim.reset(new TimerProbe(selector, 1, _fired));
+        cxxtools::connect(timer.timeout, *this, &SelectorTest::onDestroyVictim);
+
+        timer.after(1);
+        _victim->timer.after(2);
+
+        CXXTOOLS_UNIT_ASSERT(selector.wait(1000));
+        CXXTOOLS_UNIT_ASSERT(!selector.wait(100));
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_fired.size(), 1);
+        CXXTOOLS_UNIT_ASSERT_EQUALS(_fired[0], 0);
+        CXXTOOLS_UNIT_ASSERT(!_victim);
+    }
+
+    void timerWaitTimeout()
+    {
+        cxxtools::Selector selector;
+        cxxtools::Timer timer(&selector);
+        timer.after(cxxtools::Seconds(10));
+
+        cxxtools::Timespan start = cxxtools::Clock::getSystemTicks();
+        CXXTOOLS_UNIT_ASSERT(!selector.wait(100));
+
+        cxxtools::Timespan elapsed = cxxtools::Clock::getSystemTicks() - start;
+        CXXTOOLS_UNIT_ASSERT(elapsed >= cxxtools::Milliseconds(100));
+        CXXTOOLS_UNIT_ASSERT(elapsed < cxxtools::Seconds(5));
+    }
+};
+
+cxxtools::unit::RegisterTest<SelectorTest> register_SelectorTest;
@@ -64,6 +64,10 @@ class SerializationInfoTest : public cxxtools::unit::TestSuite
             registerMethod("testMove", *this, &SerializationInfoTest::testMove);
             registerMethod("testStringToBool", *this, &SerializationInfoTest::testStringToBool);
             registerMethod("testMember", *this, &SerializationInfoTest::testMember);
+            registerMethod("testReset", *this, &SerializationInfoTest::testReset);
+            registerMethod("testManyMembers", *this, &SerializationInfoTest::testManyMembers);
+            registerMethod("testManyMembersIteration", *this, &SerializationInfoTest::testManyMembersIteration);
+            registerMethod("testNames", *this, &SerializationInfoTest::testNames);
         }
 
         void testSiSet()
@@ -548,6 +552,161 @@ class SerializationInfoTest : public cxxtools::unit::TestSuite
             CXXTOOLS_UNIT_ASSERT_EQUALS(si.getMember(2).name(), "baz");
             CXXTOOLS_UNIT_ASSERT_EQUALS(si.getMember(3).name(), "foo");
         }
+
+        void testReset()
+        {
+            cxxtools::SerializationInfo si;
+            si.setTypeName("point");
+            si.addValue("x", 1);
+            si.addValue("y", 2);
+            si.addMember("z").addValue("w", 3);
+
+            const cxxtools::SerializationInfo* x = &si.getMember("x");
+
+            si.reset();
+
+            CXXTOOLS_UNIT_ASSERT(si.isNull());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(si.memberCount(), 0u);
+            CXXTOOLS_UNIT_ASSERT(si.begin() == si.end());
+            CXXTOOLS_UNIT_ASSERT(si.findMember("x") == 0);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(si.typeName(), "");
+
+            // nodes are reused
+            cxxtools::SerializationInfo& a = si.addMember("a");
+            CXXTOOLS_UNIT_ASSERT(&a == x);
+            CXXTOOLS_UNIT_ASSERT(a.isNull());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(a.memberCount(), 0u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(si.memberCount(), 1u);
+
+            // copies do not contain the spare nodes
+            cxxtools::SerializationInfo si2(si);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(si2.memberCount(), 1u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(si2.getMember(0).name(), "a");
+
+            si.addValue("b", 5);
+            si.addValue("c", 6);
+            si.addValue("d", 7);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(si.memberCount(), 4u);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(siValue<int>(si.getMember("d")), 7);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(siValue<int>(si.getMember(3)), 7);
+        }
+
+        void testManyMembers()
+        {
+            cxxtools::SerializationInfo si;
+            for (int n = 0; n < 100; ++n)
+                si.addValue("m" + cxxtools::convert<std::string>(n), n);
+            si.addValue("m5", 500);
+
+            const cxxtools::SerializationInfo& csi = si;
+
+            for (int n = 0; n < 100; ++n)
+                CXXTOOLS_UNIT_ASSERT_EQUALS(siValue<int>(csi.getMember("m" + cxxtools::convert<std::string>(n))), n);
+
+            CXXTOOLS_UNIT_ASSERT(csi.findMember("m100") == 0);
+            CXXTOOLS_UNIT_ASSERT_THROW(csi.getMember("foo"), cxxtools::SerializationError);
+
+            const cxxtools::SerializationInfo::Key key("m42");
+            int value = 0;
+            CXXTOOLS_UNIT_ASSERT(csi.getMember(key, value));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(value, 42);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(siValue<int>(csi.getMember(key)), 42);
+
+            // index is updated when members are added
+            const cxxtools::SerializationInfo::Key newKey("new");
+            CXXTOOLS_UNIT_ASSERT(csi.findMember(newKey) == 0);
+            si.addValue("new", 17);
+            CXXTOOLS_UNIT_ASSERT(csi.findMember(newKey) != 0);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(siValue<int>(*csi.findMember(newKey)), 17);
+
+            // and when members are renamed
+            si.getMember("m7").setName("seven");
+            CXXTOOLS_UNIT_ASSERT(csi.findMember("m7") == 0);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(siValue<int>(csi.getMember("seven")), 7);
+
+            // and on reset
+            si.reset();
+            CXXTOOLS_UNIT_ASSERT(csi.findMember(key) == 0);
+        }
+
+        void testManyMembersIteration()
+        {
+            cxxtools::SerializationInfo si;
+            for (int n = 0; n < 100; ++n)
+                si.addValue("m" + cxxtools::convert<std::string>(n), n);
+
+            const cxxtools::SerializationInfo& csi = si;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(siValue<int>(csi.getMember("m10")), 10);
+
+            // values changed through non const iterators are found
+            for (cxxtools::SerializationInfo::Iterator it = si.begin(); it != si.end(); ++it)
+                it->setValue(siValue<int>(*it) + 1000);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(siValue<int>(csi.getMember("m10")), 1010);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(siValue<int>(si.getMember("m99")), 1099);
+
+            // names changed through non const iterators are found
+            (si.begin() + 20)->setName("twenty");
+            CXXTOOLS_UNIT_ASSERT(csi.findMember("m20") == 0);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(siValue<int>(csi.getMember("twenty")), 1020);
+
+            (si.begin() + 30)->swap(*(si.begin() + 31));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(siValue<int>(csi.getMember("m30")), 1030);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(csi.findMember("m30"), &*(si.begin() + 31));
+
+            cxxtools::SerializationInfo other;
+            other.setName("m50");
+            other.setValue(-1);
+            *(si.begin() + 60) = other;
+            CXXTOOLS_UNIT_ASSERT_EQUALS(siValue<int>(csi.getMember("m50")), 1050);
+            CXXTOOLS_UNIT_ASSERT(csi.findMember("m60") == 0);
+
+            // a duplicate name in front of the indexed member is found first
+            (si.begin() + 40)->setName("m45");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(siValue<int>(csi.getMember("m45")), 1040);
+        }
+
+        void testNames()
+        {
+            cxxtools::SerializationInfo si;
+            si.addValue("point", 1);
+            si.addValue("point", 2);
+            si.setTypeName("point");
+
+            // short names are shared
+            CXXTOOLS_UNIT_ASSERT_EQUALS(&si.getMember(0).name(), &si.getMember(1).name());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(&si.getMember(0).name(), &si.typeName());
+
+            // long names are kept by the node
+            std::string longName(200, 'x');
+            cxxtools::SerializationInfo& l = si.addMember(longName);
+            l.setTypeName(longName + 'y');
+            CXXTOOLS_UNIT_ASSERT_EQUALS(l.name(), longName);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(l.typeName(), longName + 'y');
+
+            l.setName(l.name());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(l.name(), longName);
+
+            cxxtools::SerializationInfo copy(si);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(copy.getMember(2).name(), longName);
+            CXXTOOLS_UNIT_ASSERT(&copy.getMember(2).name() != &l.name());
+
+            cxxtools::SerializationInfo moved(std::move(copy.getMember(2)));
+            CXXTOOLS_UNIT_ASSERT_EQUALS(moved.name(), longName);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(moved.typeName(), longName + 'y');
+
+            cxxtools::SerializationInfo other;
+            other.setName("short");
+            other.swap(moved);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(other.name(), longName);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(moved.name(), "short");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(moved.typeName(), "");
+
+            si.reset();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(si.typeName(), "");
+            si.setName("");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(si.name(), "");
+        }
 };
 
 cxxtools::unit::RegisterTest<SerializationInfoTest> register_SerializationInfoTest;
@@ -28,6 +28,10 @@
 
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <atomic>
+#include <new>
+#include <stdlib.h>
 #include <math.h>
 #include <cxxtools/xml/xmlserializer.h>
 #include <cxxtools/xml/xmldeserializer.h>
@@ -39,6 +43,8 @@
 #include <cxxtools/clock.h>
 #include <cxxtools/convert.h>
 #include <cxxtools/tee.h>
+#include <cxxtools/textstream.h>
+#include <cxxtools/utf8codec.h>
 #include <cxxtools/log.h>
 
 namespace
@@ -85,6 +91,34 @@ namespace
     bool runXml = true;
     bool runJson = true;
     bool runBin = true;
+
+    // counts the calls of operator new
+    std::atomic<unsigned long> allocations(0);
+}
+
+// gcc warns about the free of memory from operator new, when the replaced
+// operators are inlined
+#if defined(__GNUC__) && __GNUC__ >= 11
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size)
+{
+    ++allocations;
+    void* p = malloc(size ? size : 1);
+    if (p == 0)
+        throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    free(p);
 }
 
 // Function, which calls the serializer.
@@ -129,22 +163,93 @@ void benchSerialization(const T& d, const char* fname = 0)
 
     // deserialization
     T v2;
+    unsigned long a = allocations;
     clock.start();
 
-    Deserializer deserializer(data);
-    deserializer.deserialize(v2);
+    cxxtools::Timespan td;
 
-    cxxtools::Timespan td = clock.stop();
+    {
+        Deserializer deserializer(data);
+        deserializer.deserialize(v2);
+        td = clock.stop();
+    }
+
+    a = allocations - a;
+
+    // deserialize again into new objects; memory released by the first
+    // deserialization may be reused
+    T v3;
+    std::istringstream data2(data.str());
+    unsigned long a2 = allocations;
+
+    {
+        Deserializer deserializer2(data2);
+        deserializer2.deserialize(v3);
+    }
+
+    a2 = allocations - a2;
 
     std::cout << "\tserialization: " << ts << "\n"
                  "\tdeserialization: " << td << "\n"
+                 "\tallocations: " << a << " (again: " << a2 << ")\n"
                  "\tsize: " << data.str().size() << " bytes" << std::endl;
 }
 
+// Count the allocations to deserialize a small object, when each object
+// is read with a new deserializer like a request of a rpc server.
+template <typename T, typename Serializer, typename Deserializer>
+void benchColdDeserialization(const T& d, unsigned count)
+{
+    std::ostringstream out;
+    Serializer serializer(out);
+    serialize(serializer, d);
+    serializer.finish();
+
+    std::string data = out.str();
+
+    unsigned long a = allocations;
+    cxxtools::Clock clock;
+    clock.start();
+
+    for (unsigned n = 0; n < count; ++n)
+    {
+        std::istringstream in(data);
+        Deserializer deserializer(in);
+        T v;
+        deserializer.deserialize(v);
+    }
+
+    cxxtools::Timespan td = clock.stop();
+    a = allocations - a;
+
+    std::cout << "\tcold deserialization: " << td / count << " per object\n"
+                 "\tallocations: " << static_cast<double>(a) / count << " per object" << std::endl;
+}
+
 template <typename T>
 void benchXmlSerialization(const T& d, const char* fname = 0)
 {
     benchSerialization<T, cxxtools::xml::XmlSerializer, cxxtools::xml::XmlDeserializer>(d, fname);
+
+    // Xml from a byte stream is parsed by the byte oriented tokenizer.
+    // Compare it with the character based parser used for unicode streams.
+    std::stringstream data;
+    cxxtools::xml::XmlSerializer serializer(data);
+    serialize(serializer, d);
+    serializer.finish();
+
+    T v2;
+    cxxtools::Clock clock;
+    clock.start();
+
+    cxxtools::TextIStream ts(data, new cxxtools::Utf8Codec());
+    cxxtools::xml::XmlDeserializer deserializer;
+    deserializer.parse(ts);
+    deserializer.deserialize(v2);
+
+    cxxtools::Timespan td = clock.stop();
+
+    std::cout << "\tdeserialization from unicode stream: " << td << std::endl;
 }
 
 template <typename T>
@@ -261,6 +366,26 @@ int main(int argc, char* argv[])
                 std::cout << "bin:" << std::endl;
                 benchBinSerialization(v, fileoutput ? "custobject.bin" : 0);
             }
+
+            std::cout << "single custom objects:" << std::endl;
+
+            if (runXml)
+            {
+                std::cout << "xml:" << std::endl;
+                benchColdDeserialization<TestObject, cxxtools::xml::XmlSerializer, cxxtools::xml::XmlDeserializer>(obj, C);
+            }
+
+            if (runJson)
+            {
+                std::cout << "json:" << std::endl;
+                benchColdDeserialization<TestObject, cxxtools::JsonSerializer, cxxtools::JsonDeserializer>(obj, C);
+            }
+
+            if (runBin)
+            {
+                std::cout << "bin:" << std::endl;
+                benchColdDeserialization<TestObject, cxxtools::bin::Serializer, cxxtools::bin::Deserializer>(obj, C);
+            }
         }
 
     }
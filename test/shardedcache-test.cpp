@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/shardedcache.h"
+#include "cxxtools/hashcache.h"
+#include "cxxtools/hashlrucache.h"
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+class ShardedCacheTest : public cxxtools::unit::TestSuite
+{
+    public:
+        ShardedCacheTest()
+        : cxxtools::unit::TestSuite("shardedcache")
+        {
+            registerMethod("cacheTest", *this, &ShardedCacheTest::cacheTest);
+            registerMethod("stats", *this, &ShardedCacheTest::stats);
+            registerMethod("threads", *this, &ShardedCacheTest::threads);
+        }
+
+        void cacheTest()
+        {
+          cxxtools::ShardedCache<cxxtools::HashLruCache<std::string, int> > cache(64, 4);
+
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache.shards(), 4u);
+
+          cache.put("foo", 1);
+          cache.put("bar", 2);
+          cache.put("baz", 3);
+
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache.size(), 3u);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache.get("foo"), 1);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache.get("bar"), 2);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache.get("xyz", 42), 42);
+
+          CXXTOOLS_UNIT_ASSERT(cache.erase("bar"));
+          CXXTOOLS_UNIT_ASSERT(!cache.erase("bar"));
+          CXXTOOLS_UNIT_ASSERT(!cache.getx("bar").first);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache.size(), 2u);
+
+          cache.clear();
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache.size(), 0u);
+
+          // each shard is limited to its part of the maximum
+          for (int n = 0; n < 1000; ++n)
+            cache.put(std::string(1, 'a' + n % 26) + std::to_string(n), n);
+
+          CXXTOOLS_UNIT_ASSERT(cache.size() <= 64u);
+          for (unsigned n = 0; n < cache.shards(); ++n)
+            CXXTOOLS_UNIT_ASSERT_EQUALS(cache.size(n), 16u);
+        }
+
+        void stats()
+        {
+          cxxtools::ShardedCache<cxxtools::HashCache<int, int> > cache(100, 8);
+
+          for (int n = 0; n < 10; ++n)
+            cache.put(n, n * 10);
+
+          for (int n = 0; n < 20; ++n)
+            cache.getx(n);
+
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache.getHits(), 10u);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache.getMisses(), 10u);
+
+          unsigned hits = 0;
+          unsigned misses = 0;
+          for (unsigned n = 0; n < cache.shards(); ++n)
+          {
+            hits += cache.getHits(n);
+            misses += cache.getMisses(n);
+          }
+
+          CXXTOOLS_UNIT_ASSERT_EQUALS(hits, 10u);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(misses, 10u);
+
+          cache.clear(true);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache.getHits(), 0u);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache.getMisses(), 0u);
+        }
+
+        static void access(cxxtools::ShardedCache<cxxtools::HashCache<int, int> >& cache, int offset, std::atomic<unsigned>& errors)
+        {
+          for (int n = 0; n < 10000; ++n)
+          {
+            int key = (n * 7 + offset) % 500;
+            std::pair<bool, int> r = cache.getx(key);
+            if (r.first && r.second != key * 2)
+              ++errors;
+            else if (!r.first)
+              cache.put(key, key * 2);
+          }
+        }
+
+        void threads()
+        {
+          cxxtools::ShardedCache<cxxtools::HashCache<int, int> > cache(256);
+
+          std::atomic<unsigned> errors(0);
+
+          std::vector<std::thread> t;
+          for (int n = 0; n < 4; ++n)
+            t.push_back(std::thread(access, std::ref(cache), n * 13, std::ref(errors)));
+
+          for (unsigned n = 0; n < t.size(); ++n)
+            t[n].join();
+
+          CXXTOOLS_UNIT_ASSERT_EQUALS(errors.load(), 0u);
+          CXXTOOLS_UNIT_ASSERT(cache.size() <= 256u);
+          CXXTOOLS_UNIT_ASSERT_EQUALS(cache.getHits() + cache.getMisses(), 40000u);
+        }
+
+};
+
+cxxtools::unit::RegisterTest<ShardedCacheTest> register_ShardedCacheTest;
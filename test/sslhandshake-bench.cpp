@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/*
+ * Measures the rate of ssl handshakes over loopback with and without
+ * client session resumption. A server thread accepts the connections
+ * using the certificate passed with -c.
+ */
+
+#include <cxxtools/arg.h>
+#include <cxxtools/clock.h>
+#include <cxxtools/sslctx.h>
+#include <cxxtools/net/tcpserver.h>
+#include <cxxtools/net/tcpsocket.h>
+
+#include <iostream>
+#include <iomanip>
+#include <thread>
+
+namespace bench
+{
+    void serve(cxxtools::net::TcpServer& server, const cxxtools::SslCtx& sslCtx, unsigned long count)
+    {
+        for (unsigned long n = 0; n < count; ++n)
+        {
+            cxxtools::net::TcpSocket socket(server);
+            socket.sslAccept(sslCtx);
+            socket.write("x", 1);
+        }
+    }
+
+    double run(cxxtools::net::TcpServer& server, const cxxtools::SslCtx& serverCtx,
+        const std::string& ip, unsigned short port, const cxxtools::SslCtx& clientCtx,
+        unsigned long count)
+    {
+        std::thread serverThread(serve, std::ref(server), std::cref(serverCtx), count);
+
+        cxxtools::Clock cl;
+        cl.start();
+
+        for (unsigned long n = 0; n < count; ++n)
+        {
+            cxxtools::net::TcpSocket socket(ip, port);
+            socket.sslConnect(clientCtx);
+
+            // reading processes the session tickets sent after the handshake
+            char ch;
+            socket.read(&ch, 1);
+        }
+
+        cxxtools::Seconds T = cl.stop();
+
+        serverThread.join();
+
+        return count / T;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        cxxtools::Arg<std::string> cert(argc, argv, 'c');
+        cxxtools::Arg<std::string> ip(argc, argv, 'i', "127.0.0.1");
+        cxxtools::Arg<unsigned short> port(argc, argv, 'p', 7010);
+        cxxtools::Arg<unsigned long> count(argc, argv, 'n', 1000);
+
+        if (!cert.isSet())
+        {
+            std::cerr << "usage: " << argv[0] << " -c cert [-i ip] [-p port] [-n count]\n"
+                         "   -c cert    server certificate with private key\n"
+                         "   -n count   number of connections per run\n";
+            return -1;
+        }
+
+        cxxtools::SslCtx serverCtx;
+        serverCtx.loadCertificateFile(cert);
+
+        cxxtools::net::TcpServer server(ip, port, 64);
+
+        std::cout << "mode\thandshakes/s\tfull\tresumed" << std::endl;
+
+        for (unsigned resume = 0; resume < 2; ++resume)
+        {
+            cxxtools::SslCtx clientCtx;
+            clientCtx.setSessionCacheSize(resume ? 100 : 0);
+
+            double rate = bench::run(server, serverCtx, ip, port, clientCtx, count);
+
+            std::cout << (resume ? "resume" : "full") << '\t'
+                      << std::fixed << std::setprecision(0) << rate << '\t'
+                      << clientCtx.fullHandshakes() << '\t'
+                      << clientCtx.resumedHandshakes() << std::endl;
+        }
+
+        std::cout << "server\t\t" << serverCtx.fullHandshakes() << '\t'
+                  << serverCtx.resumedHandshakes() << std::endl;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return -1;
+    }
+}
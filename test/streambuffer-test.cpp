@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "cxxtools/unit/testsuite.h"
+#include "cxxtools/unit/registertest.h"
+#include "cxxtools/iostream.h"
+#include "cxxtools/pipe.h"
+#include <string>
+
+namespace
+{
+    std::string content(std::size_t size, char first)
+    {
+        std::string s;
+        s.reserve(size);
+        for (std::size_t n = 0; n < size; ++n)
+            s += static_cast<char>(first + n % 26);
+        return s;
+    }
+
+    std::string readAll(cxxtools::IODevice& device, std::size_t size)
+    {
+        std::string s(size, '\0');
+        std::size_t count = 0;
+        while (count < size)
+            count += device.read(&s[count], size - count);
+        return s;
+    }
+}
+
+class StreamBufferTest : public cxxtools::unit::TestSuite
+{
+    public:
+        StreamBufferTest()
+        : cxxtools::unit::TestSuite("streambuffer")
+        {
+            registerMethod("Slices", *this, &StreamBufferTest::Slices);
+            registerMethod("SmallSlice", *this, &StreamBufferTest::SmallSlice);
+            registerMethod("SliceOverflow", *this, &StreamBufferTest::SliceOverflow);
+            registerMethod("AsyncSlices", *this, &StreamBufferTest::AsyncSlices);
+            registerMethod("DiscardSlices", *this, &StreamBufferTest::DiscardSlices);
+            registerMethod("DiscardTail", *this, &StreamBufferTest::DiscardTail);
+        }
+
+        void Slices()
+        {
+            cxxtools::Pipe pipe;
+            cxxtools::IOStream out(pipe.in());
+
+            std::string body = content(5000, 'a');
+            std::string borrowed = content(2000, 'A');
+
+            out << "header\n";
+            out.putSlice(std::string(body));
+            out << "middle\n";
+            out.putSlice(borrowed.data(), borrowed.size());
+            out << "tail\n";
+
+            std::string expected = "header\n" + body + "middle\n" + borrowed + "tail\n";
+            CXXTOOLS_UNIT_ASSERT_EQUALS(out.out_avail(), static_cast<std::streamsize>(expected.size()));
+
+            out.flush();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(out.out_avail(), 0);
+            CXXTOOLS_UNIT_ASSERT(readAll(pipe.out(), expected.size()) == expected);
+        }
+
+        void SmallSlice()
+        {
+            cxxtools::Pipe pipe;
+            cxxtools::IOStream out(pipe.in());
+
+            // small blocks are copied, so the data may be changed afterwards
+            std::string data = "small";
+            out.putSlice(data.data(), data.size());
+            data = "other";
+
+            out.flush();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(readAll(pipe.out(), 5), "small");
+        }
+
+        void SliceOverflow()
+        {
+            cxxtools::Pipe pipe;
+            cxxtools::IOStream out(pipe.in(), 16);
+
+            // the slice must be written before the data, which does not
+            // fit into the buffer any more
+            std::string body = content(3000, 'a');
+            std::string tail = content(100, 'A');
+
+            out << "header\n";
+            out.putSlice(std::string(body));
+            out << tail;
+            out.flush();
+
+            std::string expected = "header\n" + body + tail;
+            CXXTOOLS_UNIT_ASSERT(readAll(pipe.out(), expected.size()) == expected);
+        }
+
+        void AsyncSlices()
+        {
+            cxxtools::Pipe pipe(cxxtools::Pipe::Async);
+            cxxtools::IOStream out(pipe.in());
+
+            std::string body = content(20000, 'a');
+
+            out << "header\n";
+            out.putSlice(std::string(body));
+            out << "tail\n";
+
+            std::string expected = "header\n" + body + "tail\n";
+
+            out.buffer().beginWrite();
+            while (out.out_avail() > 0)
+            {
+                out.buffer().endWrite();
+                out.buffer().beginWrite();
+            }
+
+            CXXTOOLS_UNIT_ASSERT(readAll(pipe.out(), expected.size()) == expected);
+        }
+
+        void DiscardSlices()
+        {
+            cxxtools::Pipe pipe;
+            cxxtools::IOStream out(pipe.in());
+
+            out << "header\n";
+            out.putSlice(content(5000, 'a'));
+            out.buffer().discardOutput();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(out.out_avail(), 0);
+
+            out << "next\n";
+            out.flush();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(readAll(pipe.out(), 5), "next\n");
+        }
+
+        void DiscardTail()
+        {
+            cxxtools::Pipe pipe;
+            cxxtools::IOStream out(pipe.in());
+
+            std::string body = content(5000, 'a');
+
+            out << "header\n";
+            out.putSlice(std::string(body));
+            out << "partial";
+            out.buffer().discardOutput(7 + body.size() + 3);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(out.out_avail(), 7 + body.size() + 3);
+
+            out.buffer().discardOutput(7 + 2000);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(out.out_avail(), 7 + 2000);
+
+            out << "tail\n";
+            out.flush();
+
+            std::string expected = "header\n" + body.substr(0, 2000) + "tail\n";
+            CXXTOOLS_UNIT_ASSERT(readAll(pipe.out(), expected.size()) == expected);
+        }
+};
+
+cxxtools::unit::RegisterTest<StreamBufferTest> register_StreamBufferTest;
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2026 Tommi Maekitalo
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * As a special exception, you may use this file as part of a free
+ * software library without restriction. Specifically, if other files
+ * instantiate templates or use macros or inline functions from this
+ * file, or you compile this file and link it with other files to
+ * produce an executable, this file does not by itself cause the
+ * resulting executable to be covered by the GNU General Public
+ * License. This exception does not however invalidate any other
+ * reasons why the executable file might be covered by the GNU Library
+ * General Public License.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/*
+ * Measures the cost of rearming timers as done for connection timeouts:
+ * a number of timers is attached to a selector and each of them is
+ * restarted over and over again before it expires.
+ */
+
+#include <cxxtools/arg.h>
+#include <cxxtools/clock.h>
+#include <cxxtools/selector.h>
+#include <cxxtools/timer.h>
+
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <vector>
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        cxxtools::Arg<unsigned> numTimers(argc, argv, 't', 10000);
+        cxxtools::Arg<unsigned> rounds(argc, argv, 'n', 100);
+        cxxtools::Arg<unsigned> resolution(argc, argv, 'r', 1);    // timer resolution in ms
+
+        cxxtools::Selector selector;
+        selector.timerResolution(cxxtools::Milliseconds(resolution.getValue()));
+
+        std::vector<std::unique_ptr<cxxtools::Timer>> timers;
+        for (unsigned n = 0; n < numTimers; ++n)
+            timers.emplace_back(new cxxtools::Timer(&selector));
+
+        cxxtools::Clock cl;
+        cl.start();
+
+        for (unsigned r = 0; r < rounds; ++r)
+        {
+            for (unsigned n = 0; n < timers.size(); ++n)
+                timers[n]->after(cxxtools::Seconds(30) + cxxtools::Milliseconds(n % 1000));
+
+            selector.wait(0);
+        }
+
+        cxxtools::Seconds T = cl.stop();
+
+        std::cout << "timers:   " << numTimers.getValue() << '\n'
+                  << "restarts: " << std::fixed << std::setprecision(0)
+                  << (static_cast<double>(numTimers) * rounds / T) << "/s" << std::endl;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return -1;
+    }
+}
@@ -29,6 +29,9 @@
 #include <iostream>
 #include "cxxtools/xml/xmlreader.h"
 #include "cxxtools/xml/startelement.h"
+#include "cxxtools/xml/characters.h"
+#include "cxxtools/xml/processinginstruction.h"
+#include "cxxtools/xml/xmlerror.h"
 #include "cxxtools/xml/entityresolver.h"
 #include "cxxtools/unit/testsuite.h"
 #include "cxxtools/unit/registertest.h"
@@ -44,6 +47,11 @@ class XmlReaderTest : public cxxtools::unit::TestSuite
             registerMethod("XmlReadEmptyXml", *this, &XmlReaderTest::XmlReadEmptyXml);
             registerMethod("XmlReadAttributes", *this, &XmlReaderTest::XmlReadAttributes);
             registerMethod("XmlReadAttributesFromEmptyXml", *this, &XmlReaderTest::XmlReadAttributesFromEmptyXml);
+            registerMethod("XmlReadCharacters", *this, &XmlReaderTest::XmlReadCharacters);
+            registerMethod("XmlReadMarkup", *this, &XmlReaderTest::XmlReadMarkup);
+            registerMethod("XmlReadLines", *this, &XmlReaderTest::XmlReadLines);
+            registerMethod("XmlReadIncomplete", *this, &XmlReaderTest::XmlReadIncomplete);
+            registerMethod("XmlAdvance", *this, &XmlReaderTest::XmlAdvance);
             registerMethod("XmlEntity", *this, &XmlReaderTest::XmlEntity);
             registerMethod("ReverseEntity", *this, &XmlReaderTest::ReverseEntity);
             registerMethod("AllEntities", *this, &XmlReaderTest::AllEntities);
@@ -147,6 +155,116 @@ class XmlReaderTest : public cxxtools::unit::TestSuite
             CXXTOOLS_UNIT_ASSERT_EQUALS(root.attribute(L"attr2").narrow(), "two");
         }
 
+        void XmlReadCharacters()
+        {
+            std::istringstream in(
+                "<root a=\"x &amp; 'y'\">1 &lt; 2 &#65;<![CDATA[<b>]]]]><e/>\xc3\xa4</root>");
+            cxxtools::xml::XmlReader xr(in);
+
+            cxxtools::xml::StartElement root = xr.nextElement();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(root.attribute(L"a").narrow(), "x & 'y'");
+
+            const cxxtools::xml::Node& chars = xr.next();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(chars.type(), cxxtools::xml::Node::Characters);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(static_cast<const cxxtools::xml::Characters&>(chars).content().narrow(), "1 < 2 A<b>]]");
+
+            xr.nextElement();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(xr.next().type(), cxxtools::xml::Node::EndElement);
+
+            const cxxtools::xml::Node& uchars = xr.next();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(uchars.type(), cxxtools::xml::Node::Characters);
+            CXXTOOLS_UNIT_ASSERT(static_cast<const cxxtools::xml::Characters&>(uchars).content() == cxxtools::String(1, cxxtools::Char(0xE4)));
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(xr.next().type(), cxxtools::xml::Node::EndElement);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(xr.next().type(), cxxtools::xml::Node::EndDocument);
+        }
+
+        void XmlReadMarkup()
+        {
+            std::istringstream in(
+                "<?xml version=\"1.0\"?>\n"
+                "<!DOCTYPE root>\n"
+                "<!-- a - comment -->\n"
+                "<root>a<!-- b -->b<?pi some data?>c</root>\n");
+            cxxtools::xml::XmlReader xr(in);
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(xr.documentVersion().narrow(), "1.0");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(xr.next().type(), cxxtools::xml::Node::DocType);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(xr.next().type(), cxxtools::xml::Node::StartElement);
+
+            const cxxtools::xml::Node& pi = xr.next();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(pi.type(), cxxtools::xml::Node::ProcessingInstruction);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(static_cast<const cxxtools::xml::ProcessingInstruction&>(pi).target().narrow(), "pi");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(static_cast<const cxxtools::xml::ProcessingInstruction&>(pi).data().narrow(), "some data");
+
+            const cxxtools::xml::Node& chars = xr.next();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(chars.type(), cxxtools::xml::Node::Characters);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(static_cast<const cxxtools::xml::Characters&>(chars).content().narrow(), "abc");
+
+            CXXTOOLS_UNIT_ASSERT_EQUALS(xr.next().type(), cxxtools::xml::Node::EndElement);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(xr.next().type(), cxxtools::xml::Node::EndDocument);
+        }
+
+        void XmlReadLines()
+        {
+            std::istringstream in(
+                "<root>\n"
+                "  <foo\n"
+                "    attr=\"1\"/>\n"
+                "  <bar>\n"
+                "  </baz\n");
+            cxxtools::xml::XmlReader xr(in);
+
+            xr.nextElement();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(xr.line(), 1u);
+            xr.nextElement();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(xr.line(), 3u);
+            xr.nextElement();
+            CXXTOOLS_UNIT_ASSERT_EQUALS(xr.line(), 4u);
+
+            try
+            {
+                for (unsigned n = 0; n < 10; ++n)
+                    xr.next();
+                CXXTOOLS_UNIT_FAIL("XmlError expected");
+            }
+            catch (const cxxtools::xml::XmlError& e)
+            {
+                CXXTOOLS_UNIT_ASSERT_EQUALS(e.line(), 6u);
+            }
+        }
+
+        void XmlReadIncomplete()
+        {
+            std::istringstream in("<root><foo>");
+            cxxtools::xml::XmlReader xr(in);
+
+            xr.nextElement();
+            xr.nextElement();
+            CXXTOOLS_UNIT_ASSERT_THROW(xr.next(), cxxtools::xml::XmlError);
+        }
+
+        void XmlAdvance()
+        {
+            std::stringstream in;
+            cxxtools::xml::XmlReader xr(in);
+
+            in << "<root><fo";
+            CXXTOOLS_UNIT_ASSERT(xr.advance());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(xr.get().type(), cxxtools::xml::Node::StartElement);
+            CXXTOOLS_UNIT_ASSERT(!xr.advance());
+
+            in << "o a=\"1\">text</foo></root>";
+            CXXTOOLS_UNIT_ASSERT(xr.advance());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(static_cast<const cxxtools::xml::StartElement&>(xr.get()).name().narrow(), "foo");
+            CXXTOOLS_UNIT_ASSERT_EQUALS(static_cast<const cxxtools::xml::StartElement&>(xr.get()).attribute(L"a").narrow(), "1");
+            CXXTOOLS_UNIT_ASSERT(xr.advance());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(xr.get().type(), cxxtools::xml::Node::Characters);
+            CXXTOOLS_UNIT_ASSERT(xr.advance());
+            CXXTOOLS_UNIT_ASSERT(xr.advance());
+            CXXTOOLS_UNIT_ASSERT_EQUALS(xr.depth(), 0u);
+        }
+
         void XmlEntity()
         {
             cxxtools::xml::EntityResolver resolver;
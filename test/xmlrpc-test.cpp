@@ -40,6 +40,8 @@
 #include <stdlib.h>
 #include <sstream>
 
+#include "asyncwaiting.h"
+
 log_define("cxxtools.test.xmlrpc")
 
 namespace
@@ -85,6 +87,9 @@ class XmlRpcTest : public cxxtools::unit::TestSuite
         std::string _listen;
         unsigned short _port;
 
+        // procedures waiting for "release"
+        AsyncWaiting _waiting;
+
     public:
         XmlRpcTest()
         : cxxtools::unit::TestSuite("xmlrpc"),
@@ -112,6 +117,8 @@ class XmlRpcTest : public cxxtools::unit::TestSuite
             registerMethod("PrepareConnect", *this, &XmlRpcTest::PrepareConnect);
             registerMethod("Connect", *this, &XmlRpcTest::Connect);
             registerMethod("Multiple", *this, &XmlRpcTest::Multiple);
+            registerMethod("Async", *this, &XmlRpcTest::Async);
+            registerMethod("AsyncFault", *this, &XmlRpcTest::AsyncFault);
 
             char* PORT = getenv("UTEST_PORT");
             if (PORT)
@@ -836,6 +843,70 @@ class XmlRpcTest : public cxxtools::unit::TestSuite
 
         }
 
+        ////////////////////////////////////////////////////////////
+        // Async
+        //
+        void Async()
+        {
+            // one of the workers blocks in accept, so the other one must not
+            // be blocked by the waiting procedure
+            _server->maxThreads(2);
+            cxxtools::xmlrpc::Service service;
+            service.registerAsyncMethod("wait", _waiting, &AsyncWaiting::wait);
+            service.registerMethod("release", _waiting, &AsyncWaiting::release);
+            _server->addService("/rpc", service);
+
+            cxxtools::xmlrpc::HttpClient client1(_loop, _listen, _port, "/rpc");
+            cxxtools::xmlrpc::HttpClient client2(_loop, _listen, _port, "/rpc");
+            cxxtools::RemoteProcedure<int, int> wait(client1, "wait");
+            cxxtools::RemoteProcedure<bool, int> release(client2, "release");
+
+            wait.begin(21);
+            AsyncWaiting::callRelease(release, 2);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(wait.end(2000), 42);
+
+            // the connection is usable after the asynchronous call
+            wait.begin(5);
+            AsyncWaiting::callRelease(release, 3);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(wait.end(2000), 15);
+        }
+
+        ////////////////////////////////////////////////////////////
+        // AsyncFault
+        //
+        void AsyncFault()
+        {
+            cxxtools::xmlrpc::Service service;
+            service.registerAsyncMethod("fault", *this, &XmlRpcTest::asyncFault);
+            service.registerMethod("multiply", *this, &XmlRpcTest::multiplyInt);
+            _server->addService("/rpc", service);
+
+            cxxtools::xmlrpc::HttpClient client(_loop, _listen, _port, "/rpc");
+            cxxtools::RemoteProcedure<int, int> fault(client, "fault");
+            cxxtools::RemoteProcedure<int, int, int> multiply(client, "multiply");
+
+            fault.begin(7);
+
+            try
+            {
+                fault.end(2000);
+                CXXTOOLS_UNIT_ASSERT_MSG(false, "cxxtools::RemoteException exception expected");
+            }
+            catch (const cxxtools::RemoteException& e)
+            {
+                CXXTOOLS_UNIT_ASSERT_EQUALS(e.rc(), 7);
+                CXXTOOLS_UNIT_ASSERT_EQUALS(e.text(), "async fault");
+            }
+
+            multiply.begin(2, 3);
+            CXXTOOLS_UNIT_ASSERT_EQUALS(multiply.end(2000), 6);
+        }
+
+        void asyncFault(cxxtools::AsyncResult<int> result, int rc)
+        {
+            result.setError(cxxtools::RemoteException("async fault", rc));
+        }
+
 };
 
 cxxtools::unit::RegisterTest<XmlRpcTest> register_XmlRpcTest;